@@ -0,0 +1,202 @@
+/*
+ * Barrier benchmark: the native InteriorPointSolver per thread count
+ * versus the native simplex and GLPK's interior-point method on LPs.
+ *
+ * Each model is solved once by SimplexSolver (primal) and glp_interior,
+ * and once per thread count by the barrier. The table shows, per thread
+ * count, the barrier's wall time (loading, which includes the ordering
+ * and symbolic analysis, plus solving), its speedup over the first thread
+ * count, its iterations, the size of the Cholesky factor and its number
+ * of supernodes. Once per model it shows the crossover from the first
+ * barrier solution (SimplexSolver::crossover() from crossoverBasis(),
+ * time and pivots), the simplex time and iterations from the all-logical
+ * basis, the glp_interior time and the simplex objective. Barrier objectives
+ * that differ from it by more than 1e-6 relative, and crossover
+ * objectives that differ by more than 1e-9, are reported below the
+ * model's rows.
+ *
+ * Without model arguments a set of generated LPs is used: transportation
+ * problems, random sparse packing LPs and min-cost flows on a grid (whose
+ * conservation rows are linearly dependent). Model files in the custom,
+ * CPLEX LP (.lp) or free MPS (.mps) format may be given instead; their
+ * integrality is dropped.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/barrier_bench.cpp src/interior_point.cpp src/sparse_cholesky.cpp \
+ *       src/crossover.cpp src/simplex.cpp src/basis_factor.cpp src/compact_model.cpp src/symbol_table.cpp src/parser.cpp \
+ *       src/lexer.cpp src/lp_format.cpp src/mps.cpp src/input_file.cpp src/thread_pool.cpp -lglpk \
+ *       -o barrier_bench
+ *
+ * Usage:
+ *   barrier_bench [--threads 1,2,4,8] [model files...]
+ */
+#include "bench_glpk.h"
+#include "bench_models.h"
+#include "interior_point.h"
+#include "crossover.h"
+#include "simplex.h"
+#include "thread_pool.h"
+#include <glpk.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+  /*
+   * Function: gridFlow
+   * -------------------------
+   * Min-cost flow on a `side` x `side` grid with arcs both ways between
+   * neighbours (capacity 30, random costs), sending 50 units from each of
+   * the top corners to each of the bottom corners. One equality row per
+   * node; together they are rank deficient by one.
+   */
+  CompactModel gridFlow(uint32_t side, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> costDist(1, 20);
+
+    CompactModel m;
+    uint32_t nodes = side * side;
+    vector<vector<pair<uint32_t, double>>> rowEntries(nodes);
+    auto addArc = [&](uint32_t from, uint32_t to) {
+      rowEntries[from].push_back({ m.numCols, 1.0 });
+      rowEntries[to].push_back({ m.numCols, -1.0 });
+      addColumn(m, 0.0, 30.0, costDist(rng));
+    };
+    for (uint32_t r = 0; r < side; ++r) {
+      for (uint32_t c = 0; c < side; ++c) {
+        uint32_t v = r * side + c;
+        if (c + 1 < side) {
+          addArc(v, v + 1);
+          addArc(v + 1, v);
+        }
+        if (r + 1 < side) {
+          addArc(v, v + side);
+          addArc(v + side, v);
+        }
+      }
+    }
+    vector<double> supply(nodes, 0.0);
+    supply[0] = supply[side - 1] = 50.0;
+    supply[nodes - side] = supply[nodes - 1] = -50.0;
+    for (uint32_t v = 0; v < nodes; ++v) addRow(m, rowEntries[v], supply[v], supply[v]);
+    return m;
+  }
+
+  /*
+   * Function: solveGlpkInterior
+   * -------------------------
+   * Loads `m` into a new GLPK problem and runs glp_interior; returns the
+   * objective, or NaN without an optimum.
+   */
+  double solveGlpkInterior(const CompactModel& m) {
+    glp_prob* lp = toGlpk(m);
+    glp_iptcp parm;
+    glp_init_iptcp(&parm);
+    parm.msg_lev = GLP_MSG_OFF;
+    double objective = NAN;
+    if (glp_interior(lp, &parm) == 0 && glp_ipt_status(lp) == GLP_OPT) objective = glp_ipt_obj_val(lp);
+    glp_delete_prob(lp);
+    return objective;
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  vector<Instance> instances;
+  vector<unsigned> threadCounts;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCounts = parseThreadList(argv[++i]);
+    else instances.push_back({ argv[i], readLpModel(argv[i]) });
+  }
+  if (instances.empty()) {
+    instances.push_back({ "transport-60x120", transportation(60, 120, 1) });
+    instances.push_back({ "transport-150x300", transportation(150, 300, 2) });
+    instances.push_back({ "packing-1000x2000", packing(1000, 2000, 10, 3) });
+    instances.push_back({ "grid-flow-100", gridFlow(100, 4) });
+  }
+  if (threadCounts.empty()) {
+    unsigned hw = ThreadPool::resolveThreads(0);
+    for (unsigned t = 1; t < hw; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+  }
+  glp_term_out(GLP_OFF);
+
+  printf("%-20s %7s | %10s %7s %5s %10s %6s | %8s %6s | %10s %7s %10s | %16s\n", "model", "threads", "barrier s",
+         "speedup", "iters", "nnz(L)", "snodes", "xover s", "pivots", "simplex s", "iters", "glpk ipm s", "objective");
+  for (const Instance& inst : instances) {
+    const CompactModel& m = inst.model;
+
+    auto start = chrono::steady_clock::now();
+    SimplexSolver simplex;
+    simplex.loadModel(m);
+    bool simplexOptimal = simplex.solve() == SimplexStatus::OPTIMAL;
+    double simplexObjective = simplexOptimal ? simplex.getObjectiveValue() : NAN;
+    double simplexSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    double glpkObjective = solveGlpkInterior(m);
+    double glpkSeconds = secondsSince(start);
+
+    double firstSeconds = 0.0;
+    vector<string> mismatches;
+    for (size_t k = 0; k < threadCounts.size(); ++k) {
+      start = chrono::steady_clock::now();
+      InteriorPointSolver barrier;
+      barrier.setThreads(threadCounts[k]);
+      barrier.loadModel(m);
+      IpmStatus status = barrier.solve();
+      double seconds = secondsSince(start);
+      if (k == 0) firstSeconds = seconds;
+
+      double objective = barrier.getObjectiveValue();
+      if (status != IpmStatus::OPTIMAL) {
+        mismatches.push_back(to_string(threadCounts[k]) + " threads: " + ipmStatusName(status));
+      }
+      else if (!(fabs(objective - simplexObjective) <= 1e-6 * (1.0 + fabs(simplexObjective)))) {
+        char line[96];
+        snprintf(line, sizeof line, "%u threads: objective %.10g", threadCounts[k], objective);
+        mismatches.push_back(line);
+      }
+
+      if (k == 0) {
+        double crossoverSeconds = NAN;
+        uint64_t pivots = 0;
+        if (status == IpmStatus::OPTIMAL) {
+          start = chrono::steady_clock::now();
+          SimplexSolver crossover;
+          crossover.loadModel(m);
+          vector<double> values = barrier.getVariableValues();
+          SimplexStatus crossoverStatus = crossover.crossover(
+              values, crossoverBasis(m, values, barrier.getRowDuals(), barrier.getReducedCosts()));
+          crossoverSeconds = secondsSince(start);
+          pivots = crossover.iterations();
+          double crossoverObjective = crossover.getObjectiveValue();
+          if (crossoverStatus != SimplexStatus::OPTIMAL) {
+            mismatches.push_back(string("crossover: ") + simplexStatusName(crossoverStatus));
+          }
+          else if (!(fabs(crossoverObjective - simplexObjective) <= 1e-9 * (1.0 + fabs(simplexObjective)))) {
+            mismatches.push_back("crossover: objective " + to_string(crossoverObjective));
+          }
+        }
+        printf("%-20s %7u | %10.4f %7.2f %5llu %10zu %6u | %8.4f %6llu | %10.4f %7llu %10.4f | %16.8g\n",
+               inst.name.c_str(), threadCounts[k], seconds, 1.0, static_cast<unsigned long long>(barrier.iterations()),
+               barrier.factorNonzeros(), barrier.supernodes(), crossoverSeconds,
+               static_cast<unsigned long long>(pivots), simplexSeconds,
+               static_cast<unsigned long long>(simplex.iterations()), glpkSeconds, simplexObjective);
+      }
+      else {
+        printf("%-20s %7u | %10.4f %7.2f %5llu %10zu %6u |\n", "", threadCounts[k], seconds, firstSeconds / seconds,
+               static_cast<unsigned long long>(barrier.iterations()), barrier.factorNonzeros(), barrier.supernodes());
+      }
+    }
+    if (!(fabs(glpkObjective - simplexObjective) <= 1e-6 * (1.0 + fabs(simplexObjective)))) {
+      mismatches.push_back("glp_interior: objective " + to_string(glpkObjective));
+    }
+    for (const string& line : mismatches) printf("  %s\n", line.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Barrier check: the native InteriorPointSolver against the dual simplex
+ * on many small random LPs, for certificates the barrier must not give.
+ *
+ * Each LP has 3 to 40 rows and columns, about a quarter of the matrix
+ * filled with small integers, and a mix of nonnegative, boxed and free
+ * columns and of <=, >=, = and ranged rows, so that feasible,
+ * infeasible and unbounded LPs all occur, along with near-degenerate
+ * feasible ones on which the barrier loses primal feasibility late and
+ * stalls. The barrier may fail to decide an LP (NUMERICAL_ERROR), but it
+ * must never report INFEASIBLE or UNBOUNDED where the simplex does not,
+ * and optimal objectives must agree to 1e-5 relative. The table counts
+ * the pairs of statuses; the first mismatches are listed, and the exit
+ * status is 1 if there were any. The pipeline falls back to the dual
+ * simplex when the barrier fails, so failures on LPs the simplex solves
+ * cost time rather than answers; their share is reported, and above
+ * MAX_OPTIMAL_FAILURES it also makes the exit status 1.
+ *
+ * The LPs come from randomSmallLp() in bench_models.h, so a seed gives
+ * the same LPs on every standard library.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/barrier_check.cpp src/interior_point.cpp src/sparse_cholesky.cpp \
+ *       src/simplex.cpp src/basis_factor.cpp src/compact_model.cpp src/symbol_table.cpp src/thread_pool.cpp \
+ *       -o barrier_check
+ *
+ * Usage:
+ *   barrier_check [count] [seed]   (defaults 2000 and 7)
+ */
+#include "bench_models.h"
+#include "interior_point.h"
+#include "simplex.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+  constexpr double OBJECTIVE_TOLERANCE = 1e-5; // Relative
+  constexpr int MAX_LISTED = 10;               // Mismatches printed in full
+  constexpr double MAX_OPTIMAL_FAILURES = 0.04; // Share of simplex optima the barrier may fail on
+
+  // A barrier result the simplex contradicts
+  bool contradicts(IpmStatus barrier, double barrierObjective, SimplexStatus simplex, double simplexObjective) {
+    if (barrier == IpmStatus::INFEASIBLE) return simplex != SimplexStatus::INFEASIBLE;
+    if (barrier == IpmStatus::UNBOUNDED) return simplex != SimplexStatus::UNBOUNDED;
+    if (barrier == IpmStatus::OPTIMAL && simplex == SimplexStatus::OPTIMAL) {
+      return fabs(barrierObjective - simplexObjective) > OBJECTIVE_TOLERANCE * (1.0 + fabs(simplexObjective));
+    }
+    return false;
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  int count = argc > 1 ? atoi(argv[1]) : 2000;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 7;
+  mt19937 rng(seed);
+
+  map<string, int> pairs;
+  int mismatches = 0;
+  int optimal = 0, optimalFailures = 0; // LPs the simplex solves, and of those the barrier failed on
+  for (int k = 0; k < count; ++k) {
+    CompactModel m = randomSmallLp(rng);
+
+    SimplexSolver simplex;
+    simplex.loadModel(m);
+    SimplexStatus simplexStatus = simplex.solve(true);
+
+    InteriorPointSolver barrier;
+    barrier.setThreads(1);
+    barrier.loadModel(m);
+    IpmStatus barrierStatus = barrier.solve();
+
+    pairs[string(simplexStatusName(simplexStatus)) + " / " + ipmStatusName(barrierStatus)]++;
+    if (simplexStatus == SimplexStatus::OPTIMAL) {
+      optimal++;
+      optimalFailures += barrierStatus == IpmStatus::NUMERICAL_ERROR;
+    }
+    if (!contradicts(barrierStatus, barrier.getObjectiveValue(), simplexStatus, simplex.getObjectiveValue())) continue;
+    if (mismatches++ < MAX_LISTED) {
+      printf("LP %d (%u rows, %u columns): simplex %s %.9g, barrier %s %.9g after %llu iterations\n", k, m.numRows,
+             m.numCols, simplexStatusName(simplexStatus), simplex.getObjectiveValue(), ipmStatusName(barrierStatus),
+             barrier.getObjectiveValue(), static_cast<unsigned long long>(barrier.iterations()));
+    }
+  }
+
+  printf("%-36s %6s\n", "simplex / barrier", "LPs");
+  for (const auto& entry : pairs) printf("%-36s %6d\n", entry.first.c_str(), entry.second);
+  printf("%d of %d LPs contradicted\n", mismatches, count);
+  double failureRate = optimal > 0 ? double(optimalFailures) / optimal : 0.0;
+  printf("NUMERICAL_ERROR on %d of %d optimal LPs (%.1f%%, at most %.1f%%)\n", optimalFailures, optimal,
+         100.0 * failureRate, 100.0 * MAX_OPTIMAL_FAILURES);
+  return mismatches > 0 || failureRate > MAX_OPTIMAL_FAILURES ? 1 : 0;
+}
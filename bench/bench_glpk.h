@@ -0,0 +1,51 @@
+#pragma once
+
+#include "compact_model.h"
+#include <glpk.h>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/*
+ * GLPK side of the benchmarks in this directory, kept apart from
+ * bench_models.h so that benchmarks without GLPK do not need its header.
+ */
+
+/**
+ * @brief Loads `m` into a new GLPK problem, all columns continuous; the
+ * caller deletes it with glp_delete_prob().
+ */
+inline glp_prob* toGlpk(const CompactModel& m) {
+  auto boundType = [](double lower, double upper) {
+    if (lower == -INFINITY && upper == INFINITY) return GLP_FR;
+    if (lower == -INFINITY) return GLP_UP;
+    if (upper == INFINITY) return GLP_LO;
+    return lower == upper ? GLP_FX : GLP_DB;
+  };
+
+  glp_prob* lp = glp_create_prob();
+  glp_set_obj_dir(lp, m.type == OptType::MAXIMIZE ? GLP_MAX : GLP_MIN);
+  if (m.numRows > 0) glp_add_rows(lp, m.numRows);
+  if (m.numCols > 0) glp_add_cols(lp, m.numCols);
+  for (uint32_t i = 0; i < m.numRows; ++i) {
+    glp_set_row_bnds(lp, i + 1, boundType(m.rowLower[i], m.rowUpper[i]), m.rowLower[i], m.rowUpper[i]);
+  }
+  for (uint32_t j = 0; j < m.numCols; ++j) {
+    glp_set_col_bnds(lp, j + 1, boundType(m.colLower[j], m.colUpper[j]), m.colLower[j], m.colUpper[j]);
+    glp_set_obj_coef(lp, j + 1, m.objective[j]);
+  }
+  glp_set_obj_coef(lp, 0, m.objectiveOffset);
+
+  size_t nnz = m.rows.numNonzeros();
+  std::vector<int> ia(nnz + 1), ja(nnz + 1);
+  std::vector<double> ar(nnz + 1);
+  for (uint32_t i = 0; i < m.numRows; ++i) {
+    for (size_t p = m.rows.start[i]; p < m.rows.start[i + 1]; ++p) {
+      ia[p + 1] = i + 1;
+      ja[p + 1] = m.rows.index[p] + 1;
+      ar[p + 1] = m.rows.value[p];
+    }
+  }
+  glp_load_matrix(lp, static_cast<int>(nnz), ia.data(), ja.data(), ar.data());
+  return lp;
+}
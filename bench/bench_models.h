@@ -0,0 +1,227 @@
+#pragma once
+
+#include "compact_model.h"
+#include "lp_format.h"
+#include "mps.h"
+#include "parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Helpers shared by the benchmarks in this directory: building generated
+ * models column by column and row by row, reading model files and parsing
+ * the common command-line arguments. Header-only, so each benchmark still
+ * builds from its own source file.
+ */
+
+/**
+ * @brief A benchmark model and the name it is reported under.
+ */
+struct Instance {
+  std::string name;
+  CompactModel model;
+};
+
+/**
+ * @brief Appends a column named x<index> with the given bounds, objective
+ * coefficient and kind.
+ */
+inline void addColumn(CompactModel& m, double lower, double upper, double cost,
+                      VarType kind = VarType::CONTINUOUS) {
+  m.variables.intern("x" + std::to_string(m.numCols++));
+  m.colLower.push_back(lower);
+  m.colUpper.push_back(upper);
+  m.colKind.push_back(kind);
+  m.objective.push_back(cost);
+}
+
+/**
+ * @brief Appends a row lower <= sum of terms (column, coefficient) <= upper.
+ */
+inline void addRow(CompactModel& m, const std::vector<std::pair<uint32_t, double>>& terms, double lower,
+                   double upper) {
+  for (const auto& t : terms) {
+    m.rows.index.push_back(t.first);
+    m.rows.value.push_back(t.second);
+  }
+  m.rows.start.push_back(m.rows.index.size());
+  m.rowLower.push_back(lower);
+  m.rowUpper.push_back(upper);
+  m.numRows++;
+}
+
+/**
+ * @brief Transportation LP: ships from `sources` supplies to `sinks`
+ * demands (90% of supply) at random unit costs, one column per
+ * source/sink pair. Highly degenerate, with triangular bases.
+ */
+inline CompactModel transportation(uint32_t sources, uint32_t sinks, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> costDist(1, 50), supplyDist(100, 200), demandDist(50, 150);
+
+  CompactModel m;
+  for (uint32_t k = 0; k < sources * sinks; ++k) addColumn(m, 0.0, INFINITY, costDist(rng));
+
+  double totalSupply = 0.0, totalDemand = 0.0;
+  std::vector<double> supply(sources), demand(sinks);
+  for (double& s : supply) totalSupply += (s = supplyDist(rng));
+  for (double& d : demand) totalDemand += (d = demandDist(rng));
+
+  for (uint32_t i = 0; i < sources; ++i) {
+    for (uint32_t j = 0; j < sinks; ++j) {
+      m.rows.index.push_back(i * sinks + j);
+      m.rows.value.push_back(1.0);
+    }
+    m.rows.start.push_back(m.rows.index.size());
+    m.rowLower.push_back(-INFINITY);
+    m.rowUpper.push_back(supply[i]);
+  }
+  for (uint32_t j = 0; j < sinks; ++j) {
+    for (uint32_t i = 0; i < sources; ++i) {
+      m.rows.index.push_back(i * sinks + j);
+      m.rows.value.push_back(1.0);
+    }
+    m.rows.start.push_back(m.rows.index.size());
+    m.rowLower.push_back(0.9 * demand[j] * totalSupply / totalDemand);
+    m.rowUpper.push_back(INFINITY);
+  }
+  m.numRows = sources + sinks;
+  return m;
+}
+
+/**
+ * @brief Packing LP: max c x s.t. A x <= b, 0 <= x <= 10, with `perRow`
+ * random positive entries per row.
+ */
+inline CompactModel packing(uint32_t rows, uint32_t cols, uint32_t perRow, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<uint32_t> colDist(0, cols - 1);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  CompactModel m;
+  m.type = OptType::MAXIMIZE;
+  for (uint32_t j = 0; j < cols; ++j) addColumn(m, 0.0, 10.0, 1.0 + 9.0 * unit(rng));
+
+  std::vector<uint32_t> mark(cols, UINT32_MAX);
+  for (uint32_t i = 0; i < rows; ++i) {
+    for (uint32_t k = 0; k < perRow; ++k) {
+      uint32_t j = colDist(rng);
+      if (mark[j] == i) continue;
+      mark[j] = i;
+      m.rows.index.push_back(j);
+      m.rows.value.push_back(1.0 + 9.0 * unit(rng));
+    }
+    m.rows.start.push_back(m.rows.index.size());
+    m.rowLower.push_back(-INFINITY);
+    m.rowUpper.push_back(50.0 + 50.0 * unit(rng));
+  }
+  m.numRows = rows;
+  return m;
+}
+
+/**
+ * @brief Integer in [lo, hi] from a plain reduction of `rng`'s output, so a
+ * seed gives the same draws on every standard library.
+ */
+inline int drawInt(std::mt19937& rng, int lo, int hi) {
+  return lo + static_cast<int>(rng() % static_cast<uint32_t>(hi - lo + 1));
+}
+
+/**
+ * @brief Small random LP for checks against the simplex: 3 to 40 rows and
+ * columns, about a quarter of the matrix filled with small integers, and
+ * a mix of nonnegative, boxed and free columns and of <=, >=, = and
+ * ranged rows, so that feasible, infeasible and unbounded LPs all occur.
+ */
+inline CompactModel randomSmallLp(std::mt19937& rng) {
+  CompactModel m;
+  m.numRows = drawInt(rng, 3, 40);
+  m.numCols = drawInt(rng, 3, 40);
+  m.type = drawInt(rng, 0, 1) ? OptType::MAXIMIZE : OptType::MINIMIZE;
+  for (uint32_t j = 0; j < m.numCols; ++j) {
+    double lower = 0.0, upper = INFINITY;
+    switch (drawInt(rng, 0, 3)) {
+      case 1: upper = drawInt(rng, 1, 10); break;
+      case 2: lower = -INFINITY; break;
+      case 3: lower = -5.0; upper = 5.0; break;
+    }
+    m.colLower.push_back(lower);
+    m.colUpper.push_back(upper);
+    m.colKind.push_back(VarType::CONTINUOUS);
+    m.objective.push_back(drawInt(rng, -9, 9));
+  }
+  for (uint32_t i = 0; i < m.numRows; ++i) {
+    for (uint32_t j = 0; j < m.numCols; ++j) {
+      if (drawInt(rng, 0, 3) != 0) continue;
+      int value = drawInt(rng, -9, 9);
+      if (value == 0) continue;
+      m.rows.index.push_back(j);
+      m.rows.value.push_back(value);
+    }
+    m.rows.start.push_back(m.rows.index.size());
+    double rhs = drawInt(rng, -5, 14);
+    switch (drawInt(rng, 0, 3)) {
+      case 0: m.rowLower.push_back(-INFINITY); m.rowUpper.push_back(rhs); break;
+      case 1: m.rowLower.push_back(rhs - 10.0); m.rowUpper.push_back(INFINITY); break;
+      case 2: m.rowLower.push_back(rhs); m.rowUpper.push_back(rhs); break;
+      default: m.rowLower.push_back(rhs - 5.0); m.rowUpper.push_back(rhs + 5.0); break;
+    }
+  }
+  return m;
+}
+
+/**
+ * @brief Reads a model file by its extension: free MPS (.mps), CPLEX LP
+ * (.lp) or otherwise the custom format.
+ */
+inline CompactModel readModel(const std::string& path) {
+  auto endsWith = [&](const std::string& suffix) {
+    return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  if (endsWith(".mps")) return MpsReader::readFile(path);
+  if (endsWith(".lp")) return CompactModel::fromLPModel(CplexLpReader::readFile(path));
+  return CompactModel::fromLPModel(Parser::parseFile(path));
+}
+
+/**
+ * @brief readModel() with every column made continuous, for LP benchmarks.
+ */
+inline CompactModel readLpModel(const std::string& path) {
+  CompactModel m = readModel(path);
+  std::fill(m.colKind.begin(), m.colKind.end(), VarType::CONTINUOUS);
+  return m;
+}
+
+/**
+ * @brief Parses a comma-separated list of thread counts such as "1,2,4,8";
+ * exits with a message on anything else.
+ */
+inline std::vector<unsigned> parseThreadList(const char* text) {
+  std::vector<unsigned> list;
+  for (const char* p = text; *p;) {
+    char* end = nullptr;
+    unsigned long t = strtoul(p, &end, 10);
+    if (end == p || t == 0) {
+      fprintf(stderr, "Bad thread list: %s\n", text);
+      exit(1);
+    }
+    list.push_back(static_cast<unsigned>(t));
+    p = *end == ',' ? end + 1 : end;
+  }
+  return list;
+}
+
+/**
+ * @brief Wall-clock seconds since `start`.
+ */
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,207 @@
+/*
+ * Branch-and-bound benchmark: nodes per second and speedup versus thread
+ * count for the native parallel BranchAndBound, and the cost of its
+ * deterministic mode.
+ *
+ * Each model is solved per thread count once in opportunistic mode and
+ * twice in deterministic mode. The table shows nodes, wall time and the
+ * speedup over the first thread count for both modes, the overhead of
+ * deterministic mode (its time over the opportunistic time), whether the
+ * two deterministic runs agreed bit for bit (node count, iterations,
+ * objective and solution), and the objective, which must agree across
+ * modes and thread counts. Opportunistic node counts vary from run to
+ * run.
+ *
+ * Without model arguments a set of generated MILPs is used:
+ * multi-dimensional 0-1 knapsacks, a general-integer knapsack and a
+ * capacitated facility location problem (binary open decisions,
+ * continuous assignments). Model files in the custom, CPLEX LP (.lp) or
+ * free MPS (.mps) format may be given instead.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/bnb_bench.cpp src/branch_and_bound.cpp src/simplex.cpp \
+ *       src/basis_factor.cpp src/compact_model.cpp src/symbol_table.cpp src/parser.cpp src/lexer.cpp \
+ *       src/lp_format.cpp src/mps.cpp src/input_file.cpp src/thread_pool.cpp -o bnb_bench
+ *
+ * Usage:
+ *   bnb_bench [--threads 1,2,4,8] [model files...]
+ */
+#include "bench_models.h"
+#include "branch_and_bound.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+  /*
+   * Function: knapsack
+   * -------------------------
+   * max c x  s.t.  A x <= b with `rows` dense random rows, b at half the
+   * row sum; x binary, or integer in [0, 3] if `general`.
+   */
+  CompactModel knapsack(uint32_t rows, uint32_t cols, bool general, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> weight(5, 60);
+
+    CompactModel m;
+    m.type = OptType::MAXIMIZE;
+    vector<double> colSum(cols, 0.0);
+    vector<vector<double>> a(rows, vector<double>(cols));
+    for (auto& row : a) {
+      for (uint32_t j = 0; j < cols; ++j) colSum[j] += (row[j] = weight(rng));
+    }
+    for (uint32_t j = 0; j < cols; ++j) {
+      // Profit correlated with weight, which makes the LP bound weak
+      double profit = colSum[j] / rows + uniform_int_distribution<int>(0, 10)(rng);
+      addColumn(m, 0.0, general ? 3.0 : 1.0, profit, general ? VarType::INTEGER : VarType::BINARY);
+    }
+    for (auto& row : a) {
+      vector<pair<uint32_t, double>> terms;
+      double sum = 0.0;
+      for (uint32_t j = 0; j < cols; ++j) {
+        terms.push_back({ j, row[j] });
+        sum += row[j];
+      }
+      addRow(m, terms, -INFINITY, (general ? 1.5 : 0.5) * sum);
+    }
+    return m;
+  }
+
+  /*
+   * Function: facilityLocation
+   * -------------------------
+   * Capacitated facility location: open facility f (binary y_f, fixed
+   * cost) and assign customer c fractionally (x_fc >= 0) with
+   * sum_f x_fc = 1, x_fc <= y_f and sum_c d_c x_fc <= cap_f y_f.
+   */
+  CompactModel facilityLocation(uint32_t facilities, uint32_t customers, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> coord(0.0, 100.0);
+    uniform_int_distribution<int> demandDist(5, 35);
+
+    vector<double> fx(facilities), fy(facilities), cx(customers), cy(customers), demand(customers);
+    double totalDemand = 0.0;
+    for (uint32_t f = 0; f < facilities; ++f) { fx[f] = coord(rng); fy[f] = coord(rng); }
+    for (uint32_t c = 0; c < customers; ++c) {
+      cx[c] = coord(rng);
+      cy[c] = coord(rng);
+      totalDemand += (demand[c] = demandDist(rng));
+    }
+
+    CompactModel m;
+    for (uint32_t f = 0; f < facilities; ++f) {
+      addColumn(m, 0.0, 1.0, 400.0 + uniform_int_distribution<int>(0, 400)(rng), VarType::BINARY);
+    }
+    auto assign = [&](uint32_t f, uint32_t c) { return facilities + f * customers + c; };
+    for (uint32_t f = 0; f < facilities; ++f) {
+      for (uint32_t c = 0; c < customers; ++c) {
+        double distance = hypot(fx[f] - cx[c], fy[f] - cy[c]);
+        addColumn(m, 0.0, INFINITY, distance * demand[c] / 10.0, VarType::CONTINUOUS);
+      }
+    }
+    for (uint32_t c = 0; c < customers; ++c) {
+      vector<pair<uint32_t, double>> terms;
+      for (uint32_t f = 0; f < facilities; ++f) terms.push_back({ assign(f, c), 1.0 });
+      addRow(m, terms, 1.0, 1.0);
+    }
+    for (uint32_t f = 0; f < facilities; ++f) {
+      for (uint32_t c = 0; c < customers; ++c) addRow(m, { { assign(f, c), 1.0 }, { f, -1.0 } }, -INFINITY, 0.0);
+    }
+    double capacity = 1.8 * totalDemand / facilities;
+    for (uint32_t f = 0; f < facilities; ++f) {
+      vector<pair<uint32_t, double>> terms;
+      for (uint32_t c = 0; c < customers; ++c) terms.push_back({ assign(f, c), demand[c] });
+      terms.push_back({ f, -capacity });
+      addRow(m, terms, -INFINITY, 0.0);
+    }
+    return m;
+  }
+
+  struct Run {
+    MipStatus status;
+    uint64_t nodes;
+    uint64_t iterations;
+    double seconds;
+    double objective;
+    vector<double> solution;
+  };
+
+  Run solveOnce(const CompactModel& model, unsigned threads, bool deterministic) {
+    BranchAndBound bnb;
+    bnb.loadModel(model);
+    bnb.setThreads(threads);
+    bnb.setDeterministic(deterministic);
+    auto start = chrono::steady_clock::now();
+    Run run;
+    run.status = bnb.solve();
+    run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    run.nodes = bnb.nodes();
+    run.iterations = bnb.iterations();
+    run.objective = bnb.hasSolution() ? bnb.getObjectiveValue() : NAN;
+    if (bnb.hasSolution()) run.solution = bnb.getVariableValues();
+    return run;
+  }
+
+  bool identical(const Run& a, const Run& b) {
+    return a.status == b.status && a.nodes == b.nodes && a.iterations == b.iterations &&
+           memcmp(&a.objective, &b.objective, sizeof(double)) == 0 && a.solution.size() == b.solution.size() &&
+           (a.solution.empty() || memcmp(a.solution.data(), b.solution.data(), a.solution.size() * sizeof(double)) == 0);
+  }
+
+  bool agrees(double objective, double reference) {
+    if (isnan(objective) || isnan(reference)) return isnan(objective) && isnan(reference);
+    return fabs(objective - reference) <= 1e-6 * (1.0 + fabs(reference));
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  vector<Instance> instances;
+  vector<unsigned> threadCounts;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCounts = parseThreadList(argv[++i]);
+    else instances.push_back({ argv[i], readModel(argv[i]) });
+  }
+  if (instances.empty()) {
+    instances.push_back({ "knapsack-5x30", knapsack(5, 30, false, 1) });
+    instances.push_back({ "knapsack-10x40", knapsack(10, 40, false, 2) });
+    instances.push_back({ "int-knapsack-5x25", knapsack(5, 25, true, 3) });
+    instances.push_back({ "facility-15x40", facilityLocation(15, 40, 4) });
+  }
+  if (threadCounts.empty()) {
+    unsigned hw = ThreadPool::resolveThreads(0);
+    for (unsigned t = 1; t < hw; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+  }
+
+  printf("%-20s %7s | %22s %8s | %22s %8s | %8s %5s | %16s\n", "", "", "opportunistic", "", "deterministic", "", "", "",
+         "");
+  printf("%-20s %7s | %10s %11s %8s | %10s %11s %8s | %8s %5s | %16s\n", "model", "threads", "nodes", "time (s)",
+         "speedup", "nodes", "time (s)", "speedup", "overhead", "repro", "objective");
+  for (Instance& inst : instances) {
+    double oppBase = 0.0, detBase = 0.0, reference = NAN;
+    for (size_t k = 0; k < threadCounts.size(); ++k) {
+      Run opp = solveOnce(inst.model, threadCounts[k], false);
+      Run det = solveOnce(inst.model, threadCounts[k], true);
+      Run again = solveOnce(inst.model, threadCounts[k], true);
+      if (k == 0) {
+        oppBase = opp.seconds;
+        detBase = det.seconds;
+        reference = opp.objective;
+      }
+      printf("%-20s %7u | %10llu %11.3f %7.2fx | %10llu %11.3f %7.2fx | %7.2fx %5s | %16.8g\n", inst.name.c_str(),
+             threadCounts[k], static_cast<unsigned long long>(opp.nodes), opp.seconds, oppBase / opp.seconds,
+             static_cast<unsigned long long>(det.nodes), det.seconds, detBase / det.seconds, det.seconds / opp.seconds,
+             identical(det, again) ? "yes" : "NO", det.objective);
+      if (opp.status != MipStatus::OPTIMAL) printf("  opportunistic status: %s\n", mipStatusName(opp.status));
+      if (det.status != MipStatus::OPTIMAL) printf("  deterministic status: %s\n", mipStatusName(det.status));
+      if (!agrees(opp.objective, reference) || !agrees(det.objective, reference)) printf("  objective mismatch\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * LP path benchmark: pure LPs through glp_intopt, as GLPKSolver::solve
+ * with isMIP set used to run them, vs. the LP path it takes now.
+ *
+ * The "intopt" column is the old path: glp_simplex (primal), then
+ * glp_intopt on the model without integer columns, with the results read
+ * from the MIP solution. The other columns load the model into a
+ * GLPKSolver and call solve(useDualSimplex, true), which finds no integer
+ * columns and stops after the LP: primal simplex, dual simplex, and
+ * glp_interior with setLpMethod(LpMethod::INTERIOR). Times are wall
+ * seconds for loading and solving, the best of --repeat runs.
+ *
+ * Without arguments a set of generated models is used: transportation
+ * problems and random sparse packing LPs. Model files in the custom,
+ * CPLEX LP (.lp) or free MPS (.mps) format may be given instead; their
+ * integrality is dropped.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/lp_path_bench.cpp src/solver.cpp src/solve_stats.cpp \
+ *       src/simplex.cpp src/basis_factor.cpp src/compact_model.cpp src/symbol_table.cpp src/parser.cpp \
+ *       src/lexer.cpp src/lp_format.cpp src/mps.cpp src/input_file.cpp src/thread_pool.cpp -lglpk \
+ *       -o lp_path_bench
+ *
+ * Usage:
+ *   lp_path_bench [--repeat 3] [model files...]
+ */
+#include "bench_glpk.h"
+#include "bench_models.h"
+#include "solver.h"
+#include <glpk.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+
+using namespace std;
+
+namespace {
+  // Best wall time of `repeat` runs of `run`, which returns the objective
+  // (NaN if it found no solution) in `objective`
+  double bestSeconds(int repeat, double& objective, const function<double()>& run) {
+    double best = INFINITY;
+    for (int r = 0; r < repeat; ++r) {
+      auto start = chrono::steady_clock::now();
+      objective = run();
+      best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+  }
+
+  // The old path: simplex, then glp_intopt on a model with nothing to branch on
+  double solveThroughIntopt(const CompactModel& m) {
+    glp_prob* lp = toGlpk(m);
+    glp_smcp parm;
+    glp_init_smcp(&parm);
+    parm.msg_lev = GLP_MSG_OFF;
+    double objective = NAN;
+    if (glp_simplex(lp, &parm) == 0 && glp_get_status(lp) == GLP_OPT) {
+      glp_iocp iocp;
+      glp_init_iocp(&iocp);
+      iocp.msg_lev = GLP_MSG_OFF;
+      if (glp_intopt(lp, &iocp) == 0 && glp_mip_status(lp) == GLP_OPT) {
+        objective = glp_mip_obj_val(lp);
+        vector<double> values(m.numCols); // Reading the solution is part of each path
+        for (uint32_t j = 0; j < m.numCols; ++j) values[j] = glp_mip_col_val(lp, j + 1);
+      }
+    }
+    glp_delete_prob(lp);
+    return objective;
+  }
+
+  double solveLpPath(const CompactModel& m, bool dual, bool interior) {
+    GLPKSolver solver;
+    solver.loadModel(m);
+    solver.setLpMethod(interior ? LpMethod::INTERIOR : LpMethod::SIMPLEX);
+    solver.solve(dual, /* isMIP */ true);
+    if (!solver.hasSolution()) return NAN;
+    vector<double> values = solver.getVariableValues();
+    return solver.getObjectiveValue();
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  int repeat = 3;
+  vector<Instance> instances;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = max(1, atoi(argv[++i]));
+    else instances.push_back({argv[i], readLpModel(argv[i])});
+  }
+  if (instances.empty()) {
+    instances.push_back({"transport-60x120", transportation(60, 120, 1)});
+    instances.push_back({"transport-150x300", transportation(150, 300, 2)});
+    instances.push_back({"packing-1000x2000", packing(1000, 2000, 10, 3)});
+    instances.push_back({"packing-2000x4000", packing(2000, 4000, 10, 4)});
+  }
+  glp_term_out(GLP_OFF);
+
+  printf("%-20s %8s %8s %9s | %9s | %9s %9s %9s | %16s\n", "model", "rows", "cols", "nonzeros",
+         "intopt s", "primal s", "dual s", "ipm s", "objective");
+  for (const Instance& inst : instances) {
+    const CompactModel& m = inst.model;
+    double intoptObj, primalObj, dualObj, interiorObj;
+    double tIntopt = bestSeconds(repeat, intoptObj, [&] { return solveThroughIntopt(m); });
+    double tPrimal = bestSeconds(repeat, primalObj, [&] { return solveLpPath(m, false, false); });
+    double tDual = bestSeconds(repeat, dualObj, [&] { return solveLpPath(m, true, false); });
+    double tInterior = bestSeconds(repeat, interiorObj, [&] { return solveLpPath(m, false, true); });
+
+    printf("%-20s %8u %8u %9zu | %9.4f | %9.4f %9.4f %9.4f | %16.8g\n", inst.name.c_str(), m.numRows,
+           m.numCols, m.rows.numNonzeros(), tIntopt, tPrimal, tDual, tInterior, primalObj);
+    double tolerance = 1e-6 * (1.0 + fabs(primalObj));
+    if (!(fabs(intoptObj - primalObj) <= tolerance && fabs(dualObj - primalObj) <= tolerance)) {
+      printf("  objective mismatch: intopt %.10g, dual %.10g\n", intoptObj, dualObj);
+    }
+    // The interior point stops at a small relative gap, not at a vertex
+    if (!(fabs(interiorObj - primalObj) <= 1e-4 * (1.0 + fabs(primalObj)))) {
+      printf("  interior point: %.10g\n", interiorObj);
+    }
+  }
+  return 0;
+}
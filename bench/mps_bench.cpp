@@ -0,0 +1,105 @@
+/*
+ * MPS benchmark: MpsReader vs. glp_read_mps on the same files.
+ *
+ * Generates a random sparse MILP with MpsWriter (free and fixed format),
+ * then times MpsReader::readFile against GLPK's glp_read_mps on each file.
+ * The writer is timed as well.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/mps_bench.cpp src/mps.cpp src/compact_model.cpp \
+ *       src/symbol_table.cpp src/input_file.cpp -lglpk -o mps_bench
+ *
+ * Usage:
+ *   mps_bench [rows] [cols] [nonzerosPerRow]   (default 1000000 500000 10)
+ */
+#include "mps.h"
+#include <glpk.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+  /*
+   * Function: randomModel
+   * -------------------------
+   * Builds a random model directly in CSR form; one column in ten is integer.
+   */
+  CompactModel randomModel(uint32_t rows, uint32_t cols, uint32_t perRow) {
+    mt19937 rng(7);
+    uniform_int_distribution<uint32_t> col(0, cols - 1);
+    uniform_int_distribution<int> coef(-50, 50);
+
+    CompactModel m;
+    m.numRows = rows;
+    m.numCols = cols;
+    for (uint32_t j = 0; j < cols; ++j) m.variables.intern("x" + to_string(j));
+    m.colLower.assign(cols, 0.0);
+    m.colUpper.assign(cols, 100.0);
+    m.colKind.assign(cols, VarType::CONTINUOUS);
+    for (uint32_t j = 0; j < cols; j += 10) m.colKind[j] = VarType::INTEGER;
+    m.objective.resize(cols);
+    for (double& c : m.objective) c = coef(rng);
+
+    vector<uint32_t> mark(cols, UINT32_MAX);
+    for (uint32_t i = 0; i < rows; ++i) {
+      for (uint32_t k = 0; k < perRow; ++k) {
+        uint32_t j = col(rng);
+        if (mark[j] == i) continue;
+        mark[j] = i;
+        m.rows.index.push_back(j);
+        m.rows.value.push_back(coef(rng) + 0.25);
+      }
+      m.rows.start.push_back(m.rows.index.size());
+      m.rowLower.push_back(-INFINITY);
+      m.rowUpper.push_back(1000.0);
+    }
+    return m;
+  }
+
+  template <typename F>
+  double timeSeconds(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t rows = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  uint32_t cols = argc > 2 ? strtoul(argv[2], nullptr, 10) : 500000;
+  uint32_t perRow = argc > 3 ? strtoul(argv[3], nullptr, 10) : 10;
+
+  CompactModel model = randomModel(rows, cols, perRow);
+  printf("Model: %u rows, %u cols, %zu nonzeros\n\n", rows, cols, model.rows.numNonzeros());
+  glp_term_out(GLP_OFF);
+
+  printf("%8s %12s %14s %14s %10s\n", "format", "write (s)", "MpsReader (s)", "glp_read (s)", "speedup");
+  for (MpsFormat format : { MpsFormat::FREE, MpsFormat::FIXED }) {
+    bool free = format == MpsFormat::FREE;
+    string path = (filesystem::temp_directory_path() / (free ? "milp_bench_free.mps" : "milp_bench_fixed.mps")).string();
+
+    double tWrite = timeSeconds([&] { MpsWriter::writeFile(model, path, format); });
+
+    size_t nnz = 0;
+    double tOurs = timeSeconds([&] { nnz = MpsReader::readFile(path, format).rows.numNonzeros(); });
+
+    glp_prob* lp = glp_create_prob();
+    int status = 0;
+    double tGlpk = timeSeconds([&] { status = glp_read_mps(lp, free ? GLP_MPS_FILE : GLP_MPS_DECK, nullptr, path.c_str()); });
+    size_t glpkNnz = glp_get_num_nz(lp);
+    glp_delete_prob(lp);
+
+    if (status != 0 || nnz != glpkNnz) {
+      fprintf(stderr, "Mismatch: glp_read_mps status %d, nonzeros %zu vs %zu\n", status, nnz, glpkNnz);
+      return 1;
+    }
+    printf("%8s %12.3f %14.3f %14.3f %9.1fx\n", free ? "free" : "fixed", tWrite, tOurs, tGlpk, tGlpk / tOurs);
+    filesystem::remove(path);
+  }
+  return 0;
+}
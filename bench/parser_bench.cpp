@@ -0,0 +1,165 @@
+/*
+ * Parser benchmark: hand-written lexer vs. the previous std::regex parser.
+ *
+ * Generates synthetic LP files with 10k / 100k / 1M constraints and times
+ * Parser::parseFile against a self-contained copy of the regex-based
+ * implementation it replaced, then reports how the lexer path scales with
+ * the number of parse threads on the largest file.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/parser_bench.cpp src/parser.cpp src/lexer.cpp \
+ *       src/input_file.cpp src/symbol_table.cpp src/thread_pool.cpp -o parser_bench
+ *
+ * Usage:
+ *   parser_bench [maxConstraints]   (default 1000000)
+ */
+#include "parser.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace legacy {
+  // Copy of the regex-based parser, kept here only as a baseline. It uses
+  // its own structs so it keeps compiling as LPModel evolves.
+  struct Term { double coefficient; string variable; };
+  struct Constraint { vector<Term> terms; double rhs; string op; };
+
+  string trim(const string& s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return (start == string::npos) ? "" : s.substr(start, end - start + 1);
+  }
+
+  Term parseTerm(const string& token) {
+    smatch match;
+    regex termPattern(R"(([+-]?\d*\.?\d*)([a-zA-Z_][a-zA-Z0-9_]*))");
+    if (!regex_match(token, match, termPattern)) throw runtime_error("Invalid term format: '" + token + "'");
+    double coeff = 1.0;
+    string coeffStr = match[1];
+    if (!coeffStr.empty() && coeffStr != "+" && coeffStr != "-") coeff = stod(coeffStr);
+    else if (coeffStr == "-") coeff = -1;
+    return Term{ coeff, match[2] };
+  }
+
+  vector<Term> parseExpression(const string& exprStr) {
+    vector<Term> terms;
+    regex tokenPattern(R"(([+-]?\s*\d*\.?\d*[a-zA-Z_][a-zA-Z0-9_]*))");
+    for (auto i = sregex_iterator(exprStr.begin(), exprStr.end(), tokenPattern); i != sregex_iterator(); ++i) {
+      terms.push_back(parseTerm(regex_replace(i->str(), regex(R"(\s+)"), "")));
+    }
+    return terms;
+  }
+
+  Constraint parseConstraint(const string& lineStr) {
+    smatch match;
+    regex constraintPattern(R"((.+)(<=|>=|=)(.+))");
+    if (!regex_match(lineStr, match, constraintPattern)) throw runtime_error("Invalid constraint format.");
+    return Constraint{ parseExpression(match[1]), stod(match[3]), match[2] };
+  }
+
+  // Same control flow as the old Parser::parseFile, with the Max/Min vs.
+  // objective flag mix-up fixed so it can read the benchmark files.
+  size_t parseFile(const string& path) {
+    ifstream file(path);
+    string line;
+    vector<Term> objective;
+    vector<Constraint> constraints;
+    bool typeParsed = false, objectiveParsed = false, inConstraints = false;
+    while (getline(file, line)) {
+      line = trim(line);
+      if (line.empty() || line.rfind("//", 0) == 0) continue;
+      if (line == "Max" || line == "Min") { typeParsed = true; continue; }
+      if (typeParsed && !objectiveParsed) { objective = parseExpression(line); objectiveParsed = inConstraints = true; continue; }
+      if (line == "Bounds:" || line == "Integer:" || line == "Binary:") { inConstraints = false; continue; }
+      if (inConstraints) constraints.push_back(parseConstraint(line));
+    }
+    return constraints.size();
+  }
+} // namespace legacy
+
+namespace {
+  /*
+   * Function: writeSyntheticModel
+   * -------------------------
+   * Writes a random sparse model with `numCons` constraints of 4-12 terms.
+   */
+  void writeSyntheticModel(const string& path, size_t numCons) {
+    mt19937 rng(12345);
+    size_t numVars = max<size_t>(100, numCons / 2);
+    uniform_int_distribution<size_t> var(0, numVars - 1);
+    uniform_int_distribution<int> len(4, 12), coef(1, 99);
+    uniform_int_distribution<int> op(0, 2);
+
+    ofstream out(path);
+    out << "Max\n";
+    for (size_t j = 0; j < 20; ++j) out << (j ? " + " : "") << coef(rng) << "x" << var(rng);
+    out << "\n\n";
+    for (size_t i = 0; i < numCons; ++i) {
+      int n = len(rng);
+      for (int k = 0; k < n; ++k) {
+        int c = coef(rng);
+        out << (k == 0 ? "" : (c % 3 == 0 ? " - " : " + ")) << c << "." << c % 10 << "x" << var(rng);
+      }
+      static const char* ops[] = { " <= ", " >= ", " = " };
+      out << ops[op(rng)] << coef(rng) * 10 << "\n";
+    }
+    out << "\nBounds:\n";
+    for (size_t j = 0; j < numVars; ++j) out << "x" << j << " >= 0\n";
+    out << "\nInteger:\n";
+    for (size_t j = 0; j < numVars; j += 7) out << (j ? ", " : "") << "x" << j;
+    out << "\n";
+  }
+
+  template <typename F>
+  double timeSeconds(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  size_t maxCons = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+  filesystem::path dir = filesystem::temp_directory_path();
+
+  string largest;
+  printf("%12s %14s %14s %10s\n", "constraints", "regex (s)", "lexer (s)", "speedup");
+  for (size_t numCons : { 10000ul, 100000ul, 1000000ul }) {
+    if (numCons > maxCons) break;
+    string path = (dir / ("milp_parser_bench_" + to_string(numCons) + ".txt")).string();
+    writeSyntheticModel(path, numCons);
+
+    size_t legacyRows = 0, rows = 0;
+    double tRegex = timeSeconds([&] { legacyRows = legacy::parseFile(path); });
+    double tLexer = timeSeconds([&] { rows = Parser::parseFile(path, 1).constraints.size(); });
+    if (rows != legacyRows) {
+      cerr << "Row count mismatch: regex " << legacyRows << " vs lexer " << rows << "\n";
+      return 1;
+    }
+    printf("%12zu %14.3f %14.3f %9.1fx\n", numCons, tRegex, tLexer, tRegex / tLexer);
+    if (!largest.empty()) filesystem::remove(largest);
+    largest = path;
+  }
+  if (largest.empty()) return 0;
+
+  printf("\n%12s %14s %10s\n", "threads", "lexer (s)", "speedup");
+  double base = 0.0;
+  unsigned hw = max(1u, thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= hw; threads *= 2) {
+    double t = timeSeconds([&] { Parser::parseFile(largest, threads); });
+    if (threads == 1) base = t;
+    printf("%12u %14.3f %9.1fx\n", threads, t, base / t);
+  }
+  filesystem::remove(largest);
+  return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * PDLP benchmark: the sparse matrix-vector kernels per instruction set
+ * and thread count, then PdlpSolver against the native barrier on LPs.
+ *
+ * The kernel table multiplies random CSR matrices (short rows of 1-7
+ * entries and long rows of 32-96) by a vector. Per SIMD level the CPU
+ * supports and per thread count it shows the best of 10 products, the
+ * throughput in nonzeros per nanosecond, and the speedup over the scalar
+ * kernel on one thread. Results that differ from the scalar product by
+ * more than 1e-12 relative are reported.
+ *
+ * The solver table runs PdlpSolver (tolerance 1e-6, best SIMD level) per
+ * thread count and shows its time, speedup over the first thread count,
+ * accepted steps and matrix-vector products, next to the barrier's time
+ * and objective. PDLP objectives that differ from the barrier's by more
+ * than 1e-5 relative are reported below the model's rows.
+ *
+ * A last table solves small LPs whose status is known, with a 10 second
+ * limit: a random LP with an empty row that excludes 0 (INFEASIBLE), and
+ * LPs with an empty column whose cost improves without bound, once with
+ * a feasible rest (UNBOUNDED) and once with an infeasible one
+ * (INFEASIBLE). Then LPs that are both primal and dual infeasible, whose
+ * improving rays must not be taken for unboundedness (INFEASIBLE): one
+ * built for it, and the 14 of the first 1000 randomSmallLp() LPs of seed
+ * 7 on which that happened. Other statuses are reported.
+ *
+ * Without model arguments generated LPs are used: transportation
+ * problems and random sparse packing LPs. Model files in the custom,
+ * CPLEX LP (.lp) or free MPS (.mps) format may be given instead; their
+ * integrality is dropped.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread -Isrc bench/pdlp_bench.cpp src/pdlp.cpp src/sparse_multiply.cpp \
+ *       src/interior_point.cpp src/sparse_cholesky.cpp src/compact_model.cpp src/symbol_table.cpp src/parser.cpp \
+ *       src/lexer.cpp src/lp_format.cpp src/mps.cpp src/input_file.cpp src/thread_pool.cpp -o pdlp_bench
+ *
+ * Usage:
+ *   pdlp_bench [--threads 1,2,4,8] [model files...]
+ */
+#include "bench_models.h"
+#include "pdlp.h"
+#include "interior_point.h"
+#include "sparse_multiply.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+
+using namespace std;
+
+namespace {
+  // Random CSR matrix with row lengths uniform in [minLength, maxLength]
+  SparseMatrix randomMatrix(uint32_t rows, uint32_t cols, uint32_t minLength, uint32_t maxLength, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<uint32_t> lengthDist(minLength, maxLength), colDist(0, cols - 1);
+    uniform_real_distribution<double> valueDist(-1.0, 1.0);
+    SparseMatrix a;
+    for (uint32_t i = 0; i < rows; ++i) {
+      for (uint32_t k = lengthDist(rng); k > 0; --k) {
+        a.index.push_back(colDist(rng));
+        a.value.push_back(valueDist(rng));
+      }
+      a.start.push_back(a.index.size());
+    }
+    return a;
+  }
+
+  // Random LP with `rows` rows and `cols` columns whose row 2 is empty with bounds [3, inf]
+  CompactModel emptyRowLp(uint32_t rows, uint32_t cols, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> valueDist(-9, 9), costDist(-9, 9), rhsDist(0, 20);
+    CompactModel m;
+    for (uint32_t j = 0; j < cols; ++j) addColumn(m, 0.0, 10.0, costDist(rng));
+    for (uint32_t i = 0; i < rows; ++i) {
+      vector<pair<uint32_t, double>> terms;
+      for (uint32_t j = 0; j < cols && i != 2; ++j) {
+        int value = valueDist(rng);
+        if (value != 0 && rng() % 3 == 0) terms.push_back({ j, double(value) });
+      }
+      if (i == 2) addRow(m, terms, 3.0, INFINITY);
+      else addRow(m, terms, -INFINITY, rhsDist(rng));
+    }
+    return m;
+  }
+
+  // min x0 - x2 over x0 + x1 >= 1, x0 - x1 <= `gap`, x2 >= 0 in no row: infeasible rest for gap < -1
+  CompactModel emptyColumnLp(double gap) {
+    CompactModel m;
+    addColumn(m, 0.0, INFINITY, 1.0);
+    addColumn(m, 0.0, 1.0, 0.0);
+    addColumn(m, 0.0, INFINITY, -1.0);
+    addRow(m, { { 0, 1.0 }, { 1, 1.0 } }, 1.0, INFINITY);
+    addRow(m, { { 0, 1.0 }, { 1, -1.0 } }, -INFINITY, gap);
+    return m;
+  }
+
+  // min -x0 over x0 - x1 <= 0 (an improving ray) and 2 <= x2 + x3 <= 1 as two rows, all columns >= 0
+  CompactModel primalDualInfeasibleLp() {
+    CompactModel m;
+    addColumn(m, 0.0, INFINITY, -1.0);
+    for (int k = 0; k < 3; ++k) addColumn(m, 0.0, INFINITY, 0.0);
+    addRow(m, { { 0, 1.0 }, { 1, -1.0 } }, -INFINITY, 0.0);
+    addRow(m, { { 2, 1.0 }, { 3, 1.0 } }, 2.0, INFINITY);
+    addRow(m, { { 2, 1.0 }, { 3, 1.0 } }, -INFINITY, 1.0);
+    return m;
+  }
+
+  /*
+   * Function: benchKernels
+   * -------------------------
+   * Prints the kernel table for `a` (rows split by balancedLineRanges()).
+   */
+  void benchKernels(const string& name, const SparseMatrix& a, uint32_t cols, const vector<unsigned>& threadCounts) {
+    uint32_t rows = a.numMajor();
+    vector<double> x(cols), reference(rows), y(rows);
+    mt19937 rng(7);
+    uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (double& v : x) v = unit(rng);
+    sparseMultiply(a, x.data(), reference.data(), 0, rows, SimdLevel::SCALAR);
+
+    double scalarSeconds = 0.0;
+    for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+      if (level > detectSimdLevel()) break;
+      for (unsigned threads : threadCounts) {
+        ThreadPool pool(threads);
+        vector<uint32_t> ranges = balancedLineRanges(a, threads);
+        double best = INFINITY;
+        for (int rep = 0; rep < 10; ++rep) {
+          auto start = chrono::steady_clock::now();
+          if (threads == 1) sparseMultiply(a, x.data(), y.data(), 0, rows, level);
+          else {
+            pool.parallelFor(threads, [&](size_t t) {
+              sparseMultiply(a, x.data(), y.data(), ranges[t], ranges[t + 1], level);
+            });
+          }
+          best = min(best, secondsSince(start));
+        }
+        if (level == SimdLevel::SCALAR && threads == threadCounts[0]) scalarSeconds = best;
+
+        double error = 0.0;
+        for (uint32_t i = 0; i < rows; ++i) {
+          error = max(error, fabs(y[i] - reference[i]) / (1.0 + fabs(reference[i])));
+        }
+        printf("%-20s %7s %7u | %10.3f %9.3f %7.2f%s\n", name.c_str(), simdLevelName(level), threads, best * 1e3,
+               double(a.numNonzeros()) / (best * 1e9), scalarSeconds / best,
+               error > 1e-12 ? "  (differs from scalar)" : "");
+      }
+    }
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  vector<Instance> instances;
+  vector<unsigned> threadCounts;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCounts = parseThreadList(argv[++i]);
+    else instances.push_back({ argv[i], readLpModel(argv[i]) });
+  }
+  if (instances.empty()) {
+    instances.push_back({ "transport-60x120", transportation(60, 120, 1) });
+    instances.push_back({ "transport-150x300", transportation(150, 300, 2) });
+    instances.push_back({ "packing-1000x2000", packing(1000, 2000, 10, 3) });
+    instances.push_back({ "packing-4000x8000", packing(4000, 8000, 10, 4) });
+  }
+  if (threadCounts.empty()) {
+    unsigned hw = ThreadPool::resolveThreads(0);
+    for (unsigned t = 1; t < hw; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hw);
+  }
+
+  printf("%-20s %7s %7s | %10s %9s %7s\n", "matrix", "simd", "threads", "product ms", "nnz/ns", "speedup");
+  benchKernels("short-rows-2M", randomMatrix(2000000, 2000000, 1, 7, 11), 2000000, threadCounts);
+  benchKernels("long-rows-100k", randomMatrix(100000, 2000000, 32, 96, 12), 2000000, threadCounts);
+
+  printf("\n%-20s %7s | %10s %7s %7s %8s | %10s | %16s\n", "model", "threads", "pdlp s", "speedup", "iters",
+         "products", "barrier s", "objective");
+  for (const Instance& inst : instances) {
+    const CompactModel& m = inst.model;
+
+    auto start = chrono::steady_clock::now();
+    InteriorPointSolver barrier;
+    barrier.loadModel(m);
+    bool barrierOptimal = barrier.solve() == IpmStatus::OPTIMAL;
+    double barrierObjective = barrierOptimal ? barrier.getObjectiveValue() : NAN;
+    double barrierSeconds = secondsSince(start);
+
+    double firstSeconds = 0.0;
+    vector<string> mismatches;
+    for (size_t k = 0; k < threadCounts.size(); ++k) {
+      start = chrono::steady_clock::now();
+      PdlpSolver pdlp;
+      pdlp.setThreads(threadCounts[k]);
+      pdlp.loadModel(m);
+      PdlpStatus status = pdlp.solve();
+      double seconds = secondsSince(start);
+      if (k == 0) firstSeconds = seconds;
+
+      double objective = pdlp.getObjectiveValue();
+      if (status != PdlpStatus::OPTIMAL) {
+        mismatches.push_back(to_string(threadCounts[k]) + " threads: " + pdlpStatusName(status));
+      }
+      else if (!(fabs(objective - barrierObjective) <= 1e-5 * (1.0 + fabs(barrierObjective)))) {
+        char line[96];
+        snprintf(line, sizeof line, "%u threads: objective %.10g", threadCounts[k], objective);
+        mismatches.push_back(line);
+      }
+
+      if (k == 0) {
+        printf("%-20s %7u | %10.4f %7.2f %7llu %8llu | %10.4f | %16.8g\n", inst.name.c_str(), threadCounts[k],
+               seconds, 1.0, static_cast<unsigned long long>(pdlp.iterations()),
+               static_cast<unsigned long long>(pdlp.products()), barrierSeconds, barrierObjective);
+      }
+      else {
+        printf("%-20s %7u | %10.4f %7.2f %7llu %8llu |\n", "", threadCounts[k], seconds, firstSeconds / seconds,
+               static_cast<unsigned long long>(pdlp.iterations()), static_cast<unsigned long long>(pdlp.products()));
+      }
+    }
+    for (const string& line : mismatches) printf("  %s\n", line.c_str());
+  }
+
+  struct Expected {
+    string name;
+    CompactModel model;
+    PdlpStatus status;
+  };
+  vector<Expected> edgeCases;
+  edgeCases.push_back({ "empty-row-9x10", emptyRowLp(9, 10, 5), PdlpStatus::INFEASIBLE });
+  edgeCases.push_back({ "empty-column", emptyColumnLp(0.0), PdlpStatus::UNBOUNDED });
+  edgeCases.push_back({ "empty-column-infeas", emptyColumnLp(-2.0), PdlpStatus::INFEASIBLE });
+  edgeCases.push_back({ "primal-dual-infeas", primalDualInfeasibleLp(), PdlpStatus::INFEASIBLE });
+  const int bothInfeasible[] = { 60, 93, 109, 188, 361, 394, 395, 476, 581, 692, 719, 911, 928, 975 };
+  mt19937 rng(7);
+  for (int k = 0, next = 0; next < int(size(bothInfeasible)); ++k) {
+    CompactModel m = randomSmallLp(rng);
+    if (k != bothInfeasible[next]) continue;
+    edgeCases.push_back({ "random-7-" + to_string(k), m, PdlpStatus::INFEASIBLE });
+    ++next;
+  }
+  printf("\n%-20s | %10s %7s | %16s\n", "edge case", "pdlp s", "iters", "status");
+  for (const Expected& e : edgeCases) {
+    auto start = chrono::steady_clock::now();
+    PdlpSolver pdlp;
+    pdlp.setTimeLimit(10.0);
+    pdlp.loadModel(e.model);
+    PdlpStatus status = pdlp.solve();
+    printf("%-20s | %10.4f %7llu | %16s%s\n", e.name.c_str(), secondsSince(start),
+           static_cast<unsigned long long>(pdlp.iterations()), pdlpStatusName(status),
+           status == e.status ? "" : (string("  (expected ") + pdlpStatusName(e.status) + ")").c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Load generator for the solver daemon (MILP_Solver --serve): sends the
+ * same model over several connections and reports answer latency.
+ *
+ * Each connection keeps up to --in-flight requests outstanding and sends
+ * --requests in total. Latency is measured per request, from sending its
+ * header to reading its answer line, so it includes queueing in the
+ * daemon. The report gives the answers by status, throughput and the
+ * p50/p90/p99/max latency over all connections.
+ *
+ * Build (from the repository root):
+ *   g++ -O2 -std=c++17 -pthread bench/serve_load.cpp -o serve_load
+ *
+ * Usage:
+ *   serve_load <socket> <model file> [--connections 4] [--requests 100]
+ *              [--in-flight 1] [--format txt|lp|mps] [--time-limit <s>]
+ */
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+  using Clock = chrono::steady_clock;
+
+  struct ConnectionResult {
+    vector<double> latencies; // Seconds, one per answered request
+    map<string, size_t> statuses;
+    string error;
+  };
+
+  int connectTo(const string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      sent += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  // Value of the string member `key` in a flat JSON line, or "" if absent
+  string jsonMember(const string& line, const string& key) {
+    string pattern = "\"" + key + "\":\"";
+    size_t p = line.find(pattern);
+    if (p == string::npos) return "";
+    p += pattern.size();
+    return line.substr(p, line.find('"', p) - p);
+  }
+
+  /*
+   * One connection: a sender thread keeps `inFlight` requests outstanding,
+   * and this thread reads the answers and matches them to their ids.
+   */
+  ConnectionResult runConnection(const string& socketPath, const string& model, const string& format,
+                                 const string& timeLimit, size_t requests, size_t inFlight, size_t index) {
+    ConnectionResult result;
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+      result.error = "cannot connect: " + string(strerror(errno));
+      return result;
+    }
+
+    mutex m;
+    condition_variable slotFree;
+    size_t outstanding = 0;
+    bool failed = false;
+    map<string, Clock::time_point> sentAt;
+
+    thread sender([&] {
+      for (size_t r = 0; r < requests; ++r) {
+        string id = to_string(index) + "-" + to_string(r);
+        {
+          unique_lock<mutex> lock(m);
+          slotFree.wait(lock, [&] { return outstanding < inFlight || failed; });
+          if (failed) break;
+          ++outstanding;
+          sentAt[id] = Clock::now();
+        }
+        string header = "SOLVE " + id + " " + format + " " + to_string(model.size());
+        if (!timeLimit.empty()) header += " " + timeLimit;
+        if (!sendAll(fd, header + "\n" + model)) {
+          lock_guard<mutex> lock(m);
+          failed = true;
+          break;
+        }
+      }
+      shutdown(fd, SHUT_WR);
+    });
+
+    string buffer;
+    char chunk[65536];
+    size_t answered = 0;
+    while (answered < requests) {
+      size_t eol;
+      while ((eol = buffer.find('\n')) == string::npos) {
+        ssize_t n = read(fd, chunk, sizeof chunk);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(n));
+      }
+      if (eol == string::npos) {
+        result.error = "connection closed after " + to_string(answered) + " answers";
+        break;
+      }
+      string line = buffer.substr(0, eol);
+      buffer.erase(0, eol + 1);
+      Clock::time_point now = Clock::now();
+
+      string id = jsonMember(line, "id");
+      string status = jsonMember(line, "status");
+      ++result.statuses[status.empty() ? "?" : status];
+      lock_guard<mutex> lock(m);
+      auto it = sentAt.find(id);
+      if (it != sentAt.end()) {
+        result.latencies.push_back(chrono::duration<double>(now - it->second).count());
+        sentAt.erase(it);
+      }
+      --outstanding;
+      ++answered;
+      slotFree.notify_one();
+    }
+    {
+      lock_guard<mutex> lock(m);
+      failed = true;
+    }
+    slotFree.notify_one();
+    sender.join();
+    close(fd);
+    return result;
+  }
+
+  double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t k = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(k, sorted.size() - 1)];
+  }
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage: serve_load <socket> <model file> [--connections n] [--requests n] "
+                    "[--in-flight n] [--format txt|lp|mps] [--time-limit s]\n");
+    return 1;
+  }
+  string socketPath = argv[1];
+  string modelPath = argv[2];
+  size_t connections = 4, requests = 100, inFlight = 1;
+  string format, timeLimit;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--connections") == 0) connections = strtoul(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--requests") == 0) requests = strtoul(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--in-flight") == 0) inFlight = max<size_t>(1, strtoul(argv[i + 1], nullptr, 10));
+    else if (strcmp(argv[i], "--format") == 0) format = argv[i + 1];
+    else if (strcmp(argv[i], "--time-limit") == 0) timeLimit = argv[i + 1];
+    else {
+      fprintf(stderr, "Unknown option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (format.empty()) {
+    size_t dot = modelPath.rfind('.');
+    string ext = dot == string::npos ? "" : modelPath.substr(dot + 1);
+    format = ext == "lp" || ext == "mps" ? ext : "txt";
+  }
+
+  ifstream in(modelPath, ios::binary);
+  if (!in) {
+    fprintf(stderr, "Cannot read %s\n", modelPath.c_str());
+    return 1;
+  }
+  stringstream text;
+  text << in.rdbuf();
+  string model = text.str();
+
+  vector<ConnectionResult> results(connections);
+  vector<thread> threads;
+  Clock::time_point start = Clock::now();
+  for (size_t c = 0; c < connections; ++c) {
+    threads.emplace_back([&, c] {
+      results[c] = runConnection(socketPath, model, format, timeLimit, requests, inFlight, c);
+    });
+  }
+  for (thread& t : threads) t.join();
+  double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+  vector<double> latencies;
+  map<string, size_t> statuses;
+  for (size_t c = 0; c < connections; ++c) {
+    if (!results[c].error.empty()) fprintf(stderr, "connection %zu: %s\n", c, results[c].error.c_str());
+    latencies.insert(latencies.end(), results[c].latencies.begin(), results[c].latencies.end());
+    for (const auto& entry : results[c].statuses) statuses[entry.first] += entry.second;
+  }
+  sort(latencies.begin(), latencies.end());
+
+  printf("%zu connections x %zu requests, %zu in flight each, %.3f s\n", connections, requests, inFlight, seconds);
+  for (const auto& entry : statuses) printf("  %-12s %zu\n", entry.first.c_str(), entry.second);
+  printf("throughput   %.1f requests/s\n", latencies.size() / seconds);
+  printf("latency ms   p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n", percentile(latencies, 50) * 1e3,
+         percentile(latencies, 90) * 1e3, percentile(latencies, 99) * 1e3,
+         latencies.empty() ? 0.0 : latencies.back() * 1e3);
+  return latencies.size() == connections * requests ? 0 : 1;
+}
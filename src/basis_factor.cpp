@@ -0,0 +1,590 @@
+#include "basis_factor.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+  // A pivot candidate must be at least this fraction of the column's largest entry.
+  constexpr double PIVOT_THRESHOLD = 0.1;
+  // Columns whose largest remaining entry is below this (relative) size are singular.
+  constexpr double SINGULAR_TOLERANCE = 1e-9;
+  // Eta entries below this magnitude are dropped.
+  constexpr double DROP_TOLERANCE = 1e-14;
+  // Refactorize after this many updates.
+  constexpr size_t MAX_UPDATES = 100;
+  // Right-hand sides denser than this fraction of m take the dense path.
+  constexpr double HYPERSPARSE_DENSITY = 0.1;
+  // Stands in for an entry that cancelled to zero but is still listed.
+  constexpr double CANCELLED = 1e-300;
+} // anonymous namespace
+
+void IndexedVector::resize(uint32_t size) {
+  values.assign(size, 0.0);
+  index.clear();
+}
+
+void IndexedVector::clear() {
+  if (index.size() * 4 > values.size()) {
+    fill(values.begin(), values.end(), 0.0);
+  }
+  else {
+    for (uint32_t i : index) values[i] = 0.0;
+  }
+  index.clear();
+}
+
+void IndexedVector::add(uint32_t i, double v) {
+  if (values[i] == 0.0) index.push_back(i);
+  values[i] += v;
+  if (values[i] == 0.0) values[i] = CANCELLED;
+}
+
+void IndexedVector::rebuildIndex() {
+  index.clear();
+  for (uint32_t i = 0; i < values.size(); ++i) {
+    if (values[i] != 0.0) index.push_back(i);
+  }
+}
+
+void BasisFactor::setMatrix(const SparseMatrix& csc, uint32_t numRows, uint32_t numCols) {
+  columns = &csc;
+  m = numRows;
+  n = numCols;
+}
+
+void BasisFactor::columnOf(uint32_t var, vector<uint32_t>& index, vector<double>& value) const {
+  index.clear();
+  value.clear();
+  if (var < n) {
+    for (size_t p = columns->start[var]; p < columns->start[var + 1]; ++p) {
+      index.push_back(columns->index[p]);
+      value.push_back(columns->value[p]);
+    }
+  }
+  else {
+    index.push_back(var - n);
+    value.push_back(-1.0);
+  }
+}
+
+/*
+ * Function: columnOrder
+ * -------------------------
+ * Orders the basis columns for the left-looking LU. Column singletons of
+ * the active submatrix are peeled off first and row singletons last
+ * (newest first), so the triangular part of the basis, usually most of
+ * it, factors without fill. The remaining nucleus follows in order of
+ * increasing active length. `rowCount` receives each row's active count
+ * once the singletons are gone, used to prefer short pivot rows.
+ */
+vector<uint32_t> BasisFactor::columnOrder(const vector<uint32_t>& basis, vector<uint32_t>& rowCount) const {
+  vector<size_t> colStart(1, 0);
+  vector<uint32_t> colRows;
+  vector<uint32_t> colIndex;
+  vector<double> colValue;
+  rowCount.assign(m, 0);
+  for (uint32_t k = 0; k < m; ++k) {
+    columnOf(basis[k], colIndex, colValue);
+    colRows.insert(colRows.end(), colIndex.begin(), colIndex.end());
+    colStart.push_back(colRows.size());
+    for (uint32_t i : colIndex) rowCount[i]++;
+  }
+
+  // Row-wise copy of the pattern
+  vector<size_t> rowStart(size_t(m) + 1, 0);
+  for (uint32_t i : colRows) rowStart[i + 1]++;
+  for (uint32_t i = 0; i < m; ++i) rowStart[i + 1] += rowStart[i];
+  vector<uint32_t> rowCols(colRows.size());
+  vector<size_t> fillPos(rowStart.begin(), rowStart.end() - 1);
+  for (uint32_t k = 0; k < m; ++k) {
+    for (size_t p = colStart[k]; p < colStart[k + 1]; ++p) rowCols[fillPos[colRows[p]]++] = k;
+  }
+
+  vector<uint32_t> colCount(m);
+  for (uint32_t k = 0; k < m; ++k) colCount[k] = static_cast<uint32_t>(colStart[k + 1] - colStart[k]);
+  vector<char> colActive(m, 1), rowActive(m, 1);
+  vector<uint32_t> front, back, queue;
+
+  // Column singletons: the column's only active row is its pivot row
+  for (uint32_t k = 0; k < m; ++k) {
+    if (colCount[k] == 1) queue.push_back(k);
+  }
+  while (!queue.empty()) {
+    uint32_t k = queue.back();
+    queue.pop_back();
+    if (!colActive[k] || colCount[k] != 1) continue;
+    uint32_t pivot = UINT32_MAX;
+    for (size_t p = colStart[k]; p < colStart[k + 1]; ++p) {
+      if (rowActive[colRows[p]]) pivot = colRows[p];
+    }
+    colActive[k] = 0;
+    front.push_back(k);
+    for (size_t p = colStart[k]; p < colStart[k + 1]; ++p) rowCount[colRows[p]]--;
+    rowActive[pivot] = 0;
+    for (size_t p = rowStart[pivot]; p < rowStart[pivot + 1]; ++p) {
+      uint32_t other = rowCols[p];
+      if (colActive[other] && --colCount[other] == 1) queue.push_back(other);
+    }
+  }
+
+  // Row singletons: the row's only active column pivots on it
+  for (uint32_t i = 0; i < m; ++i) {
+    if (rowActive[i] && rowCount[i] == 1) queue.push_back(i);
+  }
+  while (!queue.empty()) {
+    uint32_t i = queue.back();
+    queue.pop_back();
+    if (!rowActive[i] || rowCount[i] != 1) continue;
+    uint32_t k = UINT32_MAX;
+    for (size_t p = rowStart[i]; p < rowStart[i + 1]; ++p) {
+      if (colActive[rowCols[p]]) k = rowCols[p];
+    }
+    rowActive[i] = 0;
+    colActive[k] = 0;
+    back.push_back(k);
+    for (size_t p = colStart[k]; p < colStart[k + 1]; ++p) {
+      uint32_t row = colRows[p];
+      if (rowActive[row] && --rowCount[row] == 1) queue.push_back(row);
+    }
+  }
+
+  vector<uint32_t> nucleus;
+  for (uint32_t k = 0; k < m; ++k) {
+    if (colActive[k]) nucleus.push_back(k);
+  }
+  stable_sort(nucleus.begin(), nucleus.end(), [&](uint32_t a, uint32_t b) {
+    return colCount[a] < colCount[b];
+  });
+
+  vector<uint32_t> order(front);
+  order.insert(order.end(), nucleus.begin(), nucleus.end());
+  order.insert(order.end(), back.rbegin(), back.rend());
+  return order;
+}
+
+/*
+ * Function: factorize
+ * -------------------------
+ * Left-looking LU in the order chosen by columnOrder. For each column, a
+ * depth-first search through the L computed so far yields the rows the
+ * column's solve can touch, in topological order; the solve then only
+ * visits those rows. Among the unpivoted rows, any entry within
+ * PIVOT_THRESHOLD of the largest may be the pivot, and the one in the
+ * shortest active row wins, which limits fill.
+ */
+vector<uint32_t> BasisFactor::factorize(vector<uint32_t>& basis) {
+  lStart.assign(1, 0);
+  lIndex.clear();
+  lValue.clear();
+  uStart.assign(1, 0);
+  uIndex.clear();
+  uValue.clear();
+  uDiag.clear();
+  stepRow.clear();
+  stepPosition.clear();
+  rowStep.assign(m, -1);
+  etaPosition.clear();
+  etaPivot.clear();
+  etaStart.assign(1, 0);
+  etaIndex.clear();
+  etaValue.clear();
+  work.assign(m, 0.0);
+
+  vector<uint32_t> colIndex;
+  vector<double> colValue;
+  vector<uint32_t> rowCount;
+  vector<uint32_t> order = columnOrder(basis, rowCount);
+
+  vector<double>& x = work;
+  vector<uint32_t> visited(m, 0);
+  uint32_t stamp = 0;
+  vector<pair<uint32_t, size_t>> stack;
+  vector<uint32_t> postorder;
+  vector<uint32_t> singular;
+
+  for (uint32_t pos : order) {
+    columnOf(basis[pos], colIndex, colValue);
+
+    // Reach of the column through L, in postorder
+    ++stamp;
+    postorder.clear();
+    for (uint32_t root : colIndex) {
+      if (visited[root] == stamp) continue;
+      visited[root] = stamp;
+      stack.emplace_back(root, 0);
+      while (!stack.empty()) {
+        uint32_t node = stack.back().first;
+        size_t next = stack.back().second;
+        bool descended = false;
+        if (rowStep[node] >= 0) {
+          size_t k = static_cast<size_t>(rowStep[node]);
+          for (size_t p = lStart[k] + next; p < lStart[k + 1]; ++p) {
+            uint32_t child = lIndex[p];
+            if (visited[child] == stamp) continue;
+            stack.back().second = p - lStart[k] + 1;
+            visited[child] = stamp;
+            stack.emplace_back(child, 0);
+            descended = true;
+            break;
+          }
+        }
+        if (!descended) {
+          postorder.push_back(node);
+          stack.pop_back();
+        }
+      }
+    }
+
+    // Sparse triangular solve with L, in topological order
+    double columnMax = 0.0;
+    for (size_t p = 0; p < colIndex.size(); ++p) {
+      x[colIndex[p]] = colValue[p];
+      columnMax = max(columnMax, fabs(colValue[p]));
+    }
+    for (size_t t = postorder.size(); t-- > 0;) {
+      uint32_t i = postorder[t];
+      if (rowStep[i] < 0 || x[i] == 0.0) continue;
+      size_t k = static_cast<size_t>(rowStep[i]);
+      double xi = x[i];
+      for (size_t p = lStart[k]; p < lStart[k + 1]; ++p) x[lIndex[p]] -= lValue[p] * xi;
+    }
+
+    // Threshold pivot among the unpivoted rows, preferring short rows
+    double largest = 0.0;
+    for (uint32_t i : postorder) {
+      if (rowStep[i] < 0) largest = max(largest, fabs(x[i]));
+    }
+    if (largest <= SINGULAR_TOLERANCE * columnMax) {
+      singular.push_back(pos);
+      for (uint32_t i : postorder) x[i] = 0.0;
+      continue;
+    }
+    int64_t pivotRow = -1;
+    for (uint32_t i : postorder) {
+      if (rowStep[i] >= 0 || fabs(x[i]) < PIVOT_THRESHOLD * largest) continue;
+      if (pivotRow < 0 || rowCount[i] < rowCount[pivotRow] ||
+          (rowCount[i] == rowCount[pivotRow] && fabs(x[i]) > fabs(x[pivotRow]))) {
+        pivotRow = i;
+      }
+    }
+
+    uint32_t step = static_cast<uint32_t>(stepRow.size());
+    double pivot = x[pivotRow];
+    for (uint32_t i : postorder) {
+      if (x[i] == 0.0 || i == pivotRow) continue;
+      if (rowStep[i] >= 0) {
+        uIndex.push_back(static_cast<uint32_t>(rowStep[i]));
+        uValue.push_back(x[i]);
+      }
+      else {
+        lIndex.push_back(i); // Row for now; mapped to a step once all rows are pivoted
+        lValue.push_back(x[i] / pivot);
+      }
+      x[i] = 0.0;
+    }
+    x[pivotRow] = 0.0;
+    uDiag.push_back(pivot);
+    uStart.push_back(uIndex.size());
+    lStart.push_back(lIndex.size());
+    rowStep[pivotRow] = step;
+    stepRow.push_back(static_cast<uint32_t>(pivotRow));
+    stepPosition.push_back(pos);
+  }
+
+  // Replace dependent columns by the logicals of the rows left over
+  vector<uint32_t> dropped;
+  size_t next = 0;
+  for (uint32_t row = 0; row < m && next < singular.size(); ++row) {
+    if (rowStep[row] >= 0) continue;
+    uint32_t pos = singular[next++];
+    dropped.push_back(basis[pos]);
+    basis[pos] = n + row;
+    rowStep[row] = static_cast<int64_t>(stepRow.size());
+    stepRow.push_back(row);
+    stepPosition.push_back(pos);
+    uDiag.push_back(-1.0);
+    uStart.push_back(uIndex.size());
+    lStart.push_back(lIndex.size());
+  }
+
+  for (uint32_t& i : lIndex) i = static_cast<uint32_t>(rowStep[i]);
+  positionStep.resize(m);
+  for (uint32_t k = 0; k < m; ++k) positionStep[stepPosition[k]] = k;
+  buildRowCopies();
+  mark.assign(m, 0);
+  stamp = 0;
+  return dropped;
+}
+
+/*
+ * Function: buildRowCopies
+ * -------------------------
+ * Transposes L and U so that BTRAN can push along rows.
+ */
+void BasisFactor::buildRowCopies() {
+  auto transpose = [&](const vector<size_t>& start, const vector<uint32_t>& index, const vector<double>& value,
+                       vector<size_t>& rowStart, vector<uint32_t>& rowIndex, vector<double>& rowValue) {
+    rowStart.assign(size_t(m) + 1, 0);
+    for (uint32_t i : index) rowStart[i + 1]++;
+    for (uint32_t k = 0; k < m; ++k) rowStart[k + 1] += rowStart[k];
+    rowIndex.resize(index.size());
+    rowValue.resize(index.size());
+    vector<size_t> next(rowStart.begin(), rowStart.end() - 1);
+    for (uint32_t k = 0; k < m; ++k) {
+      for (size_t p = start[k]; p < start[k + 1]; ++p) {
+        size_t q = next[index[p]]++;
+        rowIndex[q] = k;
+        rowValue[q] = value[p];
+      }
+    }
+  };
+  transpose(lStart, lIndex, lValue, lRowStart, lRowIndex, lRowValue);
+  transpose(uStart, uIndex, uValue, uRowStart, uRowIndex, uRowValue);
+}
+
+/*
+ * Function: reach
+ * -------------------------
+ * Depth-first search from the steps in `from` through the graph whose
+ * node k has children index[start[k] .. start[k + 1]). Writes the nodes
+ * reached to `order` in topological order (every node before its
+ * children), which is the order a push-style triangular solve needs.
+ */
+void BasisFactor::reach(const vector<size_t>& start, const vector<uint32_t>& index,
+                        const vector<uint32_t>& from, vector<uint32_t>& order) const {
+  if (++stamp == 0) {
+    fill(mark.begin(), mark.end(), 0);
+    stamp = 1;
+  }
+  order.clear();
+  for (uint32_t root : from) {
+    if (mark[root] == stamp) continue;
+    mark[root] = stamp;
+    stack.emplace_back(root, start[root]);
+    while (!stack.empty()) {
+      uint32_t node = stack.back().first;
+      size_t& p = stack.back().second;
+      while (p < start[node + 1] && mark[index[p]] == stamp) ++p;
+      if (p < start[node + 1]) {
+        uint32_t child = index[p++];
+        mark[child] = stamp;
+        stack.emplace_back(child, start[child]);
+      }
+      else {
+        order.push_back(node);
+        stack.pop_back();
+      }
+    }
+  }
+  reverse(order.begin(), order.end());
+}
+
+/*
+ * Function: ftran
+ * -------------------------
+ * x := B^-1 x. Permute into step order, forward solve with L, backward
+ * solve with U, permute to basis positions, then apply the etas oldest
+ * first.
+ */
+void BasisFactor::ftran(vector<double>& x) const {
+  for (uint32_t k = 0; k < m; ++k) work[k] = x[stepRow[k]];
+
+  for (uint32_t k = 0; k < m; ++k) {
+    double wk = work[k];
+    if (wk == 0.0) continue;
+    for (size_t p = lStart[k]; p < lStart[k + 1]; ++p) work[lIndex[p]] -= lValue[p] * wk;
+  }
+  for (uint32_t k = m; k-- > 0;) {
+    if (work[k] == 0.0) continue;
+    double vk = work[k] / uDiag[k];
+    work[k] = vk;
+    for (size_t p = uStart[k]; p < uStart[k + 1]; ++p) work[uIndex[p]] -= uValue[p] * vk;
+  }
+
+  for (uint32_t k = 0; k < m; ++k) {
+    x[stepPosition[k]] = work[k];
+    work[k] = 0.0;
+  }
+
+  for (size_t e = 0; e < etaPosition.size(); ++e) {
+    uint32_t r = etaPosition[e];
+    if (x[r] == 0.0) continue;
+    double xr = x[r] / etaPivot[e];
+    x[r] = xr;
+    for (size_t p = etaStart[e]; p < etaStart[e + 1]; ++p) x[etaIndex[p]] -= etaValue[p] * xr;
+  }
+}
+
+/*
+ * Function: btran
+ * -------------------------
+ * y := B^-T y. The transpose of ftran: etas newest first, then U^T
+ * forward and L^T backward in step order.
+ */
+void BasisFactor::btran(vector<double>& y) const {
+  for (size_t e = etaPosition.size(); e-- > 0;) {
+    uint32_t r = etaPosition[e];
+    double s = y[r];
+    for (size_t p = etaStart[e]; p < etaStart[e + 1]; ++p) s -= etaValue[p] * y[etaIndex[p]];
+    y[r] = s / etaPivot[e];
+  }
+
+  for (uint32_t k = 0; k < m; ++k) work[k] = y[stepPosition[k]];
+
+  for (uint32_t k = 0; k < m; ++k) {
+    double s = work[k];
+    for (size_t p = uStart[k]; p < uStart[k + 1]; ++p) s -= uValue[p] * work[uIndex[p]];
+    work[k] = s / uDiag[k];
+  }
+  for (uint32_t k = m; k-- > 0;) {
+    double s = work[k];
+    for (size_t p = lStart[k]; p < lStart[k + 1]; ++p) s -= lValue[p] * work[lIndex[p]];
+    work[k] = s;
+  }
+
+  for (uint32_t k = 0; k < m; ++k) {
+    y[stepRow[k]] = work[k];
+    work[k] = 0.0;
+  }
+}
+
+/*
+ * Function: ftran (hypersparse)
+ * -------------------------
+ * Same algebra as the dense ftran, but the L and U solves only visit the
+ * steps reachable from the nonzeros of x. Falls back to the dense solve
+ * when x is not sparse.
+ */
+void BasisFactor::ftran(IndexedVector& x) const {
+  if (x.index.size() > HYPERSPARSE_DENSITY * m) {
+    ftran(x.values);
+    x.rebuildIndex();
+    return;
+  }
+
+  seeds.clear();
+  for (uint32_t i : x.index) {
+    if (x.values[i] == 0.0) continue;
+    uint32_t k = static_cast<uint32_t>(rowStep[i]);
+    work[k] = x.values[i];
+    x.values[i] = 0.0;
+    seeds.push_back(k);
+  }
+  x.index.clear();
+
+  reach(lStart, lIndex, seeds, reached);
+  for (uint32_t k : reached) {
+    double wk = work[k];
+    if (wk == 0.0) continue;
+    for (size_t p = lStart[k]; p < lStart[k + 1]; ++p) work[lIndex[p]] -= lValue[p] * wk;
+  }
+
+  seeds.swap(reached);
+  reach(uStart, uIndex, seeds, reached);
+  for (uint32_t k : reached) {
+    if (work[k] == 0.0) continue;
+    double vk = work[k] / uDiag[k];
+    work[k] = vk;
+    for (size_t p = uStart[k]; p < uStart[k + 1]; ++p) work[uIndex[p]] -= uValue[p] * vk;
+  }
+
+  for (uint32_t k : reached) {
+    if (work[k] != 0.0) {
+      x.values[stepPosition[k]] = work[k];
+      x.index.push_back(stepPosition[k]);
+    }
+    work[k] = 0.0;
+  }
+
+  for (size_t e = 0; e < etaPosition.size(); ++e) {
+    uint32_t r = etaPosition[e];
+    if (x.values[r] == 0.0) continue;
+    double xr = x.values[r] / etaPivot[e];
+    x.values[r] = xr;
+    for (size_t p = etaStart[e]; p < etaStart[e + 1]; ++p) x.add(etaIndex[p], -etaValue[p] * xr);
+  }
+}
+
+/*
+ * Function: btran (hypersparse)
+ * -------------------------
+ * Etas newest first, then U^T and L^T solved in push form along the row
+ * copies, visiting only the steps reachable from the nonzeros of y.
+ */
+void BasisFactor::btran(IndexedVector& y) const {
+  if (y.index.size() > HYPERSPARSE_DENSITY * m) {
+    btran(y.values);
+    y.rebuildIndex();
+    return;
+  }
+
+  for (size_t e = etaPosition.size(); e-- > 0;) {
+    uint32_t r = etaPosition[e];
+    double s = y.values[r];
+    for (size_t p = etaStart[e]; p < etaStart[e + 1]; ++p) s -= etaValue[p] * y.values[etaIndex[p]];
+    if (s == 0.0 && y.values[r] == 0.0) continue;
+    if (y.values[r] == 0.0) y.index.push_back(r);
+    y.values[r] = s != 0.0 ? s / etaPivot[e] : CANCELLED;
+  }
+
+  seeds.clear();
+  for (uint32_t pos : y.index) {
+    if (y.values[pos] == 0.0) continue;
+    uint32_t k = positionStep[pos];
+    work[k] = y.values[pos];
+    y.values[pos] = 0.0;
+    seeds.push_back(k);
+  }
+  y.index.clear();
+
+  reach(uRowStart, uRowIndex, seeds, reached);
+  for (uint32_t k : reached) {
+    if (work[k] == 0.0) continue;
+    double s = work[k] / uDiag[k];
+    work[k] = s;
+    for (size_t p = uRowStart[k]; p < uRowStart[k + 1]; ++p) work[uRowIndex[p]] -= uRowValue[p] * s;
+  }
+
+  seeds.swap(reached);
+  reach(lRowStart, lRowIndex, seeds, reached);
+  for (uint32_t k : reached) {
+    double t = work[k];
+    if (t == 0.0) continue;
+    for (size_t p = lRowStart[k]; p < lRowStart[k + 1]; ++p) work[lRowIndex[p]] -= lRowValue[p] * t;
+  }
+
+  for (uint32_t k : reached) {
+    if (work[k] != 0.0) {
+      y.values[stepRow[k]] = work[k];
+      y.index.push_back(stepRow[k]);
+    }
+    work[k] = 0.0;
+  }
+}
+
+void BasisFactor::update(uint32_t position, const IndexedVector& alpha) {
+  etaPosition.push_back(position);
+  etaPivot.push_back(alpha.values[position]);
+  for (uint32_t i : alpha.index) {
+    if (i == position || fabs(alpha.values[i]) <= DROP_TOLERANCE) continue;
+    etaIndex.push_back(i);
+    etaValue.push_back(alpha.values[i]);
+  }
+  etaStart.push_back(etaIndex.size());
+}
+
+void BasisFactor::update(uint32_t position, const vector<double>& alpha) {
+  etaPosition.push_back(position);
+  etaPivot.push_back(alpha[position]);
+  for (uint32_t i = 0; i < m; ++i) {
+    if (i == position || fabs(alpha[i]) <= DROP_TOLERANCE) continue;
+    etaIndex.push_back(i);
+    etaValue.push_back(alpha[i]);
+  }
+  etaStart.push_back(etaIndex.size());
+}
+
+bool BasisFactor::needsRefactor() const {
+  return numUpdates() >= MAX_UPDATES || etaIndex.size() > lIndex.size() + uIndex.size() + m;
+}
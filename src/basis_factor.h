@@ -0,0 +1,171 @@
+#pragma once
+
+#include "compact_model.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dense vector that also lists the positions that may be nonzero,
+ * so that sparse results can be consumed without scanning every entry.
+ *
+ * Every nonzero of `values` appears in `index` exactly once; `index` may
+ * also list positions whose value has since cancelled to zero.
+ */
+struct IndexedVector {
+  std::vector<double> values;
+  std::vector<uint32_t> index;
+
+  /**
+   * @brief Sets the dimension and zeroes the vector.
+   */
+  void resize(uint32_t size);
+
+  /**
+   * @brief Zeroes the vector in time proportional to its listed entries.
+   */
+  void clear();
+
+  /**
+   * @brief Adds `v` to entry `i`, listing it if it was not yet listed.
+   */
+  void add(uint32_t i, double v);
+
+  /**
+   * @brief Rebuilds `index` from `values` after a dense update.
+   */
+  void rebuildIndex();
+};
+
+/**
+ * @class BasisFactor
+ * @brief Sparse LU factorization of a simplex basis with product-form updates.
+ *
+ * The constraint matrix is [A  -I]: variable j < n is structural column j
+ * of A, variable n + i is the logical (slack) of row i, a column -e_i.
+ * A basis lists one variable per row; basis position k holds variable
+ * basis[k], and FTRAN results are indexed by basis position.
+ *
+ * The factorization is a left-looking Gilbert-Peierls LU (one sparse
+ * triangular solve per column, nonzero pattern found by depth-first
+ * search) with threshold partial pivoting that prefers short rows. Row
+ * and column singletons are ordered first so that the triangular part
+ * of the basis produces no fill.
+ * Basis changes are applied as product-form eta vectors until the next
+ * refactorization.
+ *
+ * The IndexedVector overloads of ftran and btran are hypersparse: when
+ * the right-hand side has few nonzeros, a depth-first search over the
+ * graph of L or U finds the entries the solve can reach and only those
+ * are visited, so the cost tracks the size of the result rather than m.
+ */
+class BasisFactor {
+  uint32_t m = 0;
+  uint32_t n = 0;
+  const SparseMatrix* columns = nullptr; // CSC of A
+
+  // L: unit lower triangular, column k holds multipliers below step k
+  std::vector<size_t> lStart;
+  std::vector<uint32_t> lIndex; // Step index of each multiplier
+  std::vector<double> lValue;
+
+  // U: column k holds entries above the diagonal, by step index
+  std::vector<size_t> uStart;
+  std::vector<uint32_t> uIndex;
+  std::vector<double> uValue;
+  std::vector<double> uDiag;
+
+  // Row-wise copies of L and U, for hypersparse BTRAN
+  std::vector<size_t> lRowStart;
+  std::vector<uint32_t> lRowIndex;
+  std::vector<double> lRowValue;
+  std::vector<size_t> uRowStart;
+  std::vector<uint32_t> uRowIndex;
+  std::vector<double> uRowValue;
+
+  std::vector<uint32_t> stepRow;      // Row pivoted at step k
+  std::vector<int64_t> rowStep;       // Step at which row i was pivoted, -1 if none
+  std::vector<uint32_t> stepPosition; // Basis position factored at step k
+  std::vector<uint32_t> positionStep; // Inverse of stepPosition
+
+  // Eta file: B_k = B_0 E_1 ... E_k
+  std::vector<uint32_t> etaPosition;
+  std::vector<double> etaPivot;
+  std::vector<size_t> etaStart{0};
+  std::vector<uint32_t> etaIndex;
+  std::vector<double> etaValue;
+
+  mutable std::vector<double> work; // Dense scratch, size m
+  mutable std::vector<uint32_t> mark; // DFS visit stamps, size m
+  mutable uint32_t stamp = 0;
+  mutable std::vector<std::pair<uint32_t, size_t>> stack;
+  mutable std::vector<uint32_t> seeds;
+  mutable std::vector<uint32_t> reached;
+
+  void columnOf(uint32_t var, std::vector<uint32_t>& index, std::vector<double>& value) const;
+  std::vector<uint32_t> columnOrder(const std::vector<uint32_t>& basis, std::vector<uint32_t>& rowCount) const;
+  void buildRowCopies();
+  void reach(const std::vector<size_t>& start, const std::vector<uint32_t>& index,
+             const std::vector<uint32_t>& from, std::vector<uint32_t>& order) const;
+
+public:
+  /**
+   * @brief Binds the factor to an m x n matrix given in CSC form. The
+   * matrix must outlive the factor.
+   */
+  void setMatrix(const SparseMatrix& csc, uint32_t numRows, uint32_t numCols);
+
+  /**
+   * @brief Factorizes the basis, discarding any updates.
+   *
+   * Columns that turn out to be (numerically) dependent are replaced in
+   * `basis` by logicals of rows left without a pivot.
+   *
+   * @return The variables that were dropped from the basis.
+   */
+  std::vector<uint32_t> factorize(std::vector<uint32_t>& basis);
+
+  /**
+   * @brief Solves B x = b in place: `x` enters indexed by row and leaves
+   * indexed by basis position.
+   */
+  void ftran(std::vector<double>& x) const;
+
+  /**
+   * @brief Solves B^T y = c in place: `y` enters indexed by basis position
+   * and leaves indexed by row.
+   */
+  void btran(std::vector<double>& y) const;
+
+  /**
+   * @brief Hypersparse ftran: as above, keeping `x.index` current.
+   */
+  void ftran(IndexedVector& x) const;
+
+  /**
+   * @brief Hypersparse btran: as above, keeping `y.index` current.
+   */
+  void btran(IndexedVector& y) const;
+
+  /**
+   * @brief Records that basis position `position` was replaced by a column
+   * whose FTRAN is `alpha` (indexed by basis position).
+   */
+  void update(uint32_t position, const std::vector<double>& alpha);
+
+  /**
+   * @brief Same as above, for a sparse `alpha`.
+   */
+  void update(uint32_t position, const IndexedVector& alpha);
+
+  /**
+   * @brief Number of eta vectors applied since the last factorization.
+   */
+  size_t numUpdates() const { return etaPosition.size(); }
+
+  /**
+   * @brief True once the eta file is long or dense enough that
+   * refactorizing is cheaper than carrying it.
+   */
+  bool needsRefactor() const;
+};
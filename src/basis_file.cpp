@@ -0,0 +1,113 @@
+#include "basis_file.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+  const char* statusCode(BasisStatus status) {
+    switch (status) {
+      case BasisStatus::BASIC: return "BS";
+      case BasisStatus::AT_LOWER: return "NL";
+      case BasisStatus::AT_UPPER: return "NU";
+      case BasisStatus::AT_ZERO: return "NF";
+    }
+    return "??";
+  }
+
+  bool parseStatus(const string& code, BasisStatus& status) {
+    if (code == "BS") status = BasisStatus::BASIC;
+    else if (code == "NL") status = BasisStatus::AT_LOWER;
+    else if (code == "NU") status = BasisStatus::AT_UPPER;
+    else if (code == "NF") status = BasisStatus::AT_ZERO;
+    else return false;
+    return true;
+  }
+
+  // Nonbasic status of a column that the file does not mention
+  BasisStatus nonbasicStatus(const CompactModel& model, uint32_t j) {
+    if (model.colLower[j] > -INFINITY) return BasisStatus::AT_LOWER;
+    if (model.colUpper[j] < INFINITY) return BasisStatus::AT_UPPER;
+    return BasisStatus::AT_ZERO;
+  }
+
+  // Row id of `name`, or NOT_FOUND; unnamed models use the default names "c<i+1>"
+  uint32_t findRow(const CompactModel& model, const string& name) {
+    if (model.rowNames.size() == model.numRows) return model.rowNames.find(name);
+    if (name.size() < 2 || name[0] != 'c' || name[1] == '0') return SymbolTable::NOT_FOUND;
+    uint64_t k = 0;
+    for (size_t p = 1; p < name.size(); ++p) {
+      if (name[p] < '0' || name[p] > '9' || k > model.numRows) return SymbolTable::NOT_FOUND;
+      k = k * 10 + (name[p] - '0');
+    }
+    return k >= 1 && k <= model.numRows ? static_cast<uint32_t>(k - 1) : SymbolTable::NOT_FOUND;
+  }
+} // anonymous namespace
+
+void BasisFile::writeFile(const CompactModel& model, const SimplexBasis& basis, const string& path) {
+  if (basis.columns.size() != model.numCols || basis.rows.size() != model.numRows) {
+    throw runtime_error("Basis does not match the model");
+  }
+  ofstream out(path);
+  if (!out.is_open()) throw runtime_error("Could not open basis file: " + path);
+
+  out << "# Basis: " << model.numCols << " columns, " << model.numRows << " rows\n";
+  for (uint32_t j = 0; j < model.numCols; ++j) {
+    out << "C " << model.variables.name(j) << ' ' << statusCode(basis.columns[j]) << '\n';
+  }
+  for (uint32_t i = 0; i < model.numRows; ++i) {
+    out << "R " << model.rowName(i) << ' ' << statusCode(basis.rows[i]) << '\n';
+  }
+  if (!out) throw runtime_error("Could not write basis file: " + path);
+}
+
+/*
+ * Function: readFile
+ * -------------------------
+ * Starts from the all-logical basis and overwrites the status of every
+ * named column and row. Then repairs the basic count: excess basic
+ * columns become nonbasic, last first, and missing basics are made up
+ * with row logicals, first first.
+ */
+SimplexBasis BasisFile::readFile(const string& path, const CompactModel& model, size_t* matched) {
+  ifstream in(path);
+  if (!in.is_open()) throw runtime_error("Could not open basis file: " + path);
+
+  SimplexBasis basis;
+  basis.columns.resize(model.numCols);
+  for (uint32_t j = 0; j < model.numCols; ++j) basis.columns[j] = nonbasicStatus(model, j);
+  basis.rows.assign(model.numRows, BasisStatus::BASIC);
+
+  size_t found = 0, lineNo = 0;
+  string line, kind, name, code;
+  while (getline(in, line)) {
+    ++lineNo;
+    if (line.empty() || line[0] == '#') continue;
+    istringstream fields(line);
+    BasisStatus status;
+    if (!(fields >> kind >> name >> code) || (kind != "C" && kind != "R") || !parseStatus(code, status)) {
+      throw runtime_error("Line " + to_string(lineNo) + ": expected 'C|R <name> BS|NL|NU|NF'");
+    }
+    uint32_t id = kind == "C" ? model.variables.find(name) : findRow(model, name);
+    if (id == SymbolTable::NOT_FOUND || (kind == "C" && id >= model.numCols)) continue;
+    (kind == "C" ? basis.columns : basis.rows)[id] = status;
+    ++found;
+  }
+  if (matched) *matched = found;
+
+  size_t basic = 0;
+  for (BasisStatus s : basis.columns) basic += s == BasisStatus::BASIC;
+  for (BasisStatus s : basis.rows) basic += s == BasisStatus::BASIC;
+  for (uint32_t j = model.numCols; basic > model.numRows && j-- > 0;) {
+    if (basis.columns[j] != BasisStatus::BASIC) continue;
+    basis.columns[j] = nonbasicStatus(model, j);
+    --basic;
+  }
+  for (uint32_t i = 0; basic < model.numRows && i < model.numRows; ++i) {
+    if (basis.rows[i] == BasisStatus::BASIC) continue;
+    basis.rows[i] = BasisStatus::BASIC;
+    ++basic;
+  }
+  return basis;
+}
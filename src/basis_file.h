@@ -0,0 +1,46 @@
+#pragma once
+
+#include "compact_model.h"
+#include "simplex.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * @class BasisFile
+ * @brief Saves a simplex basis keyed by row and column names, and loads
+ * it into a possibly different model.
+ *
+ * The file is plain text, one variable per line:
+ *
+ *   C <column name> <status>
+ *   R <row name> <status>
+ *
+ * with status BS (basic), NL (nonbasic at its lower bound), NU (at its
+ * upper bound) or NF (free, at zero), as in GLPK. Lines starting with '#'
+ * are comments.
+ *
+ * Because entries are matched by name, a basis saved for one model can
+ * warm-start a later model that differs in bounds, right-hand sides or a
+ * few rows and columns. Variables the file does not mention start as in
+ * the all-logical basis (columns nonbasic, rows basic), and the basic
+ * count is repaired to equal the number of rows.
+ */
+class BasisFile {
+public:
+  /**
+   * @brief Writes `basis` (one status per column and row of `model`) to `path`.
+   *
+   * @throws std::runtime_error if the sizes do not match or the file
+   * cannot be written.
+   */
+  static void writeFile(const CompactModel& model, const SimplexBasis& basis, const std::string& path);
+
+  /**
+   * @brief Reads the basis at `path` and maps it onto `model` by name.
+   *
+   * @param matched If not null, receives the number of entries that
+   * named a column or row of `model`.
+   * @throws std::runtime_error with a "Line N: ..." message on malformed input.
+   */
+  static SimplexBasis readFile(const std::string& path, const CompactModel& model, size_t* matched = nullptr);
+};
@@ -0,0 +1,503 @@
+#include "branch_and_bound.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+  constexpr double INTEGRALITY_TOLERANCE = 1e-6; // Distance from an integer still counted as integral
+  constexpr double ABSOLUTE_GAP = 1e-6;          // Nodes that cannot improve by more are pruned
+  constexpr double RELATIVE_GAP = 1e-9;
+  // Keep diving while the child's bound is within this fraction of the
+  // gap between the worker's best open bound and the incumbent.
+  constexpr double DIVE_FRACTION = 0.5;
+  // Deterministic mode: work each worker does between synchronizations,
+  // in simplex iterations plus NODE_WORK per node evaluated.
+  constexpr uint64_t WORK_UNIT = 2000;
+  constexpr uint64_t NODE_WORK = 10;
+
+  // Nodes whose bound is at or above the returned value cannot improve
+  // an incumbent of `value` by more than the gap tolerance.
+  double cutoffFor(double value) {
+    if (value == INFINITY) return INFINITY;
+    return value - max(ABSOLUTE_GAP, RELATIVE_GAP * fabs(value));
+  }
+} // anonymous namespace
+
+const char* mipStatusName(MipStatus status) {
+  switch (status) {
+    case MipStatus::UNSOLVED: return "UNSOLVED";
+    case MipStatus::OPTIMAL: return "OPTIMAL";
+    case MipStatus::INFEASIBLE: return "INFEASIBLE";
+    case MipStatus::UNBOUNDED: return "UNBOUNDED";
+    case MipStatus::NODE_LIMIT: return "NODE_LIMIT";
+    case MipStatus::NUMERICAL_ERROR: return "NUMERICAL_ERROR";
+  }
+  return "UNKNOWN";
+}
+
+void BranchAndBound::loadModel(const CompactModel& model) {
+  maximize = (model.type == OptType::MAXIMIZE);
+  numCols = model.numCols;
+  colLower = model.colLower;
+  colUpper = model.colUpper;
+  integral.assign(numCols, false);
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (model.colKind[j] == VarType::CONTINUOUS) continue;
+    integral[j] = true;
+    if (model.colKind[j] == VarType::BINARY) {
+      colLower[j] = max(colLower[j], 0.0);
+      colUpper[j] = min(colUpper[j], 1.0);
+    }
+    // Integer columns only take integer values, so round fractional bounds inward
+    colLower[j] = ceil(colLower[j] - INTEGRALITY_TOLERANCE);
+    colUpper[j] = floor(colUpper[j] + INTEGRALITY_TOLERANCE);
+  }
+
+  root.loadModel(model);
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (integral[j]) root.setColumnBounds(j, colLower[j], colUpper[j]);
+  }
+  result = MipStatus::UNSOLVED;
+}
+
+/*
+ * Function: betterNode
+ * -------------------------
+ * Node order: lower bound first, then earlier creation. Used as the heap
+ * comparator with the arguments swapped, so the best node is on top.
+ */
+bool BranchAndBound::betterNode(const Node& a, const Node& b) {
+  if (a.bound != b.bound) return a.bound < b.bound;
+  return a.id < b.id;
+}
+
+double BranchAndBound::cutoff() const {
+  return cutoffFor(incumbentValue.load(memory_order_acquire));
+}
+
+/*
+ * Function: offerIncumbent
+ * -------------------------
+ * Installs `solution` as the incumbent if `objective` beats it. The value
+ * is claimed by compare-and-swap; only the winner takes the mutex to
+ * store the solution vector, and a late writer with a worse value (which
+ * lost a race it had already won the CAS for) does not overwrite it.
+ */
+bool BranchAndBound::offerIncumbent(double objective, vector<double>& solution) {
+  double current = incumbentValue.load(memory_order_acquire);
+  while (objective < current) {
+    if (incumbentValue.compare_exchange_weak(current, objective, memory_order_acq_rel)) {
+      lock_guard<mutex> lock(incumbentMutex);
+      if (objective < incumbentStored) {
+        incumbentStored = objective;
+        incumbent = move(solution);
+      }
+      incumbentCount.fetch_add(1, memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Function: evaluate
+ * -------------------------
+ * Solves the LP of `node` on the worker's solver and decides its fate:
+ * pruned by infeasibility or bound, integer feasible, or branched on its
+ * most fractional integer column (lowest index on ties). A node LP that
+ * the warm-started dual cannot solve is retried from the root basis with
+ * the primal.
+ */
+BranchAndBound::Evaluation BranchAndBound::evaluate(Worker& worker, const Node& node, double cutoffValue) {
+  Evaluation ev;
+  SimplexSolver& lp = worker.lp;
+  for (uint32_t j : worker.changed) lp.setColumnBounds(j, colLower[j], colUpper[j]);
+  worker.changed.clear();
+  for (const BoundChange& c : node.changes) {
+    lp.setColumnBounds(c.column, c.lower, c.upper);
+    worker.changed.push_back(c.column);
+  }
+
+  lp.setBasis(*node.basis);
+  SimplexStatus st = lp.solve(true);
+  ev.iterations = lp.iterations();
+  if (st != SimplexStatus::OPTIMAL && st != SimplexStatus::INFEASIBLE) {
+    lp.setBasis(root.getBasis());
+    st = lp.solve(false);
+    ev.iterations += lp.iterations();
+  }
+  if (st == SimplexStatus::INFEASIBLE) return ev;
+  if (st != SimplexStatus::OPTIMAL) {
+    ev.outcome = Evaluation::FAILED;
+    return ev;
+  }
+
+  ev.objective = maximize ? -lp.getObjectiveValue() : lp.getObjectiveValue();
+  if (ev.objective >= cutoffValue) return ev;
+
+  vector<double> x = lp.getVariableValues();
+  int64_t branch = -1;
+  double fractionality = INTEGRALITY_TOLERANCE;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (!integral[j]) continue;
+    double f = min(x[j] - floor(x[j]), ceil(x[j]) - x[j]);
+    if (f > fractionality) {
+      fractionality = f;
+      branch = j;
+    }
+  }
+
+  if (branch < 0) {
+    for (uint32_t j = 0; j < numCols; ++j) {
+      if (integral[j]) x[j] = round(x[j]);
+    }
+    ev.outcome = Evaluation::INTEGER;
+    ev.solution = move(x);
+    return ev;
+  }
+
+  uint32_t j = static_cast<uint32_t>(branch);
+  double lower = colLower[j], upper = colUpper[j];
+  size_t slot = node.changes.size();
+  for (size_t k = 0; k < node.changes.size(); ++k) {
+    if (node.changes[k].column == j) {
+      lower = node.changes[k].lower;
+      upper = node.changes[k].upper;
+      slot = k;
+    }
+  }
+
+  auto basis = make_shared<const SimplexBasis>(lp.getBasis());
+  for (Node* child : { &ev.down, &ev.up }) {
+    child->changes = node.changes;
+    if (slot == node.changes.size()) child->changes.push_back({ j, lower, upper });
+    child->basis = basis;
+    child->bound = ev.objective;
+    child->depth = node.depth + 1;
+  }
+  ev.down.changes[slot].upper = floor(x[j]);
+  ev.up.changes[slot].lower = ceil(x[j]);
+  ev.upFirst = x[j] - floor(x[j]) >= 0.5;
+  ev.outcome = Evaluation::BRANCHED;
+  return ev;
+}
+
+void BranchAndBound::pushOpen(Worker& worker, Node node) {
+  {
+    lock_guard<mutex> lock(worker.mutex);
+    worker.open.push_back(move(node));
+    push_heap(worker.open.begin(), worker.open.end(), [](const Node& a, const Node& b) { return betterNode(b, a); });
+  }
+  pushCount.fetch_add(1);
+  if (idleWorkers.load() > 0) {
+    lock_guard<mutex> lock(idleMutex);
+    nodesPushed.notify_one();
+  }
+}
+
+bool BranchAndBound::popOpen(Worker& worker, Node& node) {
+  lock_guard<mutex> lock(worker.mutex);
+  if (worker.open.empty()) return false;
+  pop_heap(worker.open.begin(), worker.open.end(), [](const Node& a, const Node& b) { return betterNode(b, a); });
+  node = move(worker.open.back());
+  worker.open.pop_back();
+  return true;
+}
+
+/*
+ * Function: steal
+ * -------------------------
+ * Takes the best open node of the first other worker that has one,
+ * starting with the next worker so that thieves spread over victims.
+ */
+bool BranchAndBound::steal(size_t self, Node& node) {
+  for (size_t k = 1; k < workers.size(); ++k) {
+    if (popOpen(*workers[(self + k) % workers.size()], node)) return true;
+  }
+  return false;
+}
+
+/*
+ * Function: waitForNodes
+ * -------------------------
+ * Parks an idle worker until a node is pushed after it read `seen` from
+ * pushCount (before its last look at the heaps), the tree is done or the
+ * search stops. The worker counts itself idle before checking, and pushes
+ * bump the count before looking for idle workers, so no push is missed.
+ */
+void BranchAndBound::waitForNodes(uint64_t seen) {
+  unique_lock<mutex> lock(idleMutex);
+  idleWorkers.fetch_add(1);
+  nodesPushed.wait(lock, [&] {
+    return stopping.load() || outstanding.load() == 0 || pushCount.load() != seen;
+  });
+  idleWorkers.fetch_sub(1);
+}
+
+// Finishes a node; the last one wakes every idle worker to leave
+void BranchAndBound::retireNode() {
+  if (outstanding.fetch_sub(1, memory_order_acq_rel) == 1) {
+    lock_guard<mutex> lock(idleMutex);
+    nodesPushed.notify_all();
+  }
+}
+
+void BranchAndBound::stopSearch() {
+  stopping = true;
+  lock_guard<mutex> lock(idleMutex);
+  nodesPushed.notify_all();
+}
+
+/*
+ * Function: expand
+ * -------------------------
+ * Files the children of a branched node (ids already assigned). The
+ * child on the side x_j rounds to is returned in `next` to be dived into
+ * while its bound is not much worse than the worker's best open node;
+ * everything else goes to the worker's heap.
+ */
+bool BranchAndBound::expand(Worker& worker, Evaluation& ev, double cutoffValue, Node& next) {
+  Node& dive = ev.upFirst ? ev.up : ev.down;
+  Node& other = ev.upFirst ? ev.down : ev.up;
+  pushOpen(worker, move(other));
+
+  double best = INFINITY;
+  {
+    lock_guard<mutex> lock(worker.mutex);
+    if (!worker.open.empty()) best = worker.open.front().bound;
+  }
+  if (cutoffValue == INFINITY || best == INFINITY || dive.bound <= best + DIVE_FRACTION * (cutoffValue - best)) {
+    next = move(dive);
+    return true;
+  }
+  pushOpen(worker, move(dive));
+  return false;
+}
+
+/*
+ * Function: runWorker
+ * -------------------------
+ * Opportunistic worker loop. `outstanding` counts nodes that exist
+ * anywhere (in a heap or being evaluated); children are counted before
+ * their parent is retired, so it only reaches zero when the tree is done.
+ * A worker with nothing to pop or steal sleeps in waitForNodes().
+ */
+void BranchAndBound::runWorker(size_t self) {
+  Worker& worker = *workers[self];
+  Node current;
+  bool have = false;
+  try {
+    while (!stopping.load(memory_order_relaxed)) {
+      if (!have) {
+        uint64_t seen = pushCount.load();
+        have = popOpen(worker, current) || steal(self, current);
+        if (!have) {
+          if (outstanding.load(memory_order_acquire) == 0) break;
+          waitForNodes(seen);
+          continue;
+        }
+      }
+
+      double cutoffValue = cutoff();
+      if (current.bound >= cutoffValue) {
+        have = false;
+        retireNode();
+        continue;
+      }
+      if (nodeCount.fetch_add(1, memory_order_relaxed) >= nodeLimit) {
+        nodeCount.fetch_sub(1, memory_order_relaxed);
+        limitReached = true;
+        stopSearch();
+        break;
+      }
+
+      Evaluation ev = evaluate(worker, current, cutoffValue);
+      lpIterations.fetch_add(ev.iterations, memory_order_relaxed);
+      have = false;
+      if (ev.outcome == Evaluation::INTEGER) offerIncumbent(ev.objective, ev.solution);
+      else if (ev.outcome == Evaluation::FAILED) lpFailed = true;
+      else if (ev.outcome == Evaluation::BRANCHED) {
+        outstanding.fetch_add(2, memory_order_acq_rel);
+        ev.down.id = nextId.fetch_add(1, memory_order_relaxed);
+        ev.up.id = nextId.fetch_add(1, memory_order_relaxed);
+        have = expand(worker, ev, cutoff(), current);
+      }
+      retireNode();
+    }
+  }
+  catch (...) {
+    stopSearch();
+    throw;
+  }
+  if (have) pushOpen(worker, move(current));
+}
+
+void BranchAndBound::searchOpportunistic(Node rootNode) {
+  outstanding = 1;
+  pushOpen(*workers[0], move(rootNode));
+  ThreadPool pool(static_cast<unsigned>(workers.size()));
+  pool.parallelFor(workers.size(), [this](size_t i) { runWorker(i); });
+}
+
+/*
+ * Function: runRound
+ * -------------------------
+ * One deterministic work unit on a single worker: best-first with diving
+ * over the worker's own heap until the heap is empty or WORK_UNIT is
+ * used up. Children are numbered from `firstId` in creation order; the
+ * numbers only need to be unique within this worker until the barrier
+ * renumbers every open node.
+ */
+void BranchAndBound::runRound(Worker& worker, uint64_t firstId, double roundCutoff) {
+  worker.roundNodes = 0;
+  worker.roundIterations = 0;
+  worker.roundFailed = false;
+  worker.roundIncumbent = INFINITY;
+  worker.roundSolution.clear();
+
+  uint64_t work = 0, ids = firstId;
+  Node current;
+  bool have = false;
+  while (work < WORK_UNIT) {
+    if (!have && !popOpen(worker, current)) break;
+    have = false;
+    double cutoffValue = min(roundCutoff, cutoffFor(worker.roundIncumbent));
+    if (current.bound >= cutoffValue) continue;
+
+    Evaluation ev = evaluate(worker, current, cutoffValue);
+    worker.roundNodes++;
+    worker.roundIterations += ev.iterations;
+    work += ev.iterations + NODE_WORK;
+    if (ev.outcome == Evaluation::INTEGER) {
+      if (ev.objective < worker.roundIncumbent) {
+        worker.roundIncumbent = ev.objective;
+        worker.roundSolution = move(ev.solution);
+      }
+    }
+    else if (ev.outcome == Evaluation::FAILED) worker.roundFailed = true;
+    else if (ev.outcome == Evaluation::BRANCHED) {
+      ev.down.id = ids++;
+      ev.up.id = ids++;
+      have = expand(worker, ev, min(roundCutoff, cutoffFor(worker.roundIncumbent)), current);
+    }
+  }
+  if (have) pushOpen(worker, move(current));
+}
+
+/*
+ * Function: searchDeterministic
+ * -------------------------
+ * Rounds of one work unit per worker. Between rounds, on one thread:
+ * merge the workers' incumbents in worker order, pool and sort the open
+ * nodes by (bound, id), prune them against the incumbent, renumber them
+ * 0..K-1 and deal node k to worker k mod T. The heaps and the id ranges
+ * are therefore a function of the previous round alone.
+ */
+void BranchAndBound::searchDeterministic(Node rootNode) {
+  vector<Node> open;
+  open.push_back(move(rootNode));
+  ThreadPool pool(static_cast<unsigned>(workers.size()));
+
+  for (;;) {
+    double cutoffValue = cutoff();
+    stable_sort(open.begin(), open.end(), betterNode); // Ties between workers keep worker order
+    while (!open.empty() && open.back().bound >= cutoffValue) open.pop_back();
+    if (open.empty()) break;
+    if (nodeCount.load() >= nodeLimit) {
+      limitReached = true;
+      break;
+    }
+
+    for (size_t k = 0; k < open.size(); ++k) {
+      open[k].id = k;
+      workers[k % workers.size()]->open.push_back(move(open[k]));
+    }
+    for (auto& worker : workers) {
+      make_heap(worker->open.begin(), worker->open.end(), [](const Node& a, const Node& b) { return betterNode(b, a); });
+    }
+    uint64_t firstId = open.size();
+    open.clear();
+
+    pool.parallelFor(workers.size(), [&](size_t w) { runRound(*workers[w], firstId, cutoffValue); });
+
+    for (auto& worker : workers) {
+      nodeCount.fetch_add(worker->roundNodes);
+      lpIterations.fetch_add(worker->roundIterations);
+      if (worker->roundFailed) lpFailed = true;
+      if (worker->roundIncumbent < INFINITY) offerIncumbent(worker->roundIncumbent, worker->roundSolution);
+      for (Node& node : worker->open) open.push_back(move(node));
+      worker->open.clear();
+    }
+  }
+
+  // Leave the unexplored nodes where bestBound() looks for them
+  for (Node& node : open) workers[0]->open.push_back(move(node));
+}
+
+MipStatus BranchAndBound::solve() {
+  incumbentValue = INFINITY;
+  incumbentStored = INFINITY;
+  incumbent.clear();
+  outstanding = 0;
+  nodeCount = 0;
+  nextId = 1;
+  lpIterations = 0;
+  incumbentCount = 0;
+  stopping = false;
+  lpFailed = false;
+  limitReached = false;
+
+  SimplexStatus rootStatus = root.solve(true);
+  lpIterations = root.iterations();
+  if (rootStatus != SimplexStatus::OPTIMAL) {
+    result = rootStatus == SimplexStatus::INFEASIBLE ? MipStatus::INFEASIBLE
+           : rootStatus == SimplexStatus::UNBOUNDED ? MipStatus::UNBOUNDED : MipStatus::NUMERICAL_ERROR;
+    boundValue = rootStatus == SimplexStatus::UNBOUNDED ? (maximize ? INFINITY : -INFINITY) : NAN;
+    return result;
+  }
+
+  Node rootNode;
+  rootNode.basis = make_shared<const SimplexBasis>(root.getBasis());
+  rootNode.bound = maximize ? -root.getObjectiveValue() : root.getObjectiveValue();
+  rootNode.id = 0;
+
+  workers.clear();
+  unsigned threads = ThreadPool::resolveThreads(numThreads);
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.push_back(make_unique<Worker>());
+    workers.back()->lp = root;
+  }
+
+  if (deterministic) searchDeterministic(move(rootNode));
+  else searchOpportunistic(move(rootNode));
+
+  // Best bound: the incumbent, or the best node left open at a limit
+  double bound = incumbentStored;
+  for (auto& worker : workers) {
+    for (const Node& node : worker->open) bound = min(bound, node.bound);
+  }
+  boundValue = maximize ? -bound : bound;
+
+  if (limitReached) result = MipStatus::NODE_LIMIT;
+  else if (lpFailed) result = MipStatus::NUMERICAL_ERROR;
+  else result = hasSolution() ? MipStatus::OPTIMAL : MipStatus::INFEASIBLE;
+  return result;
+}
+
+bool BranchAndBound::hasSolution() const {
+  return incumbentStored < INFINITY;
+}
+
+double BranchAndBound::getObjectiveValue() const {
+  return maximize ? -incumbentStored : incumbentStored;
+}
+
+vector<double> BranchAndBound::getVariableValues() const {
+  return incumbent;
+}
+
+double BranchAndBound::bestBound() const {
+  return boundValue;
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "simplex.h"
+#include "compact_model.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Outcome of a BranchAndBound run.
+ */
+enum class MipStatus {
+  UNSOLVED,       // solve() has not run
+  OPTIMAL,        // Incumbent proven optimal
+  INFEASIBLE,     // No integer feasible point exists
+  UNBOUNDED,      // The LP relaxation is unbounded
+  NODE_LIMIT,     // Stopped at the node limit; an incumbent may exist
+  NUMERICAL_ERROR // Some node LP could not be solved; an incumbent may exist
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "OPTIMAL".
+ */
+const char* mipStatusName(MipStatus status);
+
+/**
+ * @class BranchAndBound
+ * @brief Parallel LP-based branch-and-bound for MILPs.
+ *
+ * Node LPs are solved by SimplexSolver's dual simplex, warm-started from
+ * the parent's optimal basis, and the search branches on the most
+ * fractional integer column. Each worker thread owns a copy of the root
+ * LP and applies a node's bound changes to it before solving.
+ *
+ * Opportunistic mode (the default): every worker keeps its own open
+ * nodes in a best-bound heap. After branching it dives into the child on
+ * the side x_j rounds to while that child's bound stays close to the
+ * best bound of its heap, and otherwise backtracks to the best node. An
+ * idle worker steals the best node of another worker, and sleeps until
+ * more nodes are pushed when there is nothing to steal. The incumbent
+ * value is a single atomic updated by compare-and-swap, so pruning never
+ * waits on a lock. Results may differ between runs with the same input.
+ *
+ * Deterministic mode: the search runs in rounds separated by barriers.
+ * At each barrier the open nodes are sorted by (bound, id), renumbered in
+ * that order and dealt round-robin to the workers. Each worker then
+ * searches its share as in opportunistic mode, but alone: no stealing,
+ * pruning against the incumbent of the round start plus its own finds,
+ * and stopping after a fixed amount of work measured in simplex
+ * iterations, not time. The round's incumbents are merged in worker
+ * order (ties go to the lower worker). Since every step depends only on
+ * data fixed at the barrier, the tree, the incumbent and the node count
+ * are bit-identical across runs for a given input and thread count. The
+ * node limit is checked at barriers only.
+ */
+class BranchAndBound {
+  struct BoundChange {
+    uint32_t column;
+    double lower;
+    double upper;
+  };
+
+  struct Node {
+    std::vector<BoundChange> changes;          // Bounds that differ from the model, one per column
+    std::shared_ptr<const SimplexBasis> basis; // Optimal basis of the parent
+    double bound = 0.0;                        // Parent's LP objective, minimization sense
+    uint32_t depth = 0;
+    uint64_t id = 0;                           // Creation order; breaks ties between equal bounds
+  };
+
+  struct Evaluation {
+    enum Outcome { PRUNED, INTEGER, BRANCHED, FAILED } outcome = PRUNED;
+    double objective = 0.0;        // Node LP objective, minimization sense
+    std::vector<double> solution;  // For INTEGER
+    Node down;                     // For BRANCHED
+    Node up;
+    bool upFirst = false;          // The up child is the one to dive into
+    uint64_t iterations = 0;
+  };
+
+  struct Worker {
+    SimplexSolver lp;
+    std::vector<uint32_t> changed; // Columns whose bounds in `lp` differ from the model
+    std::mutex mutex;              // Guards `open`
+    std::vector<Node> open;        // Heap, best bound first
+
+    // Deterministic mode: results of the current round, merged at the barrier
+    uint64_t roundNodes = 0;
+    uint64_t roundIterations = 0;
+    bool roundFailed = false;
+    double roundIncumbent = 0.0;
+    std::vector<double> roundSolution;
+  };
+
+  bool maximize = false;
+  uint32_t numCols = 0;
+  std::vector<double> colLower;
+  std::vector<double> colUpper;
+  std::vector<bool> integral;
+  SimplexSolver root;
+
+  unsigned numThreads = 0;
+  bool deterministic = false;
+  uint64_t nodeLimit = UINT64_MAX;
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::atomic<double> incumbentValue{INFINITY}; // Minimization sense, +infinity if none
+  std::mutex incumbentMutex;                    // Guards `incumbent` and `incumbentStored`
+  std::vector<double> incumbent;
+  double incumbentStored = INFINITY;
+  std::atomic<int64_t> outstanding{0};          // Nodes created and not yet finished
+  std::atomic<uint64_t> nodeCount{0};
+  std::atomic<uint64_t> nextId{0};
+  std::atomic<uint64_t> lpIterations{0};
+  std::atomic<uint64_t> incumbentCount{0};
+  std::atomic<bool> stopping{false};
+  std::mutex idleMutex;                         // Pairs with `nodesPushed`
+  std::condition_variable nodesPushed;          // Signalled on pushes while workers are idle, and at the end
+  std::atomic<uint64_t> pushCount{0};           // Nodes pushed so far; an idle worker waits for it to move
+  std::atomic<unsigned> idleWorkers{0};         // Workers waiting on `nodesPushed`
+  std::atomic<bool> lpFailed{false};
+  std::atomic<bool> limitReached{false};
+
+  MipStatus result = MipStatus::UNSOLVED;
+  double boundValue = 0.0;
+
+  static bool betterNode(const Node& a, const Node& b);
+  double cutoff() const;
+  bool offerIncumbent(double objective, std::vector<double>& solution);
+  Evaluation evaluate(Worker& worker, const Node& node, double cutoffValue);
+  void pushOpen(Worker& worker, Node node);
+  bool popOpen(Worker& worker, Node& node);
+  bool steal(size_t self, Node& node);
+  void waitForNodes(uint64_t seen);
+  void retireNode();
+  void stopSearch();
+  bool expand(Worker& worker, Evaluation& ev, double cutoffValue, Node& next);
+  void runWorker(size_t self);
+  void runRound(Worker& worker, uint64_t firstId, double roundCutoff);
+  void searchOpportunistic(Node rootNode);
+  void searchDeterministic(Node rootNode);
+
+public:
+  /**
+   * @brief Loads a CompactModel (copied internally).
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Starting basis for the root LP relaxation; call after loadModel().
+   *
+   * @throws std::runtime_error as SimplexSolver::setBasis.
+   */
+  void setRootBasis(const SimplexBasis& basis) { root.setBasis(basis); }
+
+  /**
+   * @brief Optimal basis of the root LP relaxation found by solve().
+   */
+  SimplexBasis getRootBasis() const { return root.getBasis(); }
+
+  /**
+   * @brief Runs the search.
+   *
+   * @return The final status, also available from status().
+   */
+  MipStatus solve();
+
+  /**
+   * @brief True if an integer feasible solution was found.
+   */
+  bool hasSolution() const;
+
+  /**
+   * @brief Objective value of the incumbent, in the model's sense and
+   * including the objective constant.
+   */
+  double getObjectiveValue() const;
+
+  /**
+   * @brief Values of the incumbent's structural variables, by column id.
+   */
+  std::vector<double> getVariableValues() const;
+
+  /**
+   * @brief Best proven bound on the optimum, in the model's sense. Equals
+   * the objective value once the status is OPTIMAL.
+   */
+  double bestBound() const;
+
+  /**
+   * @brief Status of the last solve().
+   */
+  MipStatus status() const { return result; }
+
+  /**
+   * @brief Nodes whose LP was solved by the last solve().
+   */
+  uint64_t nodes() const { return nodeCount.load(); }
+
+  /**
+   * @brief Simplex iterations summed over all node LPs of the last solve().
+   */
+  uint64_t iterations() const { return lpIterations.load(); }
+
+  /**
+   * @brief Times the last solve() replaced its incumbent with a better one.
+   */
+  uint64_t incumbentUpdates() const { return incumbentCount.load(); }
+
+  /**
+   * @brief Worker threads (0 = one per hardware thread).
+   */
+  void setThreads(unsigned threads) { numThreads = threads; }
+
+  /**
+   * @brief Selects deterministic (reproducible) or opportunistic search.
+   */
+  void setDeterministic(bool enabled) { deterministic = enabled; }
+
+  /**
+   * @brief Caps the number of nodes per solve().
+   */
+  void setNodeLimit(uint64_t limit) { nodeLimit = limit; }
+};
@@ -0,0 +1,135 @@
+#include "compact_model.h"
+
+using namespace std;
+
+/*
+ * Function: transpose
+ * -------------------------
+ * Counting-sort transpose: one pass to count entries per minor line, one
+ * pass to scatter. Minor indices come out sorted within each line.
+ */
+SparseMatrix SparseMatrix::transpose(uint32_t numMinor) const {
+  SparseMatrix t;
+  t.start.assign(size_t(numMinor) + 1, 0);
+  t.index.resize(numNonzeros());
+  t.value.resize(numNonzeros());
+
+  for (uint32_t idx : index) t.start[idx + 1]++;
+  for (uint32_t k = 0; k < numMinor; ++k) t.start[k + 1] += t.start[k];
+
+  vector<size_t> next(t.start.begin(), t.start.end() - 1);
+  for (uint32_t major = 0; major < numMajor(); ++major) {
+    for (size_t p = start[major]; p < start[major + 1]; ++p) {
+      size_t q = next[index[p]]++;
+      t.index[q] = major;
+      t.value[q] = value[p];
+    }
+  }
+  return t;
+}
+
+const SparseMatrix& CompactModel::columns() {
+  if (!colsValid) {
+    cols = rows.transpose(numCols);
+    colsValid = true;
+  }
+  return cols;
+}
+
+string CompactModel::rowName(uint32_t i) const {
+  if (rowNames.size() == numRows) return string(rowNames.name(i));
+  return "c" + to_string(i + 1);
+}
+
+bool CompactModel::hasIntegerColumns() const {
+  for (VarType kind : colKind) {
+    if (kind != VarType::CONTINUOUS) return true;
+  }
+  return false;
+}
+
+/*
+ * Function: fromLPModel
+ * -------------------------
+ * Converts per-constraint term lists into CSR plus flat bound arrays.
+ * A position marker per column merges duplicate terms in O(nnz).
+ */
+CompactModel CompactModel::fromLPModel(const LPModel& model) {
+  CompactModel cm;
+  cm.type = model.type;
+  cm.numCols = static_cast<uint32_t>(model.bounds.size());
+  cm.numRows = static_cast<uint32_t>(model.constraints.size());
+  cm.variables = model.variables;
+  cm.rowNames = model.constraintNames;
+  cm.objectiveOffset = model.objective.rhs;
+
+  // Columns
+  cm.colLower.resize(cm.numCols);
+  cm.colUpper.resize(cm.numCols);
+  cm.colKind.resize(cm.numCols);
+  for (uint32_t j = 0; j < cm.numCols; ++j) {
+    const Bound& b = model.bounds[j];
+    cm.colLower[j] = b.isFree ? -INFINITY : b.lower;
+    cm.colUpper[j] = b.isFree ? INFINITY : b.upper;
+    cm.colKind[j] = b.type;
+
+    // Binary columns are [0, 1] whatever else was declared, as in GLPK's GLP_BV
+    if (b.type == VarType::BINARY) {
+      cm.colLower[j] = 0.0;
+      cm.colUpper[j] = 1.0;
+    }
+  }
+
+  cm.objective.assign(cm.numCols, 0.0);
+  for (const Term& term : model.objective.terms) {
+    cm.objective[term.column] += term.coefficient;
+  }
+
+  // Rows
+  size_t nnz = 0;
+  for (const auto& con : model.constraints) nnz += con.terms.size();
+  cm.rows.start.reserve(size_t(cm.numRows) + 1);
+  cm.rows.index.reserve(nnz);
+  cm.rows.value.reserve(nnz);
+  cm.rowLower.resize(cm.numRows);
+  cm.rowUpper.resize(cm.numRows);
+
+  vector<uint32_t> lastRow(cm.numCols, UINT32_MAX); // Last row that used column j
+  vector<size_t> position(cm.numCols);               // Its slot in that row
+  for (uint32_t i = 0; i < cm.numRows; ++i) {
+    const auto& con = model.constraints[i];
+    size_t rowStart = cm.rows.index.size();
+
+    for (const Term& term : con.terms) {
+      if (lastRow[term.column] == i) {
+        cm.rows.value[position[term.column]] += term.coefficient;
+      }
+      else {
+        lastRow[term.column] = i;
+        position[term.column] = cm.rows.index.size();
+        cm.rows.index.push_back(term.column);
+        cm.rows.value.push_back(term.coefficient);
+      }
+    }
+
+    // Drop entries that cancelled out
+    size_t out = rowStart;
+    for (size_t p = rowStart; p < cm.rows.index.size(); ++p) {
+      if (cm.rows.value[p] == 0.0) continue;
+      cm.rows.index[out] = cm.rows.index[p];
+      cm.rows.value[out] = cm.rows.value[p];
+      ++out;
+    }
+    cm.rows.index.resize(out);
+    cm.rows.value.resize(out);
+    cm.rows.start.push_back(out);
+
+    switch (con.op) {
+      case RelOp::LESS_EQUAL:    cm.rowLower[i] = -INFINITY; cm.rowUpper[i] = con.rhs; break;
+      case RelOp::GREATER_EQUAL: cm.rowLower[i] = con.rhs;   cm.rowUpper[i] = INFINITY; break;
+      case RelOp::EQUAL:         cm.rowLower[i] = con.rhs;   cm.rowUpper[i] = con.rhs; break;
+    }
+  }
+
+  return cm;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "parser.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Compressed sparse matrix (CSR or CSC, depending on orientation).
+ *
+ * Entries of major line k (a row in CSR, a column in CSC) are
+ * index[start[k] .. start[k + 1]) / value[start[k] .. start[k + 1]).
+ */
+struct SparseMatrix {
+  std::vector<size_t> start{0}; // numMajor + 1 offsets into index/value
+  std::vector<uint32_t> index;  // Minor index of each nonzero
+  std::vector<double> value;    // Coefficient of each nonzero
+
+  uint32_t numMajor() const { return static_cast<uint32_t>(start.size() - 1); }
+  size_t numNonzeros() const { return index.size(); }
+
+  /**
+   * @brief Returns the transpose (CSR <-> CSC) with `numMinor` major lines.
+   */
+  SparseMatrix transpose(uint32_t numMinor) const;
+};
+
+/**
+ * @struct CompactModel
+ * @brief Flat-array form of an LP/MILP, the layout handed to solvers.
+ *
+ * Row i is rowLower[i] <= A[i,:] x <= rowUpper[i] and column j is
+ * colLower[j] <= x[j] <= colUpper[j]; infinite bounds are +/-INFINITY.
+ * The matrix is kept in CSR form; the CSC transpose is built on demand.
+ */
+struct CompactModel {
+  OptType type = OptType::MINIMIZE;
+  uint32_t numRows = 0;
+  uint32_t numCols = 0;
+
+  SparseMatrix rows;              // Constraint matrix, row-major (CSR)
+  std::vector<double> rowLower;   // Per row
+  std::vector<double> rowUpper;   // Per row
+  std::vector<double> colLower;   // Per column
+  std::vector<double> colUpper;   // Per column
+  std::vector<VarType> colKind;   // Per column
+  std::vector<double> objective;  // Per column
+  double objectiveOffset = 0.0;   // Constant term of the objective
+  SymbolTable variables;          // Column names
+  SymbolTable rowNames;           // Empty, or one name per row (default "c<i+1>")
+
+  /**
+   * @brief Returns the name of row `i`: its own name if the model has row
+   * names, "c<i+1>" otherwise.
+   */
+  std::string rowName(uint32_t i) const;
+
+  /**
+   * @brief Returns the column-major (CSC) matrix, building it on first use.
+   */
+  const SparseMatrix& columns();
+
+  /**
+   * @brief True if any column is INTEGER or BINARY.
+   */
+  bool hasIntegerColumns() const;
+
+  /**
+   * @brief Flattens a parsed LPModel. Repeated variables within a row or
+   * the objective are summed; entries that cancel to zero are dropped.
+   */
+  static CompactModel fromLPModel(const LPModel& model);
+
+private:
+  SparseMatrix cols; // CSC cache; empty until columns() is called
+  bool colsValid = false;
+};
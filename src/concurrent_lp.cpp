@@ -0,0 +1,257 @@
+#include "concurrent_lp.h"
+#include "interior_point.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace {
+  constexpr chrono::milliseconds CANCEL_POLL{10}; // Longest wait between checks of the external cancel flag
+
+  // The race's outcome for a method's own status
+  template <class Status>
+  ConcurrentStatus outcome(Status status) {
+    if (status == Status::OPTIMAL) return ConcurrentStatus::OPTIMAL;
+    if (status == Status::INFEASIBLE) return ConcurrentStatus::INFEASIBLE;
+    if (status == Status::UNBOUNDED) return ConcurrentStatus::UNBOUNDED;
+    if (status == Status::ITERATION_LIMIT) return ConcurrentStatus::ITERATION_LIMIT;
+    if (status == Status::TIME_LIMIT) return ConcurrentStatus::TIME_LIMIT;
+    if (status == Status::CANCELLED) return ConcurrentStatus::CANCELLED;
+    return ConcurrentStatus::NUMERICAL_ERROR;
+  }
+
+  bool decisive(ConcurrentStatus status) {
+    return status == ConcurrentStatus::OPTIMAL || status == ConcurrentStatus::INFEASIBLE ||
+           status == ConcurrentStatus::UNBOUNDED;
+  }
+
+  // Whether `status` from `racer` ends the race. The barrier's infeasibility
+  // and unboundedness rest on rays checked to a tolerance, while the simplex
+  // methods prove theirs from a basis, so those only end the race when a
+  // simplex method reports them.
+  bool endsRace(LpRacer racer, ConcurrentStatus status) {
+    if (racer == LpRacer::BARRIER) return status == ConcurrentStatus::OPTIMAL;
+    return decisive(status);
+  }
+} // anonymous namespace
+
+const char* concurrentStatusName(ConcurrentStatus status) {
+  switch (status) {
+    case ConcurrentStatus::UNSOLVED: return "UNSOLVED";
+    case ConcurrentStatus::OPTIMAL: return "OPTIMAL";
+    case ConcurrentStatus::INFEASIBLE: return "INFEASIBLE";
+    case ConcurrentStatus::UNBOUNDED: return "UNBOUNDED";
+    case ConcurrentStatus::ITERATION_LIMIT: return "ITERATION_LIMIT";
+    case ConcurrentStatus::TIME_LIMIT: return "TIME_LIMIT";
+    case ConcurrentStatus::CANCELLED: return "CANCELLED";
+    case ConcurrentStatus::NUMERICAL_ERROR: return "NUMERICAL_ERROR";
+  }
+  return "UNKNOWN";
+}
+
+const char* lpRacerName(LpRacer racer) {
+  switch (racer) {
+    case LpRacer::NONE: return "none";
+    case LpRacer::PRIMAL: return "primal";
+    case LpRacer::DUAL: return "dual";
+    case LpRacer::BARRIER: return "barrier";
+  }
+  return "unknown";
+}
+
+void ConcurrentLpSolver::loadModel(const CompactModel& source) {
+  model = source;
+  result = ConcurrentStatus::UNSOLVED;
+}
+
+/*
+ * Function: solve
+ * -------------------------
+ * Starts one thread per method and waits for the first result that ends
+ * the race, the time limit or the external cancel flag, checking the flag
+ * every CANCEL_POLL. The barrier's infeasibility or unboundedness is kept
+ * aside and reported only if no method ends the race. Either way the
+ * shared stop flag goes up and every thread is joined before returning,
+ * so no method outlives the call. Results are copied out under the lock
+ * by the winning thread itself.
+ */
+ConcurrentStatus ConcurrentLpSolver::solve() {
+  bool warmStart = !startBasis.rows.empty() || !startBasis.columns.empty();
+  if (warmStart) {
+    // Checked here, since an error in a thread would only drop that method from the race
+    if (startBasis.columns.size() != model.numCols || startBasis.rows.size() != model.numRows) {
+      throw runtime_error("Basis does not match the model dimensions");
+    }
+    uint32_t numBasic = 0;
+    for (BasisStatus st : startBasis.columns) numBasic += st == BasisStatus::BASIC;
+    for (BasisStatus st : startBasis.rows) numBasic += st == BasisStatus::BASIC;
+    if (numBasic != model.numRows) {
+      throw runtime_error("Basis has " + to_string(numBasic) + " basic variables for " +
+                          to_string(model.numRows) + " rows");
+    }
+  }
+  result = ConcurrentStatus::UNSOLVED;
+  winningRacer = LpRacer::NONE;
+  values.clear();
+  rowDuals.clear();
+  reducedCosts.clear();
+  basis = SimplexBasis();
+  reports.assign(3, Report());
+
+  atomic<bool> stopRace{false};
+  mutex lock;
+  condition_variable returned;
+  unsigned running = 3;
+  bool hitLimit = false;
+  ConcurrentStatus fallback = ConcurrentStatus::UNSOLVED; // The barrier's infeasibility or unboundedness
+  exception_ptr error;
+  auto start = chrono::steady_clock::now();
+  auto elapsed = [&] { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+
+  // Called by each method as it returns; the first result that ends the race is kept
+  auto finish = [&](size_t slot, LpRacer racer, const char* statusName, uint64_t iterations,
+                    ConcurrentStatus status, auto&& keep) {
+    lock_guard<mutex> guard(lock);
+    reports[slot] = Report{ racer, statusName, iterations, elapsed() };
+    hitLimit = hitLimit || status == ConcurrentStatus::ITERATION_LIMIT;
+    if (winningRacer == LpRacer::NONE && endsRace(racer, status)) {
+      winningRacer = racer;
+      result = status;
+      if (status == ConcurrentStatus::OPTIMAL) keep();
+      stopRace = true;
+    }
+    else if (decisive(status)) {
+      fallback = status;
+    }
+    --running;
+    returned.notify_one();
+  };
+  auto fail = [&](size_t slot, LpRacer racer) {
+    lock_guard<mutex> guard(lock);
+    reports[slot] = Report{ racer, "ERROR", 0, elapsed() };
+    if (!error) error = current_exception();
+    --running;
+    returned.notify_one();
+  };
+
+  auto simplex = [&](size_t slot, LpRacer racer) {
+    try {
+      SimplexSolver solver;
+      solver.loadModel(model);
+      if (warmStart) solver.setBasis(startBasis);
+      solver.setIterationLimit(iterationLimit);
+      solver.setCancelFlag(&stopRace);
+      SimplexStatus status = solver.solve(racer == LpRacer::DUAL);
+      finish(slot, racer, simplexStatusName(status), solver.iterations(), outcome(status), [&] {
+        objective = solver.getObjectiveValue();
+        values = solver.getVariableValues();
+        basis = solver.getBasis();
+      });
+    }
+    catch (...) {
+      fail(slot, racer);
+    }
+  };
+  auto barrier = [&](size_t slot) {
+    try {
+      unsigned threads = ThreadPool::resolveThreads(numThreads);
+      InteriorPointSolver solver;
+      solver.loadModel(model);
+      solver.setThreads(threads > 2 ? threads - 2 : 1);
+      if (iterationLimit != UINT64_MAX) solver.setIterationLimit(iterationLimit);
+      solver.setCancelFlag(&stopRace);
+      IpmStatus status = solver.solve();
+      finish(slot, LpRacer::BARRIER, ipmStatusName(status), solver.iterations(), outcome(status), [&] {
+        objective = solver.getObjectiveValue();
+        values = solver.getVariableValues();
+        rowDuals = solver.getRowDuals();
+        reducedCosts = solver.getReducedCosts();
+      });
+    }
+    catch (...) {
+      fail(slot, LpRacer::BARRIER);
+    }
+  };
+
+  vector<thread> threads;
+  threads.emplace_back(simplex, 0, LpRacer::PRIMAL);
+  threads.emplace_back(simplex, 1, LpRacer::DUAL);
+  threads.emplace_back(barrier, 2);
+
+  ConcurrentStatus stopped = ConcurrentStatus::UNSOLVED; // Why the race was stopped from outside, if it was
+  {
+    unique_lock<mutex> guard(lock);
+    while (running > 0 && winningRacer == LpRacer::NONE) {
+      if (cancelFlag && cancelFlag->load()) {
+        stopped = ConcurrentStatus::CANCELLED;
+        break;
+      }
+      double remaining = timeLimit - elapsed();
+      if (remaining <= 0.0) {
+        stopped = ConcurrentStatus::TIME_LIMIT;
+        break;
+      }
+      returned.wait_for(guard, min<chrono::duration<double>>(CANCEL_POLL, chrono::duration<double>(remaining)));
+    }
+  }
+  stopRace = true;
+  for (thread& t : threads) t.join();
+
+  if (winningRacer == LpRacer::NONE && fallback != ConcurrentStatus::UNSOLVED) {
+    winningRacer = LpRacer::BARRIER;
+    result = fallback;
+  }
+  if (winningRacer == LpRacer::NONE) {
+    if (stopped != ConcurrentStatus::UNSOLVED) result = stopped;
+    else if (error) rethrow_exception(error);
+    else result = hitLimit ? ConcurrentStatus::ITERATION_LIMIT : ConcurrentStatus::NUMERICAL_ERROR;
+  }
+  return result;
+}
+
+uint64_t ConcurrentLpSolver::iterations() const {
+  for (const Report& report : reports) {
+    if (report.racer == winningRacer) return report.iterations;
+  }
+  return 0;
+}
+
+void ConcurrentLpSolver::recordStats(SolveStats& stats) const {
+  for (const Report& report : reports) {
+    string name = lpRacerName(report.racer);
+    stats.setCounter(name + "_iterations", report.iterations);
+    stats.addTime("race_" + name, report.seconds);
+  }
+}
+
+string ConcurrentLpSolver::summary() const {
+  ostringstream out;
+  out.precision(3);
+  double seconds = 0.0;
+  for (const Report& report : reports) {
+    if (report.racer == winningRacer) seconds = report.seconds;
+  }
+  if (winningRacer == LpRacer::NONE) out << "no method finished (";
+  else out << lpRacerName(winningRacer) << " won in " << seconds << " s (";
+  bool first = true;
+  for (const Report& report : reports) {
+    if (report.racer == winningRacer) continue;
+    out << (first ? "" : ", ") << lpRacerName(report.racer) << ' ' << report.status << " after "
+        << report.iterations << " iterations";
+    first = false;
+  }
+  out << ')';
+  return out.str();
+}
+
+SimplexBasis crossoverStart(const CompactModel& model, const ConcurrentLpSolver& solver,
+                            const vector<double>& values) {
+  if (solver.hasBasis()) return solver.getBasis();
+  return crossoverBasis(model, values, solver.getRowDuals(), solver.getReducedCosts());
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "compact_model.h"
+#include "crossover.h"
+#include "simplex.h"
+#include "solve_stats.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Outcome of a ConcurrentLpSolver race.
+ */
+enum class ConcurrentStatus {
+  UNSOLVED,        // solve() has not run
+  OPTIMAL,         // The winner found an optimum
+  INFEASIBLE,      // The winner found the LP infeasible
+  UNBOUNDED,       // The winner found the LP unbounded
+  ITERATION_LIMIT, // Every method stopped at the iteration limit or failed
+  TIME_LIMIT,      // The time limit expired first
+  CANCELLED,       // The cancel flag was raised first
+  NUMERICAL_ERROR  // Every method failed numerically
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "OPTIMAL".
+ */
+const char* concurrentStatusName(ConcurrentStatus status);
+
+/**
+ * @brief The LP methods a ConcurrentLpSolver races.
+ */
+enum class LpRacer {
+  NONE,    // No method finished
+  PRIMAL,  // SimplexSolver, primal
+  DUAL,    // SimplexSolver, dual
+  BARRIER  // InteriorPointSolver
+};
+
+/**
+ * @brief Returns the name of `racer`: "none", "primal", "dual" or "barrier".
+ */
+const char* lpRacerName(LpRacer racer);
+
+/**
+ * @class ConcurrentLpSolver
+ * @brief Races the primal simplex, the dual simplex and the barrier on one
+ * LP and keeps the result of whichever finishes first.
+ *
+ * Which method is fastest varies widely between models, so instead of
+ * guessing, solve() starts all three on threads of their own. Each loads
+ * the model into its own solver, so they share nothing but a stop flag.
+ * The first to prove optimality, infeasibility or unboundedness wins and
+ * raises the flag, and the others stop at their next iteration. A method
+ * that fails (numerical trouble, its iteration limit) drops out and the
+ * others go on. The time limit and the external cancel flag raise the
+ * stop flag as well.
+ *
+ * Infeasibility or unboundedness found by the barrier does not stop the
+ * race: the simplex methods go on, and the barrier's result is kept only
+ * if neither of them ends the race, since they prove theirs from a basis.
+ *
+ * The winner and how far each method got are kept for reports, so the
+ * method to pick for a class of models can be tuned from them. Integrality
+ * is ignored. The model is held four times over during the race: the
+ * loaded copy and one per method.
+ */
+class ConcurrentLpSolver {
+public:
+  /**
+   * @brief How one method of the last race ended.
+   */
+  struct Report {
+    LpRacer racer = LpRacer::NONE;
+    std::string status;   // The method's own status name, e.g. "CANCELLED"
+    uint64_t iterations = 0;
+    double seconds = 0.0; // From the start of the race to the method's return
+  };
+
+private:
+  CompactModel model;
+  SimplexBasis startBasis;            // Empty unless setBasis() was called
+  unsigned numThreads = 0;
+  uint64_t iterationLimit = UINT64_MAX;
+  double timeLimit = INFINITY;
+  const std::atomic<bool>* cancelFlag = nullptr;
+
+  ConcurrentStatus result = ConcurrentStatus::UNSOLVED;
+  LpRacer winningRacer = LpRacer::NONE;
+  double objective = 0.0;
+  std::vector<double> values;
+  std::vector<double> rowDuals;       // Barrier winner only
+  std::vector<double> reducedCosts;
+  SimplexBasis basis;                 // Simplex winner only
+  std::vector<Report> reports;
+
+public:
+  /**
+   * @brief Loads a CompactModel (copied; each method copies it again).
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Starting basis for both simplex methods in the following
+   * solve() calls, e.g. from a basis file; the barrier starts from its own
+   * point. May be set before or after loadModel().
+   */
+  void setBasis(const SimplexBasis& start) { startBasis = start; }
+
+  /**
+   * @brief Runs the race and waits until every method has returned.
+   *
+   * @return The final status, also available from status().
+   * @throws std::runtime_error if the basis of setBasis() does not match
+   * the model: its sizes differ, or its number of BASIC entries is not the
+   * number of rows. Errors inside a method drop it from the race; they
+   * are rethrown here only if no method finished.
+   */
+  ConcurrentStatus solve();
+
+  /**
+   * @brief Objective value of the winner's solution, in the model's sense
+   * and including the objective constant.
+   */
+  double getObjectiveValue() const { return objective; }
+
+  /**
+   * @brief The winner's values of the structural variables, indexed by
+   * column id.
+   */
+  std::vector<double> getVariableValues() const { return values; }
+
+  /**
+   * @brief Row duals and reduced costs, in the model's sense, if the
+   * barrier won (empty otherwise), for crossoverBasis().
+   */
+  std::vector<double> getRowDuals() const { return rowDuals; }
+  std::vector<double> getReducedCosts() const { return reducedCosts; }
+
+  /**
+   * @brief True if a simplex method won, which leaves its optimal basis
+   * for getBasis().
+   */
+  bool hasBasis() const { return !basis.rows.empty() || !basis.columns.empty(); }
+  const SimplexBasis& getBasis() const { return basis; }
+
+  /**
+   * @brief Status of the last solve().
+   */
+  ConcurrentStatus status() const { return result; }
+
+  /**
+   * @brief The method whose result was kept, or LpRacer::NONE.
+   */
+  LpRacer winner() const { return winningRacer; }
+
+  /**
+   * @brief Iterations of the winner (0 if none).
+   */
+  uint64_t iterations() const;
+
+  /**
+   * @brief How each method ended, in the order primal, dual, barrier.
+   */
+  const std::vector<Report>& raceReports() const { return reports; }
+
+  /**
+   * @brief Records the race in `stats`: counters primal_iterations,
+   * dual_iterations and barrier_iterations, and phases race_primal,
+   * race_dual and race_barrier with the seconds each method ran.
+   */
+  void recordStats(SolveStats& stats) const;
+
+  /**
+   * @brief One line for logs, e.g. "dual won in 0.42 s (primal CANCELLED
+   * after 310 iterations, barrier CANCELLED after 7 iterations)".
+   */
+  std::string summary() const;
+
+  /**
+   * @brief Threads for the barrier's linear algebra (0 = one per hardware
+   * thread). The two simplex methods take one thread each, so the barrier
+   * gets what remains of the count, at least one.
+   */
+  void setThreads(unsigned threads) { numThreads = threads; }
+
+  /**
+   * @brief Caps the iterations of each method per solve(); the barrier
+   * keeps its own default when this is unset.
+   */
+  void setIterationLimit(uint64_t limit) { iterationLimit = limit; }
+
+  /**
+   * @brief Wall-clock seconds per solve(); the race stops at the limit.
+   */
+  void setTimeLimit(double seconds) { timeLimit = seconds; }
+
+  /**
+   * @brief solve() stops the race once `*flag` is true; null detaches the
+   * flag.
+   */
+  void setCancelFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+};
+
+/**
+ * @brief Starting basis for a crossover after a native LP method: the one
+ * crossoverBasis() guesses from its solution and duals, or after a race
+ * won by a simplex method, that method's optimal basis.
+ */
+template <class Solver>
+SimplexBasis crossoverStart(const CompactModel& model, const Solver& solver, const std::vector<double>& values) {
+  return crossoverBasis(model, values, solver.getRowDuals(), solver.getReducedCosts());
+}
+SimplexBasis crossoverStart(const CompactModel& model, const ConcurrentLpSolver& solver,
+                            const std::vector<double>& values);
@@ -0,0 +1,68 @@
+#include "crossover.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+  struct Candidate {
+    double score;  // Likelihood of being basic, in [0, 2]
+    uint32_t var;  // Column j, or numCols + i for row i's logical
+  };
+
+  // dist / (dist + |dual|) for a value within [lower, upper]; 2 for free variables
+  double basicScore(double value, double lower, double upper, double dual) {
+    if (lower == -INFINITY && upper == INFINITY) return 2.0;
+    double dist = max(0.0, min(value - lower, upper - value));
+    double sum = dist + fabs(dual);
+    return sum > 0.0 ? dist / sum : 0.0;
+  }
+
+  BasisStatus nearerBound(double value, double lower, double upper) {
+    if (lower == -INFINITY && upper == INFINITY) return BasisStatus::AT_ZERO;
+    if (lower == -INFINITY) return BasisStatus::AT_UPPER;
+    if (upper == INFINITY) return BasisStatus::AT_LOWER;
+    return value - lower <= upper - value ? BasisStatus::AT_LOWER : BasisStatus::AT_UPPER;
+  }
+} // anonymous namespace
+
+SimplexBasis crossoverBasis(const CompactModel& model, const vector<double>& values, const vector<double>& rowDuals,
+                            const vector<double>& reducedCosts) {
+  uint32_t n = model.numCols, m = model.numRows;
+  if (values.size() != n || reducedCosts.size() != n || rowDuals.size() != m) {
+    throw runtime_error("Interior-point solution does not match the model");
+  }
+
+  vector<double> activity(m, 0.0);
+  for (uint32_t i = 0; i < m; ++i) {
+    for (size_t p = model.rows.start[i]; p < model.rows.start[i + 1]; ++p) {
+      activity[i] += model.rows.value[p] * values[model.rows.index[p]];
+    }
+  }
+
+  vector<Candidate> candidates(n + m);
+  for (uint32_t j = 0; j < n; ++j) {
+    candidates[j] = { basicScore(values[j], model.colLower[j], model.colUpper[j], reducedCosts[j]), j };
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    candidates[n + i] = { basicScore(activity[i], model.rowLower[i], model.rowUpper[i], rowDuals[i]), n + i };
+  }
+  auto better = [](const Candidate& a, const Candidate& b) {
+    if (a.score != b.score) return a.score > b.score;
+    return a.var > b.var; // Logicals (the highest indices) first, then later columns
+  };
+  nth_element(candidates.begin(), candidates.begin() + m, candidates.end(), better);
+
+  SimplexBasis basis;
+  basis.columns.resize(n);
+  basis.rows.resize(m);
+  for (uint32_t j = 0; j < n; ++j) basis.columns[j] = nearerBound(values[j], model.colLower[j], model.colUpper[j]);
+  for (uint32_t i = 0; i < m; ++i) basis.rows[i] = nearerBound(activity[i], model.rowLower[i], model.rowUpper[i]);
+  for (uint32_t k = 0; k < m; ++k) {
+    uint32_t var = candidates[k].var;
+    if (var < n) basis.columns[var] = BasisStatus::BASIC;
+    else basis.rows[var - n] = BasisStatus::BASIC;
+  }
+  return basis;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "compact_model.h"
+#include "simplex.h"
+#include <vector>
+
+/**
+ * @brief Guesses an optimal basis from an interior-point solution, as the
+ * start of a crossover (SimplexSolver::crossover(), or a simplex run from
+ * this basis alone), which then ends at an optimal vertex after few pivots.
+ *
+ * Near the optimum, a variable strictly between its bounds is basic and
+ * one at a bound with a nonzero dual is not. Every structural and row
+ * logical is ranked by dist / (dist + |dual|), where dist is its distance
+ * to the nearest bound and dual its reduced cost or row dual; the m best
+ * (m = rows) become basic, logicals first among ties, and the rest
+ * nonbasic at the nearer bound. Free variables rank first. A guess that
+ * is singular is repaired by the simplex's factorization, which swaps
+ * dependent columns for logicals.
+ *
+ * @param values Column values, indexed by column id.
+ * @param rowDuals Row duals, indexed by row id; only magnitudes matter.
+ * @param reducedCosts Column reduced costs, indexed by column id.
+ */
+SimplexBasis crossoverBasis(const CompactModel& model, const std::vector<double>& values,
+                            const std::vector<double>& rowDuals, const std::vector<double>& reducedCosts);
@@ -0,0 +1,73 @@
+#include "input_file.h"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+/*
+ * Function: InputFile
+ * -------------------------
+ * Maps regular files read-only. Anything else (pipes, terminals, stdin
+ * given as "-") is read through a buffered loop instead.
+ */
+InputFile::InputFile(const string& path) {
+  bool isStdin = (path == "-");
+  int fd = isStdin ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw runtime_error("Could not open input file: " + path);
+
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+      data = static_cast<const char*>(p);
+      size = static_cast<size_t>(st.st_size);
+      mapped = true;
+    }
+  }
+
+  if (!mapped) {
+    try {
+      readBuffered(fd);
+    }
+    catch (...) {
+      if (!isStdin) close(fd);
+      throw;
+    }
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  if (!isStdin) close(fd);
+}
+
+InputFile::~InputFile() {
+  if (mapped) munmap(const_cast<char*>(data), size);
+}
+
+/*
+ * Function: readBuffered
+ * -------------------------
+ * Reads the descriptor to EOF in 64 KiB blocks.
+ */
+void InputFile::readBuffered(int fd) {
+  constexpr size_t blockSize = 64 * 1024;
+  size_t used = 0;
+  for (;;) {
+    buffer.resize(used + blockSize);
+    ssize_t n = read(fd, &buffer[used], blockSize);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw runtime_error(string("Could not read input: ") + strerror(errno));
+    }
+    if (n == 0) break;
+    used += static_cast<size_t>(n);
+  }
+  buffer.resize(used);
+  data = buffer.data();
+  size = buffer.size();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * @class InputFile
+ * @brief Read-only view of a model file's bytes.
+ *
+ * Regular files are memory-mapped, so the parser reads straight out of
+ * the page cache without copying line contents. Pipes, character devices
+ * and standard input (path "-") fall back to buffered reads into memory.
+ */
+class InputFile {
+  const char* data = nullptr;
+  size_t size = 0;
+  bool mapped = false;
+  std::string buffer; // Backing storage when the input is not mapped
+
+  void readBuffered(int fd);
+
+public:
+  /**
+   * @brief Opens and maps (or reads) the file at `path`.
+   *
+   * @throws std::runtime_error if the file cannot be opened or read.
+   */
+  explicit InputFile(const std::string& path);
+
+  /**
+   * @brief Unmaps the file, if it was mapped.
+   */
+  ~InputFile();
+
+  InputFile(const InputFile&) = delete;
+  InputFile& operator=(const InputFile&) = delete;
+
+  /**
+   * @brief Returns the file contents. Valid for the lifetime of this object.
+   */
+  std::string_view contents() const { return std::string_view(data, size); }
+
+  /**
+   * @brief True if the contents are served from a memory mapping.
+   */
+  bool isMapped() const { return mapped; }
+};
@@ -0,0 +1,649 @@
+#include "interior_point.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+  constexpr uint32_t NONE = UINT32_MAX;
+  constexpr double STEP_FRACTION = 0.995;   // Share of the step to the boundary that is taken
+  constexpr double PRIMAL_REG = 1e-10;      // Added to 1/D for every column; keeps free columns finite
+  constexpr double DUAL_REG = 1e-10;        // Added to the diagonal of A D A^T
+  constexpr double DIVERGENCE = 1e12;       // Iterates beyond this (scaled) are taken as diverging
+  constexpr double MU_COLLAPSE = 1e-14;     // mu below this share of the starting mu: complementarity is gone
+  constexpr double RAY_TOLERANCE = 1e-6;    // Relative violation allowed in an infeasibility or unboundedness ray
+  constexpr double RAY_BOUND = 100.0;       // A missing bound counts as this multiple of the data in a Farkas ray
+  constexpr double MIN_STEP = 1e-8;         // Steps below this in both spaces count as no progress
+  constexpr uint32_t STALL_LIMIT = 5;       // Iterations without progress before giving up
+
+  // Rounds a scale factor to a power of two, so scaling loses no precision.
+  double powerOfTwo(double s) {
+    return exp2(round(log2(s)));
+  }
+
+  // Largest alpha in [0, 1] keeping v + alpha dv >= 0 over the entries where `has` holds
+  double maxStep(const vector<double>& v, const vector<double>& dv, const vector<char>& has) {
+    double alpha = 1.0;
+    for (size_t j = 0; j < v.size(); ++j) {
+      if (has[j] && dv[j] < 0.0) alpha = min(alpha, -v[j] / dv[j]);
+    }
+    return alpha;
+  }
+
+  double maxAbs(const vector<double>& v) {
+    double r = 0.0;
+    for (double a : v) r = max(r, fabs(a));
+    return r;
+  }
+} // anonymous namespace
+
+const char* ipmStatusName(IpmStatus status) {
+  switch (status) {
+    case IpmStatus::UNSOLVED: return "UNSOLVED";
+    case IpmStatus::OPTIMAL: return "OPTIMAL";
+    case IpmStatus::INFEASIBLE: return "INFEASIBLE";
+    case IpmStatus::UNBOUNDED: return "UNBOUNDED";
+    case IpmStatus::ITERATION_LIMIT: return "ITERATION_LIMIT";
+    case IpmStatus::TIME_LIMIT: return "TIME_LIMIT";
+    case IpmStatus::CANCELLED: return "CANCELLED";
+    case IpmStatus::NUMERICAL_ERROR: return "NUMERICAL_ERROR";
+  }
+  return "UNKNOWN";
+}
+
+/*
+ * Function: loadModel
+ * -------------------------
+ * Builds the bounded form: fixed columns are substituted, empty and free
+ * rows dropped (an empty row whose bounds exclude zero makes the model
+ * infeasible), and each kept inequality row gets a slack with the row's
+ * bounds less the fixed activity. Then scales and analyzes A A^T.
+ */
+void InteriorPointSolver::loadModel(const CompactModel& model) {
+  modelRows = model.numRows;
+  modelCols = model.numCols;
+  maximize = model.type == OptType::MAXIMIZE;
+  objectiveOffset = model.objectiveOffset;
+  boundsInfeasible = false;
+  modelMatrix = model.rows;
+  modelCost = model.objective;
+
+  fixedValue.assign(modelCols, NAN);
+  colOf.clear();
+  vector<uint32_t> keptCol(modelCols, NONE);
+  for (uint32_t j = 0; j < modelCols; ++j) {
+    double lo = model.colLower[j], up = model.colUpper[j];
+    if (lo > up) boundsInfeasible = true;
+    if (lo == up) {
+      fixedValue[j] = lo;
+      objectiveOffset += model.objective[j] * lo;
+    }
+    else {
+      keptCol[j] = static_cast<uint32_t>(colOf.size());
+      colOf.push_back(j);
+    }
+  }
+  nx = static_cast<uint32_t>(colOf.size());
+
+  rowOf.clear();
+  slackRow.clear();
+  rowsA = SparseMatrix();
+  b.clear();
+  vector<double> slackLower, slackUpper;
+  for (uint32_t i = 0; i < modelRows; ++i) {
+    double fixedActivity = 0.0;
+    size_t kept = 0;
+    for (size_t p = model.rows.start[i]; p < model.rows.start[i + 1]; ++p) {
+      uint32_t j = model.rows.index[p];
+      if (keptCol[j] == NONE) fixedActivity += model.rows.value[p] * fixedValue[j];
+      else ++kept;
+    }
+    double lo = model.rowLower[i] - fixedActivity, up = model.rowUpper[i] - fixedActivity;
+    if (lo > up) boundsInfeasible = true;
+    if (kept == 0) {
+      double tolerance = 1e-9 * (1.0 + fabs(fixedActivity));
+      if (lo > tolerance || up < -tolerance) boundsInfeasible = true;
+      continue;
+    }
+    if (lo == -INFINITY && up == INFINITY) continue;
+
+    for (size_t p = model.rows.start[i]; p < model.rows.start[i + 1]; ++p) {
+      uint32_t j = model.rows.index[p];
+      if (keptCol[j] == NONE) continue;
+      rowsA.index.push_back(keptCol[j]);
+      rowsA.value.push_back(model.rows.value[p]);
+    }
+    rowsA.start.push_back(rowsA.index.size());
+    if (lo == up) b.push_back(lo);
+    else {
+      b.push_back(0.0);
+      slackRow.push_back(static_cast<uint32_t>(rowOf.size()));
+      slackLower.push_back(lo);
+      slackUpper.push_back(up);
+    }
+    rowOf.push_back(i);
+  }
+  m = static_cast<uint32_t>(rowOf.size());
+  nv = nx + static_cast<uint32_t>(slackRow.size());
+  colsA = rowsA.transpose(nx);
+
+  double sense = maximize ? -1.0 : 1.0;
+  cost.assign(nv, 0.0);
+  lower.resize(nv);
+  upper.resize(nv);
+  for (uint32_t k = 0; k < nx; ++k) {
+    cost[k] = sense * model.objective[colOf[k]];
+    lower[k] = model.colLower[colOf[k]];
+    upper[k] = model.colUpper[colOf[k]];
+  }
+  for (size_t k = 0; k < slackRow.size(); ++k) {
+    lower[nx + k] = slackLower[k];
+    upper[nx + k] = slackUpper[k];
+  }
+
+  scale();
+  buildNormalPattern();
+  cholesky.analyze(normalPattern);
+  x.clear();
+  y.clear();
+  result = IpmStatus::UNSOLVED;
+  iterationCount = 0;
+}
+
+/*
+ * Function: scale
+ * -------------------------
+ * Geometric scaling as in SimplexSolver::scale. Scaled structural k is
+ * x[k] / colScale[k]; row i and its slack are multiplied by rowScale[i].
+ */
+void InteriorPointSolver::scale() {
+  rowScale.assign(m, 1.0);
+  colScale.assign(nx, 1.0);
+  vector<double> rowMin(m), rowMax(m);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    fill(rowMin.begin(), rowMin.end(), INFINITY);
+    fill(rowMax.begin(), rowMax.end(), 0.0);
+    for (uint32_t j = 0; j < nx; ++j) {
+      for (size_t p = colsA.start[j]; p < colsA.start[j + 1]; ++p) {
+        double a = fabs(colsA.value[p]) * colScale[j];
+        uint32_t i = colsA.index[p];
+        rowMin[i] = min(rowMin[i], a);
+        rowMax[i] = max(rowMax[i], a);
+      }
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      if (rowMax[i] > 0.0) rowScale[i] = powerOfTwo(1.0 / sqrt(rowMin[i] * rowMax[i]));
+    }
+
+    for (uint32_t j = 0; j < nx; ++j) {
+      double colMin = INFINITY, colMax = 0.0;
+      for (size_t p = colsA.start[j]; p < colsA.start[j + 1]; ++p) {
+        double a = fabs(colsA.value[p]) * rowScale[colsA.index[p]];
+        colMin = min(colMin, a);
+        colMax = max(colMax, a);
+      }
+      if (colMax > 0.0) colScale[j] = powerOfTwo(1.0 / sqrt(colMin * colMax));
+    }
+  }
+
+  for (uint32_t j = 0; j < nx; ++j) {
+    for (size_t p = colsA.start[j]; p < colsA.start[j + 1]; ++p) {
+      colsA.value[p] *= rowScale[colsA.index[p]] * colScale[j];
+    }
+    lower[j] /= colScale[j];
+    upper[j] /= colScale[j];
+    cost[j] *= colScale[j];
+  }
+  for (uint32_t i = 0; i < m; ++i) b[i] *= rowScale[i];
+  for (size_t k = 0; k < slackRow.size(); ++k) {
+    lower[nx + k] *= rowScale[slackRow[k]];
+    upper[nx + k] *= rowScale[slackRow[k]];
+  }
+  rowsA = colsA.transpose(m);
+}
+
+/*
+ * Function: buildNormalPattern
+ * -------------------------
+ * Row i of the lower triangle of A A^T holds every row k <= i that shares
+ * a column with row i, and i itself.
+ */
+void InteriorPointSolver::buildNormalPattern() {
+  normalPattern = SparseMatrix();
+  vector<uint32_t> mark(m, NONE);
+  vector<uint32_t> found;
+  for (uint32_t i = 0; i < m; ++i) {
+    found.clear();
+    mark[i] = i;
+    found.push_back(i);
+    for (size_t p = rowsA.start[i]; p < rowsA.start[i + 1]; ++p) {
+      uint32_t j = rowsA.index[p];
+      for (size_t q = colsA.start[j]; q < colsA.start[j + 1]; ++q) {
+        uint32_t k = colsA.index[q];
+        if (k < i && mark[k] != i) {
+          mark[k] = i;
+          found.push_back(k);
+        }
+      }
+    }
+    sort(found.begin(), found.end());
+    normalPattern.index.insert(normalPattern.index.end(), found.begin(), found.end());
+    normalPattern.start.push_back(normalPattern.index.size());
+  }
+  normalPattern.value.assign(normalPattern.index.size(), 0.0);
+}
+
+// out = A v over all variables: the structurals' columns, then -1 per slack
+void InteriorPointSolver::multiply(const vector<double>& v, vector<double>& out) const {
+  out.assign(m, 0.0);
+  for (uint32_t i = 0; i < m; ++i) {
+    double sum = 0.0;
+    for (size_t p = rowsA.start[i]; p < rowsA.start[i + 1]; ++p) sum += rowsA.value[p] * v[rowsA.index[p]];
+    out[i] = sum;
+  }
+  for (size_t k = 0; k < slackRow.size(); ++k) out[slackRow[k]] -= v[nx + k];
+}
+
+// out = A^T w, one entry per variable
+void InteriorPointSolver::multiplyTransposed(const vector<double>& w, vector<double>& out) const {
+  out.assign(nv, 0.0);
+  for (uint32_t j = 0; j < nx; ++j) {
+    double sum = 0.0;
+    for (size_t p = colsA.start[j]; p < colsA.start[j + 1]; ++p) sum += colsA.value[p] * w[colsA.index[p]];
+    out[j] = sum;
+  }
+  for (size_t k = 0; k < slackRow.size(); ++k) out[nx + k] = -w[slackRow[k]];
+}
+
+/*
+ * Function: formNormalMatrix
+ * -------------------------
+ * Values of A diag(d) A^T + regularization * I in the order of
+ * normalPattern. Row i accumulates a_ij d_j a_kj over its columns j into
+ * a dense work vector, which is then gathered along the pattern; rows are
+ * dealt round-robin to the pool's threads.
+ */
+void InteriorPointSolver::formNormalMatrix(const vector<double>& d, double regularization, vector<double>& values,
+                                           ThreadPool* pool) const {
+  values.resize(normalPattern.numNonzeros());
+  vector<double> slackDiagonal(m, 0.0);
+  for (size_t k = 0; k < slackRow.size(); ++k) slackDiagonal[slackRow[k]] = d[nx + k];
+
+  auto formRows = [&](uint32_t first, uint32_t stride) {
+    vector<double> work(m, 0.0);
+    for (uint32_t i = first; i < m; i += stride) {
+      for (size_t p = rowsA.start[i]; p < rowsA.start[i + 1]; ++p) {
+        uint32_t j = rowsA.index[p];
+        double t = rowsA.value[p] * d[j];
+        for (size_t q = colsA.start[j]; q < colsA.start[j + 1]; ++q) {
+          uint32_t k = colsA.index[q];
+          if (k <= i) work[k] += t * colsA.value[q];
+        }
+      }
+      for (size_t p = normalPattern.start[i]; p < normalPattern.start[i + 1]; ++p) {
+        uint32_t k = normalPattern.index[p];
+        values[p] = work[k];
+        work[k] = 0.0;
+      }
+      values[normalPattern.start[i + 1] - 1] += slackDiagonal[i] + regularization; // Diagonal is last
+    }
+  };
+
+  if (pool == nullptr) formRows(0, 1);
+  else {
+    uint32_t threads = pool->size();
+    pool->parallelFor(threads, [&](size_t t) { formRows(static_cast<uint32_t>(t), threads); });
+  }
+}
+
+/*
+ * Function: startingPoint
+ * -------------------------
+ * Mehrotra's starting point: x is the least-norm solution of A x = b and
+ * y, z the least-squares dual estimate, both through one factorization of
+ * A A^T. Bound slacks and duals are then shifted to be positive and
+ * balanced, so that no complementarity product is far from the others.
+ */
+void InteriorPointSolver::startingPoint(ThreadPool* pool) {
+  vector<double> ones(nv, 1.0), values;
+  formNormalMatrix(ones, DUAL_REG, values, pool);
+  cholesky.factor(values, pool);
+
+  vector<double> w = b;
+  cholesky.solve(w);
+  multiplyTransposed(w, x);
+
+  multiply(cost, y);
+  cholesky.solve(y);
+  vector<double> aty;
+  multiplyTransposed(y, aty);
+
+  xl.assign(nv, 0.0);
+  xu.assign(nv, 0.0);
+  zl.assign(nv, 0.0);
+  zu.assign(nv, 0.0);
+  double minSlack = INFINITY, minDual = INFINITY;
+  for (uint32_t j = 0; j < nv; ++j) {
+    bool hasLower = lower[j] > -INFINITY, hasUpper = upper[j] < INFINITY;
+    double z = cost[j] - aty[j];
+    if (hasLower) {
+      xl[j] = x[j] - lower[j];
+      zl[j] = hasUpper ? max(z, 0.0) : z;
+      minSlack = min(minSlack, xl[j]);
+      minDual = min(minDual, zl[j]);
+    }
+    if (hasUpper) {
+      xu[j] = upper[j] - x[j];
+      zu[j] = hasLower ? max(-z, 0.0) : -z;
+      minSlack = min(minSlack, xu[j]);
+      minDual = min(minDual, zu[j]);
+    }
+  }
+  if (minSlack == INFINITY) return; // No bounds at all: nothing to keep positive
+
+  // Keep every slack and dual positive, then balance the products
+  double shiftX = max(-1.5 * minSlack, 0.0), shiftZ = max(-1.5 * minDual, 0.0);
+  double product = 0.0, sumX = 0.0, sumZ = 0.0;
+  for (uint32_t j = 0; j < nv; ++j) {
+    if (lower[j] > -INFINITY) {
+      double s = xl[j] + shiftX, z = zl[j] + shiftZ;
+      product += s * z;
+      sumX += s;
+      sumZ += z;
+    }
+    if (upper[j] < INFINITY) {
+      double s = xu[j] + shiftX, z = zu[j] + shiftZ;
+      product += s * z;
+      sumX += s;
+      sumZ += z;
+    }
+  }
+  double extraX = sumZ > 0.0 ? 0.5 * product / sumZ : 0.0;
+  double extraZ = sumX > 0.0 ? 0.5 * product / sumX : 0.0;
+  shiftX += extraX;
+  shiftZ += extraZ;
+  if (shiftX + minSlack <= 0.0) shiftX = 1.0 - minSlack; // Everything was zero
+  if (shiftZ + minDual <= 0.0) shiftZ = 1.0 - minDual;
+  for (uint32_t j = 0; j < nv; ++j) {
+    if (lower[j] > -INFINITY) {
+      xl[j] += shiftX;
+      zl[j] += shiftZ;
+    }
+    if (upper[j] < INFINITY) {
+      xu[j] += shiftX;
+      zu[j] += shiftZ;
+    }
+  }
+}
+
+/*
+ * Function: solve
+ * -------------------------
+ * Mehrotra predictor-corrector. With residuals rb = b - A x,
+ * rc = c - A^T y - zl + zu, rl = l - x + xl, ru = u - x - xu and
+ * complementarity targets rxl, rxu, the Newton system reduces to
+ *
+ *   (A D A^T) dy = rb - A D (g - rc),  dx = D (A^T dy + g - rc),
+ *   D = (zl / xl + zu / xu)^-1,  g = (rxl + zl rl) / xl + (zu ru - rxu) / xu,
+ *
+ * and the bound slacks and duals follow from dx. The predictor aims at
+ * rxl = -xl zl, the corrector at sigma mu - xl zl - dxl dzl with
+ * sigma = (mu_affine / mu)^3; both share one factorization.
+ */
+IpmStatus InteriorPointSolver::solve() {
+  auto start = chrono::steady_clock::now();
+  iterationCount = 0;
+  if (boundsInfeasible) return result = IpmStatus::INFEASIBLE;
+
+  ThreadPool pool(ThreadPool::resolveThreads(numThreads));
+  ThreadPool* workers = pool.size() > 1 ? &pool : nullptr;
+
+  vector<char> hasLower(nv), hasUpper(nv);
+  size_t numBounds = 0;
+  for (uint32_t j = 0; j < nv; ++j) {
+    hasLower[j] = lower[j] > -INFINITY;
+    hasUpper[j] = upper[j] < INFINITY;
+    numBounds += hasLower[j] + hasUpper[j];
+  }
+  double normB = 1.0 + maxAbs(b), normC = 1.0 + maxAbs(cost);
+  for (uint32_t j = 0; j < nv; ++j) {
+    if (hasLower[j]) normB = max(normB, 1.0 + fabs(lower[j]));
+    if (hasUpper[j]) normB = max(normB, 1.0 + fabs(upper[j]));
+  }
+
+  startingPoint(workers);
+
+  vector<double> rb(m), rc(nv), rl(nv, 0.0), ru(nv, 0.0), d(nv), values, work, aty;
+  vector<double> rxl(nv, 0.0), rxu(nv, 0.0), g(nv), h(nv), rhs;
+  vector<double> dx(nv), dxl(nv, 0.0), dxu(nv, 0.0), dy(m), dzl(nv, 0.0), dzu(nv, 0.0);
+
+  // Newton direction for the targets rxl, rxu with the current factorization
+  auto direction = [&]() {
+    for (uint32_t j = 0; j < nv; ++j) {
+      double gj = 0.0;
+      if (hasLower[j]) gj += (rxl[j] + zl[j] * rl[j]) / xl[j];
+      if (hasUpper[j]) gj += (zu[j] * ru[j] - rxu[j]) / xu[j];
+      g[j] = gj;
+      h[j] = d[j] * (gj - rc[j]);
+    }
+    multiply(h, rhs);
+    for (uint32_t i = 0; i < m; ++i) dy[i] = rb[i] - rhs[i];
+    cholesky.solve(dy);
+    multiplyTransposed(dy, aty);
+    for (uint32_t j = 0; j < nv; ++j) {
+      dx[j] = d[j] * aty[j] + h[j];
+      if (hasLower[j]) {
+        dxl[j] = dx[j] - rl[j];
+        dzl[j] = (rxl[j] - zl[j] * dxl[j]) / xl[j];
+      }
+      if (hasUpper[j]) {
+        dxu[j] = ru[j] - dx[j];
+        dzu[j] = (rxu[j] - zu[j] * dxu[j]) / xu[j];
+      }
+    }
+  };
+
+  // Farkas value of y: b^T y plus the best bound multipliers for t = -A^T y,
+  // l_j t_j where t_j > 0 and u_j t_j where t_j < 0. Every feasible x gives
+  // b^T y = -t^T x <= that sum, so a clearly positive value proves the
+  // primal infeasible whether or not the iterates converged. A missing
+  // bound is taken at RAY_BOUND times the data instead.
+  auto dualRay = [&](double size) {
+    if (size <= 0.0) return false;
+    double value = 0.0;
+    for (uint32_t i = 0; i < m; ++i) value += b[i] * y[i];
+    for (uint32_t j = 0; j < nv; ++j) {
+      double t = -aty[j];
+      bool bounded = t > 0.0 ? hasLower[j] : hasUpper[j];
+      value += bounded ? (t > 0.0 ? lower[j] : upper[j]) * t : -RAY_BOUND * normB * fabs(t);
+    }
+    return value > RAY_TOLERANCE * size * normB;
+  };
+  // Improving ray: A x ~ 0, x in the recession cone of the bounds and
+  // c^T x < 0 (x scaled to size 1), with x large enough against b and the
+  // bounds to stand for its own direction. It proves the LP unbounded only
+  // once the LP is known to be feasible.
+  auto primalRay = [&](double size, double value) {
+    if (size * RAY_TOLERANCE < normB || value >= -RAY_TOLERANCE * size * normC) return false;
+    if (maxAbs(work) > RAY_TOLERANCE * size) return false;
+    for (uint32_t j = 0; j < nv; ++j) {
+      if (hasLower[j] && x[j] < -RAY_TOLERANCE * size) return false;
+      if (hasUpper[j] && x[j] > RAY_TOLERANCE * size) return false;
+    }
+    return true;
+  };
+  // Feasibility of the LP, by the same method on a zero objective, which
+  // cannot be unbounded
+  auto feasibility = [&]() {
+    InteriorPointSolver phase = *this;
+    phase.cost.assign(nv, 0.0);
+    phase.iterationLimit = iterationLimit - min(iterationLimit, iterationCount);
+    phase.timeLimit = timeLimit - chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    IpmStatus status = phase.solve();
+    iterationCount += phase.iterationCount;
+    return status;
+  };
+
+  uint32_t stalled = 0;
+  double startMu = -1.0;
+  while (true) {
+    multiply(x, work);
+    for (uint32_t i = 0; i < m; ++i) rb[i] = b[i] - work[i];
+    multiplyTransposed(y, aty);
+    double primalObjective = 0.0, dualObjective = 0.0, complementarity = 0.0;
+    for (uint32_t i = 0; i < m; ++i) dualObjective += b[i] * y[i];
+    for (uint32_t j = 0; j < nv; ++j) {
+      rc[j] = cost[j] - aty[j] - zl[j] + zu[j];
+      primalObjective += cost[j] * x[j];
+      if (hasLower[j]) {
+        rl[j] = lower[j] - x[j] + xl[j];
+        dualObjective += lower[j] * zl[j];
+        complementarity += xl[j] * zl[j];
+      }
+      if (hasUpper[j]) {
+        ru[j] = upper[j] - x[j] - xu[j];
+        dualObjective -= upper[j] * zu[j];
+        complementarity += xu[j] * zu[j];
+      }
+    }
+    double primalInfeasibility = max(maxAbs(rb), max(maxAbs(rl), maxAbs(ru))) / normB;
+    double dualInfeasibility = maxAbs(rc) / normC;
+    double gap = fabs(primalObjective - dualObjective) / (1.0 + fabs(primalObjective));
+    if (primalInfeasibility <= tolerance && dualInfeasibility <= tolerance && gap <= tolerance) {
+      return result = IpmStatus::OPTIMAL;
+    }
+    if (!isfinite(primalObjective) || !isfinite(dualObjective)) return result = IpmStatus::NUMERICAL_ERROR;
+    // Iterates that diverge, or complementarity that collapsed with the
+    // residuals still open, end the method. Only a ray checked on the
+    // iterates proves infeasibility or unboundedness; a stall with bounded
+    // iterates proves nothing.
+    if (startMu < 0.0) startMu = complementarity;
+    double dualSize = max(maxAbs(y), max(maxAbs(zl), maxAbs(zu))), primalSize = maxAbs(x);
+    if (max(primalSize, dualSize) > DIVERGENCE || (numBounds > 0 && complementarity <= MU_COLLAPSE * startMu)) {
+      if (dualRay(maxAbs(y))) return result = IpmStatus::INFEASIBLE;
+      if (primalRay(primalSize, primalObjective)) {
+        IpmStatus feasible = feasibility();
+        if (feasible == IpmStatus::OPTIMAL) return result = IpmStatus::UNBOUNDED;
+        return result = feasible;
+      }
+      return result = IpmStatus::NUMERICAL_ERROR;
+    }
+    if (iterationCount >= iterationLimit) return result = IpmStatus::ITERATION_LIMIT;
+    if (cancelFlag != nullptr && cancelFlag->load()) return result = IpmStatus::CANCELLED;
+    if (chrono::duration<double>(chrono::steady_clock::now() - start).count() >= timeLimit) {
+      return result = IpmStatus::TIME_LIMIT;
+    }
+
+    for (uint32_t j = 0; j < nv; ++j) {
+      double inverse = PRIMAL_REG;
+      if (hasLower[j]) inverse += zl[j] / xl[j];
+      if (hasUpper[j]) inverse += zu[j] / xu[j];
+      d[j] = 1.0 / inverse;
+    }
+    formNormalMatrix(d, DUAL_REG, values, workers);
+    cholesky.factor(values, workers);
+
+    // Predictor
+    for (uint32_t j = 0; j < nv; ++j) {
+      if (hasLower[j]) rxl[j] = -xl[j] * zl[j];
+      if (hasUpper[j]) rxu[j] = -xu[j] * zu[j];
+    }
+    direction();
+    double alphaPrimal = maxStep(xl, dxl, hasLower), alphaDual = maxStep(zl, dzl, hasLower);
+    alphaPrimal = min(alphaPrimal, maxStep(xu, dxu, hasUpper));
+    alphaDual = min(alphaDual, maxStep(zu, dzu, hasUpper));
+
+    // Corrector, centred on sigma mu
+    if (numBounds > 0) {
+      double mu = complementarity / numBounds, affine = 0.0;
+      for (uint32_t j = 0; j < nv; ++j) {
+        if (hasLower[j]) affine += (xl[j] + alphaPrimal * dxl[j]) * (zl[j] + alphaDual * dzl[j]);
+        if (hasUpper[j]) affine += (xu[j] + alphaPrimal * dxu[j]) * (zu[j] + alphaDual * dzu[j]);
+      }
+      double sigma = pow(affine / numBounds / mu, 3);
+      for (uint32_t j = 0; j < nv; ++j) {
+        if (hasLower[j]) rxl[j] = sigma * mu - xl[j] * zl[j] - dxl[j] * dzl[j];
+        if (hasUpper[j]) rxu[j] = sigma * mu - xu[j] * zu[j] - dxu[j] * dzu[j];
+      }
+      direction();
+      alphaPrimal = min(maxStep(xl, dxl, hasLower), maxStep(xu, dxu, hasUpper));
+      alphaDual = min(maxStep(zl, dzl, hasLower), maxStep(zu, dzu, hasUpper));
+    }
+    alphaPrimal = min(1.0, STEP_FRACTION * alphaPrimal);
+    alphaDual = min(1.0, STEP_FRACTION * alphaDual);
+
+    for (uint32_t j = 0; j < nv; ++j) {
+      x[j] += alphaPrimal * dx[j];
+      if (hasLower[j]) {
+        xl[j] += alphaPrimal * dxl[j];
+        zl[j] += alphaDual * dzl[j];
+      }
+      if (hasUpper[j]) {
+        xu[j] += alphaPrimal * dxu[j];
+        zu[j] += alphaDual * dzu[j];
+      }
+    }
+    for (uint32_t i = 0; i < m; ++i) y[i] += alphaDual * dy[i];
+    ++iterationCount;
+
+    stalled = alphaPrimal < MIN_STEP && alphaDual < MIN_STEP ? stalled + 1 : 0;
+    if (stalled >= STALL_LIMIT) return result = IpmStatus::NUMERICAL_ERROR;
+  }
+}
+
+double InteriorPointSolver::getObjectiveValue() const {
+  if (x.empty()) return NAN;
+  double objective = 0.0;
+  for (uint32_t k = 0; k < nx; ++k) objective += cost[k] * x[k]; // Scaling leaves c x unchanged
+  return (maximize ? -objective : objective) + objectiveOffset;
+}
+
+vector<double> InteriorPointSolver::getVariableValues() const {
+  vector<double> values(modelCols, 0.0);
+  for (uint32_t j = 0; j < modelCols; ++j) {
+    if (!isnan(fixedValue[j])) values[j] = fixedValue[j];
+  }
+  if (x.empty()) return values;
+  for (uint32_t k = 0; k < nx; ++k) values[colOf[k]] = x[k] * colScale[k];
+  return values;
+}
+
+vector<double> InteriorPointSolver::getRowActivities() const {
+  vector<double> values = getVariableValues(), activities(modelRows, 0.0);
+  for (uint32_t i = 0; i < modelRows; ++i) {
+    double sum = 0.0;
+    for (size_t p = modelMatrix.start[i]; p < modelMatrix.start[i + 1]; ++p) {
+      sum += modelMatrix.value[p] * values[modelMatrix.index[p]];
+    }
+    activities[i] = sum;
+  }
+  return activities;
+}
+
+vector<double> InteriorPointSolver::getRowDuals() const {
+  vector<double> duals(modelRows, 0.0);
+  if (y.empty()) return duals;
+  double sense = maximize ? -1.0 : 1.0;
+  for (uint32_t i = 0; i < m; ++i) duals[rowOf[i]] = sense * y[i] * rowScale[i];
+  return duals;
+}
+
+/*
+ * Function: getReducedCosts
+ * -------------------------
+ * c_j - A_j^T y in the model's terms, which also covers the fixed columns
+ * the method never saw.
+ */
+vector<double> InteriorPointSolver::getReducedCosts() const {
+  vector<double> duals = getRowDuals(), reduced = modelCost;
+  for (uint32_t i = 0; i < modelRows; ++i) {
+    if (duals[i] == 0.0) continue;
+    for (size_t p = modelMatrix.start[i]; p < modelMatrix.start[i + 1]; ++p) {
+      reduced[modelMatrix.index[p]] -= modelMatrix.value[p] * duals[i];
+    }
+  }
+  return reduced;
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "compact_model.h"
+#include "sparse_cholesky.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Outcome of an InteriorPointSolver run.
+ */
+enum class IpmStatus {
+  UNSOLVED,        // solve() has not run
+  OPTIMAL,         // Primal and dual feasible with a small gap
+  INFEASIBLE,      // The dual iterates give a Farkas ray: no primal feasible point
+  UNBOUNDED,       // The primal iterates give an improving ray and the LP is feasible
+  ITERATION_LIMIT, // Stopped at the iteration limit
+  TIME_LIMIT,      // Stopped at the time limit
+  CANCELLED,       // The cancel flag was raised
+  NUMERICAL_ERROR  // No progress, or iterates that stall or diverge without a ray
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "OPTIMAL".
+ */
+const char* ipmStatusName(IpmStatus status);
+
+/**
+ * @class InteriorPointSolver
+ * @brief Native primal-dual interior-point (barrier) method for LPs.
+ *
+ * Mehrotra's predictor-corrector on the bounded form A x = b with
+ * l <= x <= u: every inequality row gets a slack column -e_i carrying the
+ * row bounds, equality rows keep their right-hand side, fixed columns are
+ * moved into b, and empty or free rows are dropped. The matrix is scaled
+ * as in SimplexSolver. Iterates may start infeasible; the method stops
+ * when the relative primal and dual residuals and the relative duality
+ * gap all fall below the tolerance.
+ *
+ * Each iteration solves the normal equations A D A^T dy = r twice with one
+ * factorization (SparseCholesky, analyzed once per model). The matrix is
+ * formed row by row in parallel, and the factorization runs on the same
+ * pool. Free columns get a small primal regularization and the normal
+ * matrix a small dual one, which keeps it positive definite.
+ *
+ * When the iterates diverge or complementarity collapses before the
+ * residuals close, the iterates are checked for a ray: a Farkas ray in y
+ * proves infeasibility, and an improving ray in x proves unboundedness
+ * once a second run on a zero objective has found a feasible point.
+ * Without a ray the result is NUMERICAL_ERROR. Integrality is ignored. A
+ * dense column of A makes A D A^T dense, since no special handling is done.
+ */
+class InteriorPointSolver {
+  uint32_t modelRows = 0;
+  uint32_t modelCols = 0;
+  bool maximize = false;
+  double objectiveOffset = 0.0; // Objective constant plus the cost of the fixed columns
+  bool boundsInfeasible = false; // Crossed bounds or an empty row that cannot hold
+
+  uint32_t m = 0;                    // Rows kept
+  uint32_t nx = 0;                   // Structural columns kept (not fixed)
+  uint32_t nv = 0;                   // Variables: nx structurals, then one slack per inequality row
+  std::vector<uint32_t> rowOf;       // Kept row -> model row
+  std::vector<uint32_t> colOf;       // Kept structural -> model column
+  std::vector<uint32_t> slackRow;    // Slack nx + k -> kept row
+  std::vector<double> fixedValue;    // Per model column: its value if fixed, NaN otherwise
+  SparseMatrix modelMatrix;          // A of the model as loaded, for activities and reduced costs
+  std::vector<double> modelCost;     // Objective of the model as loaded
+  SparseMatrix rowsA;                // Scaled A, kept rows x kept structurals, row-major
+  SparseMatrix colsA;                // The same, column-major
+  std::vector<double> rowScale;      // Per kept row
+  std::vector<double> colScale;      // Per kept structural
+  std::vector<double> b;             // Per kept row, scaled
+  std::vector<double> cost;          // Per variable, scaled, minimized
+  std::vector<double> lower;         // Per variable, scaled
+  std::vector<double> upper;         // Per variable, scaled
+
+  SparseMatrix normalPattern;        // Lower triangle of A A^T by rows
+  SparseCholesky cholesky;
+
+  // Iterate: x - xl = l, x + xu = u, A^T y + zl - zu = c (scaled)
+  std::vector<double> x, xl, xu, y, zl, zu;
+
+  IpmStatus result = IpmStatus::UNSOLVED;
+  uint64_t iterationCount = 0;
+  uint64_t iterationLimit = 200;
+  double timeLimit = INFINITY;
+  double tolerance = 1e-8;
+  unsigned numThreads = 0;
+  const std::atomic<bool>* cancelFlag = nullptr;
+
+  void scale();
+  void buildNormalPattern();
+  void multiply(const std::vector<double>& v, std::vector<double>& out) const;
+  void multiplyTransposed(const std::vector<double>& w, std::vector<double>& out) const;
+  void formNormalMatrix(const std::vector<double>& d, double regularization, std::vector<double>& values,
+                        ThreadPool* pool) const;
+  void startingPoint(ThreadPool* pool);
+
+public:
+  /**
+   * @brief Loads a CompactModel (copied, reduced and scaled internally).
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Runs the method from a fresh starting point.
+   *
+   * @return The final status, also available from status().
+   */
+  IpmStatus solve();
+
+  /**
+   * @brief Objective value of the final iterate, in the model's sense and
+   * including the objective constant.
+   */
+  double getObjectiveValue() const;
+
+  /**
+   * @brief Values of the structural variables, indexed by column id.
+   */
+  std::vector<double> getVariableValues() const;
+
+  /**
+   * @brief Row activities A x, indexed by row id.
+   */
+  std::vector<double> getRowActivities() const;
+
+  /**
+   * @brief Dual values of the rows, indexed by row id (0 for dropped rows),
+   * in the model's sense: d(objective) / d(row bound).
+   */
+  std::vector<double> getRowDuals() const;
+
+  /**
+   * @brief Reduced costs of the structural columns, indexed by column id,
+   * in the model's sense.
+   */
+  std::vector<double> getReducedCosts() const;
+
+  /**
+   * @brief Status of the last solve().
+   */
+  IpmStatus status() const { return result; }
+
+  /**
+   * @brief Interior-point iterations of the last solve().
+   */
+  uint64_t iterations() const { return iterationCount; }
+
+  /**
+   * @brief Threads for forming and factoring the normal equations
+   * (0 = one per hardware thread).
+   */
+  void setThreads(unsigned threads) { numThreads = threads; }
+
+  /**
+   * @brief Caps the iterations per solve() (default 200).
+   */
+  void setIterationLimit(uint64_t limit) { iterationLimit = limit; }
+
+  /**
+   * @brief Wall-clock seconds per solve(), checked once per iteration.
+   */
+  void setTimeLimit(double seconds) { timeLimit = seconds; }
+
+  /**
+   * @brief Relative residual and gap tolerance (default 1e-8).
+   */
+  void setTolerance(double value) { tolerance = value; }
+
+  /**
+   * @brief solve() stops at the next iteration once `*flag` is true; null
+   * detaches the flag.
+   */
+  void setCancelFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+
+  /**
+   * @brief Size of the Cholesky factor and its supernode count, for reports.
+   */
+  size_t factorNonzeros() const { return cholesky.factorNonzeros(); }
+  uint32_t supernodes() const { return cholesky.supernodes(); }
+};
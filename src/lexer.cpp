@@ -0,0 +1,162 @@
+#include "lexer.h"
+#include <charconv>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+  bool isAlpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+  }
+
+  bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  // Characters CPLEX allows in names besides letters and digits.
+  bool isCplexNameSymbol(char c) {
+    return c != '\0' && strchr("!\"#$%&()/,.;?@_`'{}|~", c) != nullptr;
+  }
+} // anonymous namespace
+
+bool Lexer::isIdentStart(char c) const {
+  if (isAlpha(c)) return true;
+  return dialect == LexerDialect::CPLEX_LP && c != '.' && isCplexNameSymbol(c);
+}
+
+bool Lexer::isIdentChar(char c) const {
+  if (isAlpha(c) || isDigit(c)) return true;
+  return dialect == LexerDialect::CPLEX_LP && isCplexNameSymbol(c);
+}
+
+Token Lexer::make(TokenKind kind, size_t start, size_t length, int tokenLine, bool tokenLineStart) {
+  Token tok;
+  tok.kind = kind;
+  tok.text = input.substr(start, length);
+  tok.line = tokenLine;
+  tok.lineStart = tokenLineStart;
+  return tok;
+}
+
+/*
+ * Function: scan
+ * -------------------------
+ * Reads one token starting at the current position.
+ *
+ * Numbers are "\d*\.?\d*" with at least one digit, optionally followed by
+ * an exponent. The exponent is only taken when it is not itself the start
+ * of an identifier, so "2e3x" still lexes as 2 followed by "e3x".
+ */
+Token Lexer::scan() {
+  for (;;) {
+    while (pos < input.size() && isBlank(input[pos])) ++pos;
+    if (pos >= input.size()) break;
+    if (input[pos] == '\n') {
+      ++pos;
+      ++line;
+      atLineStart = true;
+    }
+    else if (dialect == LexerDialect::CPLEX_LP && input[pos] == '\\') {
+      while (pos < input.size() && input[pos] != '\n') ++pos;
+    }
+    else {
+      break;
+    }
+  }
+
+  int tokenLine = line;
+  bool tokenLineStart = atLineStart;
+  atLineStart = false;
+  if (pos >= input.size()) return make(TokenKind::END, pos, 0, tokenLine, tokenLineStart);
+
+  size_t start = pos;
+  char c = input[pos];
+
+  if (isIdentStart(c)) {
+    while (pos < input.size() && isIdentChar(input[pos])) ++pos;
+    size_t length = pos - start;
+
+    size_t colon = pos;
+    if (dialect == LexerDialect::CPLEX_LP) {
+      while (colon < input.size() && isBlank(input[colon])) ++colon;
+    }
+    if (colon < input.size() && input[colon] == ':') {
+      pos = colon + 1;
+      return make(TokenKind::SECTION, start, length, tokenLine, tokenLineStart);
+    }
+    return make(TokenKind::IDENTIFIER, start, length, tokenLine, tokenLineStart);
+  }
+
+  if (isDigit(c) || c == '.') {
+    size_t digits = 0;
+    while (pos < input.size() && isDigit(input[pos])) { ++pos; ++digits; }
+    if (pos < input.size() && input[pos] == '.') {
+      ++pos;
+      while (pos < input.size() && isDigit(input[pos])) { ++pos; ++digits; }
+    }
+    if (digits == 0) return make(TokenKind::INVALID, start, pos - start, tokenLine, tokenLineStart);
+
+    if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+      size_t exp = pos + 1;
+      if (exp < input.size() && (input[exp] == '+' || input[exp] == '-')) ++exp;
+      if (exp < input.size() && isDigit(input[exp])) {
+        while (exp < input.size() && isDigit(input[exp])) ++exp;
+        if (exp >= input.size() || !isIdentChar(input[exp])) pos = exp;
+      }
+    }
+
+    Token tok = make(TokenKind::NUMBER, start, pos - start, tokenLine, tokenLineStart);
+    auto result = from_chars(tok.text.data(), tok.text.data() + tok.text.size(), tok.number);
+    if (result.ec != errc() || result.ptr != tok.text.data() + tok.text.size()) {
+      tok.kind = TokenKind::INVALID;
+    }
+    return tok;
+  }
+
+  ++pos;
+  bool cplex = dialect == LexerDialect::CPLEX_LP;
+  bool nextIsEqual = pos < input.size() && input[pos] == '=';
+  switch (c) {
+    case '+': return make(TokenKind::PLUS, start, 1, tokenLine, tokenLineStart);
+    case '-': return make(TokenKind::MINUS, start, 1, tokenLine, tokenLineStart);
+    case ',':
+      if (!cplex) return make(TokenKind::COMMA, start, 1, tokenLine, tokenLineStart);
+      break;
+    case '=':
+      if (cplex && pos < input.size() && (input[pos] == '<' || input[pos] == '>')) {
+        ++pos;
+        return make(input[pos - 1] == '<' ? TokenKind::LESS_EQUAL : TokenKind::GREATER_EQUAL,
+                    start, 2, tokenLine, tokenLineStart);
+      }
+      return make(TokenKind::EQUAL, start, 1, tokenLine, tokenLineStart);
+    case '<':
+    case '>':
+      if (nextIsEqual || cplex) {
+        if (nextIsEqual) ++pos;
+        return make(c == '<' ? TokenKind::LESS_EQUAL : TokenKind::GREATER_EQUAL,
+                    start, pos - start, tokenLine, tokenLineStart);
+      }
+      break;
+  }
+  return make(TokenKind::INVALID, start, pos - start, tokenLine, tokenLineStart);
+}
+
+Token Lexer::next() {
+  if (hasPeeked) {
+    hasPeeked = false;
+    return peeked;
+  }
+  return scan();
+}
+
+const Token& Lexer::peek() {
+  if (!hasPeeked) {
+    peeked = scan();
+    hasPeeked = true;
+  }
+  return peeked;
+}
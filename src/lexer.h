@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string_view>
+
+/**
+ * @brief Kinds of tokens produced by the Lexer.
+ */
+enum class TokenKind {
+  END,           // End of input
+  NUMBER,        // Unsigned numeric literal, e.g. 3, 2.5, .5, 1e6
+  IDENTIFIER,    // Variable name: [a-zA-Z_][a-zA-Z0-9_]* (wider in CPLEX LP)
+  SECTION,       // Identifier immediately followed by ':', e.g. "Bounds:"
+  PLUS,          // +
+  MINUS,         // -
+  LESS_EQUAL,    // <= (also =< and < in CPLEX LP)
+  GREATER_EQUAL, // >= (also => and > in CPLEX LP)
+  EQUAL,         // =
+  COMMA,         // , (custom format only; part of names in CPLEX LP)
+  INVALID        // Any character the grammar does not accept
+};
+
+/**
+ * @brief Input dialects understood by the Lexer.
+ *
+ * CPLEX_LP widens the identifier character set to CPLEX's, accepts the
+ * extra operator spellings, skips '\' comments, allows blanks before the
+ * ':' of a label, and tracks line numbers across newlines.
+ */
+enum class LexerDialect { CUSTOM, CPLEX_LP };
+
+/**
+ * @brief A single token. `text` is a view into the lexer's input.
+ */
+struct Token {
+  TokenKind kind = TokenKind::END;
+  std::string_view text;
+  double number = 0.0;    // Parsed value, valid when kind == NUMBER
+  int line = 0;           // Line the token starts on
+  bool lineStart = false; // First token on its line
+};
+
+/**
+ * @class Lexer
+ * @brief Hand-written single-pass tokenizer for the LP text formats.
+ *
+ * Walks the input once, character by character, and returns tokens as
+ * views into the input. No regular expressions and no heap allocation.
+ */
+class Lexer {
+  std::string_view input;
+  LexerDialect dialect;
+  size_t pos = 0;
+  int line;
+  bool atLineStart = true;
+  bool hasPeeked = false;
+  Token peeked;
+
+  Token scan();
+  Token make(TokenKind kind, size_t start, size_t length, int tokenLine, bool tokenLineStart);
+  bool isIdentStart(char c) const;
+  bool isIdentChar(char c) const;
+
+public:
+  /**
+   * @brief Creates a lexer over `input` (one line for the custom format,
+   * a whole file for CPLEX LP) whose first line is `firstLine`.
+   */
+  explicit Lexer(std::string_view input, LexerDialect dialect = LexerDialect::CUSTOM, int firstLine = 1)
+    : input(input), dialect(dialect), line(firstLine) {}
+
+  /**
+   * @brief Returns the next token and advances past it.
+   */
+  Token next();
+
+  /**
+   * @brief Returns the next token without consuming it.
+   */
+  const Token& peek();
+};
@@ -0,0 +1,388 @@
+#include "lp_format.h"
+#include "input_file.h"
+#include "lexer.h"
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+  runtime_error lineError(int line, const string& message) {
+    return runtime_error("Line " + to_string(line) + ": " + message);
+  }
+
+  bool equalsIgnoreCase(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+      char x = a[i], y = b[i];
+      if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+      if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+      if (x != y) return false;
+    }
+    return true;
+  }
+
+  bool matchesAny(string_view word, initializer_list<string_view> options) {
+    for (string_view option : options) {
+      if (equalsIgnoreCase(word, option)) return true;
+    }
+    return false;
+  }
+
+  enum Keyword { NOT_KEYWORD, MAXIMIZE, MINIMIZE, SUBJECT_TO, BOUNDS, GENERAL, BINARY, SEMI_CONTINUOUS, SOS, END };
+
+  // Values at or beyond this magnitude are infinite, as in CPLEX.
+  constexpr double LP_INFINITY = 1e30;
+
+  /*
+   * Class: LpFileParser
+   * -------------------------
+   * Recursive-descent parser over one Lexer token stream for the whole
+   * file. Keywords are only recognised as the first token on a line.
+   */
+  class LpFileParser {
+    Lexer lex;
+    LPModel& model;
+    vector<string_view> labels; // Per constraint; empty if unnamed
+
+  public:
+    LpFileParser(string_view text, LPModel& model)
+      : lex(text, LexerDialect::CPLEX_LP), model(model) {}
+
+    void parse();
+
+  private:
+    Keyword keyword(const Token& tok) const;
+    Keyword peekKeyword() { return keyword(lex.peek()); }
+    void consumeKeyword();
+    uint32_t column(string_view name);
+    double parseBoundValue();
+    bool parseExpression(vector<Term>& terms, double& constant, bool stopAtLabel);
+    void parseObjective();
+    void parseConstraints();
+    void parseBounds();
+    void parseVariableList(VarType type);
+    void assignConstraintNames();
+  };
+
+  Keyword LpFileParser::keyword(const Token& tok) const {
+    if (!tok.lineStart || tok.kind != TokenKind::IDENTIFIER) return NOT_KEYWORD;
+    string_view w = tok.text;
+    if (matchesAny(w, { "max", "maximize", "maximise", "maximum" })) return MAXIMIZE;
+    if (matchesAny(w, { "min", "minimize", "minimise", "minimum" })) return MINIMIZE;
+    if (matchesAny(w, { "subject", "such", "st", "s.t." })) return SUBJECT_TO;
+    if (matchesAny(w, { "bound", "bounds" })) return BOUNDS;
+    if (matchesAny(w, { "general", "generals", "gen", "integer", "integers" })) return GENERAL;
+    if (matchesAny(w, { "binary", "binaries", "bin" })) return BINARY;
+    if (matchesAny(w, { "semi", "semis", "semi-continuous" })) return SEMI_CONTINUOUS;
+    if (matchesAny(w, { "sos" })) return SOS;
+    if (matchesAny(w, { "end" })) return END;
+    return NOT_KEYWORD;
+  }
+
+  // Consumes a keyword, including the second word of "subject to" / "such that".
+  void LpFileParser::consumeKeyword() {
+    Token tok = lex.next();
+    bool twoWords = equalsIgnoreCase(tok.text, "subject") || equalsIgnoreCase(tok.text, "such");
+    if (twoWords) {
+      Token second = lex.next();
+      string_view expected = equalsIgnoreCase(tok.text, "subject") ? "to" : "that";
+      if (second.kind != TokenKind::IDENTIFIER || !equalsIgnoreCase(second.text, expected)) {
+        throw lineError(tok.line, "Expected '" + string(tok.text) + " " + string(expected) + "'");
+      }
+    }
+  }
+
+  // Interns a variable; new variables get CPLEX's default bounds [0, +inf).
+  uint32_t LpFileParser::column(string_view name) {
+    size_t before = model.bounds.size();
+    uint32_t id = model.column(name);
+    if (model.bounds.size() != before) model.bounds[id].lower = 0.0;
+    return id;
+  }
+
+  /*
+   * Function: parseExpression
+   * -------------------------
+   * Parses "[sign] [coef] [name]" terms across lines until an operator, a
+   * keyword, the end of input or (if stopAtLabel) the next "name:" label.
+   * Terms without a variable accumulate into `constant`.
+   * Returns false if no term was read.
+   */
+  bool LpFileParser::parseExpression(vector<Term>& terms, double& constant, bool stopAtLabel) {
+    bool any = false;
+    for (;;) {
+      const Token& tok = lex.peek();
+      if (tok.kind == TokenKind::END || tok.kind == TokenKind::LESS_EQUAL ||
+          tok.kind == TokenKind::GREATER_EQUAL || tok.kind == TokenKind::EQUAL) {
+        return any;
+      }
+      if (tok.kind == TokenKind::SECTION && stopAtLabel) return any;
+      if (keyword(tok) != NOT_KEYWORD) return any;
+
+      int line = tok.line;
+      double coeff = 1.0;
+      bool hasSign = false;
+      while (lex.peek().kind == TokenKind::PLUS || lex.peek().kind == TokenKind::MINUS) {
+        if (lex.next().kind == TokenKind::MINUS) coeff = -coeff;
+        hasSign = true;
+      }
+
+      bool hasNumber = false;
+      if (lex.peek().kind == TokenKind::NUMBER) {
+        coeff *= lex.next().number;
+        hasNumber = true;
+      }
+
+      const Token& name = lex.peek();
+      if (name.kind == TokenKind::IDENTIFIER && keyword(name) == NOT_KEYWORD) {
+        terms.push_back(Term{ coeff, column(lex.next().text) });
+      }
+      else if (hasNumber) {
+        constant += coeff;
+      }
+      else if (name.kind == TokenKind::INVALID && name.text == "[") {
+        throw lineError(name.line, "Quadratic terms are not supported.");
+      }
+      else {
+        string found = name.kind == TokenKind::END ? "end of input" : "'" + string(name.text) + "'";
+        throw lineError(hasSign ? name.line : line, "Expected a term but found " + found);
+      }
+      any = true;
+    }
+  }
+
+  void LpFileParser::parseObjective() {
+    if (lex.peek().kind == TokenKind::SECTION) lex.next(); // Objective name
+    int line = lex.peek().line;
+    vector<Term> terms;
+    double constant = 0.0;
+    parseExpression(terms, constant, false);
+    model.objective = LinearExpression{ terms, constant, RelOp::EQUAL, line };
+  }
+
+  void LpFileParser::parseConstraints() {
+    while (lex.peek().kind != TokenKind::END && peekKeyword() == NOT_KEYWORD) {
+      string_view label;
+      if (lex.peek().kind == TokenKind::SECTION) label = lex.next().text;
+      int line = lex.peek().line;
+
+      vector<Term> terms;
+      double constant = 0.0;
+      if (!parseExpression(terms, constant, true)) {
+        throw lineError(line, "Constraint has no terms.");
+      }
+
+      RelOp op;
+      Token opTok = lex.next();
+      switch (opTok.kind) {
+        case TokenKind::LESS_EQUAL:    op = RelOp::LESS_EQUAL;    break;
+        case TokenKind::GREATER_EQUAL: op = RelOp::GREATER_EQUAL; break;
+        case TokenKind::EQUAL:         op = RelOp::EQUAL;         break;
+        default: throw lineError(opTok.line, "Expected a comparison operator.");
+      }
+
+      double sign = 1.0;
+      while (lex.peek().kind == TokenKind::PLUS || lex.peek().kind == TokenKind::MINUS) {
+        if (lex.next().kind == TokenKind::MINUS) sign = -sign;
+      }
+      Token rhs = lex.next();
+      if (rhs.kind != TokenKind::NUMBER) {
+        throw lineError(rhs.line, "Expected a number on the right-hand side.");
+      }
+
+      // Constants written on the left move to the right-hand side
+      model.constraints.push_back(LinearExpression{ terms, sign * rhs.number - constant, op, line });
+      labels.push_back(label);
+    }
+  }
+
+  double LpFileParser::parseBoundValue() {
+    double sign = 1.0;
+    while (lex.peek().kind == TokenKind::PLUS || lex.peek().kind == TokenKind::MINUS) {
+      if (lex.next().kind == TokenKind::MINUS) sign = -sign;
+    }
+    Token tok = lex.next();
+    if (tok.kind == TokenKind::IDENTIFIER && matchesAny(tok.text, { "inf", "infinity" })) {
+      return sign * INFINITY;
+    }
+    if (tok.kind != TokenKind::NUMBER) {
+      throw lineError(tok.line, "Expected a bound value but found '" + string(tok.text) + "'");
+    }
+    return tok.number >= LP_INFINITY ? sign * INFINITY : sign * tok.number;
+  }
+
+  /*
+   * Function: parseBounds
+   * -------------------------
+   * Accepts "x op v", "v op x", "v1 op x op v2" and "x free".
+   */
+  void LpFileParser::parseBounds() {
+    auto isOp = [](TokenKind k) {
+      return k == TokenKind::LESS_EQUAL || k == TokenKind::GREATER_EQUAL || k == TokenKind::EQUAL;
+    };
+
+    while (lex.peek().kind != TokenKind::END && peekKeyword() == NOT_KEYWORD) {
+      const Token& first = lex.peek();
+      bool startsWithName = first.kind == TokenKind::IDENTIFIER && !matchesAny(first.text, { "inf", "infinity" });
+
+      if (startsWithName) {
+        Token var = lex.next();
+        uint32_t col = column(var.text);
+        Bound& b = model.bounds[col];
+        Token op = lex.next();
+        if (op.kind == TokenKind::IDENTIFIER && equalsIgnoreCase(op.text, "free")) {
+          b.lower = -INFINITY;
+          b.upper = INFINITY;
+          continue;
+        }
+        if (!isOp(op.kind)) throw lineError(op.line, "Invalid bound format.");
+        double v = parseBoundValue();
+        if (op.kind == TokenKind::LESS_EQUAL) b.upper = v;
+        else if (op.kind == TokenKind::GREATER_EQUAL) b.lower = v;
+        else b.lower = b.upper = v;
+        continue;
+      }
+
+      int line = first.line;
+      double v = parseBoundValue();
+      Token op = lex.next();
+      Token var = lex.next();
+      if (!isOp(op.kind) || var.kind != TokenKind::IDENTIFIER) throw lineError(line, "Invalid bound format.");
+      uint32_t col = column(var.text);
+      Bound& b = model.bounds[col];
+      if (op.kind == TokenKind::LESS_EQUAL) b.lower = v;
+      else if (op.kind == TokenKind::GREATER_EQUAL) b.upper = v;
+      else b.lower = b.upper = v;
+
+      if (isOp(lex.peek().kind)) {
+        Token op2 = lex.next();
+        double v2 = parseBoundValue();
+        if (op2.kind == TokenKind::LESS_EQUAL) b.upper = v2;
+        else if (op2.kind == TokenKind::GREATER_EQUAL) b.lower = v2;
+        else throw lineError(op2.line, "Invalid bound format.");
+      }
+    }
+  }
+
+  void LpFileParser::parseVariableList(VarType type) {
+    while (lex.peek().kind != TokenKind::END && peekKeyword() == NOT_KEYWORD) {
+      Token var = lex.next();
+      if (var.kind != TokenKind::IDENTIFIER) {
+        throw lineError(var.line, "Invalid variable name: '" + string(var.text) + "'");
+      }
+      uint32_t col = column(var.text);
+      Bound& b = model.bounds[col];
+      b.type = type;
+      if (type == VarType::BINARY) {
+        b.lower = 0;
+        b.upper = 1;
+      }
+    }
+  }
+
+  /*
+   * Function: assignConstraintNames
+   * -------------------------
+   * Keeps the labels from the file. Unnamed constraints get "c<i+1>",
+   * suffixed with '_' until it clashes with no other name.
+   */
+  void LpFileParser::assignConstraintNames() {
+    SymbolTable given;
+    for (size_t i = 0; i < labels.size(); ++i) {
+      if (labels[i].empty()) continue;
+      if (given.find(labels[i]) != SymbolTable::NOT_FOUND) {
+        throw lineError(model.constraints[i].lineNumber, "Duplicate constraint name '" + string(labels[i]) + "'");
+      }
+      given.intern(labels[i]);
+    }
+    if (given.size() == 0) return;
+
+    for (size_t i = 0; i < labels.size(); ++i) {
+      if (!labels[i].empty()) {
+        model.constraintNames.intern(labels[i]);
+        continue;
+      }
+      string name = "c" + to_string(i + 1);
+      while (given.find(name) != SymbolTable::NOT_FOUND || model.constraintNames.find(name) != SymbolTable::NOT_FOUND) {
+        name += "_";
+      }
+      model.constraintNames.intern(name);
+    }
+  }
+
+  void LpFileParser::parse() {
+    Keyword sense = peekKeyword();
+    if (sense != MAXIMIZE && sense != MINIMIZE) {
+      throw lineError(lex.peek().line, "Expected 'Maximize' or 'Minimize'.");
+    }
+    consumeKeyword();
+    model.type = (sense == MAXIMIZE) ? OptType::MAXIMIZE : OptType::MINIMIZE;
+    parseObjective();
+
+    bool constraintsSeen = false;
+    while (lex.peek().kind != TokenKind::END) {
+      Token tok = lex.peek();
+      Keyword kw = keyword(tok);
+      switch (kw) {
+        case SUBJECT_TO:
+          if (constraintsSeen) throw lineError(tok.line, "Duplicate constraints section.");
+          constraintsSeen = true;
+          consumeKeyword();
+          parseConstraints();
+          break;
+        case BOUNDS:
+          consumeKeyword();
+          parseBounds();
+          break;
+        case GENERAL:
+          consumeKeyword();
+          parseVariableList(VarType::INTEGER);
+          break;
+        case BINARY:
+          consumeKeyword();
+          parseVariableList(VarType::BINARY);
+          break;
+        case END:
+          assignConstraintNames();
+          return;
+        case MAXIMIZE:
+        case MINIMIZE:
+          throw lineError(tok.line, "Duplicate optimization type.");
+        case SEMI_CONTINUOUS:
+        case SOS:
+          throw lineError(tok.line, "Section '" + string(tok.text) + "' is not supported.");
+        case NOT_KEYWORD:
+          throw lineError(tok.line, "Unexpected '" + string(tok.text) + "'.");
+      }
+    }
+    assignConstraintNames();
+  }
+} // anonymous namespace
+
+/*
+ * Function: readFile
+ * -------------------------
+ * Maps the file and parses it in place. See readBuffer.
+ */
+LPModel CplexLpReader::readFile(const string& path) {
+  InputFile file(path);
+  return readBuffer(file.contents());
+}
+
+/*
+ * Function: readBuffer
+ * -------------------------
+ * Parses CPLEX LP text with one Lexer pass over the whole buffer.
+ *
+ * Returns:
+ *   An LPModel with constraint names when the file names any constraint.
+ *
+ * Throws:
+ *   runtime_error on invalid format or unsupported features.
+ */
+LPModel CplexLpReader::readBuffer(string_view text) {
+  LPModel model;
+  LpFileParser(text, model).parse();
+  return model;
+}
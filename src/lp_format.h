@@ -0,0 +1,33 @@
+#pragma once
+
+#include "parser.h"
+#include <string>
+#include <string_view>
+
+/**
+ * @class CplexLpReader
+ * @brief Reader for the CPLEX LP file format, producing the same LPModel
+ * as Parser::parseFile.
+ *
+ * Supports objective sense keywords (Maximize/Minimize and variants), an
+ * optional objective name and constant, "Subject To" with named or
+ * unnamed constraints spanning any number of lines, Bounds (including
+ * "free", infinite values and double-sided bounds), General/Integers and
+ * Binary/Binaries sections, '\' comments and End. Variables default to
+ * [0, +inf) as in CPLEX. Quadratic terms, SOS, semi-continuous variables
+ * and indicator constraints are rejected with a line-numbered error.
+ */
+class CplexLpReader {
+public:
+  /**
+   * @brief Reads a CPLEX LP file ('-' reads stdin).
+   *
+   * @throws std::runtime_error with a "Line N: ..." message on malformed input.
+   */
+  static LPModel readFile(const std::string& path);
+
+  /**
+   * @brief Reads CPLEX LP text held in memory.
+   */
+  static LPModel readBuffer(std::string_view text);
+};
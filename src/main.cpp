@@ -1,36 +1,237 @@
-#include "parser.h"
+#include "pipeline.h"
+#include "compact_model.h"
+#include "mps.h"
+#include "snapshot.h"
 #include "solver.h"
+#include "solve_server.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <csignal>
 #include <cstring>
+#include <cstdlib>
 
 #include <inttypes.h>
 
+/**
+ * @brief Reads the input model through the snapshot at `snapshotPath`.
+ *
+ * The snapshot is used if it was built from the input file as it is now;
+ * otherwise (missing, stale or corrupt) the input is parsed and the
+ * snapshot rewritten for the next run.
+ */
+CompactModel readModelCached(const std::string& path, const std::string& format, unsigned numThreads,
+                             const std::string& snapshotPath) {
+  std::string resolved = resolveFormat(path, format);
+  uint64_t fingerprint = ModelSnapshot::sourceFingerprint(path, resolved);
+  if (fingerprint != 0) {
+    try {
+      return ModelSnapshot::readFile(snapshotPath, fingerprint);
+    }
+    catch (const std::exception& ex) {
+      std::cerr << "Rebuilding snapshot: " << ex.what() << "\n";
+    }
+  }
+
+  CompactModel model = readModel(path, resolved, numThreads);
+  ModelSnapshot::writeFile(model, snapshotPath, fingerprint);
+  return model;
+}
+
+/**
+ * @brief Model files of a batch: the lines of the manifest at `path`
+ * (blank lines and '#' comments skipped), or if `path` is a directory,
+ * its .txt, .lp, .mps and .snap files in name order.
+ */
+std::vector<std::string> batchInputs(const std::string& path) {
+  std::vector<std::string> inputs;
+  if (std::filesystem::is_directory(path)) {
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+      std::string file = entry.path().string();
+      if (entry.is_regular_file() && (endsWith(file, ".txt") || endsWith(file, ".lp") ||
+                                      endsWith(file, ".mps") || endsWith(file, ".snap"))) {
+        inputs.push_back(file);
+      }
+    }
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+  }
+
+  std::ifstream manifest(path);
+  if (!manifest.is_open()) throw std::runtime_error("Could not open batch manifest: " + path);
+  std::string line;
+  while (std::getline(manifest, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') continue;
+    size_t last = line.find_last_not_of(" \t\r");
+    inputs.push_back(line.substr(first, last - first + 1));
+  }
+  return inputs;
+}
+
+/**
+ * @brief Solves every model in `inputs` on `numWorkers` threads and writes
+ * one JSON object per model, as it finishes, to `outputFile`.
+ *
+ * Each worker owns a GLPKSolver that it reuses for all of its jobs, and
+ * solves its models single-threaded. A record holds the model's position
+ * in `inputs`, its path, the status, the objective and variable values
+ * (or the error message), its SolveStats, and the wall time spent
+ * reading and solving.
+ *
+ * @return The number of models that failed.
+ */
+size_t runBatch(const std::vector<std::string>& inputs, const std::string& format, SolveOptions options,
+                unsigned numWorkers, const std::string& outputFile) {
+  std::ofstream out(outputFile);
+  if (!out.is_open()) throw std::runtime_error("Could not open output file: " + outputFile);
+  options.numThreads = 1;
+  options.verbose = false;
+
+  std::mutex outMutex;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> failed{0};
+  ThreadPool pool(std::min<size_t>(ThreadPool::resolveThreads(numWorkers), std::max<size_t>(inputs.size(), 1)));
+  pool.parallelFor(pool.size(), [&](size_t) {
+    glp_term_out(GLP_OFF); // GLPK's terminal output is per thread
+    {
+      GLPKSolver glpk;
+      for (size_t k; (k = next++) < inputs.size();) {
+        std::ostringstream record;
+        record.precision(15);
+        record << "{\"index\":" << k << ",\"model\":" << jsonString(inputs[k]);
+        auto start = std::chrono::steady_clock::now();
+        double readSeconds = 0.0;
+        SolveStats stats;
+        try {
+          CompactModel model = readModel(inputs[k], format, 1);
+          auto read = std::chrono::steady_clock::now();
+          readSeconds = std::chrono::duration<double>(read - start).count();
+          stats.addTime("read", readSeconds);
+          SolveResult result = solveModel(model, options, glpk, stats);
+          record << ',' << resultJson(model, result);
+        }
+        catch (const std::exception& ex) {
+          record << ",\"status\":\"ERROR\",\"error\":" << jsonString(ex.what());
+          ++failed;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (readSeconds == 0.0) readSeconds = seconds;
+        stats.addTime("total", seconds);
+        record << ",\"stats\":" << stats.toJson() << ",\"read_seconds\":" << readSeconds
+               << ",\"solve_seconds\":" << seconds - readSeconds << "}\n";
+        std::lock_guard<std::mutex> lock(outMutex);
+        out << record.str();
+      }
+    }
+    glp_free_env(); // Releases this thread's GLPK environment
+  });
+  if (!out) throw std::runtime_error("Could not write output file: " + outputFile);
+  return failed.load();
+}
+
+/**
+ * @brief The server run by --serve, for the signal handler.
+ */
+SolveServer* activeServer = nullptr;
+
+/**
+ * @brief SIGINT/SIGTERM handler: stops the server.
+ */
+extern "C" void stopServer(int) {
+  if (activeServer) activeServer->stop();
+}
+
 /**
  * @brief Prints the usage instructions for the CLI tool.
  */
 void printUsage() {
-  std::cout << "Usage: MILP_Solver -f <input_file> -o <output_file> [--dual] [--log]\n"
+  std::cout << "Usage: MILP_Solver -f <input_file> -o <output_file> [options]\n"
+    << "       MILP_Solver --batch <manifest|dir> -o <results_file> [options]\n"
+    << "       MILP_Solver --serve <socket> [options]\n"
     << "Options:\n"
-    << "  -f <input_file>   Path to the input MILP file.\n"
+    << "  -f <input_file>   Path to the input MILP file ('-' reads stdin).\n"
     << "  -o <output_file>  Path to the output log file.\n"
+    << "  --batch <path>    Solve many models in one process: the files listed in a\n"
+    << "                    manifest (one path per line), or the model files of a\n"
+    << "                    directory. Results go to the output file as one JSON\n"
+    << "                    object per line, in completion order. Exits with 1 if\n"
+    << "                    any model failed.\n"
+    << "  --serve <socket>  Run as a daemon on a Unix domain socket; see\n"
+    << "                    solve_server.h for the protocol. Stops on SIGINT/SIGTERM.\n"
+    << "  --queue-limit <n> Requests the daemon queues before rejecting (default: 1024).\n"
+    << "  --format <fmt>    Input format: txt (custom), lp (CPLEX LP), mps (free MPS)\n"
+    << "                    or snap (model snapshot).\n"
+    << "                    Default: by extension (.lp, .mps, .snap), otherwise txt.\n"
+    << "  --solver <name>   glpk (default) or simplex (native simplex; MILPs use the\n"
+    << "                    native parallel branch-and-bound).\n"
     << "  --dual            Use the dual simplex method (default is primal).\n"
-    << "  --log             Enable logging of intermediate simplex states.\n";
+    << "  --interior        Solve LPs without integer columns by GLPK's interior-point\n"
+    << "                    method (no --save-basis).\n"
+    << "  --barrier         Solve LPs without integer columns by the native parallel\n"
+    << "                    interior-point method (--save-basis needs --crossover).\n"
+    << "  --pdlp            Solve LPs without integer columns by the native first-order\n"
+    << "                    PDLP method, for LPs too large to factorize; accurate to\n"
+    << "                    1e-6 relative (--save-basis needs --crossover).\n"
+    << "  --concurrent      Solve LPs without integer columns by racing the native\n"
+    << "                    primal simplex, dual simplex and barrier on separate\n"
+    << "                    threads; the first to finish wins and is reported\n"
+    << "                    (--save-basis needs --crossover).\n"
+    << "  --crossover       With --barrier, --pdlp or --concurrent: continue from the\n"
+    << "                    optimum found to an optimal basis with a few simplex pivots.\n"
+    << "  --deterministic   Reproducible parallel branch-and-bound (--solver simplex).\n"
+    << "  --no-presolve     Hand the model to the solver as read, without presolve.\n"
+    << "  --presolve-time <s> Time limit for presolve in seconds (default: 10).\n"
+    << "  --time-limit <s>  Stop the solve after this many seconds, presolve included\n"
+    << "                    (GLPK; native LP simplex, barrier, PDLP, concurrent).\n"
+    << "  --mip-gap <r>     Stop once the relative MIP gap is at most r (GLPK).\n"
+    << "  --abs-gap <a>     Stop once the absolute MIP gap is at most a (GLPK).\n"
+    << "  --node-limit <n>  Stop after n branch-and-bound nodes.\n"
+    << "  --iteration-limit <n> Stop after n simplex iterations (GLPK; native LPs),\n"
+    << "                    or n barrier or PDLP iterations; with --concurrent, per\n"
+    << "                    method.\n"
+    << "  --log             Enable logging of intermediate simplex states.\n"
+    << "  --threads <n>     Worker threads for parsing, branch-and-bound, the\n"
+    << "                    barrier, PDLP and the concurrent race, or with --batch or\n"
+    << "                    --serve, models solved at once (default: all cores).\n"
+    << "  --write-mps <file> Also write the parsed model as free MPS.\n"
+    << "  --load-basis <file> Warm-start the simplex from a basis saved by --save-basis;\n"
+    << "                    rows and columns are matched by name. Turns presolve off.\n"
+    << "  --save-basis <file> Save the final LP basis (the relaxation's for a MILP),\n"
+    << "                    every row and column of the model. Turns presolve off.\n"
+    << "  --stats <file>    Write the solution with phase timings and solver counters\n"
+    << "                    as one JSON object (batch and daemon results always\n"
+    << "                    carry them).\n"
+    << "  --snapshot <file> Load the model from this snapshot if it matches the input\n"
+    << "                    file, otherwise parse the input and write the snapshot.\n";
 }
 
 int main(int argc, char* argv[]) {
   // Check for minimum required arguments
-  if (argc < 5) {
+  if (argc < 3) {
     printUsage();
     return 1;
   }
 
   std::string inputFile;
   std::string outputFile;
-  bool useDualSimplex = false;
+  std::string inputFormat;
+  std::string batchPath;
+  std::string socketPath;
+  size_t queueLimit = 1024;
   bool enableLogging = false;
+  std::string mpsOutputFile;
+  std::string snapshotFile;
+  std::string statsFile;
+  SolveOptions options;
 
   // Parse command-line arguments
   for (int i = 1; i < argc; ++i) {
@@ -40,12 +241,84 @@ int main(int argc, char* argv[]) {
     else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
       outputFile = argv[++i];
     }
+    else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+      batchPath = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+      socketPath = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--queue-limit") == 0 && i + 1 < argc) {
+      queueLimit = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+      inputFormat = argv[++i];
+    }
     else if (std::strcmp(argv[i], "--dual") == 0) {
-      useDualSimplex = true;
+      options.useDualSimplex = true;
+    }
+    else if (std::strcmp(argv[i], "--interior") == 0) {
+      options.lpMethod = LpMethod::INTERIOR;
+    }
+    else if (std::strcmp(argv[i], "--barrier") == 0) {
+      options.lpMethod = LpMethod::BARRIER;
+    }
+    else if (std::strcmp(argv[i], "--pdlp") == 0) {
+      options.lpMethod = LpMethod::PDLP;
+    }
+    else if (std::strcmp(argv[i], "--concurrent") == 0) {
+      options.lpMethod = LpMethod::CONCURRENT;
+    }
+    else if (std::strcmp(argv[i], "--crossover") == 0) {
+      options.crossover = true;
+    }
+    else if (std::strcmp(argv[i], "--deterministic") == 0) {
+      options.deterministic = true;
+    }
+    else if (std::strcmp(argv[i], "--no-presolve") == 0) {
+      options.usePresolve = false;
+    }
+    else if (std::strcmp(argv[i], "--presolve-time") == 0 && i + 1 < argc) {
+      options.presolveTime = std::strtod(argv[++i], nullptr);
+    }
+    else if (std::strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) {
+      options.limits.timeLimit = std::strtod(argv[++i], nullptr);
+    }
+    else if (std::strcmp(argv[i], "--mip-gap") == 0 && i + 1 < argc) {
+      options.limits.relativeGap = std::strtod(argv[++i], nullptr);
+    }
+    else if (std::strcmp(argv[i], "--abs-gap") == 0 && i + 1 < argc) {
+      options.limits.absoluteGap = std::strtod(argv[++i], nullptr);
+    }
+    else if (std::strcmp(argv[i], "--node-limit") == 0 && i + 1 < argc) {
+      options.limits.nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--iteration-limit") == 0 && i + 1 < argc) {
+      options.limits.iterationLimit = std::strtoull(argv[++i], nullptr, 10);
     }
     else if (std::strcmp(argv[i], "--log") == 0) {
       enableLogging = true;
     }
+    else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      options.numThreads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (std::strcmp(argv[i], "--write-mps") == 0 && i + 1 < argc) {
+      mpsOutputFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--load-basis") == 0 && i + 1 < argc) {
+      options.basisInput = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--save-basis") == 0 && i + 1 < argc) {
+      options.basisOutput = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+      statsFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+      snapshotFile = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--solver") == 0 && i + 1 < argc) {
+      options.solverName = argv[++i];
+    }
     else {
       std::cerr << "Unknown argument: " << argv[i] << "\n";
       printUsage();
@@ -54,22 +327,94 @@ int main(int argc, char* argv[]) {
   }
 
   // Validate required arguments
-  if (inputFile.empty() || outputFile.empty()) {
-    std::cerr << "Error: Input and output file paths are required.\n";
+  if (options.lpMethod == LpMethod::INTERIOR && options.solverName != "glpk") {
+    std::cerr << "Error: --interior needs --solver glpk.\n";
+    return 1;
+  }
+  if (options.crossover && options.lpMethod != LpMethod::BARRIER && options.lpMethod != LpMethod::PDLP &&
+      options.lpMethod != LpMethod::CONCURRENT) {
+    std::cerr << "Error: --crossover needs --barrier, --pdlp or --concurrent.\n";
+    return 1;
+  }
+  if (options.lpMethod != LpMethod::SIMPLEX && !options.crossover && !options.basisOutput.empty()) {
+    std::cerr << "Error: --save-basis needs a simplex basis, which --interior, --barrier and --pdlp do not"
+                 " leave, nor --concurrent when the barrier wins (with --crossover they do).\n";
+    return 1;
+  }
+  if (!socketPath.empty()) {
+    if (!inputFile.empty() || !batchPath.empty() || !options.basisInput.empty() || !options.basisOutput.empty()) {
+      std::cerr << "Error: --serve takes its models from the socket.\n";
+      return 1;
+    }
+    try {
+      SolveServer server(socketPath, options);
+      server.setWorkers(options.numThreads);
+      server.setQueueLimit(queueLimit);
+      activeServer = &server;
+      std::signal(SIGINT, stopServer);
+      std::signal(SIGTERM, stopServer);
+      std::cout << "Serving on " << socketPath << "\n";
+      server.run();
+      activeServer = nullptr;
+    }
+    catch (const std::exception& ex) {
+      std::cerr << "Error: " << ex.what() << "\n";
+      return 1;
+    }
+    return 0;
+  }
+  if ((inputFile.empty() == batchPath.empty()) || outputFile.empty()) {
+    std::cerr << "Error: An output file and either an input file or --batch are required.\n";
     printUsage();
     return 1;
   }
+  if (!batchPath.empty() && (!mpsOutputFile.empty() || !snapshotFile.empty() || !statsFile.empty() ||
+                             !options.basisInput.empty() || !options.basisOutput.empty())) {
+    std::cerr << "Error: --write-mps, --snapshot, --stats, --load-basis and --save-basis take a single model, not --batch.\n";
+    return 1;
+  }
 
   try {
+    if (!batchPath.empty()) {
+      std::vector<std::string> inputs = batchInputs(batchPath);
+      auto start = std::chrono::steady_clock::now();
+      size_t failed = runBatch(inputs, inputFormat, options, options.numThreads, outputFile);
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "Batch: " << inputs.size() << " models, " << failed << " failed, " << seconds
+                << " s; results logged to: " << outputFile << "\n";
+      return failed > 0 ? 1 : 0;
+    }
+
     // Parse the input file
-    LPModel model = Parser::parseFile(inputFile);
+    auto start = std::chrono::steady_clock::now();
+    SolveStats stats;
+    CompactModel model = [&] {
+      SolveStats::Timer timer(&stats, "read");
+      return snapshotFile.empty()
+        ? readModel(inputFile, inputFormat, options.numThreads)
+        : readModelCached(inputFile, inputFormat, options.numThreads, snapshotFile);
+    }();
 
-    // Initialize the solver
-    GLPKSolver solver;
-    solver.loadModel(model);
+    if (!mpsOutputFile.empty()) {
+      MpsWriter::writeFile(model, mpsOutputFile);
+    }
 
-    // Solve the problem
-    solver.solve(useDualSimplex, /* isMIP */ true);
+    GLPKSolver glpk;
+    SolveResult result = solveModel(model, options, glpk, stats);
+    stats.addTime("total", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    if (!statsFile.empty()) {
+      std::ofstream statsOut(statsFile);
+      statsOut << "{\"model\":" << jsonString(inputFile) << ',' << resultJson(model, result)
+               << ",\"stats\":" << stats.toJson() << "}\n";
+      if (!statsOut) throw std::runtime_error("Could not write stats file: " + statsFile);
+    }
+    if (result.values.empty() && model.numCols > 0) {
+      throw std::runtime_error("Solve stopped without a solution: " + result.status);
+    }
+    if (result.stop != StopReason::NONE) {
+      std::cout << "Stopped early: " << stopReasonName(result.stop) << "; the solution is "
+                << result.status << "\n";
+    }
 
     // Open the output file for logging
     std::ofstream logFile(outputFile);
@@ -78,10 +423,10 @@ int main(int argc, char* argv[]) {
     }
 
     // Log the results
-    logFile << "Objective Value: " << solver.getObjectiveValue() << "\n";
+    logFile << "Objective Value: " << result.objective << "\n";
     logFile << "Variable Values:\n";
-    for (const auto& [varName, value] : solver.getVariableValues()) {
-      logFile << "  " << varName << " = " << value << "\n";
+    for (uint32_t j = 0; j < result.values.size(); ++j) {
+      logFile << "  " << model.variables.name(j) << " = " << result.values[j] << "\n";
     }
 
     // Log intermediate simplex states if enabled
@@ -0,0 +1,563 @@
+#include "mps.h"
+#include "input_file.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+  runtime_error lineError(int line, const string& message) {
+    return runtime_error("Line " + to_string(line) + ": " + message);
+  }
+
+  bool isBlankChar(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  string_view trim(string_view s) {
+    size_t start = 0, end = s.size();
+    while (start < end && isBlankChar(s[start])) ++start;
+    while (end > start && isBlankChar(s[end - 1])) --end;
+    return s.substr(start, end - start);
+  }
+
+  /*
+   * Struct: Record
+   * -------------------------
+   * One data line laid out as the six fixed-format fields:
+   *   f[0] type (cols 2-3), f[1] name (5-12), f[2] name (15-22),
+   *   f[3] number (25-36), f[4] name (40-47), f[5] number (50-61).
+   * Free-format lines are mapped onto the same slots, so the section
+   * handlers do not care which dialect they are reading.
+   */
+  struct Record {
+    string_view f[6];
+  };
+
+  int splitFree(string_view line, string_view (&tokens)[8]) {
+    int count = 0;
+    size_t pos = 0;
+    while (pos < line.size()) {
+      while (pos < line.size() && isBlankChar(line[pos])) ++pos;
+      if (pos >= line.size()) break;
+      size_t start = pos;
+      while (pos < line.size() && !isBlankChar(line[pos])) ++pos;
+      if (count == 8) return 9;
+      tokens[count++] = line.substr(start, pos - start);
+    }
+    return count;
+  }
+
+  string_view fixedField(string_view line, size_t begin, size_t end) {
+    if (begin >= line.size()) return string_view();
+    return trim(line.substr(begin, min(end, line.size()) - begin));
+  }
+
+  enum Section { NONE, NAME, OBJSENSE, ROWS, COLUMNS, RHS, RANGES, BOUNDS, ENDATA };
+
+  bool boundNeedsValue(string_view type) {
+    return !(type == "FR" || type == "MI" || type == "PL" || type == "BV");
+  }
+
+  /*
+   * Function: toRecord
+   * -------------------------
+   * Splits a data line into the fixed-format field slots.
+   */
+  Record toRecord(string_view line, Section section, MpsFormat format, int lineNo) {
+    Record r;
+    if (format == MpsFormat::FIXED) {
+      r.f[0] = fixedField(line, 1, 3);
+      r.f[1] = fixedField(line, 4, 12);
+      r.f[2] = fixedField(line, 14, 22);
+      r.f[3] = fixedField(line, 24, 36);
+      r.f[4] = fixedField(line, 39, 47);
+      r.f[5] = fixedField(line, 49, 61);
+      return r;
+    }
+
+    string_view t[8];
+    int n = splitFree(line, t);
+    auto expect = [&](bool ok) {
+      if (!ok) throw lineError(lineNo, "Wrong number of fields.");
+    };
+
+    switch (section) {
+      case ROWS:
+        expect(n == 2);
+        r.f[0] = t[0];
+        r.f[1] = t[1];
+        break;
+      case COLUMNS:
+        expect(n == 3 || n == 5);
+        for (int k = 0; k < n; ++k) r.f[k + 1] = t[k];
+        break;
+      case RHS:
+      case RANGES: {
+        // The set name is optional in free MPS: an odd count means it is present.
+        expect(n >= 2 && n <= 5);
+        int shift = (n % 2 == 1) ? 1 : 2;
+        for (int k = 0; k < n; ++k) r.f[k + shift] = t[k];
+        break;
+      }
+      case BOUNDS: {
+        expect(n >= 2 && n <= 4);
+        r.f[0] = t[0];
+        int withoutSet = boundNeedsValue(t[0]) ? 3 : 2;
+        int shift = (n > withoutSet) ? 1 : 2;
+        for (int k = 1; k < n; ++k) r.f[k + shift - 1] = t[k];
+        break;
+      }
+      default:
+        for (int k = 0; k < n && k < 6; ++k) r.f[k] = t[k];
+        break;
+    }
+    return r;
+  }
+
+  double parseNumber(string_view s, int lineNo) {
+    double value = 0.0;
+    const char* begin = s.data();
+    const char* end = s.data() + s.size();
+    if (begin != end && *begin == '+') ++begin;
+    auto result = from_chars(begin, end, value);
+    if (s.empty() || result.ec != errc() || result.ptr != end) {
+      throw lineError(lineNo, "Invalid number '" + string(s) + "'");
+    }
+    return value;
+  }
+
+  constexpr int32_t OBJECTIVE_ROW = -1;
+} // anonymous namespace
+
+/*
+ * Function: readFile
+ * -------------------------
+ * Maps the file and parses it in place. See readBuffer.
+ */
+CompactModel MpsReader::readFile(const string& path, MpsFormat format) {
+  InputFile file(path);
+  return readBuffer(file.contents(), format);
+}
+
+/*
+ * Function: readBuffer
+ * -------------------------
+ * Single pass over the MPS text. Rows are interned into a symbol table
+ * so every COLUMNS/RHS/RANGES entry costs one hash lookup; row bounds are
+ * resolved from type, RHS and RANGES once the whole file has been read.
+ *
+ * Returns:
+ *   A CompactModel with row names. Columns default to [0, +inf).
+ *
+ * Throws:
+ *   runtime_error on malformed input, unknown names, repeated entries or
+ *   unsupported sections.
+ */
+CompactModel MpsReader::readBuffer(string_view text, MpsFormat format) {
+  CompactModel model;
+  SymbolTable rowTable;       // Every ROWS name, including the objective
+  vector<int32_t> rowOf;      // Symbol id -> model row, or OBJECTIVE_ROW
+  vector<char> rowType;       // Per model row: 'L', 'G', 'E' or 'N'
+  vector<double> rhs, range;  // Per model row
+  vector<char> hasRange;      // Per model row
+  bool objectiveSeen = false;
+
+  SparseMatrix csc;           // Built column by column
+  vector<uint32_t> lastCol;   // Per model row: last column with an entry
+  bool integerMarker = false;
+
+  Section section = NONE;
+  int lineNo = 0;
+  size_t pos = 0;
+
+  while (pos < text.size() && section != ENDATA) {
+    const char* nl = static_cast<const char*>(memchr(text.data() + pos, '\n', text.size() - pos));
+    size_t end = nl ? static_cast<size_t>(nl - text.data()) : text.size();
+    string_view line = text.substr(pos, end - pos);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    pos = end + 1;
+    lineNo++;
+
+    if (trim(line).empty() || line[0] == '*') continue;
+
+    // Section headers start in column 1
+    if (!isBlankChar(line[0])) {
+      string_view t[8];
+      int n = splitFree(line, t);
+      string_view name = t[0];
+      if (name == "NAME") section = NAME;
+      else if (name == "ROWS") section = ROWS;
+      else if (name == "COLUMNS") section = COLUMNS;
+      else if (name == "RHS") section = RHS;
+      else if (name == "RANGES") section = RANGES;
+      else if (name == "BOUNDS") section = BOUNDS;
+      else if (name == "ENDATA") section = ENDATA;
+      else if (name == "OBJSENSE" || name == "OBJSENCE") {
+        section = OBJSENSE;
+        if (n > 1) {
+          if (t[1] == "MAX" || t[1] == "MAXIMIZE") model.type = OptType::MAXIMIZE;
+          else if (t[1] == "MIN" || t[1] == "MINIMIZE") model.type = OptType::MINIMIZE;
+          else throw lineError(lineNo, "Invalid OBJSENSE '" + string(t[1]) + "'");
+        }
+      }
+      else throw lineError(lineNo, "Unsupported section '" + string(name) + "'");
+
+      if (section == COLUMNS || section == ENDATA) {
+        lastCol.assign(model.numRows, UINT32_MAX);
+      }
+      continue;
+    }
+
+    if (section == OBJSENSE) {
+      string_view sense = trim(line);
+      if (sense == "MAX" || sense == "MAXIMIZE") model.type = OptType::MAXIMIZE;
+      else if (sense == "MIN" || sense == "MINIMIZE") model.type = OptType::MINIMIZE;
+      else throw lineError(lineNo, "Invalid OBJSENSE '" + string(sense) + "'");
+      continue;
+    }
+    if (section == NAME) continue;
+    if (section == NONE) throw lineError(lineNo, "Data line outside of any section.");
+
+    Record r = toRecord(line, section, format, lineNo);
+
+    auto lookupRow = [&](string_view name) {
+      uint32_t id = rowTable.find(name);
+      if (id == SymbolTable::NOT_FOUND) throw lineError(lineNo, "Unknown row '" + string(name) + "'");
+      return rowOf[id];
+    };
+
+    if (section == ROWS) {
+      char type = r.f[0].size() == 1 ? r.f[0][0] : '?';
+      if (type != 'N' && type != 'L' && type != 'G' && type != 'E') {
+        throw lineError(lineNo, "Invalid row type '" + string(r.f[0]) + "'");
+      }
+      uint32_t before = rowTable.size();
+      uint32_t id = rowTable.intern(r.f[1]);
+      if (id != before) throw lineError(lineNo, "Duplicate row '" + string(r.f[1]) + "'");
+
+      if (type == 'N' && !objectiveSeen) {
+        objectiveSeen = true;
+        rowOf.push_back(OBJECTIVE_ROW);
+        continue;
+      }
+      rowOf.push_back(static_cast<int32_t>(model.numRows++));
+      model.rowNames.intern(r.f[1]);
+      rowType.push_back(type);
+    }
+    else if (section == COLUMNS) {
+      if (r.f[2] == "'MARKER'") {
+        string_view marker = !r.f[3].empty() ? r.f[3] : r.f[4];
+        if (marker == "'INTORG'") integerMarker = true;
+        else if (marker == "'INTEND'") integerMarker = false;
+        else throw lineError(lineNo, "Invalid marker '" + string(marker) + "'");
+        continue;
+      }
+
+      uint32_t before = model.variables.size();
+      uint32_t col = model.variables.intern(r.f[1]);
+      if (col == before) {
+        model.numCols++;
+        csc.start.push_back(csc.index.size());
+        model.colKind.push_back(integerMarker ? VarType::INTEGER : VarType::CONTINUOUS);
+        model.objective.push_back(0.0);
+      }
+      else if (col != before - 1) {
+        throw lineError(lineNo, "Column '" + string(r.f[1]) + "' is not contiguous.");
+      }
+
+      for (int k = 2; k <= 4; k += 2) {
+        if (r.f[k].empty()) continue;
+        int32_t row = lookupRow(r.f[k]);
+        double value = parseNumber(r.f[k + 1], lineNo);
+        if (row == OBJECTIVE_ROW) {
+          model.objective[col] = value;
+          continue;
+        }
+        if (lastCol[row] == col) {
+          throw lineError(lineNo, "Repeated entry for column '" + string(r.f[1]) + "' in row '" + string(r.f[k]) + "'");
+        }
+        lastCol[row] = col;
+        csc.index.push_back(static_cast<uint32_t>(row));
+        csc.value.push_back(value);
+        csc.start.back() = csc.index.size();
+      }
+    }
+    else if (section == RHS || section == RANGES) {
+      if (rhs.empty()) {
+        rhs.assign(model.numRows, 0.0);
+        range.assign(model.numRows, 0.0);
+        hasRange.assign(model.numRows, 0);
+      }
+      for (int k = 2; k <= 4; k += 2) {
+        if (r.f[k].empty()) continue;
+        int32_t row = lookupRow(r.f[k]);
+        double value = parseNumber(r.f[k + 1], lineNo);
+        if (section == RHS) {
+          if (row == OBJECTIVE_ROW) model.objectiveOffset = -value;
+          else rhs[row] = value;
+        }
+        else if (row != OBJECTIVE_ROW) {
+          range[row] = value;
+          hasRange[row] = 1;
+        }
+      }
+    }
+    else if (section == BOUNDS) {
+      if (model.colLower.empty()) {
+        model.colLower.assign(model.numCols, 0.0);
+        model.colUpper.assign(model.numCols, INFINITY);
+      }
+      uint32_t col = model.variables.find(r.f[2]);
+      if (col == SymbolTable::NOT_FOUND) throw lineError(lineNo, "Unknown column '" + string(r.f[2]) + "'");
+
+      string_view type = r.f[0];
+      double value = boundNeedsValue(type) ? parseNumber(r.f[3], lineNo) : 0.0;
+      double& lo = model.colLower[col];
+      double& up = model.colUpper[col];
+
+      if (type == "UP") {
+        up = value;
+        if (value < 0 && lo == 0.0) lo = -INFINITY;
+      }
+      else if (type == "LO") lo = value;
+      else if (type == "FX") lo = up = value;
+      else if (type == "FR") { lo = -INFINITY; up = INFINITY; }
+      else if (type == "MI") lo = -INFINITY;
+      else if (type == "PL") up = INFINITY;
+      else if (type == "BV") { lo = 0.0; up = 1.0; model.colKind[col] = VarType::BINARY; }
+      else if (type == "LI") { lo = value; model.colKind[col] = VarType::INTEGER; }
+      else if (type == "UI") { up = value; model.colKind[col] = VarType::INTEGER; }
+      else throw lineError(lineNo, "Unsupported bound type '" + string(type) + "'");
+    }
+  }
+
+  // Resolve row bounds from type, RHS and RANGES
+  model.rowLower.resize(model.numRows);
+  model.rowUpper.resize(model.numRows);
+  for (uint32_t i = 0; i < model.numRows; ++i) {
+    double b = rhs.empty() ? 0.0 : rhs[i];
+    double r = (rhs.empty() || !hasRange[i]) ? 0.0 : range[i];
+    bool ranged = !rhs.empty() && hasRange[i];
+    double& lo = model.rowLower[i];
+    double& up = model.rowUpper[i];
+    switch (rowType[i]) {
+      case 'N': lo = -INFINITY; up = INFINITY; break;
+      case 'L': lo = ranged ? b - fabs(r) : -INFINITY; up = b; break;
+      case 'G': lo = b; up = ranged ? b + fabs(r) : INFINITY; break;
+      case 'E':
+        lo = (ranged && r < 0) ? b + r : b;
+        up = (ranged && r > 0) ? b + r : b;
+        break;
+    }
+  }
+
+  if (model.colLower.empty()) {
+    model.colLower.assign(model.numCols, 0.0);
+    model.colUpper.assign(model.numCols, INFINITY);
+  }
+  csc.start.resize(size_t(model.numCols) + 1, csc.index.size());
+  model.rows = csc.transpose(model.numRows);
+  return model;
+}
+
+namespace {
+  /*
+   * Class: MpsOutput
+   * -------------------------
+   * Buffered writer that formats MPS fields into a string and flushes
+   * it to the file in large blocks.
+   */
+  class MpsOutput {
+    FILE* file;
+    string buffer;
+    MpsFormat format;
+
+  public:
+    MpsOutput(const string& path, MpsFormat format) : format(format) {
+      file = fopen(path.c_str(), "wb");
+      if (!file) throw runtime_error("Could not open output file: " + path);
+      buffer.reserve(1 << 20);
+    }
+
+    ~MpsOutput() {
+      if (file) fclose(file);
+    }
+
+    void flush() {
+      if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        throw runtime_error("Failed to write MPS output");
+      }
+      buffer.clear();
+    }
+
+    void close() {
+      flush();
+      if (fclose(file) != 0) {
+        file = nullptr;
+        throw runtime_error("Failed to write MPS output");
+      }
+      file = nullptr;
+    }
+
+    void raw(string_view s) {
+      buffer.append(s);
+    }
+
+    void padTo(size_t lineStart, size_t column) {
+      size_t len = buffer.size() - lineStart;
+      buffer.append(len < column ? column - len : 1, ' ');
+    }
+
+    // Formats a number in the shortest round-trip form; fixed MPS limits
+    // numbers to 12 characters, trading precision for width if needed.
+    string_view number(double v, char (&buf)[32]) {
+      auto r = to_chars(buf, buf + sizeof(buf), v);
+      size_t len = r.ptr - buf;
+      for (int precision = 12; format == MpsFormat::FIXED && len > 12 && precision > 1; --precision) {
+        len = to_chars(buf, buf + sizeof(buf), v, chars_format::general, precision).ptr - buf;
+      }
+      return string_view(buf, len);
+    }
+
+    // Writes one data line with up to six fields.
+    void line(string_view f0, string_view f1, string_view f2 = {}, string_view f3 = {},
+              string_view f4 = {}, string_view f5 = {}) {
+      if (format == MpsFormat::FREE) {
+        buffer.push_back(' ');
+        for (string_view f : { f0, f1, f2, f3, f4, f5 }) {
+          if (f.empty()) continue;
+          buffer.push_back(' ');
+          buffer.append(f);
+        }
+      }
+      else {
+        static const size_t columns[6] = { 1, 4, 14, 24, 39, 49 };
+        static const size_t widths[6] = { 2, 8, 8, 12, 8, 12 };
+        string_view fields[6] = { f0, f1, f2, f3, f4, f5 };
+        size_t lineStart = buffer.size();
+        int last = 5;
+        while (last > 0 && fields[last].empty()) --last;
+        for (int k = 0; k <= last; ++k) {
+          if (fields[k].size() > widths[k]) {
+            throw runtime_error("'" + string(fields[k]) + "' does not fit fixed MPS format");
+          }
+          padTo(lineStart, columns[k]);
+          buffer.append(fields[k]);
+        }
+      }
+      buffer.push_back('\n');
+      if (buffer.size() >= (1 << 20)) flush();
+    }
+  };
+} // anonymous namespace
+
+/*
+ * Function: writeFile
+ * -------------------------
+ * Writes the model in column order from its CSC transpose. Integer and
+ * binary columns are wrapped in INTORG/INTEND markers, and integer columns
+ * without a finite upper bound get an explicit PL bound so readers that
+ * default integer columns to [0, 1] see the same model.
+ */
+void MpsWriter::writeFile(const CompactModel& model, const string& path, MpsFormat format) {
+  MpsOutput out(path, format);
+  SparseMatrix csc = model.rows.transpose(model.numCols);
+
+  // Pick an objective row name that does not collide with a constraint
+  string objName = "OBJ";
+  bool named = model.rowNames.size() == model.numRows;
+  while (named && model.rowNames.find(objName) != SymbolTable::NOT_FOUND) objName += "_";
+
+  vector<string> rowNames(model.numRows);
+  for (uint32_t i = 0; i < model.numRows; ++i) rowNames[i] = model.rowName(i);
+
+  out.raw("NAME          MILP_Model\n");
+  if (model.type == OptType::MAXIMIZE) out.raw("OBJSENSE\n    MAX\n");
+
+  out.raw("ROWS\n");
+  out.line("N", objName);
+  for (uint32_t i = 0; i < model.numRows; ++i) {
+    double lo = model.rowLower[i], up = model.rowUpper[i];
+    const char* type = (lo == -INFINITY && up == INFINITY) ? "N"
+                     : (lo == up) ? "E"
+                     : (lo == -INFINITY) ? "L" : "G";
+    out.line(type, rowNames[i]);
+  }
+
+  char num[32];
+  out.raw("COLUMNS\n");
+  bool inInteger = false;
+  for (uint32_t j = 0; j < model.numCols; ++j) {
+    bool integer = model.colKind[j] != VarType::CONTINUOUS;
+    if (integer != inInteger) {
+      out.line("", "MARKER", "'MARKER'", "", integer ? "'INTORG'" : "'INTEND'");
+      inInteger = integer;
+    }
+
+    // A column with no entries is declared through a zero objective entry
+    string_view name = model.variables.name(j);
+    if (model.objective[j] != 0.0 || csc.start[j] == csc.start[j + 1]) {
+      out.line("", name, objName, out.number(model.objective[j], num));
+    }
+    for (size_t p = csc.start[j]; p < csc.start[j + 1]; ++p) {
+      out.line("", name, rowNames[csc.index[p]], out.number(csc.value[p], num));
+    }
+  }
+  if (inInteger) out.line("", "MARKER", "'MARKER'", "", "'INTEND'");
+
+  out.raw("RHS\n");
+  if (model.objectiveOffset != 0.0) {
+    out.line("", "RHS", objName, out.number(-model.objectiveOffset, num));
+  }
+  for (uint32_t i = 0; i < model.numRows; ++i) {
+    double lo = model.rowLower[i], up = model.rowUpper[i];
+    double b = (lo == -INFINITY) ? up : lo;
+    if (b != 0.0 && b != INFINITY) out.line("", "RHS", rowNames[i], out.number(b, num));
+  }
+
+  bool rangesHeader = false;
+  for (uint32_t i = 0; i < model.numRows; ++i) {
+    double lo = model.rowLower[i], up = model.rowUpper[i];
+    if (lo == -INFINITY || up == INFINITY || lo == up) continue;
+    if (!rangesHeader) {
+      out.raw("RANGES\n");
+      rangesHeader = true;
+    }
+    out.line("", "RNG", rowNames[i], out.number(up - lo, num));
+  }
+
+  out.raw("BOUNDS\n");
+  for (uint32_t j = 0; j < model.numCols; ++j) {
+    string_view name = model.variables.name(j);
+    double lo = model.colLower[j], up = model.colUpper[j];
+    bool integer = model.colKind[j] != VarType::CONTINUOUS;
+
+    if (model.colKind[j] == VarType::BINARY && lo == 0.0 && up == 1.0) {
+      out.line("BV", "BND", name);
+    }
+    else if (lo == up) {
+      out.line("FX", "BND", name, out.number(lo, num));
+    }
+    else if (lo == -INFINITY && up == INFINITY) {
+      out.line("FR", "BND", name);
+    }
+    else {
+      if (lo == -INFINITY) out.line("MI", "BND", name);
+      else if (lo != 0.0) out.line("LO", "BND", name, out.number(lo, num));
+
+      if (up != INFINITY) out.line("UP", "BND", name, out.number(up, num));
+      else if (integer) out.line("PL", "BND", name);
+    }
+  }
+
+  out.raw("ENDATA\n");
+  out.close();
+}
+
+void MpsWriter::writeFile(const LPModel& model, const string& path, MpsFormat format) {
+  writeFile(CompactModel::fromLPModel(model), path, format);
+}
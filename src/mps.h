@@ -0,0 +1,58 @@
+#pragma once
+
+#include "compact_model.h"
+#include <string>
+#include <string_view>
+
+/**
+ * @brief MPS dialect: fixed columns or whitespace-separated fields.
+ */
+enum class MpsFormat { FIXED, FREE };
+
+/**
+ * @class MpsReader
+ * @brief Streaming MPS reader that fills a CompactModel directly.
+ *
+ * The file is memory-mapped and scanned once. COLUMNS entries are
+ * appended straight into a CSC matrix (columns must be contiguous, as in
+ * GLPK), which is transposed into the model's CSR form at the end.
+ * Supported sections: NAME, OBJSENSE, ROWS, COLUMNS (with INTORG/INTEND
+ * markers), RHS, RANGES, BOUNDS (UP, LO, FX, FR, MI, PL, BV, LI, UI) and
+ * ENDATA. The first N row is the objective; later N rows become free rows.
+ */
+class MpsReader {
+public:
+  /**
+   * @brief Reads an MPS file ('-' reads stdin).
+   *
+   * @throws std::runtime_error with a "Line N: ..." message on malformed input.
+   */
+  static CompactModel readFile(const std::string& path, MpsFormat format = MpsFormat::FREE);
+
+  /**
+   * @brief Reads MPS text held in memory.
+   */
+  static CompactModel readBuffer(std::string_view text, MpsFormat format = MpsFormat::FREE);
+};
+
+/**
+ * @class MpsWriter
+ * @brief Writes a model as MPS, formatting numbers without iostreams.
+ */
+class MpsWriter {
+public:
+  /**
+   * @brief Writes `model` to `path`.
+   *
+   * @throws std::runtime_error if the file cannot be written, or if a name
+   * does not fit the fixed format (8 characters, no spaces).
+   */
+  static void writeFile(const CompactModel& model, const std::string& path,
+                        MpsFormat format = MpsFormat::FREE);
+
+  /**
+   * @brief Flattens `model` and writes it to `path`.
+   */
+  static void writeFile(const LPModel& model, const std::string& path,
+                        MpsFormat format = MpsFormat::FREE);
+};
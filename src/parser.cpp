@@ -1,10 +1,11 @@
 #include "parser.h"
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <regex>
+#include "lexer.h"
+#include "input_file.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
-#include <cctype>
+#include <cstring>
 
 using namespace std;
 
@@ -14,87 +15,81 @@ namespace {
    * -------------------------
    * Removes leading and trailing whitespace from the string.
    */
-  string trim(const string& s) {
+  string_view trim(string_view s) {
     size_t start = s.find_first_not_of(" \t\r\n");
     size_t end = s.find_last_not_of(" \t\r\n");
-    return (start == string::npos) ? "" : s.substr(start, end - start + 1);
+    return (start == string_view::npos) ? string_view() : s.substr(start, end - start + 1);
   }
 
   /*
-   * Function: split
+   * Function: lineError
    * -------------------------
-   * Splits a string by a given delimiter and trims each token.
+   * Builds the runtime_error thrown for a malformed line.
    */
-  vector<string> split(const string& s, char delimiter) {
-    vector<string> tokens;
-    stringstream ss(s);
-    string item;
-    while (getline(ss, item, delimiter)) {
-      tokens.push_back(trim(item));
-    }
-    return tokens;
+  runtime_error lineError(int line, const string& message) {
+    return runtime_error("Line " + to_string(line) + ": " + message);
   }
 
   /*
-   * Function: isBlank
+   * Function: parseSignedNumber
    * -------------------------
-   * Checks if a string is empty or contains only whitespace.
+   * Parses an optionally signed numeric literal such as "-5" or "+2.5".
    */
-  bool isBlank(const string& s) {
-    return trim(s).empty();
-  }
-
-  /*
-   * Function: isOperator
-   * -------------------------
-   * Checks if a string is a valid comparison operator (<=, >=, =).
-   */
-  bool isOperator(const string& s) {
-    return s == "<=" || s == ">=" || s == "=";
+  double parseSignedNumber(Lexer& lex, int line) {
+    double sign = 1.0;
+    if (lex.peek().kind == TokenKind::PLUS || lex.peek().kind == TokenKind::MINUS) {
+      if (lex.next().kind == TokenKind::MINUS) sign = -1.0;
+    }
+    Token tok = lex.next();
+    if (tok.kind != TokenKind::NUMBER) {
+      throw lineError(line, "Expected a number but found '" + string(tok.text) + "'");
+    }
+    return sign * tok.number;
   }
 
   /*
    * Function: parseTerm
    * -------------------------
-   * Parses a term like "3x" into its coefficient and variable name.
+   * Parses a term like "3x", "- 2.5y" or "+z" into its coefficient and
+   * variable name.
    */
-  Term parseTerm(const string& token, int line) {
-    smatch match;
-    regex termPattern(R"(([+-]?\d*\.?\d*)([a-zA-Z_][a-zA-Z0-9_]*))");
-    if (!regex_match(token, match, termPattern)) {
-      throw runtime_error("Line " + to_string(line) + ": Invalid term format: '" + token + "'");
+  Term parseTerm(Lexer& lex, int line, LPModel& model) {
+    double coeff = 1.0;
+    if (lex.peek().kind == TokenKind::PLUS || lex.peek().kind == TokenKind::MINUS) {
+      if (lex.next().kind == TokenKind::MINUS) coeff = -1.0;
     }
 
-    double coeff = 1.0;
-    string coeffStr = match[1];
-    if (!coeffStr.empty() && coeffStr != "+" && coeffStr != "-") {
-      coeff = stod(coeffStr);
+    Token tok = lex.next();
+    if (tok.kind == TokenKind::NUMBER) {
+      coeff *= tok.number;
+      tok = lex.next();
     }
-    else if (coeffStr == "-") {
-      coeff = -1;
+    if (tok.kind != TokenKind::IDENTIFIER) {
+      throw lineError(line, "Invalid term format: '" + string(tok.text) + "'");
     }
 
-    return Term{ coeff, match[2] };
+    return Term{ coeff, model.column(tok.text) };
   }
 
   /*
    * Function: parseExpression
    * -------------------------
-   * Parses a linear expression like "3x + 2y - z" into a list of Term objects.
+   * Parses a linear expression like "3x + 2y - z" into a list of Term
+   * objects. Stops at the first comparison operator or end of line.
    */
-  vector<Term> parseExpression(const string& exprStr, int line) {
+  vector<Term> parseExpression(Lexer& lex, int line, LPModel& model) {
     vector<Term> terms;
-    regex tokenPattern(R"(([+-]?\s*\d*\.?\d*[a-zA-Z_][a-zA-Z0-9_]*))");
-    auto begin = sregex_iterator(exprStr.begin(), exprStr.end(), tokenPattern);
-    auto end = sregex_iterator();
-
-    for (auto i = begin; i != end; ++i) {
-      string token = regex_replace(i->str(), regex(R"(\s+)"), ""); // remove inner spaces
-      terms.push_back(parseTerm(token, line));
+    for (;;) {
+      TokenKind kind = lex.peek().kind;
+      if (kind == TokenKind::END || kind == TokenKind::LESS_EQUAL ||
+          kind == TokenKind::GREATER_EQUAL || kind == TokenKind::EQUAL) {
+        break;
+      }
+      terms.push_back(parseTerm(lex, line, model));
     }
 
     if (terms.empty()) {
-      throw runtime_error("Line " + to_string(line) + ": No valid terms found in expression");
+      throw lineError(line, "No valid terms found in expression");
     }
 
     return terms;
@@ -105,23 +100,299 @@ namespace {
    * -------------------------
    * Parses a constraint like "x + 2y <= 10" into a LinearExpression.
    */
-  LinearExpression parseConstraint(const string& lineStr, int line) {
-    smatch match;
-    regex constraintPattern(R"((.+)(<=|>=|=)(.+))");
-    if (!regex_match(lineStr, match, constraintPattern)) {
-      throw runtime_error("Line " + to_string(line) + ": Invalid constraint format.");
+  LinearExpression parseConstraint(Lexer& lex, int line, LPModel& model) {
+    vector<Term> terms = parseExpression(lex, line, model);
+
+    RelOp op;
+    switch (lex.next().kind) {
+      case TokenKind::LESS_EQUAL:    op = RelOp::LESS_EQUAL;    break;
+      case TokenKind::GREATER_EQUAL: op = RelOp::GREATER_EQUAL; break;
+      case TokenKind::EQUAL:         op = RelOp::EQUAL;         break;
+      default: throw lineError(line, "Invalid constraint format.");
     }
 
-    string lhs = match[1];
-    string op = match[2];
-    string rhsStr = match[3];
-
-    vector<Term> terms = parseExpression(lhs, line);
-    double rhs = stod(rhsStr);
+    double rhs = parseSignedNumber(lex, line);
+    if (lex.peek().kind != TokenKind::END) {
+      throw lineError(line, "Invalid constraint format.");
+    }
 
     return LinearExpression{ terms, rhs, op, line };
   }
 
+  /*
+   * Function: parseBound
+   * -------------------------
+   * Parses a bound like "x >= 0", "y <= 10", "w = 3" or "z free".
+   */
+  void parseBound(Lexer& lex, int line, LPModel& model) {
+    Token var = lex.next();
+    if (var.kind != TokenKind::IDENTIFIER) {
+      throw lineError(line, "Invalid bound format.");
+    }
+
+    Token tok = lex.next();
+    if (tok.kind == TokenKind::IDENTIFIER && tok.text == "free") {
+      if (lex.peek().kind != TokenKind::END) throw lineError(line, "Invalid bound format.");
+      uint32_t col = model.column(var.text);
+      model.bounds[col].isFree = true;
+      return;
+    }
+    if (tok.kind != TokenKind::LESS_EQUAL && tok.kind != TokenKind::GREATER_EQUAL &&
+        tok.kind != TokenKind::EQUAL) {
+      throw lineError(line, "Invalid bound format.");
+    }
+
+    double val = parseSignedNumber(lex, line);
+    if (lex.peek().kind != TokenKind::END) {
+      throw lineError(line, "Invalid bound format.");
+    }
+
+    uint32_t col = model.column(var.text);
+    auto& b = model.bounds[col];
+    if (tok.kind == TokenKind::GREATER_EQUAL) b.lower = val;
+    else if (tok.kind == TokenKind::LESS_EQUAL) b.upper = val;
+    else b.lower = b.upper = val;
+  }
+
+  /*
+   * Function: parseVariableList
+   * -------------------------
+   * Parses a comma separated list of variables ("x, y") and marks each
+   * one as integer or binary.
+   */
+  void parseVariableList(Lexer& lex, int line, VarType type, LPModel& model) {
+    for (;;) {
+      Token var = lex.next();
+      if (var.kind != TokenKind::IDENTIFIER) {
+        throw lineError(line, "Invalid variable name: '" + string(var.text) + "'");
+      }
+
+      uint32_t col = model.column(var.text);
+      auto& b = model.bounds[col];
+      b.type = type;
+      if (type == VarType::BINARY) {
+        b.lower = 0;
+        b.upper = 1;
+      }
+
+      Token sep = lex.next();
+      if (sep.kind == TokenKind::END) break;
+      if (sep.kind != TokenKind::COMMA) {
+        throw lineError(line, "Expected ',' between variables.");
+      }
+    }
+  }
+
+  enum Section { NONE, CONSTRAINTS, BOUNDS, INTEGERS, BINARIES };
+
+  /*
+   * Struct: LineParser
+   * -------------------------
+   * Section state machine shared by the sequential and parallel paths.
+   * parseLine consumes one trimmed, non-blank, non-comment line.
+   */
+  struct LineParser {
+    LPModel& model;
+    Section current = NONE;
+    bool typeParsed = false;
+    bool objectiveParsed = false;
+
+    explicit LineParser(LPModel& model) : model(model) {}
+
+    void parseLine(string_view line, int lineNo) {
+      Lexer lex(line);
+      Token first = lex.peek();
+
+      // Parse optimization type (Min or Max)
+      if (first.kind == TokenKind::IDENTIFIER && (first.text == "Max" || first.text == "Min") &&
+          line.size() == first.text.size()) {
+        if (typeParsed) {
+          throw lineError(lineNo, "Duplicate optimization type.");
+        }
+        model.type = (first.text == "Max") ? OptType::MAXIMIZE : OptType::MINIMIZE;
+        typeParsed = true;
+        return;
+      }
+
+      // Parse objective function
+      if (!objectiveParsed) {
+        if (!typeParsed) {
+          throw lineError(lineNo, "Expected 'Max' or 'Min' before the objective.");
+        }
+        model.objective = { parseExpression(lex, lineNo, model), 0.0, RelOp::EQUAL, lineNo };
+        if (lex.peek().kind != TokenKind::END) {
+          throw lineError(lineNo, "Unexpected '" + string(lex.peek().text) + "' in objective.");
+        }
+        objectiveParsed = true;
+        current = CONSTRAINTS;
+        return;
+      }
+
+      // Handle section headers
+      if (first.kind == TokenKind::SECTION && line.size() == first.text.size() + 1) {
+        if (first.text == "Bounds")  { current = BOUNDS;   return; }
+        if (first.text == "Integer") { current = INTEGERS; return; }
+        if (first.text == "Binary")  { current = BINARIES; return; }
+      }
+
+      // Parse constraints
+      if (current == CONSTRAINTS) {
+        model.constraints.push_back(parseConstraint(lex, lineNo, model));
+
+        // Parse bounds section
+      }
+      else if (current == BOUNDS) {
+        parseBound(lex, lineNo, model);
+
+        // Parse integer variable declarations
+      }
+      else if (current == INTEGERS || current == BINARIES) {
+        parseVariableList(lex, lineNo, current == INTEGERS ? VarType::INTEGER : VarType::BINARY, model);
+
+        // Catch unexpected or misformatted input
+      }
+      else {
+        throw lineError(lineNo, "Unexpected line or misplaced section.");
+      }
+    }
+  };
+
+  /*
+   * Function: nextLine
+   * -------------------------
+   * Returns the line starting at `pos` (without its newline) and advances
+   * `pos` past the newline.
+   */
+  string_view nextLine(string_view text, size_t& pos) {
+    const char* nl = static_cast<const char*>(memchr(text.data() + pos, '\n', text.size() - pos));
+    size_t end = nl ? static_cast<size_t>(nl - text.data()) : text.size();
+    string_view line = text.substr(pos, end - pos);
+    pos = end + 1;
+    return line;
+  }
+
+  bool isSkippable(string_view line) {
+    return line.empty() || line.substr(0, 2) == "//";
+  }
+
+  bool isSectionHeader(string_view line) {
+    return line == "Bounds:" || line == "Integer:" || line == "Binary:";
+  }
+
+  /*
+   * Function: findConstraintsEnd
+   * -------------------------
+   * Returns the offset of the first section header at or after `pos`, or
+   * the end of the text. Headers are the only valid lines containing ':',
+   * so memchr can skip straight from one candidate to the next.
+   */
+  size_t findConstraintsEnd(string_view text, size_t pos) {
+    while (pos < text.size()) {
+      const char* colon = static_cast<const char*>(memchr(text.data() + pos, ':', text.size() - pos));
+      if (!colon) return text.size();
+
+      size_t c = static_cast<size_t>(colon - text.data());
+      size_t lineStart = text.rfind('\n', c);
+      lineStart = (lineStart == string_view::npos) ? 0 : lineStart + 1;
+      size_t lineEnd = lineStart;
+      string_view line = nextLine(text, lineEnd);
+      if (lineStart >= pos && isSectionHeader(trim(line))) return lineStart;
+      pos = lineEnd;
+    }
+    return text.size();
+  }
+
+  size_t countLines(string_view text) {
+    size_t count = 0;
+    for (const char* p = text.data(), *end = p + text.size();
+         (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr; ++p) {
+      ++count;
+    }
+    return count;
+  }
+
+  // Constraint sections smaller than this are not worth splitting.
+  constexpr size_t PARALLEL_MIN_BYTES = 4u << 20;
+
+  /*
+   * Function: parseConstraintsParallel
+   * -------------------------
+   * Parses the constraint lines in text[begin, end), which start at line
+   * `firstLine`, and appends them to `model` in file order.
+   *
+   * The range is cut into chunks at newline boundaries. Chunks are
+   * processed on the pool in three phases:
+   * 1. count newlines, so every chunk knows its absolute first line;
+   * 2. parse into a chunk-local model with its own symbol table;
+   * 3. after a sequential merge of the chunk symbol tables (in chunk order,
+   *    which preserves first-appearance column numbering), rewrite the
+   *    chunk's column ids to global ids.
+   * If several chunks fail, the error of the earliest one is rethrown, the
+   * same error a sequential parse would report.
+   */
+  void parseConstraintsParallel(string_view text, size_t begin, size_t end, int firstLine,
+                                LPModel& model, ThreadPool& pool) {
+    size_t numChunks = size_t(pool.size()) * 4;
+    size_t target = (end - begin + numChunks - 1) / numChunks;
+
+    vector<size_t> cuts{ begin };
+    while (cuts.back() < end) {
+      size_t cut = min(end, cuts.back() + target);
+      if (cut < end) {
+        const char* nl = static_cast<const char*>(memchr(text.data() + cut, '\n', end - cut));
+        cut = nl ? static_cast<size_t>(nl - text.data()) + 1 : end;
+      }
+      cuts.push_back(cut);
+    }
+    numChunks = cuts.size() - 1;
+
+    vector<size_t> lineCounts(numChunks);
+    pool.parallelFor(numChunks, [&](size_t k) {
+      lineCounts[k] = countLines(text.substr(cuts[k], cuts[k + 1] - cuts[k]));
+    });
+    vector<int> chunkFirstLine(numChunks);
+    size_t lineNo = size_t(firstLine);
+    for (size_t k = 0; k < numChunks; ++k) {
+      chunkFirstLine[k] = static_cast<int>(lineNo);
+      lineNo += lineCounts[k];
+    }
+
+    vector<LPModel> chunks(numChunks);
+    pool.parallelFor(numChunks, [&](size_t k) {
+      LineParser parser(chunks[k]);
+      parser.typeParsed = parser.objectiveParsed = true;
+      parser.current = CONSTRAINTS;
+
+      size_t pos = cuts[k];
+      int n = chunkFirstLine[k];
+      while (pos < cuts[k + 1]) {
+        string_view line = trim(nextLine(text.substr(0, cuts[k + 1]), pos));
+        if (!isSkippable(line)) parser.parseLine(line, n);
+        ++n;
+      }
+    });
+
+    vector<vector<uint32_t>> remap(numChunks);
+    size_t numConstraints = model.constraints.size();
+    for (size_t k = 0; k < numChunks; ++k) {
+      const SymbolTable& local = chunks[k].variables;
+      remap[k].resize(local.size());
+      for (uint32_t id = 0; id < local.size(); ++id) remap[k][id] = model.column(local.name(id));
+      numConstraints += chunks[k].constraints.size();
+    }
+
+    pool.parallelFor(numChunks, [&](size_t k) {
+      for (auto& con : chunks[k].constraints) {
+        for (Term& term : con.terms) term.column = remap[k][term.column];
+      }
+    });
+
+    model.constraints.reserve(numConstraints);
+    for (auto& chunk : chunks) {
+      move(chunk.constraints.begin(), chunk.constraints.end(), back_inserter(model.constraints));
+    }
+  }
+
 } // anonymous namespace
 
 
@@ -131,105 +402,70 @@ namespace {
  * -------------------------
  * Parses a linear programming model from the given file path.
  *
- * The input file must follow this structure:
+ * Regular files are memory-mapped and parsed in place; pipes and stdin
+ * ("-") are read into memory first. See parseBuffer for the format.
+ *
+ * Returns:
+ *   An LPModel object populated with the parsed problem.
+ *
+ * Throws:
+ *   runtime_error if the file cannot be read, or on any parse error.
+ */
+LPModel Parser::parseFile(const string& path, unsigned numThreads) {
+  InputFile file(path);
+  return parseBuffer(file.contents(), numThreads);
+}
+
+/*
+ * Function: parseBuffer
+ * -------------------------
+ * Parses a linear programming model from an in-memory buffer.
+ *
+ * The input must follow this structure:
  * - First non-comment, non-empty line must specify "Max" or "Min".
  * - Next line is the objective function (e.g., 3x + 4y - z).
  * - Followed by constraints, and optionally bounded variables, integers, or binaries.
  *
+ * Lines are sliced out of the buffer as string_views and tokenized once by
+ * the Lexer; line contents are never copied. A large constraints section
+ * is parsed on `numThreads` threads (0 = all cores); every other section
+ * is parsed sequentially. Results, column numbering and error messages are
+ * identical either way.
+ *
  * Returns:
  *   An LPModel object populated with the parsed problem.
  *
  * Throws:
  *   runtime_error on invalid format, duplicate sections, or parsing errors.
  */
-LPModel Parser::parseFile(const string& path) {
-  ifstream file(path);
-  if (!file.is_open()) throw runtime_error("Could not open input file: " + path);
-
+LPModel Parser::parseBuffer(string_view text, unsigned numThreads) {
   LPModel model;
-  string line;
+  LineParser parser(model);
   int lineNo = 0;
+  bool splitChecked = false;
+  numThreads = ThreadPool::resolveThreads(numThreads);
 
-  enum Section { NONE, CONSTRAINTS, BOUNDS, INTEGERS, BINARIES };
-  Section current = NONE;
-  bool objectiveParsed = false;
-
-  while (getline(file, line)) {
+  size_t pos = 0;
+  while (pos < text.size()) {
+    string_view line = trim(nextLine(text, pos));
     lineNo++;
-    line = trim(line);
 
     // Skip empty lines and comments
-    if (isBlank(line) || line.rfind("//", 0) == 0) continue;
-
-    // Parse optimization type (Min or Max)
-    if (line == "Max" || line == "Min") {
-      if (objectiveParsed) {
-        throw runtime_error("Line " + to_string(lineNo) + ": Duplicate optimization type.");
-      }
-      model.type = (line == "Max") ? OptType::MAXIMIZE : OptType::MINIMIZE;
-      objectiveParsed = true;
-      continue;
-    }
-
-    // Parse objective function
-    if (!objectiveParsed) {
-      model.objective = { parseExpression(line, lineNo), 0.0, "", lineNo };
-      objectiveParsed = true;
-      current = CONSTRAINTS;
-      continue;
-    }
-
-    // Handle section headers
-    if (line == "Bounds:") { current = BOUNDS;   continue; }
-    if (line == "Integer:") { current = INTEGERS; continue; }
-    if (line == "Binary:") { current = BINARIES; continue; }
-
-    // Parse constraints
-    if (current == CONSTRAINTS) {
-      model.constraints.push_back(parseConstraint(line, lineNo));
-
-      // Parse bounds section
-    }
-    else if (current == BOUNDS) {
-      smatch match;
-      regex boundPattern(R"((\w+)\s*(>=|<=|=)\s*(-?\d+\.?\d*))");
-
-      if (line.find("free") != string::npos) {
-        string var = trim(line.substr(0, line.find("free")));
-        model.bounds[var].isFree = true;
-      }
-      else if (regex_match(line, match, boundPattern)) {
-        string var = match[1];
-        string op = match[2];
-        double val = stod(match[3]);
-
-        auto& b = model.bounds[var];
-        if (op == ">=") b.lower = val;
-        else if (op == "<=") b.upper = val;
-        else if (op == "=")  b.lower = b.upper = val;
-      }
-      else {
-        throw runtime_error("Line " + to_string(lineNo) + ": Invalid bound format.");
-      }
-
-      // Parse integer variable declarations
-    }
-    else if (current == INTEGERS || current == BINARIES) {
-      vector<string> vars = split(line, ',');
-      for (const string& var : vars) {
-        auto& b = model.bounds[var];
-        b.type = (current == INTEGERS) ? VarType::INTEGER : VarType::BINARY;
-
-        if (current == BINARIES) {
-          b.lower = 0;
-          b.upper = 1;
-        }
+    if (isSkippable(line)) continue;
+
+    parser.parseLine(line, lineNo);
+
+    // Hand a large constraints section to the thread pool
+    if (parser.current == CONSTRAINTS && !splitChecked && numThreads > 1) {
+      splitChecked = true;
+      size_t end = findConstraintsEnd(text, pos);
+      if (end - pos >= PARALLEL_MIN_BYTES) {
+        ThreadPool pool(numThreads);
+        parseConstraintsParallel(text, pos, end, lineNo + 1, model, pool);
+        lineNo += static_cast<int>(countLines(text.substr(pos, end - pos)));
+        pos = end;
+        parser.current = NONE; // Only a section header can follow
       }
-
-      // Catch unexpected or misformatted input
-    }
-    else {
-      throw runtime_error("Line " + to_string(lineNo) + ": Unexpected line or misplaced section.");
     }
   }
 
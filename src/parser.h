@@ -1,23 +1,27 @@
 #pragma once
 
+#include "symbol_table.h"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <limits>
 
 constexpr double INFINITY = std::numeric_limits<double>::infinity();
 
 enum class OptType { MAXIMIZE, MINIMIZE };
 
+enum class RelOp { LESS_EQUAL, GREATER_EQUAL, EQUAL };
+
 struct Term {
   double coefficient;
-  std::string variable;
+  uint32_t column; // Variable id in LPModel::variables
 };
 
 struct LinearExpression {
   std::vector<Term> terms;
   double rhs = 0.0;
-  std::string op; // <=, >=, =
+  RelOp op = RelOp::EQUAL;
   int lineNumber;
 };
 
@@ -37,12 +41,25 @@ struct Bound {
 
 struct LPModel {
   OptType type;
-  LinearExpression objective;
+  LinearExpression objective;                // rhs holds the objective's constant term
   std::vector<LinearExpression> constraints;
-  std::unordered_map<std::string, Bound> bounds;
+  SymbolTable constraintNames;               // Empty, or one name per constraint
+  SymbolTable variables;                     // Variable name <-> column id
+  std::vector<Bound> bounds;                 // Indexed by column id
+
+  // Returns the column id of `name`, registering it with default bounds if new.
+  uint32_t column(std::string_view name) {
+    uint32_t id = variables.intern(name);
+    if (id == bounds.size()) bounds.emplace_back();
+    return id;
+  }
 };
 
 class Parser {
 public:
-  static LPModel parseFile(const std::string& path);
+  // numThreads: threads for large constraint sections (0 = all cores).
+  static LPModel parseFile(const std::string& path, unsigned numThreads = 0);
+
+  // Parses a model held in memory; parseFile maps the file and calls this.
+  static LPModel parseBuffer(std::string_view text, unsigned numThreads = 0);
 };
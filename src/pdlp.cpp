@@ -0,0 +1,513 @@
+#include "pdlp.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+  constexpr int RUIZ_PASSES = 10;           // Equilibration passes before the Pock-Chambolle step
+  constexpr uint64_t RESTART_CHECK = 64;    // Iterations between restart and termination checks
+  constexpr double RESTART_SUFFICIENT = 0.2; // Restart once the KKT error fell to this share ...
+  constexpr double RESTART_NECESSARY = 0.8;  // ... or to this share and stopped falling
+  constexpr double RESTART_ARTIFICIAL = 0.36; // ... or this share of all iterations ran since the last one
+  constexpr uint64_t MAX_STEP_TRIES = 1000; // Rejected steps in a row before giving up
+  constexpr double OMEGA_RANGE = 1e40;      // The primal weight stays within this factor of its start
+
+  double norm(const vector<double>& v) {
+    double sum = 0.0;
+    for (double a : v) sum += a * a;
+    return sqrt(sum);
+  }
+
+  // The part of reduced cost r that a bounded variable can absorb: r > 0 needs a lower bound, r < 0 an upper
+  double boundMultiplier(double r, double lo, double up) {
+    if (r > 0.0) return lo > -INFINITY ? r : 0.0;
+    if (r < 0.0) return up < INFINITY ? r : 0.0;
+    return 0.0;
+  }
+} // anonymous namespace
+
+const char* pdlpStatusName(PdlpStatus status) {
+  switch (status) {
+    case PdlpStatus::UNSOLVED: return "UNSOLVED";
+    case PdlpStatus::OPTIMAL: return "OPTIMAL";
+    case PdlpStatus::INFEASIBLE: return "INFEASIBLE";
+    case PdlpStatus::UNBOUNDED: return "UNBOUNDED";
+    case PdlpStatus::ITERATION_LIMIT: return "ITERATION_LIMIT";
+    case PdlpStatus::TIME_LIMIT: return "TIME_LIMIT";
+    case PdlpStatus::CANCELLED: return "CANCELLED";
+    case PdlpStatus::NUMERICAL_ERROR: return "NUMERICAL_ERROR";
+  }
+  return "UNKNOWN";
+}
+
+double PdlpSolver::Residuals::kkt() const {
+  double gap = primalObjective - dualObjective;
+  return sqrt(primal * primal + dual * dual + gap * gap);
+}
+
+void PdlpSolver::loadModel(const CompactModel& model) {
+  m = model.numRows;
+  n = model.numCols;
+  maximize = model.type == OptType::MAXIMIZE;
+  objectiveOffset = model.objectiveOffset;
+  rowsA = model.rows;
+  cost.resize(n);
+  for (uint32_t j = 0; j < n; ++j) cost[j] = maximize ? -model.objective[j] : model.objective[j];
+  lower = model.colLower;
+  upper = model.colUpper;
+  rowLower = model.rowLower;
+  rowUpper = model.rowUpper;
+
+  costNorm = norm(cost);
+  double sum = 0.0;
+  for (uint32_t i = 0; i < m; ++i) {
+    if (rowLower[i] > -INFINITY) sum += rowLower[i] * rowLower[i];
+    if (rowUpper[i] < INFINITY && rowUpper[i] != rowLower[i]) sum += rowUpper[i] * rowUpper[i];
+  }
+  boundNorm = sqrt(sum);
+
+  scale();
+  x.clear();
+  y.clear();
+  result = PdlpStatus::UNSOLVED;
+  iterationCount = productCount = 0;
+}
+
+/*
+ * Function: scale
+ * -------------------------
+ * Diagonal preconditioning: Ruiz equilibration divides every row and
+ * column by the square root of its largest entry, RUIZ_PASSES times, and
+ * a Pock-Chambolle pass then divides each by the square root of its
+ * absolute sum. Scaled x[j] is x[j] / colScale[j] and scaled row bounds
+ * are multiplied by rowScale[i].
+ */
+void PdlpSolver::scale() {
+  rowScale.assign(m, 1.0);
+  colScale.assign(n, 1.0);
+  vector<double> rowNorm(m), colNorm(n);
+
+  auto pass = [&](bool sums) {
+    fill(rowNorm.begin(), rowNorm.end(), 0.0);
+    fill(colNorm.begin(), colNorm.end(), 0.0);
+    for (uint32_t i = 0; i < m; ++i) {
+      for (size_t p = rowsA.start[i]; p < rowsA.start[i + 1]; ++p) {
+        uint32_t j = rowsA.index[p];
+        double a = fabs(rowsA.value[p]) * rowScale[i] * colScale[j];
+        if (sums) {
+          rowNorm[i] += a;
+          colNorm[j] += a;
+        }
+        else {
+          rowNorm[i] = max(rowNorm[i], a);
+          colNorm[j] = max(colNorm[j], a);
+        }
+      }
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      if (rowNorm[i] > 0.0) rowScale[i] /= sqrt(rowNorm[i]);
+    }
+    for (uint32_t j = 0; j < n; ++j) {
+      if (colNorm[j] > 0.0) colScale[j] /= sqrt(colNorm[j]);
+    }
+  };
+  for (int k = 0; k < RUIZ_PASSES; ++k) pass(false);
+  pass(true);
+
+  for (uint32_t i = 0; i < m; ++i) {
+    for (size_t p = rowsA.start[i]; p < rowsA.start[i + 1]; ++p) {
+      rowsA.value[p] *= rowScale[i] * colScale[rowsA.index[p]];
+    }
+    rowLower[i] *= rowScale[i];
+    rowUpper[i] *= rowScale[i];
+  }
+  for (uint32_t j = 0; j < n; ++j) {
+    cost[j] *= colScale[j];
+    lower[j] /= colScale[j];
+    upper[j] /= colScale[j];
+  }
+  colsA = rowsA.transpose(n);
+}
+
+void PdlpSolver::multiply(const SparseMatrix& a, const vector<uint32_t>& ranges, const vector<double>& v,
+                          vector<double>& out, ThreadPool* pool) {
+  ++productCount;
+  if (pool == nullptr) {
+    sparseMultiply(a, v.data(), out.data(), 0, a.numMajor(), simd);
+    return;
+  }
+  pool->parallelFor(ranges.size() - 1, [&](size_t t) {
+    sparseMultiply(a, v.data(), out.data(), ranges[t], ranges[t + 1], simd);
+  });
+}
+
+/*
+ * Function: evaluate
+ * -------------------------
+ * Residuals of the iterate (px, py) with its products, in unscaled terms.
+ * The dual objective is -g*(y) plus the bound terms of lambda, the part
+ * of the reduced costs c + A^T y the column bounds can carry; the rest is
+ * the dual residual.
+ */
+PdlpSolver::Residuals PdlpSolver::evaluate(const vector<double>& px, const vector<double>& py,
+                                           const vector<double>& pax, const vector<double>& paty) const {
+  Residuals r;
+  double primal = 0.0, dual = 0.0;
+  for (uint32_t i = 0; i < m; ++i) {
+    double violation = max(rowLower[i] - pax[i], 0.0) + max(pax[i] - rowUpper[i], 0.0);
+    violation /= rowScale[i];
+    primal += violation * violation;
+    if (py[i] > 0.0) r.dualObjective -= py[i] * rowUpper[i];
+    else if (py[i] < 0.0) r.dualObjective -= py[i] * rowLower[i];
+  }
+  for (uint32_t j = 0; j < n; ++j) {
+    r.primalObjective += cost[j] * px[j];
+    double reduced = cost[j] + paty[j];
+    double lambda = boundMultiplier(reduced, lower[j], upper[j]);
+    double residual = (reduced - lambda) / colScale[j];
+    dual += residual * residual;
+    if (lambda > 0.0) r.dualObjective += lambda * lower[j];
+    else if (lambda < 0.0) r.dualObjective += lambda * upper[j];
+  }
+  r.primal = sqrt(primal);
+  r.dual = sqrt(dual);
+  return r;
+}
+
+bool PdlpSolver::converged(const Residuals& r) const {
+  double gap = fabs(r.primalObjective - r.dualObjective);
+  return r.primal <= tolerance * (1.0 + boundNorm) && r.dual <= tolerance * (1.0 + costNorm) &&
+         gap <= tolerance * (1.0 + fabs(r.primalObjective) + fabs(r.dualObjective));
+}
+
+/*
+ * Function: primalRay
+ * -------------------------
+ * True if dx (with A dx) is an improving ray: c^T dx < 0 while A dx and
+ * dx stay, up to the tolerance relative to the improvement, within the
+ * recession cones of the row and column bounds. Unscaled, with dx
+ * normalized to a largest entry of 1. Such a ray proves the LP unbounded
+ * only once it is known to be feasible: LPs that are both primal and dual
+ * infeasible have one too.
+ */
+bool PdlpSolver::primalRay(const vector<double>& dx, const vector<double>& adx) const {
+  double largest = 0.0;
+  for (uint32_t j = 0; j < n; ++j) largest = max(largest, fabs(dx[j] * colScale[j]));
+  if (largest == 0.0) return false;
+  double objective = 0.0, violation = 0.0;
+  for (uint32_t j = 0; j < n; ++j) {
+    objective += cost[j] * dx[j] / largest;
+    double d = dx[j] * colScale[j] / largest;
+    double v = (lower[j] > -INFINITY ? max(-d, 0.0) : 0.0) + (upper[j] < INFINITY ? max(d, 0.0) : 0.0);
+    violation += v * v;
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    double d = adx[i] / rowScale[i] / largest;
+    double v = (rowLower[i] > -INFINITY ? max(-d, 0.0) : 0.0) + (rowUpper[i] < INFINITY ? max(d, 0.0) : 0.0);
+    violation += v * v;
+  }
+  return objective < 0.0 && sqrt(violation) <= tolerance * -objective;
+}
+
+/*
+ * Function: dualRay
+ * -------------------------
+ * True if dy (with A^T dy) is a Farkas ray: the dual objective of
+ * (dy, lambda) without costs is positive while A^T dy - lambda vanishes,
+ * up to the tolerance relative to that objective. Unscaled, with dy
+ * normalized to a largest entry of 1.
+ */
+bool PdlpSolver::dualRay(const vector<double>& dy, const vector<double>& atdy) const {
+  double largest = 0.0;
+  for (uint32_t i = 0; i < m; ++i) largest = max(largest, fabs(dy[i] * rowScale[i]));
+  if (largest == 0.0) return false;
+  double objective = 0.0, residual = 0.0;
+  for (uint32_t i = 0; i < m; ++i) {
+    double bound = dy[i] > 0.0 ? rowUpper[i] : dy[i] < 0.0 ? rowLower[i] : 0.0;
+    if (fabs(bound) == INFINITY) return false;
+    objective -= dy[i] * bound / largest;
+  }
+  for (uint32_t j = 0; j < n; ++j) {
+    double reduced = atdy[j] / largest;
+    double lambda = boundMultiplier(reduced, lower[j], upper[j]);
+    if (lambda > 0.0) objective += lambda * lower[j];
+    else if (lambda < 0.0) objective += lambda * upper[j];
+    double r = (reduced - lambda) / colScale[j];
+    residual += r * r;
+  }
+  return objective > 0.0 && sqrt(residual) <= tolerance * objective;
+}
+
+/*
+ * Function: solve
+ * -------------------------
+ * Decides what needs no iterations, then runs iterate(). An empty row
+ * whose bounds exclude 0 makes the LP infeasible. An empty column whose
+ * cost improves towards an infinite bound makes it unbounded unless the
+ * rest is infeasible, so such columns are fixed at a finite point while
+ * iterating and an optimal result for the rest becomes UNBOUNDED.
+ */
+PdlpStatus PdlpSolver::solve() {
+  iterationCount = productCount = 0;
+  for (uint32_t j = 0; j < n; ++j) {
+    if (lower[j] > upper[j]) return result = PdlpStatus::INFEASIBLE;
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    if (rowLower[i] > rowUpper[i]) return result = PdlpStatus::INFEASIBLE;
+    bool empty = rowsA.start[i] == rowsA.start[i + 1];
+    if (empty && (rowLower[i] > 0.0 || rowUpper[i] < 0.0)) return result = PdlpStatus::INFEASIBLE;
+  }
+
+  vector<uint32_t> rayColumns;
+  for (uint32_t j = 0; j < n; ++j) {
+    if (colsA.start[j] != colsA.start[j + 1]) continue;
+    if ((cost[j] < 0.0 && upper[j] == INFINITY) || (cost[j] > 0.0 && lower[j] == -INFINITY)) rayColumns.push_back(j);
+  }
+  vector<double> rayLower(rayColumns.size()), rayUpper(rayColumns.size());
+  for (size_t k = 0; k < rayColumns.size(); ++k) {
+    uint32_t j = rayColumns[k];
+    rayLower[k] = lower[j];
+    rayUpper[k] = upper[j];
+    lower[j] = upper[j] = min(max(0.0, lower[j]), upper[j]);
+  }
+
+  result = iterate();
+
+  for (size_t k = 0; k < rayColumns.size(); ++k) {
+    lower[rayColumns[k]] = rayLower[k];
+    upper[rayColumns[k]] = rayUpper[k];
+  }
+  if (!rayColumns.empty() && result == PdlpStatus::OPTIMAL) result = PdlpStatus::UNBOUNDED;
+  return result;
+}
+
+/*
+ * Function: iterate
+ * -------------------------
+ * PDHG with adaptive steps and restarts. A step of size eta (tau =
+ * eta / omega in x, sigma = eta * omega in y) is accepted if eta is at
+ * most ||dz||^2_omega / (2 |dy^T A dx|); either way the next eta is
+ * min((1 - (k+1)^-0.3) limit, (1 + (k+1)^-0.6) eta) for the k-th try.
+ * The cancel flag and the time limit are checked before every try, and
+ * MAX_STEP_TRIES rejections in a row, or step sizes and weights that are
+ * no longer finite, end in NUMERICAL_ERROR. The average iterate is
+ * weighted by the accepted step sizes; products with A are linear, so
+ * they are averaged alongside. Every RESTART_CHECK iterations the
+ * current and average iterates are tested for optimality, the moves
+ * since the last restart for rays, and the restart criteria are applied
+ * to the better of the two.
+ */
+PdlpStatus PdlpSolver::iterate() {
+  auto start = chrono::steady_clock::now();
+  ThreadPool pool(ThreadPool::resolveThreads(numThreads));
+  ThreadPool* workers = pool.size() > 1 ? &pool : nullptr;
+  vector<uint32_t> rowRanges = balancedLineRanges(rowsA, pool.size());
+  vector<uint32_t> colRanges = balancedLineRanges(colsA, pool.size());
+
+  x.assign(n, 0.0);
+  for (uint32_t j = 0; j < n; ++j) x[j] = min(max(0.0, lower[j]), upper[j]);
+  y.assign(m, 0.0);
+  ax.assign(m, 0.0);
+  aty.assign(n, 0.0);
+  multiply(rowsA, rowRanges, x, ax, workers);
+
+  // Initial step from the largest entry, primal weight from the cost and bound norms (scaled)
+  double largest = 0.0;
+  for (double a : rowsA.value) largest = max(largest, fabs(a));
+  double eta = largest > 0.0 ? 1.0 / largest : 1.0;
+  double scaledBounds = 0.0;
+  for (uint32_t i = 0; i < m; ++i) {
+    if (rowLower[i] > -INFINITY) scaledBounds += rowLower[i] * rowLower[i];
+    if (rowUpper[i] < INFINITY && rowUpper[i] != rowLower[i]) scaledBounds += rowUpper[i] * rowUpper[i];
+  }
+  scaledBounds = sqrt(scaledBounds);
+  double scaledCost = norm(cost);
+  double omega = scaledCost > 1e-10 && scaledBounds > 1e-10 ? scaledCost / scaledBounds : 1.0;
+  double omegaMin = omega / OMEGA_RANGE, omegaMax = omega * OMEGA_RANGE;
+
+  vector<double> xNew(n), yNew(m), axNew(m), atyNew(n);
+  vector<double> xSum(n, 0.0), ySum(m, 0.0), axSum(m, 0.0), atySum(n, 0.0);
+  vector<double> xAvg(n), yAvg(m), axAvg(m), atyAvg(n), dx(n), dy(m), adx(m), atdy(n);
+  vector<double> xLast = x, yLast = y, axLast = ax, atyLast = aty;
+  double weightSum = 0.0;
+  double kktLast = evaluate(x, y, ax, aty).kkt();
+  double kktPrevious = INFINITY; // Candidate KKT error at the previous check
+  uint64_t sinceRestart = 0, tries = 0;
+
+  for (;;) {
+    if (iterationCount >= iterationLimit) return PdlpStatus::ITERATION_LIMIT;
+
+    // Adaptive step: shrink eta until the step is within the local limit
+    double weight;
+    for (uint64_t rejected = 0;; ++rejected) {
+      if (cancelFlag && cancelFlag->load()) return PdlpStatus::CANCELLED;
+      if (chrono::duration<double>(chrono::steady_clock::now() - start).count() > timeLimit) {
+        return PdlpStatus::TIME_LIMIT;
+      }
+      if (rejected >= MAX_STEP_TRIES) return PdlpStatus::NUMERICAL_ERROR;
+      double tau = eta / omega, sigma = eta * omega;
+      double dx2 = 0.0;
+      for (uint32_t j = 0; j < n; ++j) {
+        xNew[j] = min(max(x[j] - tau * (cost[j] + aty[j]), lower[j]), upper[j]);
+        dx2 += (xNew[j] - x[j]) * (xNew[j] - x[j]);
+      }
+      multiply(rowsA, rowRanges, xNew, axNew, workers);
+      double dy2 = 0.0, interaction = 0.0;
+      for (uint32_t i = 0; i < m; ++i) {
+        double v = y[i] + sigma * (2.0 * axNew[i] - ax[i]);
+        yNew[i] = v - sigma * min(max(v / sigma, rowLower[i]), rowUpper[i]);
+        double step = yNew[i] - y[i];
+        dy2 += step * step;
+        interaction += step * (axNew[i] - ax[i]);
+      }
+      ++tries;
+      double movement = 0.5 * (omega * dx2 + dy2 / omega);
+      double limit = interaction != 0.0 ? movement / fabs(interaction) : INFINITY;
+      if (!isfinite(movement) || isnan(limit)) return PdlpStatus::NUMERICAL_ERROR;
+      double next = min((1.0 - pow(double(tries + 1), -0.3)) * limit, (1.0 + pow(double(tries + 1), -0.6)) * eta);
+      if (!isfinite(next) || next <= 0.0) return PdlpStatus::NUMERICAL_ERROR;
+      bool accepted = eta <= limit;
+      weight = eta;
+      eta = next;
+      if (accepted) break;
+    }
+    multiply(colsA, colRanges, yNew, atyNew, workers);
+    x.swap(xNew);
+    y.swap(yNew);
+    ax.swap(axNew);
+    aty.swap(atyNew);
+    for (uint32_t j = 0; j < n; ++j) {
+      xSum[j] += weight * x[j];
+      atySum[j] += weight * aty[j];
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      ySum[i] += weight * y[i];
+      axSum[i] += weight * ax[i];
+    }
+    weightSum += weight;
+    ++iterationCount;
+    ++sinceRestart;
+    if (iterationCount % RESTART_CHECK != 0) continue;
+
+    Residuals current = evaluate(x, y, ax, aty);
+    if (converged(current)) return PdlpStatus::OPTIMAL;
+    for (uint32_t j = 0; j < n; ++j) {
+      xAvg[j] = xSum[j] / weightSum;
+      atyAvg[j] = atySum[j] / weightSum;
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      yAvg[i] = ySum[i] / weightSum;
+      axAvg[i] = axSum[i] / weightSum;
+    }
+    Residuals average = evaluate(xAvg, yAvg, axAvg, atyAvg);
+    bool useAverage = average.kkt() < current.kkt();
+    if (useAverage) {
+      x.swap(xAvg);
+      y.swap(yAvg);
+      ax.swap(axAvg);
+      aty.swap(atyAvg);
+      if (converged(average)) return PdlpStatus::OPTIMAL;
+    }
+
+    for (uint32_t j = 0; j < n; ++j) {
+      dx[j] = x[j] - xLast[j];
+      atdy[j] = aty[j] - atyLast[j];
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      dy[i] = y[i] - yLast[i];
+      adx[i] = ax[i] - axLast[i];
+    }
+    if (dualRay(dy, atdy)) return PdlpStatus::INFEASIBLE;
+    if (primalRay(dx, adx)) {
+      // Feasibility, by the same method on a zero objective, which cannot be unbounded
+      PdlpSolver phase = *this;
+      phase.cost.assign(n, 0.0);
+      phase.costNorm = 0.0;
+      phase.iterationCount = phase.productCount = 0;
+      phase.iterationLimit = iterationLimit - iterationCount;
+      phase.timeLimit = timeLimit - chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      PdlpStatus feasible = phase.iterate();
+      iterationCount += phase.iterationCount;
+      productCount += phase.productCount;
+      if (feasible == PdlpStatus::OPTIMAL) return PdlpStatus::UNBOUNDED;
+      if (feasible == PdlpStatus::INFEASIBLE || feasible == PdlpStatus::TIME_LIMIT ||
+          feasible == PdlpStatus::ITERATION_LIMIT || feasible == PdlpStatus::CANCELLED) {
+        return feasible;
+      }
+      return PdlpStatus::NUMERICAL_ERROR;
+    }
+
+    double kktCandidate = useAverage ? average.kkt() : current.kkt();
+    bool restart = kktCandidate <= RESTART_SUFFICIENT * kktLast ||
+                   (kktCandidate <= RESTART_NECESSARY * kktLast && kktCandidate > kktPrevious) ||
+                   sinceRestart >= RESTART_ARTIFICIAL * iterationCount;
+    kktPrevious = kktCandidate;
+    if (!restart) {
+      if (useAverage) {
+        // Keep iterating from the current iterate, not the average
+        x.swap(xAvg);
+        y.swap(yAvg);
+        ax.swap(axAvg);
+        aty.swap(atyAvg);
+      }
+      continue;
+    }
+
+    // Primal weight: geometric mean of the old one and the ratio of the moves since the last restart.
+    // On infeasible LPs it grows with the diverging y, which is what exposes the ray, so the range only
+    // keeps tau and sigma finite.
+    double deltaX = norm(dx), deltaY = norm(dy);
+    if (deltaX > 1e-10 && deltaY > 1e-10) omega = exp(0.5 * log(deltaY / deltaX) + 0.5 * log(omega));
+    if (!isfinite(omega)) return PdlpStatus::NUMERICAL_ERROR;
+    omega = min(max(omega, omegaMin), omegaMax);
+    xLast = x;
+    yLast = y;
+    axLast = ax;
+    atyLast = aty;
+    kktLast = kktCandidate;
+    kktPrevious = INFINITY;
+    fill(xSum.begin(), xSum.end(), 0.0);
+    fill(ySum.begin(), ySum.end(), 0.0);
+    fill(axSum.begin(), axSum.end(), 0.0);
+    fill(atySum.begin(), atySum.end(), 0.0);
+    weightSum = 0.0;
+    sinceRestart = 0;
+  }
+}
+
+double PdlpSolver::getObjectiveValue() const {
+  double value = 0.0;
+  for (uint32_t j = 0; j < x.size(); ++j) value += cost[j] * x[j];
+  return (maximize ? -value : value) + objectiveOffset;
+}
+
+vector<double> PdlpSolver::getVariableValues() const {
+  vector<double> values(x.size());
+  for (uint32_t j = 0; j < x.size(); ++j) values[j] = x[j] * colScale[j];
+  return values;
+}
+
+vector<double> PdlpSolver::getRowActivities() const {
+  vector<double> activities(ax.size());
+  for (uint32_t i = 0; i < ax.size(); ++i) activities[i] = ax[i] / rowScale[i];
+  return activities;
+}
+
+// y is the multiplier of A x in c^T x + y^T A x: its negative, in the model's sense
+vector<double> PdlpSolver::getRowDuals() const {
+  vector<double> duals(y.size());
+  for (uint32_t i = 0; i < y.size(); ++i) duals[i] = (maximize ? y[i] : -y[i]) * rowScale[i];
+  return duals;
+}
+
+vector<double> PdlpSolver::getReducedCosts() const {
+  vector<double> reduced(aty.size());
+  for (uint32_t j = 0; j < aty.size(); ++j) {
+    double r = (cost[j] + aty[j]) / colScale[j];
+    reduced[j] = maximize ? -r : r;
+  }
+  return reduced;
+}
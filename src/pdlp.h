@@ -0,0 +1,201 @@
+#pragma once
+
+#include "compact_model.h"
+#include "sparse_multiply.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Outcome of a PdlpSolver run.
+ */
+enum class PdlpStatus {
+  UNSOLVED,        // solve() has not run
+  OPTIMAL,         // Relative residuals and gap within the tolerance
+  INFEASIBLE,      // The dual iterates move along a ray certifying primal infeasibility
+  UNBOUNDED,       // An improving ray, and a feasible point from a run on a zero objective
+  ITERATION_LIMIT, // Stopped at the iteration limit
+  TIME_LIMIT,      // Stopped at the time limit
+  CANCELLED,       // The cancel flag was raised
+  NUMERICAL_ERROR  // The step search failed or the iterates stopped being finite
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "OPTIMAL".
+ */
+const char* pdlpStatusName(PdlpStatus status);
+
+/**
+ * @class PdlpSolver
+ * @brief Matrix-free first-order LP method: primal-dual hybrid gradient
+ * in the style of PDLP, for LPs too large to factorize.
+ *
+ * Solves min c^T x over l <= x <= u, rl <= A x <= ru as the saddle point
+ * of c^T x + y^T A x - g*(y). Each iteration is a projected gradient step
+ * in x followed by one in y at the extrapolated point 2 x' - x, so the
+ * only work beyond vector updates is one product with A and one with A^T.
+ * These run on the SIMD kernels of sparse_multiply.h over a scaled CSR
+ * and CSC copy of A, with the lines split across a thread pool.
+ *
+ * As in PDLP, A is diagonally preconditioned (Ruiz equilibration, then
+ * Pock-Chambolle), the step size adapts to the local curvature
+ * |dy^T A dx|, and the primal weight balancing the two step sizes is
+ * updated at each restart. Restarts go to the current or the averaged
+ * iterate, whichever has the smaller KKT error, once that error has
+ * fallen far enough since the last restart.
+ *
+ * Optimality is judged on the unscaled model: primal and dual residuals
+ * relative to the bounds and costs, and the relative duality gap. The
+ * difference between the iterate and the last restart point is tested
+ * as an infeasibility or unboundedness ray. An improving ray proves the
+ * LP unbounded only with a feasible point, which a second run on a zero
+ * objective looks for; if that run proves the LP infeasible, so is the
+ * result, and if it fails, the result is NUMERICAL_ERROR. Empty rows and
+ * columns are decided before iterating, since their rays would only show
+ * as diverging iterates. Integrality is ignored. The solution is accurate
+ * to the tolerance, not a vertex; crossover turns it into a basic
+ * solution.
+ */
+class PdlpSolver {
+  uint32_t m = 0;                    // Rows
+  uint32_t n = 0;                    // Columns
+  bool maximize = false;
+  double objectiveOffset = 0.0;
+
+  SparseMatrix rowsA;                // Scaled A, row-major: A x
+  SparseMatrix colsA;                // Scaled A, column-major: A^T y
+  std::vector<double> rowScale;      // Scaled A = diag(rowScale) A diag(colScale)
+  std::vector<double> colScale;
+  std::vector<double> cost;          // Per column, scaled, minimized
+  std::vector<double> lower;         // Per column, scaled
+  std::vector<double> upper;
+  std::vector<double> rowLower;      // Per row, scaled
+  std::vector<double> rowUpper;
+  double costNorm = 0.0;             // Unscaled 2-norms for the relative tolerances
+  double boundNorm = 0.0;
+
+  // Final iterate (scaled) with its products A x and A^T y
+  std::vector<double> x, y, ax, aty;
+
+  PdlpStatus result = PdlpStatus::UNSOLVED;
+  uint64_t iterationCount = 0;
+  uint64_t iterationLimit = 1000000;
+  uint64_t productCount = 0;
+  double timeLimit = INFINITY;
+  double tolerance = 1e-6;
+  unsigned numThreads = 0;
+  SimdLevel simd = detectSimdLevel();
+  const std::atomic<bool>* cancelFlag = nullptr;
+
+  struct Residuals {
+    double primal = 0.0;           // ||violation of rl <= A x <= ru||
+    double dual = 0.0;             // ||c + A^T y - lambda||, lambda the feasible part
+    double primalObjective = 0.0;
+    double dualObjective = 0.0;
+    double kkt() const;
+  };
+
+  void scale();
+  void multiply(const SparseMatrix& a, const std::vector<uint32_t>& ranges, const std::vector<double>& v,
+                std::vector<double>& out, ThreadPool* pool);
+  Residuals evaluate(const std::vector<double>& px, const std::vector<double>& py, const std::vector<double>& pax,
+                     const std::vector<double>& paty) const;
+  bool converged(const Residuals& r) const;
+  bool primalRay(const std::vector<double>& dx, const std::vector<double>& adx) const;
+  bool dualRay(const std::vector<double>& dy, const std::vector<double>& atdy) const;
+  PdlpStatus iterate();
+
+public:
+  /**
+   * @brief Loads a CompactModel (copied and scaled internally).
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Runs the method from x = 0 (projected onto the bounds), y = 0.
+   *
+   * @return The final status, also available from status().
+   */
+  PdlpStatus solve();
+
+  /**
+   * @brief Objective value of the final iterate, in the model's sense and
+   * including the objective constant.
+   */
+  double getObjectiveValue() const;
+
+  /**
+   * @brief Values of the structural variables, indexed by column id.
+   */
+  std::vector<double> getVariableValues() const;
+
+  /**
+   * @brief Row activities A x, indexed by row id.
+   */
+  std::vector<double> getRowActivities() const;
+
+  /**
+   * @brief Dual values of the rows, indexed by row id, in the model's
+   * sense: d(objective) / d(row bound).
+   */
+  std::vector<double> getRowDuals() const;
+
+  /**
+   * @brief Reduced costs of the structural columns, indexed by column id,
+   * in the model's sense.
+   */
+  std::vector<double> getReducedCosts() const;
+
+  /**
+   * @brief Status of the last solve().
+   */
+  PdlpStatus status() const { return result; }
+
+  /**
+   * @brief Accepted steps of the last solve().
+   */
+  uint64_t iterations() const { return iterationCount; }
+
+  /**
+   * @brief Products with A or A^T of the last solve(), rejected steps and
+   * restarts included.
+   */
+  uint64_t products() const { return productCount; }
+
+  /**
+   * @brief Threads for the matrix-vector products (0 = one per hardware
+   * thread). Results do not depend on it.
+   */
+  void setThreads(unsigned threads) { numThreads = threads; }
+
+  /**
+   * @brief Caps the kernels at `level` (default: the best detectSimdLevel()
+   * reports), e.g. to compare them.
+   */
+  void setSimdLevel(SimdLevel level) { simd = level; }
+
+  /**
+   * @brief Caps the iterations per solve() (default 1000000).
+   */
+  void setIterationLimit(uint64_t limit) { iterationLimit = limit; }
+
+  /**
+   * @brief Wall-clock seconds per solve(), checked before every step
+   * tried, rejected ones included.
+   */
+  void setTimeLimit(double seconds) { timeLimit = seconds; }
+
+  /**
+   * @brief Relative residual and gap tolerance (default 1e-6).
+   */
+  void setTolerance(double value) { tolerance = value; }
+
+  /**
+   * @brief solve() stops before the next step tried once `*flag` is true;
+   * null detaches the flag.
+   */
+  void setCancelFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+};
@@ -0,0 +1,331 @@
+#include "pipeline.h"
+#include "parser.h"
+#include "lp_format.h"
+#include "mps.h"
+#include "snapshot.h"
+#include "branch_and_bound.h"
+#include "basis_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+  // Size counters of `model`, named with `prefix`
+  void recordModelSize(SolveStats& stats, const CompactModel& model, const std::string& prefix) {
+    uint64_t integerColumns = 0;
+    for (VarType kind : model.colKind) integerColumns += kind != VarType::CONTINUOUS;
+    stats.setCounter(prefix + "rows", model.numRows);
+    stats.setCounter(prefix + "columns", model.numCols);
+    stats.setCounter(prefix + "nonzeros", model.rows.numNonzeros());
+    stats.setCounter(prefix + "integer_columns", integerColumns);
+  }
+} // anonymous namespace
+
+bool endsWith(const std::string& path, const std::string& suffix) {
+  return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string resolveFormat(const std::string& path, const std::string& format) {
+  if (!format.empty()) return format;
+  if (endsWith(path, ".lp")) return "lp";
+  if (endsWith(path, ".mps")) return "mps";
+  if (endsWith(path, ".snap")) return "snap";
+  return "txt";
+}
+
+CompactModel readModel(const std::string& path, std::string format, unsigned numThreads) {
+  format = resolveFormat(path, format);
+  if (format == "snap") return ModelSnapshot::readFile(path);
+  if (format == "lp") return CompactModel::fromLPModel(CplexLpReader::readFile(path));
+  if (format == "mps") return MpsReader::readFile(path);
+  if (format == "txt") return CompactModel::fromLPModel(Parser::parseFile(path, numThreads));
+  throw std::runtime_error("Unknown input format: " + format);
+}
+
+CompactModel readModelBuffer(std::string_view text, const std::string& format, unsigned numThreads) {
+  if (format == "lp") return CompactModel::fromLPModel(CplexLpReader::readBuffer(text));
+  if (format == "mps") return MpsReader::readBuffer(text);
+  if (format == "txt") return CompactModel::fromLPModel(Parser::parseBuffer(text, numThreads));
+  throw std::runtime_error("Unsupported format for a model in memory: " + format);
+}
+
+void printPresolveStats(const PresolveStats& stats) {
+  const std::pair<const char*, uint32_t> entries[] = {
+    { "empty rows", stats.emptyRows },
+    { "singleton rows", stats.singletonRows },
+    { "redundant rows", stats.redundantRows },
+    { "forcing rows", stats.forcingRows },
+    { "duplicate rows", stats.duplicateRows },
+    { "fixed columns", stats.fixedColumns },
+    { "empty columns", stats.emptyColumns },
+    { "dominated columns", stats.dominatedColumns },
+    { "slack columns", stats.slackColumns },
+    { "duplicate columns", stats.duplicateColumns },
+    { "tightened bounds", stats.tightenedBounds },
+    { "integer roundings", stats.integerRoundings },
+    { "tightened coefficients", stats.coefficientsTightened },
+    { "probed binaries", stats.probedColumns },
+    { "fixed by probing", stats.probingFixed },
+    { "bounds from probing", stats.probingTightened },
+    { "implications", stats.implications },
+    { "cliques", stats.cliques },
+    { "clique rows", stats.cliqueRows },
+  };
+  for (const auto& entry : entries) {
+    if (entry.second > 0) std::cout << "  " << entry.first << ": " << entry.second << "\n";
+  }
+  if (stats.timedOut) std::cout << "  (stopped at the time limit)\n";
+}
+
+SimplexBasis readStartBasis(const std::string& path, const CompactModel& model) {
+  size_t matched = 0;
+  SimplexBasis basis = BasisFile::readFile(path, model, &matched);
+  std::cout << "Warm start: " << matched << " of " << size_t(model.numCols) + model.numRows
+            << " columns and rows found in " << path << "\n";
+  return basis;
+}
+
+SolveResult solveModel(const CompactModel& model, const SolveOptions& options, GLPKSolver& glpk,
+                       SolveStats& stats) {
+  recordModelSize(stats, model, "");
+  // The time limit covers the whole solve: each solver gets what presolve and earlier phases left
+  auto start = std::chrono::steady_clock::now();
+  auto remaining = [&] {
+    return options.limits.timeLimit - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  // Presolve; the solver sees the reduced model and postsolve maps its solution back. A basis
+  // file names the model's own rows and columns and their bounds, which presolve removes or
+  // changes, so loading or saving one turns presolve off.
+  bool usePresolve = options.usePresolve && options.basisInput.empty() && options.basisOutput.empty();
+  Presolver presolver;
+  if (usePresolve) {
+    presolver.setTimeLimit(std::min(options.presolveTime, options.limits.timeLimit));
+    PresolveStatus status;
+    {
+      SolveStats::Timer timer(&stats, "presolve");
+      status = presolver.presolve(model);
+    }
+    if (status != PresolveStatus::REDUCED) {
+      throw std::runtime_error(std::string("Presolve: model is ") + presolveStatusName(status));
+    }
+    const CompactModel& reduced = presolver.reducedModel();
+    recordModelSize(stats, reduced, "presolved_");
+    if (options.verbose) {
+      std::cout << "Presolve: " << reduced.numRows << " of " << model.numRows << " rows, "
+                << reduced.numCols << " of " << model.numCols << " columns, "
+                << reduced.rows.numNonzeros() << " of " << model.rows.numNonzeros() << " nonzeros remain\n";
+      printPresolveStats(presolver.stats());
+    }
+  }
+  const CompactModel& target = usePresolve ? presolver.reducedModel() : model;
+  const std::string& basisInput = options.basisInput;
+  const std::string& basisOutput = options.basisOutput;
+
+  SolveResult result;
+  result.status = "OPTIMAL";
+  if (target.numCols == 0) {
+    // Presolve removed everything; the objective constant is the optimum
+    result.objective = target.objectiveOffset;
+  }
+  else if (options.solverName == "glpk") {
+    // GLPK records its own phases; the solver outlives `stats`, so detach on the way out
+    struct Detach {
+      GLPKSolver& solver;
+      ~Detach() { solver.setStats(nullptr); }
+    } detach{ glpk };
+    glpk.setStats(&stats);
+    glpk.loadModel(target);
+    SolveLimits limits = options.limits;
+    limits.timeLimit = remaining();
+    glpk.setLimits(limits);
+    glpk.setLpMethod(options.lpMethod);
+    glpk.setThreads(options.numThreads);
+    glpk.setCrossover(options.crossover);
+    if (!basisInput.empty()) glpk.setBasis(readStartBasis(basisInput, target));
+
+    // Solve the problem; a model without integer columns skips branch-and-bound
+    glpk.solve(options.useDualSimplex, target.hasIntegerColumns());
+    if (!basisOutput.empty()) BasisFile::writeFile(target, glpk.getBasis(), basisOutput);
+    result.stop = glpk.stopReason();
+    if (glpk.lpWinner() != LpRacer::NONE) result.lpWinner = lpRacerName(glpk.lpWinner());
+    if (!glpk.lpRaceSummary().empty() && options.verbose) {
+      std::cout << "Concurrent LP: " << glpk.lpRaceSummary() << "\n";
+    }
+    if (!glpk.hasSolution()) {
+      if (result.stop != StopReason::NONE) {
+        result.status = stopReasonName(result.stop);
+        return result;
+      }
+      throw std::runtime_error(std::string("GLPK found no solution: ") + glpk.statusName());
+    }
+    result.status = glpk.statusName();
+    result.objective = glpk.getObjectiveValue();
+    result.values = glpk.getVariableValues();
+  }
+  else if (options.solverName == "simplex" && target.hasIntegerColumns()) {
+    BranchAndBound solver;
+    {
+      SolveStats::Timer timer(&stats, "load");
+      solver.loadModel(target);
+    }
+    solver.setThreads(options.numThreads);
+    solver.setDeterministic(options.deterministic);
+    solver.setNodeLimit(options.limits.nodeLimit);
+    if (!basisInput.empty()) solver.setRootBasis(readStartBasis(basisInput, target));
+    MipStatus status;
+    {
+      SolveStats::Timer timer(&stats, "mip");
+      status = solver.solve();
+    }
+    stats.setCounter("mip_iterations", solver.iterations());
+    stats.setCounter("nodes", solver.nodes());
+    stats.setCounter("incumbent_updates", solver.incumbentUpdates());
+    if (status == MipStatus::NODE_LIMIT) result.stop = StopReason::NODE_LIMIT;
+    if (!basisOutput.empty() && status != MipStatus::UNBOUNDED && status != MipStatus::INFEASIBLE) {
+      BasisFile::writeFile(target, solver.getRootBasis(), basisOutput);
+    }
+    if (!solver.hasSolution()) {
+      if (result.stop != StopReason::NONE) {
+        result.status = stopReasonName(result.stop);
+        return result;
+      }
+      throw std::runtime_error(std::string("Branch-and-bound found no solution: ") + mipStatusName(status));
+    }
+    if (status != MipStatus::OPTIMAL && result.stop == StopReason::NONE && options.verbose) {
+      std::cerr << "Warning: branch-and-bound stopped with status " << mipStatusName(status) << "\n";
+    }
+    result.status = result.stop == StopReason::NONE ? mipStatusName(status) : "FEASIBLE";
+    result.objective = solver.getObjectiveValue();
+    result.values = solver.getVariableValues();
+  }
+  else if (options.solverName == "simplex" && (options.lpMethod == LpMethod::BARRIER ||
+                                               options.lpMethod == LpMethod::PDLP ||
+                                               options.lpMethod == LpMethod::CONCURRENT)) {
+    NativeLpSettings settings;
+    settings.method = options.lpMethod;
+    settings.threads = options.numThreads;
+    settings.timeLimit = remaining();
+    settings.iterationLimit = options.limits.iterationLimit;
+    settings.crossover = options.crossover;
+    if (!basisInput.empty() && options.lpMethod == LpMethod::CONCURRENT) {
+      settings.startBasis = readStartBasis(basisInput, target);
+    }
+    NativeLpResult lp = runNativeLp(target, settings, &stats);
+    if (lp.winner != LpRacer::NONE) result.lpWinner = lpRacerName(lp.winner);
+    if (!lp.raceSummary.empty() && options.verbose) std::cout << "Concurrent LP: " << lp.raceSummary << "\n";
+    if (lp.fallbackFrom && options.verbose) {
+      std::cerr << "Warning: barrier stopped with status " << lp.fallbackFrom << "; solved by the dual simplex\n";
+    }
+    const char* method = lp.fallbackFrom ? "Dual simplex"
+                         : options.lpMethod == LpMethod::PDLP ? "PDLP"
+                         : options.lpMethod == LpMethod::CONCURRENT ? "Concurrent LP" : "Barrier";
+    const char* solutionKind = options.lpMethod == LpMethod::PDLP ? "PDLP"
+                               : options.lpMethod == LpMethod::CONCURRENT ? "winner's" : "interior-point";
+    if (lp.outcome == NativeLpResult::Outcome::STOPPED) {
+      result.stop = lp.stop;
+      result.status = stopReasonName(result.stop);
+      return result;
+    }
+    if (lp.outcome != NativeLpResult::Outcome::OPTIMAL) {
+      throw std::runtime_error(std::string(method) + " did not find an optimum: " + lp.status);
+    }
+    result.objective = lp.objective;
+    result.values = lp.values;
+
+    // Push from the solution to a vertex, then finish with the dual simplex
+    if (options.crossover) {
+      SimplexSolver simplex;
+      SimplexStatus crossoverStatus;
+      {
+        SolveStats::Timer timer(&stats, "crossover");
+        simplex.loadModel(target);
+        simplex.setIterationLimit(options.limits.iterationLimit);
+        simplex.setTimeLimit(remaining());
+        crossoverStatus = simplex.crossover(result.values, lp.crossoverStartBasis);
+      }
+      stats.setCounter("crossover_iterations", simplex.iterations());
+      if (!basisOutput.empty()) BasisFile::writeFile(target, simplex.getBasis(), basisOutput);
+      if (crossoverStatus == SimplexStatus::OPTIMAL) {
+        result.objective = simplex.getObjectiveValue();
+        result.values = simplex.getVariableValues();
+      }
+      else if (options.verbose) {
+        std::cerr << "Warning: crossover stopped with status " << simplexStatusName(crossoverStatus)
+                  << "; keeping the " << solutionKind << " solution\n";
+      }
+    }
+  }
+  else if (options.solverName == "simplex") {
+    SimplexSolver solver;
+    {
+      SolveStats::Timer timer(&stats, "load");
+      solver.loadModel(target);
+    }
+    solver.setIterationLimit(options.limits.iterationLimit);
+    solver.setTimeLimit(remaining());
+    if (!basisInput.empty()) solver.setBasis(readStartBasis(basisInput, target));
+    SimplexStatus status;
+    {
+      SolveStats::Timer timer(&stats, "lp");
+      status = solver.solve(options.useDualSimplex);
+    }
+    stats.setCounter("lp_iterations", solver.iterations());
+    if (!basisOutput.empty()) BasisFile::writeFile(target, solver.getBasis(), basisOutput);
+    if (status == SimplexStatus::ITERATION_LIMIT || status == SimplexStatus::TIME_LIMIT) {
+      result.stop = status == SimplexStatus::TIME_LIMIT ? StopReason::TIME_LIMIT : StopReason::ITERATION_LIMIT;
+      result.status = stopReasonName(result.stop);
+      return result;
+    }
+    if (status != SimplexStatus::OPTIMAL) {
+      throw std::runtime_error(std::string("Simplex did not find an optimum: ") + simplexStatusName(status));
+    }
+    result.objective = solver.getObjectiveValue();
+    result.values = solver.getVariableValues();
+  }
+  else {
+    throw std::runtime_error("Unknown solver: " + options.solverName);
+  }
+  if (usePresolve) {
+    SolveStats::Timer timer(&stats, "postsolve");
+    result.values = presolver.postsolve(result.values);
+  }
+  return result;
+}
+
+std::string jsonString(std::string_view text) {
+  std::string out = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20) {
+      char escape[8];
+      std::snprintf(escape, sizeof escape, "\\u%04x", c);
+      out += escape;
+    }
+    else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+std::string resultJson(const CompactModel& model, const SolveResult& result) {
+  std::ostringstream out;
+  out.precision(15);
+  out << "\"status\":" << jsonString(result.status);
+  if (result.values.empty() && model.numCols > 0) return out.str();
+  if (result.stop != StopReason::NONE) out << ",\"stopped\":" << jsonString(stopReasonName(result.stop));
+  if (!result.lpWinner.empty()) out << ",\"lp_winner\":" << jsonString(result.lpWinner);
+  out << ",\"objective\":" << result.objective << ",\"values\":{";
+  for (uint32_t j = 0; j < result.values.size(); ++j) {
+    out << (j ? "," : "") << jsonString(model.variables.name(j)) << ':' << result.values[j];
+  }
+  out << '}';
+  return out.str();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "compact_model.h"
+#include "presolve.h"
+#include "simplex.h"
+#include "solver.h"
+#include "solve_stats.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Returns true if `path` ends with `suffix`.
+ */
+bool endsWith(const std::string& path, const std::string& suffix);
+
+/**
+ * @brief Returns `format`, or the format implied by the extension of `path` if it is empty.
+ */
+std::string resolveFormat(const std::string& path, const std::string& format);
+
+/**
+ * @brief Reads the input model in the given format ("" picks one by extension).
+ */
+CompactModel readModel(const std::string& path, std::string format, unsigned numThreads);
+
+/**
+ * @brief Reads a model held in memory: txt, lp or mps.
+ */
+CompactModel readModelBuffer(std::string_view text, const std::string& format, unsigned numThreads);
+
+/**
+ * @brief Prints the reductions presolve made, one "technique: count" pair per nonzero count.
+ */
+void printPresolveStats(const PresolveStats& stats);
+
+/**
+ * @brief Reads the basis file at `path` for `model` and reports how much of it matched.
+ */
+SimplexBasis readStartBasis(const std::string& path, const CompactModel& model);
+
+/**
+ * @brief Solver settings taken from the command line.
+ */
+struct SolveOptions {
+  std::string solverName = "glpk";
+  bool useDualSimplex = false;
+  LpMethod lpMethod = LpMethod::SIMPLEX; // Pure LPs; LpMethod::INTERIOR is GLPK's alone
+  bool crossover = false;      // Barrier, PDLP and race optima go on to an optimal basis
+  bool deterministic = false;
+  bool usePresolve = true;     // Ignored (off) with a basis file to load or save
+  double presolveTime = 10.0;
+  // All limits apply to GLPK; the native branch-and-bound honours the node
+  // limit, and the native LP simplex, barrier, PDLP, concurrent race and
+  // crossover the time and iteration limits. The time limit covers the
+  // whole solve: presolve gets at most all of it, and each solver what is
+  // left.
+  SolveLimits limits;
+  unsigned numThreads = 0;     // Branch-and-bound workers, barrier, PDLP and race threads
+  std::string basisInput;
+  std::string basisOutput;
+  bool verbose = true;         // Print presolve and warm-start reports and warnings
+};
+
+/**
+ * @brief Outcome of solveModel(): values are by column id of the input
+ * model, and empty if a stopped solve found no solution.
+ */
+struct SolveResult {
+  std::string status;
+  StopReason stop = StopReason::NONE;
+  double objective = 0.0;
+  std::vector<double> values;
+  std::string lpWinner;        // With LpMethod::CONCURRENT: lpRacerName() of the winner, if any
+};
+
+/**
+ * @brief Presolves `model`, solves the reduced model with the selected
+ * solver (`glpk` if it is "glpk") and maps the solution back. A basis
+ * file to load or save refers to the model's own rows and columns, so it
+ * turns presolve off. The model sizes and the presolve, load, lp,
+ * crossover, mip and postsolve phases are recorded in `stats`, with
+ * ConcurrentLpSolver::recordStats() for a race, whose summary is printed
+ * if `options.verbose`.
+ *
+ * @throws std::runtime_error if presolve or the solver finds no solution,
+ * except when a limit or GLPKSolver::cancel() stopped the solver first:
+ * then the result has the stop reason as its status and no values.
+ */
+SolveResult solveModel(const CompactModel& model, const SolveOptions& options, GLPKSolver& glpk,
+                       SolveStats& stats);
+
+/**
+ * @brief Returns `text` as a quoted JSON string.
+ */
+std::string jsonString(std::string_view text);
+
+/**
+ * @brief JSON members (without braces) for `result`: status, and if it
+ * has a solution, the stop reason and race winner if any, the objective
+ * and the values keyed by column name.
+ */
+std::string resultJson(const CompactModel& model, const SolveResult& result);
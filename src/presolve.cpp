@@ -0,0 +1,1027 @@
+#include "presolve.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+  constexpr double FEASIBILITY_TOLERANCE = 1e-7; // Relative bound violation still counted as feasible
+  constexpr double INTEGER_TOLERANCE = 1e-6;     // Distance to an integer still counted as integral
+  constexpr double MIN_TIGHTENING = 1e-3;        // Relative change that makes a continuous bound worth tightening
+  constexpr double MAX_IMPLIED_BOUND = 1e9;      // Implied bounds beyond this are not trusted
+  constexpr double MIN_COEFFICIENT = 1e-9;       // Smaller entries imply no bounds
+  constexpr double PARALLEL_TOLERANCE = 1e-12;   // Relative difference still counted as parallel
+  constexpr uint32_t MAX_PASSES = 20;
+  constexpr size_t MAX_PAIR_CHECKS = 16;         // Earlier lines compared per line in duplicate detection
+  constexpr size_t MAX_PROBES = 5000;            // Binaries probed per presolve
+  constexpr size_t PROBE_WORK = 20000;           // Row entries visited by propagation per probe
+  constexpr size_t MAX_IMPLICATIONS = 1000000;
+
+  double tolerance(double bound) {
+    return FEASIBILITY_TOLERANCE * max(1.0, fabs(bound));
+  }
+
+  // Smallest and largest value of a * x over x in [lower, upper]
+  double minTerm(double a, double lower, double upper) { return a > 0 ? a * lower : a * upper; }
+  double maxTerm(double a, double lower, double upper) { return a > 0 ? a * upper : a * lower; }
+
+  // The point of [lower, upper] closest to zero; the midpoint if rounding emptied the interval
+  double closestToZero(double lower, double upper) {
+    if (lower > upper) return 0.5 * (lower + upper);
+    return min(max(0.0, lower), upper);
+  }
+
+  uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+  }
+
+  /*
+   * Function: lineHash
+   * -------------------------
+   * Hash of major line k over its active minor entries, with values
+   * divided by the first one so that parallel lines hash alike. Values
+   * are rounded to six digits; a parallel pair split by the rounding is
+   * only a missed reduction.
+   */
+  uint64_t lineHash(const SparseMatrix& m, uint32_t k, const vector<bool>& active) {
+    uint64_t h = 0;
+    double first = 0.0;
+    for (size_t p = m.start[k]; p < m.start[k + 1]; ++p) {
+      if (!active[m.index[p]]) continue;
+      if (first == 0.0) first = m.value[p];
+      h = mix(h, m.index[p]);
+      h = mix(h, static_cast<uint64_t>(llround(m.value[p] / first * 1e6)));
+    }
+    return h;
+  }
+
+  /*
+   * Function: parallelFactor
+   * -------------------------
+   * True if line b = factor * line a over the active minor entries.
+   * Both index lists are sorted, so one merge-style pass suffices.
+   */
+  bool parallelFactor(const SparseMatrix& m, uint32_t a, uint32_t b, const vector<bool>& active, double& factor) {
+    size_t p = m.start[a], q = m.start[b];
+    factor = 0.0;
+    for (;;) {
+      while (p < m.start[a + 1] && !active[m.index[p]]) ++p;
+      while (q < m.start[b + 1] && !active[m.index[q]]) ++q;
+      bool endA = p == m.start[a + 1], endB = q == m.start[b + 1];
+      if (endA || endB) return endA && endB && factor != 0.0;
+      if (m.index[p] != m.index[q]) return false;
+      if (factor == 0.0) factor = m.value[q] / m.value[p];
+      else if (fabs(m.value[q] - factor * m.value[p]) > PARALLEL_TOLERANCE * fabs(m.value[q])) return false;
+      ++p;
+      ++q;
+    }
+  }
+
+  /*
+   * Function: findDuplicates
+   * -------------------------
+   * Sorts the candidate lines by hash and, within each group of equal
+   * hashes, compares every line with the earlier lines that are still
+   * active. `merge(keep, drop, factor)` returns 1 if it removed line
+   * `drop`, 0 if the pair is not a duplicate after all, and -1 to stop
+   * the search.
+   */
+  template <typename Merge>
+  uint32_t findDuplicates(const SparseMatrix& m, const vector<uint32_t>& candidates, const vector<bool>& minorActive,
+                          const vector<bool>& majorActive, Merge merge) {
+    vector<pair<uint64_t, uint32_t>> keys;
+    keys.reserve(candidates.size());
+    for (uint32_t k : candidates) keys.push_back({ lineHash(m, k, minorActive), k });
+    sort(keys.begin(), keys.end());
+
+    uint32_t merged = 0;
+    for (size_t g = 0; g < keys.size();) {
+      size_t end = g;
+      while (end < keys.size() && keys[end].first == keys[g].first) ++end;
+      for (size_t b = g + 1; b < end; ++b) {
+        size_t checks = 0;
+        for (size_t a = g; a < b && checks < MAX_PAIR_CHECKS; ++a) {
+          uint32_t keep = keys[a].second, drop = keys[b].second;
+          if (!majorActive[keep]) continue;
+          ++checks;
+          double factor;
+          if (!parallelFactor(m, keep, drop, minorActive, factor)) continue;
+          int outcome = merge(keep, drop, factor);
+          if (outcome < 0) return merged;
+          if (outcome == 0) continue;
+          ++merged;
+          break;
+        }
+      }
+      g = end;
+    }
+    return merged;
+  }
+} // anonymous namespace
+
+const char* presolveStatusName(PresolveStatus status) {
+  switch (status) {
+    case PresolveStatus::UNSOLVED: return "UNSOLVED";
+    case PresolveStatus::REDUCED: return "REDUCED";
+    case PresolveStatus::INFEASIBLE: return "INFEASIBLE";
+    case PresolveStatus::INFEASIBLE_OR_UNBOUNDED: return "INFEASIBLE_OR_UNBOUNDED";
+  }
+  return "UNKNOWN";
+}
+
+/*
+ * Function: presolve
+ * -------------------------
+ * Copies the model into the working arrays (CSC first, so that the CSR
+ * built back from it has sorted column indices), rounds integer bounds,
+ * then runs the reduction passes until a full round changes nothing.
+ */
+PresolveStatus Presolver::presolve(const CompactModel& model) {
+  numRows = model.numRows;
+  numCols = model.numCols;
+  cols = model.rows.transpose(numCols);
+  rows = cols.transpose(numRows);
+  inputNonzeros = rows.numNonzeros();
+  rowLower = model.rowLower;
+  rowUpper = model.rowUpper;
+  colLower.assign(numCols, -INFINITY);
+  colUpper.assign(numCols, INFINITY);
+  cost.resize(numCols);
+  integral.resize(numCols);
+  for (uint32_t j = 0; j < numCols; ++j) {
+    cost[j] = model.type == OptType::MAXIMIZE ? -model.objective[j] : model.objective[j];
+    integral[j] = model.colKind[j] != VarType::CONTINUOUS;
+  }
+  fixedCost = 0.0;
+
+  rowActive.assign(numRows, true);
+  colActive.assign(numCols, true);
+  rowSize.resize(numRows);
+  colSize.resize(numCols);
+  for (uint32_t i = 0; i < numRows; ++i) rowSize[i] = static_cast<uint32_t>(rows.start[i + 1] - rows.start[i]);
+  for (uint32_t j = 0; j < numCols; ++j) colSize[j] = static_cast<uint32_t>(cols.start[j + 1] - cols.start[j]);
+
+  steps.clear();
+  stepTerms.clear();
+  counts = PresolveStats();
+  reduced = CompactModel();
+  colMap.clear();
+  rowMap.clear();
+  trail.clear();
+  rowQueued.assign(numRows, false);
+  implicationTable.clear();
+  cliques.clear();
+  cliqueLiterals.clear();
+  deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+                                               chrono::duration<double>(min(timeLimit, 1e9)));
+  result = PresolveStatus::REDUCED;
+
+  for (uint32_t j = 0; j < numCols && result == PresolveStatus::REDUCED; ++j) {
+    setColumnBounds(j, model.colLower[j], model.colUpper[j]);
+  }
+
+  // The MIP reductions run once the LP ones are exhausted; probing only once
+  uint32_t (Presolver::*const passes[])() = {
+    &Presolver::emptyAndSingletonRows, &Presolver::fixedColumns, &Presolver::dominatedColumns,
+    &Presolver::slackColumns, &Presolver::activityReductions, &Presolver::duplicateRows,
+    &Presolver::duplicateColumns,
+  };
+  bool hasIntegers = model.hasIntegerColumns(), probed = false;
+  for (uint32_t round = 0; round < MAX_PASSES && result == PresolveStatus::REDUCED; ++round) {
+    uint32_t changes = 0;
+    for (auto pass : passes) {
+      changes += (this->*pass)();
+      if (result != PresolveStatus::REDUCED) break;
+    }
+    if (result == PresolveStatus::REDUCED && changes == 0 && hasIntegers) {
+      changes += coefficientTightening();
+      if (!probed) {
+        probed = true;
+        changes += probing();
+      }
+    }
+    if (changes == 0 || outOfTime()) break;
+  }
+
+  if (result == PresolveStatus::REDUCED) {
+    if (hasIntegers && !outOfTime()) buildCliques();
+    buildReducedModel(model);
+  }
+  return result;
+}
+
+void Presolver::removeRow(uint32_t i) {
+  rowActive[i] = false;
+  for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+    if (colActive[rows.index[p]]) colSize[rows.index[p]]--;
+  }
+}
+
+/*
+ * Function: fixColumn
+ * -------------------------
+ * Removes column j at `value`: its terms move into the row bounds and
+ * its cost into the objective constant.
+ */
+void Presolver::fixColumn(uint32_t j, double value) {
+  for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+    uint32_t i = cols.index[p];
+    if (!rowActive[i]) continue;
+    double shift = cols.value[p] * value;
+    if (rowLower[i] > -INFINITY) rowLower[i] -= shift;
+    if (rowUpper[i] < INFINITY) rowUpper[i] -= shift;
+    rowSize[i]--;
+  }
+  colActive[j] = false;
+  fixedCost += cost[j] * value;
+
+  PostsolveStep step{};
+  step.kind = PostsolveStep::FIXED;
+  step.column = j;
+  step.value = value;
+  steps.push_back(step);
+}
+
+/*
+ * Function: setColumnBounds
+ * -------------------------
+ * Intersects the bounds of column j with [lower, upper], rounding inward
+ * for integer columns. Bounds that cross by no more than the tolerance
+ * are collapsed; beyond it the model is infeasible and false is returned.
+ */
+bool Presolver::setColumnBounds(uint32_t j, double lower, double upper) {
+  if (integral[j]) {
+    double roundedLower = ceil(lower - INTEGER_TOLERANCE), roundedUpper = floor(upper + INTEGER_TOLERANCE);
+    if (roundedLower > lower + INTEGER_TOLERANCE && roundedLower > colLower[j]) counts.integerRoundings++;
+    if (roundedUpper < upper - INTEGER_TOLERANCE && roundedUpper < colUpper[j]) counts.integerRoundings++;
+    lower = roundedLower;
+    upper = roundedUpper;
+  }
+  colLower[j] = max(colLower[j], lower);
+  colUpper[j] = min(colUpper[j], upper);
+  if (colLower[j] > colUpper[j]) {
+    if (integral[j] || colLower[j] > colUpper[j] + tolerance(colUpper[j])) {
+      result = PresolveStatus::INFEASIBLE;
+      return false;
+    }
+    colLower[j] = colUpper[j];
+  }
+  return true;
+}
+
+/*
+ * Function: emptyAndSingletonRows
+ * -------------------------
+ * An empty row must admit zero. A row with a single entry a x_j is a
+ * bound on x_j.
+ */
+uint32_t Presolver::emptyAndSingletonRows() {
+  uint32_t changes = 0;
+  for (uint32_t i = 0; i < numRows; ++i) {
+    if (!rowActive[i] || rowSize[i] > 1) continue;
+    if (rowSize[i] == 0) {
+      if (rowLower[i] > tolerance(rowLower[i]) || rowUpper[i] < -tolerance(rowUpper[i])) {
+        result = PresolveStatus::INFEASIBLE;
+        return changes;
+      }
+      removeRow(i);
+      counts.emptyRows++;
+      changes++;
+      continue;
+    }
+
+    size_t p = rows.start[i];
+    while (!colActive[rows.index[p]]) ++p;
+    uint32_t j = rows.index[p];
+    double a = rows.value[p];
+    double lower = rowLower[i] / a, upper = rowUpper[i] / a;
+    if (a < 0) swap(lower, upper);
+    removeRow(i);
+    counts.singletonRows++;
+    changes++;
+    if (!setColumnBounds(j, lower, upper)) return changes;
+  }
+  return changes;
+}
+
+uint32_t Presolver::fixedColumns() {
+  uint32_t changes = 0;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (!colActive[j] || colLower[j] != colUpper[j]) continue;
+    fixColumn(j, colLower[j]);
+    counts.fixedColumns++;
+    changes++;
+  }
+  return changes;
+}
+
+/*
+ * Function: dominatedColumns
+ * -------------------------
+ * If lowering x_j can violate no row (every positive entry is in a row
+ * without a lower bound, every negative one in a row without an upper
+ * bound) and its cost is nonnegative, some optimum has x_j at its lower
+ * bound; likewise upward. A column whose cost pushes it toward an
+ * infinite bound this way makes the model unbounded, if it is feasible;
+ * presolve does not decide that, so it stops with INFEASIBLE_OR_UNBOUNDED.
+ * Empty columns are the special case with no rows at all.
+ */
+uint32_t Presolver::dominatedColumns() {
+  uint32_t changes = 0;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (!colActive[j]) continue;
+    bool canDecrease = true, canIncrease = true;
+    for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+      uint32_t i = cols.index[p];
+      if (!rowActive[i]) continue;
+      bool hasLower = rowLower[i] > -INFINITY, hasUpper = rowUpper[i] < INFINITY;
+      if (cols.value[p] > 0) {
+        if (hasLower) canDecrease = false;
+        if (hasUpper) canIncrease = false;
+      }
+      else {
+        if (hasUpper) canDecrease = false;
+        if (hasLower) canIncrease = false;
+      }
+    }
+
+    double c = cost[j], value;
+    if (c > 0 && canDecrease) {
+      if (colLower[j] == -INFINITY) {
+        result = PresolveStatus::INFEASIBLE_OR_UNBOUNDED;
+        return changes;
+      }
+      value = colLower[j];
+    }
+    else if (c < 0 && canIncrease) {
+      if (colUpper[j] == INFINITY) {
+        result = PresolveStatus::INFEASIBLE_OR_UNBOUNDED;
+        return changes;
+      }
+      value = colUpper[j];
+    }
+    else if (c == 0 && canDecrease && canIncrease) value = closestToZero(colLower[j], colUpper[j]);
+    else if (c == 0 && canDecrease && colLower[j] > -INFINITY) value = colLower[j];
+    else if (c == 0 && canIncrease && colUpper[j] < INFINITY) value = colUpper[j];
+    else continue;
+
+    if (colSize[j] == 0) counts.emptyColumns++;
+    else counts.dominatedColumns++;
+    fixColumn(j, value);
+    changes++;
+  }
+  return changes;
+}
+
+/*
+ * Function: slackColumns
+ * -------------------------
+ * A continuous column with zero cost and a single entry a in row i acts
+ * as a slack of that row: removing it widens the row bounds by the range
+ * of a x_j. Postsolve picks x_j to bring the rest of the row back inside
+ * the original bounds, so the rest of the row is recorded.
+ */
+uint32_t Presolver::slackColumns() {
+  uint32_t changes = 0;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (!colActive[j] || integral[j] || colSize[j] != 1 || cost[j] != 0.0) continue;
+    size_t p = cols.start[j];
+    while (!rowActive[cols.index[p]]) ++p;
+    uint32_t i = cols.index[p];
+    double a = cols.value[p];
+
+    PostsolveStep step{};
+    step.kind = PostsolveStep::SLACK;
+    step.column = j;
+    step.value = a;
+    step.lower = rowLower[i];
+    step.upper = rowUpper[i];
+    step.colLower = colLower[j];
+    step.colUpper = colUpper[j];
+    step.first = stepTerms.size();
+    for (size_t q = rows.start[i]; q < rows.start[i + 1]; ++q) {
+      uint32_t k = rows.index[q];
+      if (k != j && colActive[k]) stepTerms.push_back({ k, rows.value[q] });
+    }
+    step.last = stepTerms.size();
+    steps.push_back(step);
+
+    rowLower[i] -= maxTerm(a, colLower[j], colUpper[j]);
+    rowUpper[i] -= minTerm(a, colLower[j], colUpper[j]);
+    colActive[j] = false;
+    rowSize[i]--;
+    counts.slackColumns++;
+    changes++;
+  }
+  return changes;
+}
+
+/*
+ * Function: rowActivity
+ * -------------------------
+ * Bounds the activity of row i over the current column bounds, with
+ * infinite contributions counted separately from the finite sums.
+ */
+Presolver::Activity Presolver::rowActivity(uint32_t i) const {
+  Activity act;
+  for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+    uint32_t j = rows.index[p];
+    if (!colActive[j]) continue;
+    double lo = minTerm(rows.value[p], colLower[j], colUpper[j]);
+    double hi = maxTerm(rows.value[p], colLower[j], colUpper[j]);
+    if (lo == -INFINITY) act.minInf++;
+    else act.minSum += lo;
+    if (hi == INFINITY) act.maxInf++;
+    else act.maxSum += hi;
+  }
+  return act;
+}
+
+/*
+ * Function: impliedBounds
+ * -------------------------
+ * Bounds on x_j implied by the bounds of row i and the activity of the
+ * rest of the row, where a is x_j's entry. Returns false unless one of
+ * them tightens x_j by a worthwhile step: a whole unit for integer
+ * columns, MIN_TIGHTENING relative for continuous ones, so that repeated
+ * passes terminate. The bound that does not tighten is returned infinite.
+ */
+bool Presolver::impliedBounds(const Activity& act, uint32_t i, uint32_t j, double a, double& newLower,
+                              double& newUpper) const {
+  newLower = -INFINITY;
+  newUpper = INFINITY;
+  if (fabs(a) < MIN_COEFFICIENT) return false;
+  double l = rowLower[i], u = rowUpper[i];
+  double lo = minTerm(a, colLower[j], colUpper[j]), hi = maxTerm(a, colLower[j], colUpper[j]);
+
+  // Bounds on a x_j from the row bounds and the rest of the row
+  double termUpper = INFINITY, termLower = -INFINITY;
+  if (u < INFINITY) {
+    if (act.minInf == 0) termUpper = u - (act.minSum - lo);
+    else if (act.minInf == 1 && lo == -INFINITY) termUpper = u - act.minSum;
+  }
+  if (l > -INFINITY) {
+    if (act.maxInf == 0) termLower = l - (act.maxSum - hi);
+    else if (act.maxInf == 1 && hi == INFINITY) termLower = l - act.maxSum;
+  }
+  double lower = (a > 0 ? termLower : termUpper) / a;
+  double upper = (a > 0 ? termUpper : termLower) / a;
+  if (fabs(lower) > MAX_IMPLIED_BOUND) lower = -INFINITY;
+  if (fabs(upper) > MAX_IMPLIED_BOUND) upper = INFINITY;
+
+  bool tightenLower, tightenUpper;
+  if (integral[j]) {
+    tightenLower = ceil(lower - INTEGER_TOLERANCE) > colLower[j];
+    tightenUpper = floor(upper + INTEGER_TOLERANCE) < colUpper[j];
+  }
+  else {
+    tightenLower = lower > -INFINITY &&
+                   (colLower[j] == -INFINITY || lower > colLower[j] + MIN_TIGHTENING * max(1.0, fabs(colLower[j])));
+    tightenUpper = upper < INFINITY &&
+                   (colUpper[j] == INFINITY || upper < colUpper[j] - MIN_TIGHTENING * max(1.0, fabs(colUpper[j])));
+  }
+  if (tightenLower) newLower = lower;
+  if (tightenUpper) newUpper = upper;
+  return tightenLower || tightenUpper;
+}
+
+/*
+ * Function: activityReductions
+ * -------------------------
+ * Rows whose activity range lies within their bounds are redundant; rows
+ * whose bound equals an extreme of the activity force every column to
+ * the bound that attains it. Otherwise each entry gets the bounds implied
+ * by the row. Activities are not refreshed as bounds tighten within a
+ * row; the stale ones are looser, so still valid.
+ */
+uint32_t Presolver::activityReductions() {
+  uint32_t changes = 0;
+  vector<pair<uint32_t, double>> forced;
+  for (uint32_t i = 0; i < numRows; ++i) {
+    if (!rowActive[i]) continue;
+    Activity act = rowActivity(i);
+
+    double l = rowLower[i], u = rowUpper[i];
+    if ((act.minInf == 0 && act.minSum > u + tolerance(u)) || (act.maxInf == 0 && act.maxSum < l - tolerance(l))) {
+      result = PresolveStatus::INFEASIBLE;
+      return changes;
+    }
+    bool lowerHolds = l == -INFINITY || (act.minInf == 0 && act.minSum >= l - tolerance(l));
+    bool upperHolds = u == INFINITY || (act.maxInf == 0 && act.maxSum <= u + tolerance(u));
+    if (lowerHolds && upperHolds) {
+      removeRow(i);
+      counts.redundantRows++;
+      changes++;
+      continue;
+    }
+
+    bool forcedDown = act.minInf == 0 && u < INFINITY && act.minSum >= u - tolerance(u);
+    bool forcedUp = act.maxInf == 0 && l > -INFINITY && act.maxSum <= l + tolerance(l);
+    if (forcedDown || forcedUp) {
+      forced.clear();
+      for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+        uint32_t j = rows.index[p];
+        if (!colActive[j]) continue;
+        bool atLower = (rows.value[p] > 0) == forcedDown;
+        forced.push_back({ j, atLower ? colLower[j] : colUpper[j] });
+      }
+      removeRow(i);
+      for (const auto& f : forced) fixColumn(f.first, f.second);
+      counts.forcingRows++;
+      counts.fixedColumns += static_cast<uint32_t>(forced.size());
+      changes++;
+      continue;
+    }
+
+    for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+      uint32_t j = rows.index[p];
+      double newLower, newUpper;
+      if (!colActive[j] || !impliedBounds(act, i, j, rows.value[p], newLower, newUpper)) continue;
+      if (!setColumnBounds(j, newLower, newUpper)) return changes;
+      counts.tightenedBounds += (newLower > -INFINITY) + (newUpper < INFINITY);
+      changes++;
+    }
+  }
+  return changes;
+}
+
+/*
+ * Function: mergeRow
+ * -------------------------
+ * Row `drop` is `factor` times row `keep`: its bounds, divided by the
+ * factor, are intersected into those of `keep`.
+ */
+bool Presolver::mergeRow(uint32_t keep, uint32_t drop, double factor) {
+  double lower = rowLower[drop] / factor, upper = rowUpper[drop] / factor;
+  if (factor < 0) swap(lower, upper);
+  lower = max(lower, rowLower[keep]);
+  upper = min(upper, rowUpper[keep]);
+  if (lower > upper) {
+    if (lower > upper + tolerance(upper)) {
+      result = PresolveStatus::INFEASIBLE;
+      return false;
+    }
+    lower = upper;
+  }
+  rowLower[keep] = lower;
+  rowUpper[keep] = upper;
+  removeRow(drop);
+  counts.duplicateRows++;
+  return true;
+}
+
+/*
+ * Function: mergeColumn
+ * -------------------------
+ * Column `drop` is `factor` times column `keep`, costs included, so the
+ * two only ever appear as x_keep + factor x_drop. Column `keep` takes
+ * over that sum and the range it can cover; postsolve splits it again.
+ */
+void Presolver::mergeColumn(uint32_t keep, uint32_t drop, double factor) {
+  PostsolveStep step{};
+  step.kind = PostsolveStep::MERGED;
+  step.column = drop;
+  step.other = keep;
+  step.value = factor;
+  step.lower = colLower[keep];
+  step.upper = colUpper[keep];
+  step.colLower = colLower[drop];
+  step.colUpper = colUpper[drop];
+  steps.push_back(step);
+
+  colLower[keep] += minTerm(factor, colLower[drop], colUpper[drop]);
+  colUpper[keep] += maxTerm(factor, colLower[drop], colUpper[drop]);
+  colActive[drop] = false;
+  for (size_t p = cols.start[drop]; p < cols.start[drop + 1]; ++p) {
+    if (rowActive[cols.index[p]]) rowSize[cols.index[p]]--;
+  }
+  counts.duplicateColumns++;
+}
+
+uint32_t Presolver::duplicateRows() {
+  vector<uint32_t> candidates;
+  for (uint32_t i = 0; i < numRows; ++i) {
+    if (rowActive[i] && rowSize[i] > 1) candidates.push_back(i);
+  }
+  return findDuplicates(rows, candidates, colActive, rowActive,
+                        [&](uint32_t keep, uint32_t drop, double factor) { return mergeRow(keep, drop, factor) ? 1 : -1; });
+}
+
+uint32_t Presolver::duplicateColumns() {
+  vector<uint32_t> candidates;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (colActive[j] && !integral[j] && colSize[j] > 0) candidates.push_back(j);
+  }
+  return findDuplicates(cols, candidates, rowActive, colActive, [&](uint32_t keep, uint32_t drop, double factor) {
+    // A parallel column with a cost that does not scale alike is not a duplicate
+    if (fabs(cost[drop] - factor * cost[keep]) > PARALLEL_TOLERANCE * max(1.0, fabs(cost[drop]))) return 0;
+    mergeColumn(keep, drop, factor);
+    return 1;
+  });
+}
+
+bool Presolver::outOfTime() {
+  if (!counts.timedOut && chrono::steady_clock::now() > deadline) counts.timedOut = true;
+  return counts.timedOut;
+}
+
+// Sets the entry at CSR position p of row i in both copies of the matrix
+void Presolver::setCoefficient(uint32_t i, size_t p, double value) {
+  uint32_t j = rows.index[p];
+  rows.value[p] = value;
+  auto first = cols.index.begin() + cols.start[j], last = cols.index.begin() + cols.start[j + 1];
+  cols.value[lower_bound(first, last, i) - cols.index.begin()] = value;
+}
+
+/*
+ * Function: coefficientTightening
+ * -------------------------
+ * On a row with one finite side, written as sum a x <= b with maximum
+ * activity M > b: a binary x_j with a_j > 0 and M - a_j < b leaves the
+ * row redundant at x_j = 0, so lowering a_j and b by d = b - (M - a_j)
+ * keeps every integer point and cuts off fractional ones. With a_j < 0
+ * and M + a_j < b the row is redundant at x_j = 1, and a_j rises to
+ * b - M.
+ */
+uint32_t Presolver::coefficientTightening() {
+  uint32_t changes = 0;
+  for (uint32_t i = 0; i < numRows; ++i) {
+    if (!rowActive[i] || (rowLower[i] > -INFINITY) == (rowUpper[i] < INFINITY)) continue;
+    double sign = rowUpper[i] < INFINITY ? 1.0 : -1.0;
+    double b = sign > 0 ? rowUpper[i] : -rowLower[i];
+    Activity act = rowActivity(i);
+    if ((sign > 0 ? act.maxInf : act.minInf) != 0) continue;
+    double maxAct = sign > 0 ? act.maxSum : -act.minSum;
+    if (maxAct <= b + tolerance(b)) continue;
+
+    for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+      uint32_t j = rows.index[p];
+      if (!colActive[j] || !isBinary(j)) continue;
+      double a = sign * rows.value[p];
+      if (a > 0) {
+        double d = b - (maxAct - a);
+        if (d <= tolerance(b)) continue;
+        a -= d;
+        b -= d;
+        maxAct -= d;
+      }
+      else {
+        double d = b - (maxAct + a);
+        if (d <= tolerance(b)) continue;
+        a += d;
+      }
+      setCoefficient(i, p, sign * a);
+      counts.coefficientsTightened++;
+      changes++;
+    }
+    if (sign > 0) rowUpper[i] = b;
+    else rowLower[i] = -b;
+  }
+  return changes;
+}
+
+/*
+ * Function: probeSetBounds
+ * -------------------------
+ * Tentative version of setColumnBounds for probing: the old bounds go on
+ * the trail, and crossing bounds return false without touching `result`.
+ */
+bool Presolver::probeSetBounds(uint32_t j, double lower, double upper) {
+  if (integral[j]) {
+    lower = ceil(lower - INTEGER_TOLERANCE);
+    upper = floor(upper + INTEGER_TOLERANCE);
+  }
+  lower = max(lower, colLower[j]);
+  upper = min(upper, colUpper[j]);
+  if (lower > upper) {
+    if (integral[j] || lower > upper + tolerance(upper)) return false;
+    lower = upper;
+  }
+  if (lower == colLower[j] && upper == colUpper[j]) return true;
+  trail.push_back({ j, colLower[j], colUpper[j] });
+  colLower[j] = lower;
+  colUpper[j] = upper;
+  return true;
+}
+
+void Presolver::undoTrail() {
+  for (auto t = trail.rbegin(); t != trail.rend(); ++t) {
+    colLower[t->column] = t->lower;
+    colUpper[t->column] = t->upper;
+  }
+  trail.clear();
+}
+
+/*
+ * Function: propagate
+ * -------------------------
+ * Bound propagation after the bounds of column j changed: rows touching
+ * a changed column are queued, and each queued row tightens its columns
+ * through impliedBounds. Returns false if some row can no longer be
+ * satisfied. Stops quietly once `work` row entries have been visited
+ * beyond PROBE_WORK; what was derived so far is still implied.
+ */
+bool Presolver::propagate(uint32_t j, size_t& work) {
+  vector<uint32_t> queue;
+  auto enqueueRows = [&](uint32_t k, uint32_t except) {
+    for (size_t p = cols.start[k]; p < cols.start[k + 1]; ++p) {
+      uint32_t i = cols.index[p];
+      if (rowActive[i] && i != except && !rowQueued[i]) {
+        rowQueued[i] = true;
+        queue.push_back(i);
+      }
+    }
+  };
+
+  enqueueRows(j, UINT32_MAX);
+  bool feasible = true;
+  size_t head = 0;
+  for (; head < queue.size() && feasible && work < PROBE_WORK; ++head) {
+    uint32_t i = queue[head];
+    rowQueued[i] = false;
+    work += rowSize[i];
+    Activity act = rowActivity(i);
+    double l = rowLower[i], u = rowUpper[i];
+    if ((act.minInf == 0 && act.minSum > u + tolerance(u)) || (act.maxInf == 0 && act.maxSum < l - tolerance(l))) {
+      feasible = false;
+      break;
+    }
+    for (size_t p = rows.start[i]; p < rows.start[i + 1] && feasible; ++p) {
+      uint32_t k = rows.index[p];
+      double newLower, newUpper;
+      if (!colActive[k] || !impliedBounds(act, i, k, rows.value[p], newLower, newUpper)) continue;
+      if (!probeSetBounds(k, newLower, newUpper)) feasible = false;
+      else enqueueRows(k, i);
+    }
+  }
+  for (; head < queue.size(); ++head) rowQueued[queue[head]] = false;
+  return feasible;
+}
+
+/*
+ * Function: probing
+ * -------------------------
+ * Fixes each binary at 0 and then at 1 and propagates. If one value is
+ * infeasible the binary takes the other; otherwise bounds that hold in
+ * both branches are kept, and the binaries each branch fixes are stored
+ * as implications. The most connected binaries are probed first.
+ */
+uint32_t Presolver::probing() {
+  vector<uint32_t> candidates;
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (colActive[j] && colSize[j] > 0 && isBinary(j)) candidates.push_back(j);
+  }
+  stable_sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) { return colSize[a] > colSize[b]; });
+  if (candidates.size() > MAX_PROBES) candidates.resize(MAX_PROBES);
+
+  uint32_t changes = 0;
+  vector<TrailEntry> down, up;
+  vector<uint32_t> downStamp(numCols, UINT32_MAX), upStamp(numCols, UINT32_MAX);
+  vector<size_t> downSlot(numCols);
+
+  // Final bounds of every column (other than j) that the branch changed
+  auto collect = [&](uint32_t j, vector<TrailEntry>& list, vector<uint32_t>& stamp, uint32_t probe) {
+    list.clear();
+    for (const TrailEntry& t : trail) {
+      if (t.column == j || stamp[t.column] == probe) continue;
+      stamp[t.column] = probe;
+      list.push_back({ t.column, colLower[t.column], colUpper[t.column] });
+    }
+  };
+  auto imply = [&](Literal cause, const TrailEntry& t) {
+    if (implicationTable.size() >= MAX_IMPLICATIONS || !isBinary(t.column)) return;
+    if (t.upper == 0.0) implicationTable.push_back({ cause, { t.column, false } });
+    else if (t.lower == 1.0) implicationTable.push_back({ cause, { t.column, true } });
+    else return;
+    counts.implications++;
+  };
+
+  for (uint32_t probe = 0; probe < candidates.size(); ++probe) {
+    uint32_t j = candidates[probe];
+    if (outOfTime()) break;
+    if (!colActive[j] || !isBinary(j)) continue;
+    counts.probedColumns++;
+
+    size_t work = 0;
+    bool downFeasible = probeSetBounds(j, 0.0, 0.0) && propagate(j, work);
+    collect(j, down, downStamp, probe);
+    undoTrail();
+    work = 0;
+    bool upFeasible = probeSetBounds(j, 1.0, 1.0) && propagate(j, work);
+    collect(j, up, upStamp, probe);
+    undoTrail();
+
+    if (!downFeasible && !upFeasible) {
+      result = PresolveStatus::INFEASIBLE;
+      return changes;
+    }
+    if (!downFeasible || !upFeasible) {
+      double value = upFeasible ? 1.0 : 0.0;
+      setColumnBounds(j, value, value);
+      counts.probingFixed++;
+      changes++;
+      continue;
+    }
+
+    for (size_t k = 0; k < down.size(); ++k) downSlot[down[k].column] = k;
+    for (const TrailEntry& t : down) imply({ j, false }, t);
+    for (const TrailEntry& t : up) {
+      imply({ j, true }, t);
+      if (downStamp[t.column] != probe) continue;
+      const TrailEntry& d = down[downSlot[t.column]];
+      double lower = min(d.lower, t.lower), upper = max(d.upper, t.upper);
+      if (lower <= colLower[t.column] && upper >= colUpper[t.column]) continue;
+      if (!setColumnBounds(t.column, lower, upper)) return changes;
+      counts.probingTightened++;
+      changes++;
+    }
+  }
+  return changes;
+}
+
+/*
+ * Function: buildCliques
+ * -------------------------
+ * Each row side, written as sum w L <= slack over binary literals L
+ * (x_j = 1 for a positive coefficient, x_j = 0 for a negative one) with
+ * the other columns at their minimum, yields the clique of its heaviest
+ * literals: sorted by weight, the longest prefix whose two lightest
+ * members cannot both be true. Each implication "a implies b" yields the
+ * two-literal clique {a, not b}. Duplicates are dropped.
+ */
+void Presolver::buildCliques() {
+  vector<pair<double, Literal>> weighted;
+  for (uint32_t i = 0; i < numRows && !outOfTime(); ++i) {
+    if (!rowActive[i]) continue;
+    Activity act = rowActivity(i);
+    for (double sign : { 1.0, -1.0 }) {
+      double b = sign > 0 ? rowUpper[i] : -rowLower[i];
+      if (b == INFINITY || (sign > 0 ? act.minInf : act.maxInf) != 0) continue;
+      double slack = b - (sign > 0 ? act.minSum : -act.maxSum);
+
+      weighted.clear();
+      bool allBinary = true;
+      for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+        uint32_t j = rows.index[p];
+        if (!colActive[j]) continue;
+        if (!isBinary(j)) allBinary = false;
+        else weighted.push_back({ fabs(rows.value[p]), { j, sign * rows.value[p] > 0 } });
+      }
+      sort(weighted.begin(), weighted.end(),
+           [](const pair<double, Literal>& a, const pair<double, Literal>& b) { return a.first > b.first; });
+      size_t size = 1;
+      while (size < weighted.size() && weighted[size - 1].first + weighted[size].first > slack + tolerance(slack)) {
+        size++;
+      }
+      if (size < 2) continue;
+
+      // The row states the clique itself when it holds only these literals, all of full weight
+      bool stated = allBinary && size == weighted.size() && weighted[size - 1].first >= slack - tolerance(slack);
+      cliques.push_back({ cliqueLiterals.size(), cliqueLiterals.size() + size, stated });
+      for (size_t k = 0; k < size; ++k) cliqueLiterals.push_back(weighted[k].second);
+    }
+  }
+  for (const Implication& imp : implicationTable) {
+    if (!colActive[imp.cause.column] || !colActive[imp.effect.column]) continue;
+    cliques.push_back({ cliqueLiterals.size(), cliqueLiterals.size() + 2, false });
+    cliqueLiterals.push_back(imp.cause);
+    cliqueLiterals.push_back({ imp.effect.column, !imp.effect.value });
+  }
+
+  // Sort each clique, then drop repeats; a repeat of a stated clique is stated too
+  auto before = [](const Literal& a, const Literal& b) {
+    return a.column != b.column ? a.column < b.column : a.value < b.value;
+  };
+  auto same = [&](const Clique& a, const Clique& b) {
+    return a.last - a.first == b.last - b.first &&
+           equal(cliqueLiterals.begin() + a.first, cliqueLiterals.begin() + a.last, cliqueLiterals.begin() + b.first,
+                 [](const Literal& x, const Literal& y) { return x.column == y.column && x.value == y.value; });
+  };
+  for (const Clique& c : cliques) sort(cliqueLiterals.begin() + c.first, cliqueLiterals.begin() + c.last, before);
+  sort(cliques.begin(), cliques.end(), [&](const Clique& a, const Clique& b) {
+    if (lexicographical_compare(cliqueLiterals.begin() + a.first, cliqueLiterals.begin() + a.last,
+                                cliqueLiterals.begin() + b.first, cliqueLiterals.begin() + b.last, before)) {
+      return true;
+    }
+    return same(a, b) && a.stated > b.stated;
+  });
+  size_t out = 0;
+  for (size_t k = 0; k < cliques.size(); ++k) {
+    if (out > 0 && same(cliques[out - 1], cliques[k])) continue;
+    cliques[out++] = cliques[k];
+  }
+  cliques.resize(out);
+  counts.cliques = static_cast<uint32_t>(cliques.size());
+}
+
+/*
+ * Function: buildReducedModel
+ * -------------------------
+ * Copies the active rows and columns, in their original order, into a
+ * fresh CompactModel, followed by the clique rows.
+ */
+void Presolver::buildReducedModel(const CompactModel& model) {
+  vector<uint32_t> newIndex(numCols, UINT32_MAX);
+  for (uint32_t j = 0; j < numCols; ++j) {
+    if (!colActive[j]) continue;
+    newIndex[j] = static_cast<uint32_t>(colMap.size());
+    colMap.push_back(j);
+    reduced.variables.intern(model.variables.name(j));
+    reduced.colLower.push_back(colLower[j]);
+    reduced.colUpper.push_back(colUpper[j]);
+    reduced.colKind.push_back(model.colKind[j]);
+    reduced.objective.push_back(model.objective[j]);
+  }
+
+  for (uint32_t i = 0; i < numRows; ++i) {
+    if (!rowActive[i]) continue;
+    rowMap.push_back(i);
+    for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+      if (!colActive[rows.index[p]]) continue;
+      reduced.rows.index.push_back(newIndex[rows.index[p]]);
+      reduced.rows.value.push_back(rows.value[p]);
+    }
+    reduced.rows.start.push_back(reduced.rows.index.size());
+    reduced.rowLower.push_back(rowLower[i]);
+    reduced.rowUpper.push_back(rowUpper[i]);
+    reduced.rowNames.intern(model.rowName(i)); // Original names even for unnamed models, so they stay stable
+  }
+
+  // Cliques of three or more literals that no row states: sum of x (value 1) + sum of (1 - x) (value 0) <= 1
+  for (const Clique& c : cliques) {
+    if (c.stated || c.last - c.first < 3) continue;
+    bool active = true;
+    for (size_t k = c.first; k < c.last; ++k) active = active && colActive[cliqueLiterals[k].column];
+    if (!active) continue;
+    double negated = 0.0;
+    for (size_t k = c.first; k < c.last; ++k) {
+      const Literal& lit = cliqueLiterals[k];
+      reduced.rows.index.push_back(newIndex[lit.column]);
+      reduced.rows.value.push_back(lit.value ? 1.0 : -1.0);
+      if (!lit.value) negated += 1.0;
+    }
+    reduced.rows.start.push_back(reduced.rows.index.size());
+    reduced.rowLower.push_back(-INFINITY);
+    reduced.rowUpper.push_back(1.0 - negated);
+    // Suffixed with '_' until it clashes with no kept row's name
+    string name = "clique" + to_string(counts.cliqueRows + 1);
+    while (reduced.rowNames.find(name) != SymbolTable::NOT_FOUND) name += "_";
+    reduced.rowNames.intern(name);
+    counts.cliqueRows++;
+  }
+
+  reduced.type = model.type;
+  reduced.numCols = static_cast<uint32_t>(colMap.size());
+  reduced.numRows = static_cast<uint32_t>(reduced.rowLower.size());
+  reduced.objectiveOffset = model.objectiveOffset + (model.type == OptType::MAXIMIZE ? -fixedCost : fixedCost);
+}
+
+/*
+ * Function: postsolve
+ * -------------------------
+ * Scatters the reduced values to their original columns, then undoes the
+ * removals newest first. Every column a step refers to was active when
+ * the step was recorded, so its value is known by the time the step is
+ * undone.
+ */
+vector<double> Presolver::postsolve(const vector<double>& reducedValues) const {
+  if (result != PresolveStatus::REDUCED) throw runtime_error("postsolve: no reduced model");
+  if (reducedValues.size() != colMap.size()) {
+    throw runtime_error("postsolve: expected " + to_string(colMap.size()) + " values, got " +
+                        to_string(reducedValues.size()));
+  }
+
+  vector<double> x(numCols, 0.0);
+  for (size_t k = 0; k < colMap.size(); ++k) x[colMap[k]] = reducedValues[k];
+
+  for (auto step = steps.rbegin(); step != steps.rend(); ++step) {
+    switch (step->kind) {
+      case PostsolveStep::FIXED:
+        x[step->column] = step->value;
+        break;
+
+      case PostsolveStep::SLACK: {
+        double rest = 0.0;
+        for (size_t t = step->first; t < step->last; ++t) rest += stepTerms[t].second * x[stepTerms[t].first];
+        double lower = (step->lower - rest) / step->value, upper = (step->upper - rest) / step->value;
+        if (step->value < 0) swap(lower, upper);
+        x[step->column] = closestToZero(max(lower, step->colLower), min(upper, step->colUpper));
+        break;
+      }
+
+      case PostsolveStep::MERGED: {
+        // x_other + factor x_column = sum, each within its own bounds
+        double sum = x[step->other];
+        double lower = (sum - step->upper) / step->value, upper = (sum - step->lower) / step->value;
+        if (step->value < 0) swap(lower, upper);
+        x[step->column] = closestToZero(max(lower, step->colLower), min(upper, step->colUpper));
+        x[step->other] = sum - step->value * x[step->column];
+        break;
+      }
+    }
+  }
+  return x;
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "compact_model.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Outcome of a Presolver run.
+ */
+enum class PresolveStatus {
+  UNSOLVED,               // presolve() has not run
+  REDUCED,                // reducedModel() is equivalent to the input (it may be empty)
+  INFEASIBLE,             // The reductions proved that no feasible point exists
+  INFEASIBLE_OR_UNBOUNDED // A column improves the objective without limit on any feasible point
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "REDUCED".
+ */
+const char* presolveStatusName(PresolveStatus status);
+
+/**
+ * @brief Number of reductions of each kind made by a Presolver run.
+ */
+struct PresolveStats {
+  uint32_t emptyRows = 0;        // Rows without entries
+  uint32_t singletonRows = 0;    // Rows with one entry, turned into column bounds
+  uint32_t redundantRows = 0;    // Rows that the column bounds always satisfy
+  uint32_t forcingRows = 0;      // Rows whose bounds force every column to a bound
+  uint32_t duplicateRows = 0;    // Rows parallel to another row
+  uint32_t fixedColumns = 0;     // Columns with equal bounds (including fixed by forcing rows)
+  uint32_t emptyColumns = 0;     // Columns without entries
+  uint32_t dominatedColumns = 0; // Columns fixed at a bound by the sign of their cost
+  uint32_t slackColumns = 0;     // Continuous zero-cost column singletons folded into their row
+  uint32_t duplicateColumns = 0; // Continuous columns parallel to another column
+  uint32_t tightenedBounds = 0;  // Column bounds tightened from row activities
+
+  // MIP reductions
+  uint32_t integerRoundings = 0;      // Fractional bounds of integer columns rounded inward
+  uint32_t coefficientsTightened = 0; // Binary coefficients strengthened on knapsack-like rows
+  uint32_t probedColumns = 0;         // Binaries probed at both values
+  uint32_t probingFixed = 0;          // Binaries fixed because one value is infeasible
+  uint32_t probingTightened = 0;      // Column bounds implied by both values of a binary
+  uint32_t implications = 0;          // Binary implications stored by probing
+  uint32_t cliques = 0;               // Entries of the clique table
+  uint32_t cliqueRows = 0;            // Cliques added to the reduced model as set-packing rows
+  bool timedOut = false;              // The time limit cut the reductions short
+};
+
+/**
+ * @brief A binary column at one value: x[column] == value.
+ */
+struct Literal {
+  uint32_t column;
+  bool value;
+};
+
+/**
+ * @brief Found by probing: every feasible point with `cause` true has
+ * `effect` true.
+ */
+struct Implication {
+  Literal cause;
+  Literal effect;
+};
+
+/**
+ * @class Presolver
+ * @brief Reduces an LP/MILP before it goes to a solver, and maps the
+ * reduced solution back.
+ *
+ * The reductions are repeated until none applies: empty, singleton,
+ * redundant, forcing and duplicate rows; fixed, empty, dominated,
+ * duplicate and slack-like singleton columns; and bound tightening from
+ * row activities. Every reduction is valid for integer columns as well
+ * (those that are not are applied to continuous columns only), and
+ * integer bounds are rounded inward, so the same reduced model serves LP
+ * and MILP solvers.
+ *
+ * Each removed column leaves a step on a postsolve stack; postsolve()
+ * replays the stack in reverse to recover the values of all original
+ * columns, which keep their original ids and hence their names.
+ *
+ * Models with integer columns get further reductions once the above run
+ * dry: coefficient strengthening on rows with binaries, and probing, which
+ * fixes each binary at 0 and at 1 in turn, propagates bounds through the
+ * rows, and keeps what both branches agree on plus the implications
+ * between binaries. Finally a clique table (sets of binary literals of
+ * which at most one can be true) is built from the rows and the
+ * implications; cliques that no row states directly are added to the
+ * reduced model as set-packing rows. These steps only remove fractional
+ * points, so postsolve is unaffected.
+ *
+ * At the time limit the reductions stop where they are; the model reduced
+ * so far is still equivalent to the input.
+ */
+class Presolver {
+  struct Activity {
+    double minSum = 0.0;  // Finite part of the minimum row activity
+    double maxSum = 0.0;  // Finite part of the maximum row activity
+    uint32_t minInf = 0;  // Entries contributing -infinity to the minimum
+    uint32_t maxInf = 0;  // Entries contributing +infinity to the maximum
+  };
+
+  struct TrailEntry {
+    uint32_t column;
+    double lower, upper;
+  };
+
+  struct Clique {
+    size_t first, last; // Literals in `cliqueLiterals`
+    bool stated;        // Some row is exactly this clique
+  };
+
+  struct PostsolveStep {
+    enum Kind { FIXED, SLACK, MERGED } kind;
+    uint32_t column;      // The removed column
+    uint32_t other;       // MERGED: the column that absorbed `column`
+    double value;         // FIXED: the value; SLACK: the column's coefficient; MERGED: the factor
+    double lower, upper;  // SLACK: row bounds before the removal; MERGED: bounds of `other` before it
+    double colLower, colUpper;
+    size_t first, last;   // SLACK: the rest of the row, in `stepTerms`
+  };
+
+  // The input model, with bounds updated as the reductions proceed
+  uint32_t numRows = 0;
+  uint32_t numCols = 0;
+  SparseMatrix rows;             // CSR with sorted column indices
+  SparseMatrix cols;             // CSC with sorted row indices
+  std::vector<double> rowLower;
+  std::vector<double> rowUpper;
+  std::vector<double> colLower;
+  std::vector<double> colUpper;
+  std::vector<double> cost;      // Minimization sense
+  std::vector<bool> integral;
+  double fixedCost = 0.0;        // Objective contribution of removed columns, minimization sense
+
+  std::vector<bool> rowActive;
+  std::vector<bool> colActive;
+  std::vector<uint32_t> rowSize; // Entries in active columns
+  std::vector<uint32_t> colSize; // Entries in active rows
+
+  std::vector<PostsolveStep> steps;
+  std::vector<std::pair<uint32_t, double>> stepTerms;
+
+  // MIP reductions
+  double timeLimit = 10.0;
+  std::chrono::steady_clock::time_point deadline;
+  std::vector<TrailEntry> trail; // Probing: bounds to restore, oldest first
+  std::vector<bool> rowQueued;
+  std::vector<Implication> implicationTable;
+  std::vector<Clique> cliques;
+  std::vector<Literal> cliqueLiterals;
+
+  PresolveStatus result = PresolveStatus::UNSOLVED;
+  PresolveStats counts;
+  CompactModel reduced;
+  std::vector<uint32_t> colMap; // Reduced column -> original column
+  std::vector<uint32_t> rowMap; // Reduced row -> original row; clique rows come after these and have none
+  size_t inputNonzeros = 0;
+
+  void removeRow(uint32_t i);
+  void fixColumn(uint32_t j, double value);
+  bool setColumnBounds(uint32_t j, double lower, double upper);
+  bool isBinary(uint32_t j) const { return integral[j] && colLower[j] == 0.0 && colUpper[j] == 1.0; }
+  bool outOfTime();
+  Activity rowActivity(uint32_t i) const;
+  bool impliedBounds(const Activity& act, uint32_t i, uint32_t j, double a, double& newLower, double& newUpper) const;
+  void setCoefficient(uint32_t i, size_t p, double value);
+  bool mergeRow(uint32_t keep, uint32_t drop, double factor);
+  void mergeColumn(uint32_t keep, uint32_t drop, double factor);
+  uint32_t emptyAndSingletonRows();
+  uint32_t fixedColumns();
+  uint32_t dominatedColumns();
+  uint32_t slackColumns();
+  uint32_t activityReductions();
+  uint32_t duplicateRows();
+  uint32_t duplicateColumns();
+  uint32_t coefficientTightening();
+  bool probeSetBounds(uint32_t j, double lower, double upper);
+  bool propagate(uint32_t j, size_t& work);
+  void undoTrail();
+  uint32_t probing();
+  void buildCliques();
+  void buildReducedModel(const CompactModel& model);
+
+public:
+  /**
+   * @brief Presolves `model` (not modified). On REDUCED the result is
+   * available from reducedModel().
+   */
+  PresolveStatus presolve(const CompactModel& model);
+
+  /**
+   * @brief The reduced model: surviving rows and columns in their
+   * original order and with their original names. Its objective constant
+   * includes the contribution of the removed columns, so its optimal value
+   * equals that of the input.
+   */
+  const CompactModel& reducedModel() const { return reduced; }
+
+  /**
+   * @brief Maps values of the reduced model's columns to values of all
+   * columns of the input model, by original column id.
+   */
+  std::vector<double> postsolve(const std::vector<double>& reducedValues) const;
+
+  /**
+   * @brief Caps the wall time of presolve(), 10 seconds by default. It is
+   * checked between rounds of reductions and between probes.
+   */
+  void setTimeLimit(double seconds) { timeLimit = seconds; }
+
+  /**
+   * @brief Implications between binaries found by probing, by original
+   * column id. Columns removed later may appear.
+   */
+  const std::vector<Implication>& implications() const { return implicationTable; }
+
+  /**
+   * @brief Status of the last presolve().
+   */
+  PresolveStatus status() const { return result; }
+
+  /**
+   * @brief Reductions made by the last presolve().
+   */
+  const PresolveStats& stats() const { return counts; }
+
+  /**
+   * @brief Rows, columns and nonzeros of the input model.
+   */
+  uint32_t originalRows() const { return numRows; }
+  uint32_t originalColumns() const { return numCols; }
+  size_t originalNonzeros() const { return inputNonzeros; }
+};
@@ -0,0 +1,978 @@
+#include "simplex.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+  constexpr double PRIMAL_TOLERANCE = 1e-7; // Bound violation still counted as feasible
+  constexpr double DUAL_TOLERANCE = 1e-7;   // Reduced cost still counted as optimal
+  constexpr double PIVOT_TOLERANCE = 1e-7;  // Smallest acceptable pivot element
+  constexpr uint32_t STALL_LIMIT = 100;     // Degenerate pivots in a row before perturbing
+  constexpr double DEVEX_RESET = 1e6;       // Restart the Devex framework past this weight
+  constexpr double MIN_WEIGHT = 1e-4;       // Floor for dual steepest-edge weights
+
+  // Rounds a scale factor to a power of two, so scaling loses no precision.
+  double powerOfTwo(double s) {
+    return exp2(round(log2(s)));
+  }
+} // anonymous namespace
+
+const char* simplexStatusName(SimplexStatus status) {
+  switch (status) {
+    case SimplexStatus::UNSOLVED: return "UNSOLVED";
+    case SimplexStatus::OPTIMAL: return "OPTIMAL";
+    case SimplexStatus::INFEASIBLE: return "INFEASIBLE";
+    case SimplexStatus::UNBOUNDED: return "UNBOUNDED";
+    case SimplexStatus::ITERATION_LIMIT: return "ITERATION_LIMIT";
+    case SimplexStatus::TIME_LIMIT: return "TIME_LIMIT";
+    case SimplexStatus::CANCELLED: return "CANCELLED";
+    case SimplexStatus::NUMERICAL_ERROR: return "NUMERICAL_ERROR";
+  }
+  return "UNKNOWN";
+}
+
+void SimplexSolver::loadModel(const LPModel& model) {
+  loadModel(CompactModel::fromLPModel(model));
+}
+
+void SimplexSolver::loadModel(const CompactModel& model) {
+  m = model.numRows;
+  n = model.numCols;
+  maximize = (model.type == OptType::MAXIMIZE);
+  objectiveOffset = model.objectiveOffset;
+  cols = model.rows.transpose(n);
+
+  uint32_t total = n + m;
+  lower.resize(total);
+  upper.resize(total);
+  cost.assign(total, 0.0);
+  for (uint32_t j = 0; j < n; ++j) {
+    lower[j] = model.colLower[j];
+    upper[j] = model.colUpper[j];
+    cost[j] = maximize ? -model.objective[j] : model.objective[j];
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    lower[n + i] = model.rowLower[i];
+    upper[n + i] = model.rowUpper[i];
+  }
+
+  scale();
+  hasBasis = false;
+  result = SimplexStatus::UNSOLVED;
+  iterationCount = 0;
+}
+
+/*
+ * Function: scale
+ * -------------------------
+ * Geometric scaling: alternately divides each row and each column by the
+ * geometric mean of its smallest and largest entry, twice over. Scaled
+ * structural j is x[j] / colScale[j] and scaled logical i is
+ * s[i] * rowScale[i].
+ */
+void SimplexSolver::scale() {
+  rowScale.assign(m, 1.0);
+  colScale.assign(n, 1.0);
+  vector<double> rowMin(m), rowMax(m);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    fill(rowMin.begin(), rowMin.end(), INFINITY);
+    fill(rowMax.begin(), rowMax.end(), 0.0);
+    for (uint32_t j = 0; j < n; ++j) {
+      for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+        double a = fabs(cols.value[p]) * colScale[j];
+        uint32_t i = cols.index[p];
+        rowMin[i] = min(rowMin[i], a);
+        rowMax[i] = max(rowMax[i], a);
+      }
+    }
+    for (uint32_t i = 0; i < m; ++i) {
+      if (rowMax[i] > 0.0) rowScale[i] = powerOfTwo(1.0 / sqrt(rowMin[i] * rowMax[i]));
+    }
+
+    for (uint32_t j = 0; j < n; ++j) {
+      double colMin = INFINITY, colMax = 0.0;
+      for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+        double a = fabs(cols.value[p]) * rowScale[cols.index[p]];
+        colMin = min(colMin, a);
+        colMax = max(colMax, a);
+      }
+      if (colMax > 0.0) colScale[j] = powerOfTwo(1.0 / sqrt(colMin * colMax));
+    }
+  }
+
+  for (uint32_t j = 0; j < n; ++j) {
+    for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+      cols.value[p] *= rowScale[cols.index[p]] * colScale[j];
+    }
+    lower[j] /= colScale[j];
+    upper[j] /= colScale[j];
+    cost[j] *= colScale[j];
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    lower[n + i] *= rowScale[i];
+    upper[n + i] *= rowScale[i];
+  }
+  rows = cols.transpose(m);
+}
+
+void SimplexSolver::setNonbasic(uint32_t var, BasisStatus st) {
+  varStatus[var] = st;
+  value[var] = st == BasisStatus::AT_LOWER ? lower[var] : st == BasisStatus::AT_UPPER ? upper[var] : 0.0;
+}
+
+/*
+ * Function: placeNonbasic
+ * -------------------------
+ * Makes `var` nonbasic at the bound `preferred` names if that bound is
+ * finite, otherwise at whichever bound is finite, otherwise at zero.
+ */
+void SimplexSolver::placeNonbasic(uint32_t var, BasisStatus preferred) {
+  if (preferred == BasisStatus::AT_UPPER && upper[var] < INFINITY) setNonbasic(var, BasisStatus::AT_UPPER);
+  else if (lower[var] > -INFINITY) setNonbasic(var, BasisStatus::AT_LOWER);
+  else if (upper[var] < INFINITY) setNonbasic(var, BasisStatus::AT_UPPER);
+  else setNonbasic(var, BasisStatus::AT_ZERO);
+}
+
+/*
+ * Function: initialBasis
+ * -------------------------
+ * All-logical basis (B = -I); each structural sits at its finite bound
+ * nearest zero, or at zero if it is free.
+ */
+void SimplexSolver::initialBasis() {
+  uint32_t total = n + m;
+  varStatus.assign(total, BasisStatus::BASIC);
+  value.assign(total, 0.0);
+  basis.resize(m);
+  for (uint32_t j = 0; j < n; ++j) {
+    if (lower[j] > -INFINITY && (upper[j] == INFINITY || fabs(lower[j]) <= fabs(upper[j]))) {
+      setNonbasic(j, BasisStatus::AT_LOWER);
+    }
+    else if (upper[j] < INFINITY) {
+      setNonbasic(j, BasisStatus::AT_UPPER);
+    }
+    else {
+      setNonbasic(j, BasisStatus::AT_ZERO);
+    }
+  }
+  for (uint32_t i = 0; i < m; ++i) basis[i] = n + i;
+}
+
+/*
+ * Function: refactor
+ * -------------------------
+ * Factorizes the current basis and recomputes the basic values. Columns
+ * the factorization rejected as dependent leave the basis at a bound.
+ */
+void SimplexSolver::refactor() {
+  // Bound here rather than at load time, so that a copied solver factors its own matrix
+  factor.setMatrix(cols, m, n);
+  vector<uint32_t> dropped = factor.factorize(basis);
+  for (uint32_t var : dropped) {
+    if (lower[var] > -INFINITY && (upper[var] == INFINITY || value[var] - lower[var] <= upper[var] - value[var])) {
+      setNonbasic(var, BasisStatus::AT_LOWER);
+    }
+    else if (upper[var] < INFINITY) {
+      setNonbasic(var, BasisStatus::AT_UPPER);
+    }
+    else {
+      setNonbasic(var, BasisStatus::AT_ZERO);
+    }
+  }
+  for (uint32_t var : basis) varStatus[var] = BasisStatus::BASIC;
+  computeBasicValues();
+}
+
+/*
+ * Function: computeBasicValues
+ * -------------------------
+ * Solves B x_B = -N x_N, from [A -I] (x, s) = 0.
+ */
+void SimplexSolver::computeBasicValues() {
+  vector<double> rhs(m, 0.0);
+  for (uint32_t j = 0; j < n; ++j) {
+    if (varStatus[j] == BasisStatus::BASIC || value[j] == 0.0) continue;
+    for (size_t p = cols.start[j]; p < cols.start[j + 1]; ++p) {
+      rhs[cols.index[p]] -= cols.value[p] * value[j];
+    }
+  }
+  for (uint32_t i = 0; i < m; ++i) {
+    if (varStatus[n + i] != BasisStatus::BASIC) rhs[i] += value[n + i];
+  }
+  factor.ftran(rhs);
+  for (uint32_t k = 0; k < m; ++k) value[basis[k]] = rhs[k];
+}
+
+double SimplexSolver::columnDot(uint32_t var, const vector<double>& y) const {
+  if (var >= n) return -y[var - n];
+  double sum = 0.0;
+  for (size_t p = cols.start[var]; p < cols.start[var + 1]; ++p) sum += cols.value[p] * y[cols.index[p]];
+  return sum;
+}
+
+void SimplexSolver::loadColumn(uint32_t var, vector<double>& x) const {
+  fill(x.begin(), x.end(), 0.0);
+  if (var >= n) {
+    x[var - n] = -1.0;
+    return;
+  }
+  for (size_t p = cols.start[var]; p < cols.start[var + 1]; ++p) x[cols.index[p]] = cols.value[p];
+}
+
+// Adds scale * (column of var) to x
+void SimplexSolver::loadColumn(uint32_t var, double scale, IndexedVector& x) const {
+  if (var >= n) {
+    x.add(var - n, -scale);
+    return;
+  }
+  for (size_t p = cols.start[var]; p < cols.start[var + 1]; ++p) x.add(cols.index[p], scale * cols.value[p]);
+}
+
+/*
+ * Function: perturbCosts
+ * -------------------------
+ * Breaks dual degeneracy when the primal stalls: each nonbasic cost is
+ * nudged by a small pseudo-random amount in the direction that makes its
+ * current bound look more attractive. The caller saves the true costs.
+ */
+void SimplexSolver::perturbCosts() {
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (uint32_t j = 0; j < n + m; ++j) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    double r = 0.5 + 0.5 * static_cast<double>(state >> 11) / 9007199254740992.0;
+    double delta = 1e-6 * r * (1.0 + fabs(cost[j]));
+    if (varStatus[j] == BasisStatus::AT_LOWER) cost[j] += delta;
+    else if (varStatus[j] == BasisStatus::AT_UPPER) cost[j] -= delta;
+  }
+}
+
+/*
+ * Function: computeReducedCosts
+ * -------------------------
+ * d = c - [A -I]^T B^-T c_B from scratch, with the phase 1 cost (zero on
+ * nonbasics) or the true cost.
+ */
+void SimplexSolver::computeReducedCosts(const vector<double>& basicCost, vector<double>& d,
+                                        bool phase1) const {
+  vector<double> y(basicCost);
+  factor.btran(y);
+  for (uint32_t j = 0; j < n + m; ++j) {
+    d[j] = varStatus[j] == BasisStatus::BASIC ? 0.0 : (phase1 ? 0.0 : cost[j]) - columnDot(j, y);
+  }
+}
+
+/*
+ * Function: pivotRow
+ * -------------------------
+ * row[j] = (B^-1 [A -I])[r, j] for every variable, given rho = B^-T e_r,
+ * via the row-major copy of A: only rows where rho is nonzero are visited.
+ * `touched` lists the variables written, so the caller can clear them.
+ */
+void SimplexSolver::pivotRow(const IndexedVector& rho, vector<double>& row, vector<uint32_t>& touched) const {
+  touched.clear();
+  for (uint32_t i : rho.index) {
+    double ri = rho.values[i];
+    if (ri == 0.0) continue;
+    row[n + i] = -ri;
+    touched.push_back(n + i);
+    for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) {
+      uint32_t j = rows.index[p];
+      if (row[j] == 0.0) touched.push_back(j);
+      row[j] += ri * rows.value[p];
+      if (row[j] == 0.0) row[j] = 1e-300; // Keep it listed in `touched`
+    }
+  }
+}
+
+/*
+ * Function: primal
+ * -------------------------
+ * The simplex loop. Reduced costs d are priced against c_B, the phase 1
+ * cost (-1/+1 on basics below/above their bounds) while any basic is
+ * infeasible and the true cost otherwise; they are recomputed whenever
+ * c_B changes other than by a pivot, and updated from the pivot row
+ * after each pivot. Devex picks the entering variable by d_j^2 / w_j.
+ *
+ * The Harris ratio test first finds the longest step that keeps every
+ * basic within its bound plus PRIMAL_TOLERANCE, then among the rows
+ * blocking within that step picks the largest pivot. In phase 1 an
+ * infeasible basic only blocks when it reaches the bound it violates.
+ */
+SimplexStatus SimplexSolver::primal() {
+  uint32_t total = n + m;
+  vector<double> alpha(m), basicCost(m), newCost(m), original;
+  vector<double> d(total), row(total, 0.0), weight(total, 1.0);
+  vector<uint32_t> touched;
+  IndexedVector rho;
+  rho.resize(m);
+  bool perturbed = false, stale = true, wasPhase1 = false;
+  uint32_t degenerate = 0;
+
+  auto finish = [&](SimplexStatus st) {
+    if (perturbed) cost = original;
+    return st;
+  };
+
+  refactor();
+  for (;;) {
+    if (iterationCount >= iterationLimit) return finish(SimplexStatus::ITERATION_LIMIT);
+    if (outOfTime()) return finish(SimplexStatus::TIME_LIMIT);
+    if (cancelFlag && cancelFlag->load()) return finish(SimplexStatus::CANCELLED);
+    if (factor.needsRefactor()) {
+      refactor();
+      stale = true;
+    }
+
+    // Phase and basic costs
+    bool phase1 = false;
+    for (uint32_t k = 0; k < m; ++k) {
+      uint32_t var = basis[k];
+      if (value[var] < lower[var] - PRIMAL_TOLERANCE) { newCost[k] = -1.0; phase1 = true; }
+      else if (value[var] > upper[var] + PRIMAL_TOLERANCE) { newCost[k] = 1.0; phase1 = true; }
+      else newCost[k] = 0.0;
+    }
+    if (!phase1) {
+      for (uint32_t k = 0; k < m; ++k) newCost[k] = cost[basis[k]];
+    }
+    if (stale || phase1 != wasPhase1 || newCost != basicCost) {
+      basicCost.swap(newCost);
+      computeReducedCosts(basicCost, d, phase1);
+      stale = false;
+    }
+    wasPhase1 = phase1;
+
+    // Devex pricing
+    int64_t entering = -1;
+    double best = 0.0;
+    for (uint32_t j = 0; j < total; ++j) {
+      BasisStatus st = varStatus[j];
+      if (st == BasisStatus::BASIC || lower[j] == upper[j]) continue;
+      bool improves = (st == BasisStatus::AT_LOWER && d[j] < -DUAL_TOLERANCE) ||
+                      (st == BasisStatus::AT_UPPER && d[j] > DUAL_TOLERANCE) ||
+                      (st == BasisStatus::AT_ZERO && fabs(d[j]) > DUAL_TOLERANCE);
+      if (improves && d[j] * d[j] > best * weight[j]) {
+        best = d[j] * d[j] / weight[j];
+        entering = j;
+      }
+    }
+
+    if (entering < 0) {
+      // Confirm on a fresh factorization and fresh reduced costs before stopping
+      if (factor.numUpdates() > 0) {
+        refactor();
+        stale = true;
+        continue;
+      }
+      if (phase1) return finish(SimplexStatus::INFEASIBLE);
+      if (perturbed) {
+        cost = original;
+        perturbed = false;
+        stale = true;
+        continue;
+      }
+      return SimplexStatus::OPTIMAL;
+    }
+
+    uint32_t q = static_cast<uint32_t>(entering);
+    double dir = d[q] < 0.0 ? 1.0 : -1.0;
+    loadColumn(q, alpha);
+    factor.ftran(alpha);
+
+    // Harris pass 1: longest step within relaxed bounds
+    double thetaMax = INFINITY;
+    for (uint32_t k = 0; k < m; ++k) {
+      double rate = -dir * alpha[k];
+      if (fabs(rate) < PIVOT_TOLERANCE) continue;
+      uint32_t var = basis[k];
+      double x = value[var];
+      if (rate < 0.0) {
+        if (phase1 && x < lower[var] - PRIMAL_TOLERANCE) continue;
+        double bound = (phase1 && x > upper[var] + PRIMAL_TOLERANCE) ? upper[var] : lower[var];
+        if (bound > -INFINITY) thetaMax = min(thetaMax, (bound - PRIMAL_TOLERANCE - x) / rate);
+      }
+      else {
+        if (phase1 && x > upper[var] + PRIMAL_TOLERANCE) continue;
+        double bound = (phase1 && x < lower[var] - PRIMAL_TOLERANCE) ? lower[var] : upper[var];
+        if (bound < INFINITY) thetaMax = min(thetaMax, (bound + PRIMAL_TOLERANCE - x) / rate);
+      }
+    }
+
+    // Harris pass 2: largest pivot among rows blocking within thetaMax
+    int64_t leaving = -1;
+    double theta = INFINITY, leavingBound = 0.0, largestPivot = 0.0;
+    if (thetaMax < INFINITY) {
+      for (uint32_t k = 0; k < m; ++k) {
+        double rate = -dir * alpha[k];
+        if (fabs(rate) < PIVOT_TOLERANCE) continue;
+        uint32_t var = basis[k];
+        double x = value[var];
+        double bound;
+        if (rate < 0.0) {
+          if (phase1 && x < lower[var] - PRIMAL_TOLERANCE) continue;
+          bound = (phase1 && x > upper[var] + PRIMAL_TOLERANCE) ? upper[var] : lower[var];
+          if (bound == -INFINITY) continue;
+        }
+        else {
+          if (phase1 && x > upper[var] + PRIMAL_TOLERANCE) continue;
+          bound = (phase1 && x < lower[var] - PRIMAL_TOLERANCE) ? lower[var] : upper[var];
+          if (bound == INFINITY) continue;
+        }
+        double ratio = (bound - x) / rate;
+        if (ratio <= thetaMax && fabs(rate) > largestPivot) {
+          largestPivot = fabs(rate);
+          leaving = k;
+          theta = max(ratio, 0.0);
+          leavingBound = bound;
+        }
+      }
+    }
+
+    double range = upper[q] - lower[q];
+    bool flip = range < INFINITY && range <= theta;
+    if (leaving < 0 && !flip) {
+      return finish(phase1 ? SimplexStatus::NUMERICAL_ERROR : SimplexStatus::UNBOUNDED);
+    }
+    if (flip) theta = range;
+
+    // Step
+    for (uint32_t k = 0; k < m; ++k) {
+      if (alpha[k] != 0.0) value[basis[k]] -= dir * theta * alpha[k];
+    }
+    ++iterationCount;
+
+    if (flip) {
+      setNonbasic(q, dir > 0.0 ? BasisStatus::AT_UPPER : BasisStatus::AT_LOWER);
+      degenerate = 0;
+      continue;
+    }
+
+    // Pivot row: update reduced costs and Devex weights
+    uint32_t r = static_cast<uint32_t>(leaving);
+    uint32_t out = basis[r];
+    rho.clear();
+    rho.add(r, 1.0);
+    factor.btran(rho);
+    pivotRow(rho, row, touched);
+    double pivot = alpha[r];
+    if (fabs(row[q] - pivot) > 1e-6 * (1.0 + fabs(pivot))) stale = true;
+
+    double thetaDual = d[q] / pivot;
+    double weightQ = weight[q];
+    bool reset = false;
+    auto updateColumn = [&](uint32_t j) {
+      if (varStatus[j] == BasisStatus::BASIC || row[j] == 0.0) return;
+      d[j] -= thetaDual * row[j];
+      double ratio = row[j] / pivot;
+      weight[j] = max(weight[j], ratio * ratio * weightQ);
+      reset = reset || weight[j] > DEVEX_RESET;
+    };
+    for (uint32_t j : touched) {
+      updateColumn(j);
+      row[j] = 0.0;
+    }
+
+    value[q] += dir * theta;
+    setNonbasic(out, leavingBound == lower[out] ? BasisStatus::AT_LOWER : BasisStatus::AT_UPPER);
+    d[out] = -thetaDual;
+    weight[out] = max(weightQ / (pivot * pivot), 1.0);
+    basis[r] = q;
+    varStatus[q] = BasisStatus::BASIC;
+    d[q] = 0.0;
+    // A leaving variable with a phase 1 cost is now feasible and costs nothing
+    if (phase1 && basicCost[r] != 0.0) stale = true;
+    basicCost[r] = phase1 ? 0.0 : cost[q];
+    factor.update(r, alpha);
+    if (reset) fill(weight.begin(), weight.end(), 1.0);
+
+    degenerate = theta == 0.0 ? degenerate + 1 : 0;
+    if (!phase1 && !perturbed && degenerate >= STALL_LIMIT) {
+      original = cost;
+      perturbCosts();
+      perturbed = true;
+      stale = true;
+    }
+  }
+}
+
+/*
+ * Function: dual
+ * -------------------------
+ * The dual simplex loop. The basis is first made dual feasible: nonbasic
+ * variables with a reduced cost of the wrong sign move to their other
+ * bound if they have one, and otherwise have their cost shifted so that
+ * the reduced cost is zero.
+ *
+ * Each iteration picks the leaving row by infeasibility^2 / w_r, where
+ * w_r = ||e_r^T B^-1||^2 is the dual steepest-edge weight, and forms the
+ * pivot row from rho = B^-T e_r. The bound-flipping ratio test then walks
+ * the breakpoints of the dual objective in groups of Harris-tolerant
+ * ties: while flipping every boxed variable in a group still leaves row r
+ * infeasible, they are flipped and the walk continues; otherwise the
+ * largest pivot in the group enters. The flips are applied to the basics
+ * with one FTRAN of the summed columns.
+ *
+ * Once no row is infeasible the cost shifts are removed; if that leaves
+ * reduced costs of the wrong sign, the primal finishes from this basis.
+ */
+SimplexStatus SimplexSolver::dual() {
+  struct Candidate {
+    uint32_t var;
+    double reducedCost; // Signed so that it is >= 0 when dual feasible
+    double pivot;       // |row[var]|
+  };
+
+  uint32_t total = n + m;
+  vector<double> d(total), row(total, 0.0), basicCost(m), weight(m, 1.0), original;
+  vector<uint32_t> touched, flipped;
+  vector<Candidate> candidates;
+  IndexedVector rho, alpha, tau, delta;
+  rho.resize(m);
+  alpha.resize(m);
+  tau.resize(m);
+  delta.resize(m);
+  bool shifted = false, perturbed = false;
+  uint32_t degenerate = 0;
+
+  auto saveCosts = [&]() {
+    if (!shifted) original = cost;
+    shifted = true;
+  };
+  auto finish = [&](SimplexStatus st) {
+    if (shifted) cost = original;
+    return st;
+  };
+
+  // Refactorizes, recomputes d and restores dual feasibility
+  auto refresh = [&]() {
+    refactor();
+    for (uint32_t k = 0; k < m; ++k) basicCost[k] = cost[basis[k]];
+    computeReducedCosts(basicCost, d, false);
+    bool flips = false;
+    for (uint32_t j = 0; j < total; ++j) {
+      BasisStatus st = varStatus[j];
+      if (st == BasisStatus::BASIC || lower[j] == upper[j]) continue;
+      bool boxed = lower[j] > -INFINITY && upper[j] < INFINITY;
+      if (st == BasisStatus::AT_LOWER && d[j] < -DUAL_TOLERANCE && boxed) {
+        setNonbasic(j, BasisStatus::AT_UPPER);
+        flips = true;
+      }
+      else if (st == BasisStatus::AT_UPPER && d[j] > DUAL_TOLERANCE && boxed) {
+        setNonbasic(j, BasisStatus::AT_LOWER);
+        flips = true;
+      }
+      else if ((st == BasisStatus::AT_LOWER && d[j] < -DUAL_TOLERANCE) ||
+               (st == BasisStatus::AT_UPPER && d[j] > DUAL_TOLERANCE) ||
+               (st == BasisStatus::AT_ZERO && fabs(d[j]) > DUAL_TOLERANCE)) {
+        saveCosts();
+        cost[j] -= d[j];
+        d[j] = 0.0;
+      }
+    }
+    if (flips) computeBasicValues();
+  };
+
+  refresh();
+  for (;;) {
+    if (iterationCount >= iterationLimit) return finish(SimplexStatus::ITERATION_LIMIT);
+    if (outOfTime()) return finish(SimplexStatus::TIME_LIMIT);
+    if (cancelFlag && cancelFlag->load()) return finish(SimplexStatus::CANCELLED);
+    if (factor.needsRefactor()) refresh();
+
+    // Dual steepest-edge pricing
+    int64_t leaving = -1;
+    double best = 0.0;
+    for (uint32_t k = 0; k < m; ++k) {
+      uint32_t var = basis[k];
+      double x = value[var];
+      double infeasibility = x < lower[var] - PRIMAL_TOLERANCE ? lower[var] - x
+                           : x > upper[var] + PRIMAL_TOLERANCE ? x - upper[var] : 0.0;
+      if (infeasibility > 0.0 && infeasibility * infeasibility > best * weight[k]) {
+        best = infeasibility * infeasibility / weight[k];
+        leaving = k;
+      }
+    }
+
+    if (leaving < 0) {
+      // Confirm on a fresh factorization before stopping
+      if (factor.numUpdates() > 0) {
+        refresh();
+        continue;
+      }
+      if (!shifted) return SimplexStatus::OPTIMAL;
+      cost = original;
+      shifted = false;
+      for (uint32_t k = 0; k < m; ++k) basicCost[k] = cost[basis[k]];
+      computeReducedCosts(basicCost, d, false);
+      for (uint32_t j = 0; j < total; ++j) {
+        BasisStatus st = varStatus[j];
+        if (st == BasisStatus::BASIC || lower[j] == upper[j]) continue;
+        if ((st != BasisStatus::AT_UPPER && d[j] < -DUAL_TOLERANCE) ||
+            (st != BasisStatus::AT_LOWER && d[j] > DUAL_TOLERANCE)) {
+          return primal();
+        }
+      }
+      return SimplexStatus::OPTIMAL;
+    }
+
+    uint32_t r = static_cast<uint32_t>(leaving);
+    uint32_t out = basis[r];
+    double bound = value[out] < lower[out] ? lower[out] : upper[out];
+    double sign = value[out] < bound ? -1.0 : 1.0;
+
+    rho.clear();
+    rho.add(r, 1.0);
+    factor.btran(rho);
+    double norm = 0.0;
+    for (uint32_t i : rho.index) norm += rho.values[i] * rho.values[i];
+    weight[r] = max(norm, MIN_WEIGHT);
+    pivotRow(rho, row, touched);
+
+    // Bound-flipping ratio test
+    candidates.clear();
+    for (uint32_t j : touched) {
+      BasisStatus st = varStatus[j];
+      if (st == BasisStatus::BASIC || lower[j] == upper[j]) continue;
+      double a = sign * row[j];
+      if ((st == BasisStatus::AT_LOWER && a > PIVOT_TOLERANCE) ||
+          (st == BasisStatus::AT_UPPER && a < -PIVOT_TOLERANCE) ||
+          (st == BasisStatus::AT_ZERO && fabs(a) > PIVOT_TOLERANCE)) {
+        candidates.push_back({j, a > 0.0 ? d[j] : -d[j], fabs(a)});
+      }
+    }
+
+    double slope = fabs(value[out] - bound);
+    int64_t entering = -1;
+    flipped.clear();
+    while (!candidates.empty()) {
+      double thetaMax = INFINITY;
+      for (const Candidate& c : candidates) thetaMax = min(thetaMax, (c.reducedCost + DUAL_TOLERANCE) / c.pivot);
+
+      double groupSlope = 0.0, largestPivot = 0.0;
+      for (const Candidate& c : candidates) {
+        if (c.reducedCost / c.pivot > thetaMax) continue;
+        groupSlope += c.pivot * (upper[c.var] - lower[c.var]);
+        if (c.pivot > largestPivot) {
+          largestPivot = c.pivot;
+          entering = c.var;
+        }
+      }
+      if (groupSlope >= slope - PRIMAL_TOLERANCE) break;
+
+      // Flipping the whole group still leaves row r infeasible
+      slope -= groupSlope;
+      entering = -1;
+      size_t kept = 0;
+      for (const Candidate& c : candidates) {
+        if (c.reducedCost / c.pivot <= thetaMax) flipped.push_back(c.var);
+        else candidates[kept++] = c;
+      }
+      candidates.resize(kept);
+    }
+
+    if (entering < 0) {
+      for (uint32_t j : touched) row[j] = 0.0;
+      if (factor.numUpdates() > 0) {
+        refresh();
+        continue;
+      }
+      return finish(SimplexStatus::INFEASIBLE);
+    }
+
+    uint32_t q = static_cast<uint32_t>(entering);
+    double rowPivot = row[q];
+    double thetaDual = d[q] / rowPivot;
+    if (thetaDual * sign < 0.0) {
+      // d[q] is within tolerance but of the wrong sign: shift it to zero
+      saveCosts();
+      cost[q] -= d[q];
+      d[q] = 0.0;
+      thetaDual = 0.0;
+    }
+
+    alpha.clear();
+    loadColumn(q, 1.0, alpha);
+    factor.ftran(alpha);
+    double pivot = alpha.values[r];
+    if (fabs(pivot - rowPivot) > 1e-6 * (1.0 + fabs(pivot)) && factor.numUpdates() > 0) {
+      for (uint32_t j : touched) row[j] = 0.0;
+      refresh();
+      continue;
+    }
+
+    // Dual step
+    for (uint32_t j : touched) {
+      if (varStatus[j] != BasisStatus::BASIC) d[j] -= thetaDual * row[j];
+      row[j] = 0.0;
+    }
+
+    // Bound flips
+    if (!flipped.empty()) {
+      delta.clear();
+      for (uint32_t j : flipped) {
+        double old = value[j];
+        setNonbasic(j, varStatus[j] == BasisStatus::AT_LOWER ? BasisStatus::AT_UPPER : BasisStatus::AT_LOWER);
+        loadColumn(j, value[j] - old, delta);
+      }
+      factor.ftran(delta);
+      for (uint32_t k : delta.index) value[basis[k]] -= delta.values[k];
+    }
+
+    // Steepest-edge weights, using tau = B^-1 rho
+    tau.clear();
+    for (uint32_t i : rho.index) tau.add(i, rho.values[i]);
+    factor.ftran(tau);
+    double weightR = weight[r];
+    for (uint32_t k : alpha.index) {
+      if (k == r || alpha.values[k] == 0.0) continue;
+      double ratio = alpha.values[k] / pivot;
+      weight[k] = max(weight[k] + ratio * (ratio * weightR - 2.0 * tau.values[k]), MIN_WEIGHT);
+    }
+    weight[r] = max(weightR / (pivot * pivot), MIN_WEIGHT);
+
+    // Primal step: `out` lands on its bound
+    double thetaPrimal = (value[out] - bound) / pivot;
+    for (uint32_t k : alpha.index) value[basis[k]] -= thetaPrimal * alpha.values[k];
+    value[q] += thetaPrimal;
+    setNonbasic(out, bound == lower[out] ? BasisStatus::AT_LOWER : BasisStatus::AT_UPPER);
+    d[out] = -thetaDual;
+    basis[r] = q;
+    varStatus[q] = BasisStatus::BASIC;
+    d[q] = 0.0;
+    factor.update(r, alpha);
+    ++iterationCount;
+
+    degenerate = thetaDual == 0.0 ? degenerate + 1 : 0;
+    if (!perturbed && degenerate >= STALL_LIMIT) {
+      saveCosts();
+      perturbCosts();
+      perturbed = true;
+      refresh();
+    }
+  }
+}
+
+/*
+ * Function: pushSuperbasics
+ * -------------------------
+ * Moves each nonbasic variable that sits strictly between its bounds to
+ * a bound, one at a time: down if its reduced cost is positive, up if it
+ * is negative, otherwise to the nearer bound; free variables go to zero.
+ * The basics follow along B x_B = -N x_N. A Harris ratio test as in the
+ * primal stops the move where a basic reaches its bound; that basic then
+ * leaves at the bound and the superbasic enters. A direction that meets
+ * no bound at all is reversed. Returns the number of pivots.
+ */
+uint64_t SimplexSolver::pushSuperbasics() {
+  vector<double> alpha(m), y(m);
+  bool dualsStale = true;
+  uint64_t pivots = 0;
+
+  // Longest step along -dir * alpha within the basic bounds; the blocking row or -1
+  auto ratioTest = [&](double dir, double& theta, double& leavingBound) -> int64_t {
+    double thetaMax = INFINITY;
+    for (uint32_t k = 0; k < m; ++k) {
+      double rate = -dir * alpha[k];
+      if (fabs(rate) < PIVOT_TOLERANCE) continue;
+      uint32_t var = basis[k];
+      double x = value[var];
+      if (rate < 0.0) {
+        if (x >= lower[var] - PRIMAL_TOLERANCE && lower[var] > -INFINITY) {
+          thetaMax = min(thetaMax, (lower[var] - PRIMAL_TOLERANCE - x) / rate);
+        }
+      }
+      else if (x <= upper[var] + PRIMAL_TOLERANCE && upper[var] < INFINITY) {
+        thetaMax = min(thetaMax, (upper[var] + PRIMAL_TOLERANCE - x) / rate);
+      }
+    }
+    int64_t leaving = -1;
+    double largestPivot = 0.0;
+    if (thetaMax == INFINITY) return leaving;
+    for (uint32_t k = 0; k < m; ++k) {
+      double rate = -dir * alpha[k];
+      if (fabs(rate) < PIVOT_TOLERANCE) continue;
+      uint32_t var = basis[k];
+      double x = value[var];
+      double bound = rate < 0.0 ? lower[var] : upper[var];
+      if (fabs(bound) == INFINITY) continue;
+      if (rate < 0.0 ? x < lower[var] - PRIMAL_TOLERANCE : x > upper[var] + PRIMAL_TOLERANCE) continue;
+      double ratio = (bound - x) / rate;
+      if (ratio <= thetaMax && fabs(rate) > largestPivot) {
+        largestPivot = fabs(rate);
+        leaving = k;
+        theta = max(ratio, 0.0);
+        leavingBound = bound;
+      }
+    }
+    return leaving;
+  };
+
+  for (uint32_t q = 0; q < n + m; ++q) {
+    if (varStatus[q] == BasisStatus::BASIC) continue;
+    double x = value[q];
+    bool isFree = lower[q] == -INFINITY && upper[q] == INFINITY;
+    if (x == lower[q]) { varStatus[q] = BasisStatus::AT_LOWER; continue; }
+    if (x == upper[q]) { varStatus[q] = BasisStatus::AT_UPPER; continue; }
+    if (isFree && x == 0.0) { varStatus[q] = BasisStatus::AT_ZERO; continue; }
+
+    if (factor.needsRefactor()) {
+      refactor();
+      dualsStale = true;
+    }
+    if (dualsStale) {
+      for (uint32_t k = 0; k < m; ++k) y[k] = cost[basis[k]];
+      factor.btran(y);
+      dualsStale = false;
+    }
+
+    double dir;
+    if (isFree) dir = x > 0.0 ? -1.0 : 1.0;
+    else {
+      double d = cost[q] - columnDot(q, y);
+      if (d > DUAL_TOLERANCE) dir = -1.0;
+      else if (d < -DUAL_TOLERANCE) dir = 1.0;
+      else dir = upper[q] - x < x - lower[q] ? 1.0 : -1.0;
+    }
+    loadColumn(q, alpha);
+    factor.ftran(alpha);
+
+    double theta = INFINITY, leavingBound = 0.0;
+    int64_t leaving = ratioTest(dir, theta, leavingBound);
+    double target = isFree ? 0.0 : dir > 0.0 ? upper[q] : lower[q];
+    if (leaving < 0 && fabs(target) == INFINITY) {
+      dir = -dir;
+      target = dir > 0.0 ? upper[q] : lower[q];
+      theta = INFINITY;
+      leaving = ratioTest(dir, theta, leavingBound);
+    }
+    double distance = (target - x) * dir;
+    double step = leaving < 0 ? distance : min(theta, distance);
+    for (uint32_t k = 0; k < m; ++k) {
+      if (alpha[k] != 0.0) value[basis[k]] -= dir * step * alpha[k];
+    }
+
+    if (leaving < 0 || distance <= theta) {
+      setNonbasic(q, isFree ? BasisStatus::AT_ZERO : dir > 0.0 ? BasisStatus::AT_UPPER : BasisStatus::AT_LOWER);
+      continue;
+    }
+    uint32_t r = static_cast<uint32_t>(leaving);
+    uint32_t out = basis[r];
+    value[q] = x + dir * step;
+    setNonbasic(out, leavingBound == lower[out] ? BasisStatus::AT_LOWER : BasisStatus::AT_UPPER);
+    basis[r] = q;
+    varStatus[q] = BasisStatus::BASIC;
+    factor.update(r, alpha);
+    dualsStale = true;
+    ++pivots;
+  }
+  return pivots;
+}
+
+SimplexStatus SimplexSolver::crossover(const vector<double>& columnValues, const SimplexBasis& start) {
+  if (columnValues.size() != n) throw runtime_error("Crossover values do not match the model dimensions");
+  startTime = chrono::steady_clock::now();
+  setBasis(start);
+
+  // Interior values, scaled and clipped to the bounds: structurals, then the row logicals
+  vector<double> interior(n + m, 0.0);
+  for (uint32_t j = 0; j < n; ++j) interior[j] = min(max(columnValues[j] / colScale[j], lower[j]), upper[j]);
+  for (uint32_t i = 0; i < m; ++i) {
+    double activity = 0.0;
+    for (size_t p = rows.start[i]; p < rows.start[i + 1]; ++p) activity += rows.value[p] * interior[rows.index[p]];
+    interior[n + i] = min(max(activity, lower[n + i]), upper[n + i]);
+  }
+
+  // Factor first: columns it drops as dependent also keep their interior values
+  refactor();
+  for (uint32_t var = 0; var < n + m; ++var) {
+    if (varStatus[var] != BasisStatus::BASIC) value[var] = interior[var];
+  }
+  computeBasicValues();
+  uint64_t pivots = pushSuperbasics();
+  // Every nonbasic is at a bound and the basics are feasible; the dual fixes the remaining reduced costs
+  run(true);
+  iterationCount += pivots;
+  return result;
+}
+
+SimplexStatus SimplexSolver::solve(bool useDualSimplex) {
+  startTime = chrono::steady_clock::now();
+  return run(useDualSimplex);
+}
+
+bool SimplexSolver::outOfTime() const {
+  if (timeLimit == INFINITY) return false;
+  return chrono::duration<double>(chrono::steady_clock::now() - startTime).count() >= timeLimit;
+}
+
+SimplexStatus SimplexSolver::run(bool useDualSimplex) {
+  iterationCount = 0;
+  if (!hasBasis) initialBasis();
+  hasBasis = true;
+  for (uint32_t var = 0; var < n + m; ++var) {
+    if (lower[var] > upper[var] + PRIMAL_TOLERANCE) return result = SimplexStatus::INFEASIBLE;
+  }
+  result = useDualSimplex ? dual() : primal();
+  return result;
+}
+
+SimplexBasis SimplexSolver::getBasis() const {
+  if (!hasBasis) throw runtime_error("No basis is available before the first solve");
+  SimplexBasis b;
+  b.columns.assign(varStatus.begin(), varStatus.begin() + n);
+  b.rows.assign(varStatus.begin() + n, varStatus.end());
+  return b;
+}
+
+void SimplexSolver::setBasis(const SimplexBasis& start) {
+  if (start.columns.size() != n || start.rows.size() != m) {
+    throw runtime_error("Basis does not match the model dimensions");
+  }
+  uint32_t numBasic = 0;
+  for (BasisStatus st : start.columns) numBasic += st == BasisStatus::BASIC;
+  for (BasisStatus st : start.rows) numBasic += st == BasisStatus::BASIC;
+  if (numBasic != m) {
+    throw runtime_error("Basis has " + to_string(numBasic) + " basic variables for " + to_string(m) + " rows");
+  }
+
+  varStatus.assign(n + m, BasisStatus::BASIC);
+  value.assign(n + m, 0.0);
+  basis.clear();
+  for (uint32_t var = 0; var < n + m; ++var) {
+    BasisStatus st = var < n ? start.columns[var] : start.rows[var - n];
+    if (st == BasisStatus::BASIC) basis.push_back(var);
+    else placeNonbasic(var, st);
+  }
+  hasBasis = true;
+}
+
+void SimplexSolver::setColumnBounds(uint32_t j, double lo, double up) {
+  if (j >= n) throw runtime_error("Column index out of range: " + to_string(j));
+  lower[j] = lo / colScale[j];
+  upper[j] = up / colScale[j];
+  if (hasBasis && varStatus[j] != BasisStatus::BASIC) placeNonbasic(j, varStatus[j]);
+}
+
+void SimplexSolver::setRowBounds(uint32_t i, double lo, double up) {
+  if (i >= m) throw runtime_error("Row index out of range: " + to_string(i));
+  lower[n + i] = lo * rowScale[i];
+  upper[n + i] = up * rowScale[i];
+  if (hasBasis && varStatus[n + i] != BasisStatus::BASIC) placeNonbasic(n + i, varStatus[n + i]);
+}
+
+double SimplexSolver::getObjectiveValue() const {
+  // Scaling cancels in cost * value
+  double sum = 0.0;
+  for (uint32_t j = 0; j < n; ++j) sum += cost[j] * value[j];
+  return (maximize ? -sum : sum) + objectiveOffset;
+}
+
+vector<double> SimplexSolver::getVariableValues() const {
+  vector<double> x(n);
+  for (uint32_t j = 0; j < n; ++j) x[j] = value[j] * colScale[j];
+  return x;
+}
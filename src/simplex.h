@@ -0,0 +1,229 @@
+#pragma once
+
+#include "parser.h"
+#include "compact_model.h"
+#include "basis_factor.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Outcome of a SimplexSolver run.
+ */
+enum class SimplexStatus {
+  UNSOLVED,        // solve() has not run
+  OPTIMAL,         // Optimal basic solution found
+  INFEASIBLE,      // No point satisfies all bounds and constraints
+  UNBOUNDED,       // The objective improves without limit
+  ITERATION_LIMIT, // Stopped at the iteration limit
+  TIME_LIMIT,      // Stopped at the time limit
+  CANCELLED,       // The cancel flag was raised
+  NUMERICAL_ERROR  // The basis could not be kept well-conditioned
+};
+
+/**
+ * @brief Returns the name of `status`, e.g. "OPTIMAL".
+ */
+const char* simplexStatusName(SimplexStatus status);
+
+/**
+ * @brief Position of a variable relative to the basis.
+ */
+enum class BasisStatus : uint8_t {
+  BASIC,    // In the basis
+  AT_LOWER, // Nonbasic at its lower bound
+  AT_UPPER, // Nonbasic at its upper bound
+  AT_ZERO   // Nonbasic free variable, held at zero
+};
+
+/**
+ * @brief A simplex basis: one status per structural column and per row
+ * logical, with exactly one BASIC entry per row.
+ */
+struct SimplexBasis {
+  std::vector<BasisStatus> columns;
+  std::vector<BasisStatus> rows;
+};
+
+/**
+ * @class SimplexSolver
+ * @brief Native bounded-variable revised simplex (primal and dual) for LPs.
+ *
+ * Works on the computational form [A -I] (x, s) = 0 with bounds on both
+ * structurals and row logicals, after geometric scaling of A. The basis
+ * is held as a sparse LU factorization with product-form updates
+ * (BasisFactor). Reduced costs are updated from the pivot row, which is
+ * formed row-wise so that a sparse B^-T e_r only touches the rows it needs.
+ *
+ * The primal simplex minimizes the sum of infeasibilities in phase 1 and
+ * the objective in phase 2, both with Devex pricing and a Harris two-pass
+ * ratio test; bound flips of the entering variable need no basis change.
+ *
+ * The dual simplex prices leaving rows by dual steepest edge and uses a
+ * bound-flipping ratio test, with hypersparse FTRAN/BTRAN throughout.
+ * Dual infeasibilities of the starting basis are removed by flipping boxed
+ * variables and shifting the costs of the rest; any that remain once the
+ * shifts are undone are cleaned up by the primal.
+ *
+ * The basis survives between solve() calls, so after a bound change
+ * (setColumnBounds, setRowBounds) the next solve warm-starts from the
+ * previous optimum; with the dual this typically takes a few pivots.
+ * A solver may be copied to re-solve a child problem from the parent's
+ * basis while keeping the parent intact.
+ *
+ * Integrality is ignored: a MILP is solved as its LP relaxation.
+ */
+class SimplexSolver {
+  uint32_t m = 0;               // Rows
+  uint32_t n = 0;               // Structural columns; variable n + i is row i's logical
+  bool maximize = false;
+  double objectiveOffset = 0.0;
+
+  SparseMatrix cols;            // Scaled A, column-major
+  SparseMatrix rows;            // Scaled A, row-major
+  std::vector<double> rowScale; // Per row
+  std::vector<double> colScale; // Per structural column
+  std::vector<double> lower;    // Per variable, scaled
+  std::vector<double> upper;    // Per variable, scaled
+  std::vector<double> cost;     // Per variable, scaled, always minimized
+
+  std::vector<BasisStatus> varStatus; // Per variable
+  std::vector<uint32_t> basis;        // Variable at each basis position
+  std::vector<double> value;          // Per variable, scaled
+  bool hasBasis = false;              // varStatus/basis hold a basis to start from
+  BasisFactor factor;
+
+  SimplexStatus result = SimplexStatus::UNSOLVED;
+  uint64_t iterationCount = 0;
+  uint64_t iterationLimit = UINT64_MAX;
+  double timeLimit = INFINITY;
+  std::chrono::steady_clock::time_point startTime; // Of the running solve() or crossover()
+  const std::atomic<bool>* cancelFlag = nullptr;
+
+  void scale();
+  void initialBasis();
+  void setNonbasic(uint32_t var, BasisStatus st);
+  void placeNonbasic(uint32_t var, BasisStatus preferred);
+  void refactor();
+  void computeBasicValues();
+  double columnDot(uint32_t var, const std::vector<double>& y) const;
+  void loadColumn(uint32_t var, std::vector<double>& x) const;
+  void loadColumn(uint32_t var, double scale, IndexedVector& x) const;
+  void computeReducedCosts(const std::vector<double>& basicCost, std::vector<double>& d,
+                           bool phase1) const;
+  void pivotRow(const IndexedVector& rho, std::vector<double>& row, std::vector<uint32_t>& touched) const;
+  void perturbCosts();
+  uint64_t pushSuperbasics();
+  bool outOfTime() const;
+  SimplexStatus run(bool useDualSimplex);
+  SimplexStatus primal();
+  SimplexStatus dual();
+
+public:
+  /**
+   * @brief Loads the parsed LPModel.
+   */
+  void loadModel(const LPModel& model);
+
+  /**
+   * @brief Loads a CompactModel (copied and scaled internally).
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Runs the simplex method from the current basis: the basis of
+   * the previous solve() or setBasis(), or the all-logical basis after
+   * loadModel().
+   *
+   * @param useDualSimplex If true, uses the dual simplex; otherwise the primal.
+   * @return The final status, also available from status().
+   */
+  SimplexStatus solve(bool useDualSimplex = false);
+
+  /**
+   * @brief Crossover from an interior-point solution to an optimal basis.
+   *
+   * Installs `start` (e.g. from crossoverBasis()), but holds its nonbasic
+   * structurals at `columnValues` and its nonbasic logicals at the
+   * matching row activities instead of at a bound. Each of these
+   * superbasic variables is then pushed to a bound in the direction its
+   * reduced cost does not make worse; a basic variable that reaches its
+   * bound first leaves the basis and the superbasic enters. The dual
+   * simplex finishes from the resulting vertex, whose basis is primal
+   * feasible but may price out some nonbasics. Pivots of the push count
+   * as iterations, and the iteration limit applies to the final simplex.
+   * The time limit covers the whole crossover.
+   *
+   * @param columnValues Structural values, indexed by column id (unscaled).
+   * @throws std::runtime_error on size mismatches, as setBasis().
+   */
+  SimplexStatus crossover(const std::vector<double>& columnValues, const SimplexBasis& start);
+
+  /**
+   * @brief Returns the current basis, e.g. to warm-start another solver
+   * on the same model.
+   */
+  SimplexBasis getBasis() const;
+
+  /**
+   * @brief Installs a starting basis for the next solve(). Nonbasic
+   * statuses that point at an infinite bound are moved to a finite one.
+   *
+   * @throws std::runtime_error if the sizes do not match the model or the
+   * number of BASIC entries is not the number of rows.
+   */
+  void setBasis(const SimplexBasis& start);
+
+  /**
+   * @brief Changes the bounds of structural column `j` (unscaled). The
+   * basis is kept, so the next solve() warm-starts.
+   */
+  void setColumnBounds(uint32_t j, double lower, double upper);
+
+  /**
+   * @brief Changes the bounds of row `i` (unscaled). The basis is kept,
+   * so the next solve() warm-starts.
+   */
+  void setRowBounds(uint32_t i, double lower, double upper);
+
+  /**
+   * @brief Objective value of the current solution, in the model's sense
+   * and including the objective constant.
+   */
+  double getObjectiveValue() const;
+
+  /**
+   * @brief Current values of the structural variables, indexed by column id.
+   */
+  std::vector<double> getVariableValues() const;
+
+  /**
+   * @brief Status of the last solve().
+   */
+  SimplexStatus status() const { return result; }
+
+  /**
+   * @brief Simplex iterations (pivots and bound flips) of the last solve().
+   */
+  uint64_t iterations() const { return iterationCount; }
+
+  /**
+   * @brief Caps the number of iterations per solve().
+   */
+  void setIterationLimit(uint64_t limit) { iterationLimit = limit; }
+
+  /**
+   * @brief Wall-clock seconds per solve() or crossover(), checked once per
+   * iteration.
+   */
+  void setTimeLimit(double seconds) { timeLimit = seconds; }
+
+  /**
+   * @brief solve() stops at the next iteration once `*flag` is true, with
+   * the basis reached so far; null detaches the flag. Copies of the
+   * solver share it.
+   */
+  void setCancelFlag(const std::atomic<bool>* flag) { cancelFlag = flag; }
+};
@@ -0,0 +1,370 @@
+#include "snapshot.h"
+#include "input_file.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace {
+  constexpr char MAGIC[8] = {'M', 'I', 'L', 'P', 'S', 'N', 'A', 'P'};
+  constexpr uint32_t VERSION = 1;
+  constexpr uint32_t ENDIAN_TAG = 0x01020304;
+
+  static_assert(sizeof(size_t) == sizeof(uint64_t), "CSR offsets are stored as 64-bit");
+  static_assert(is_trivially_copyable<VarType>::value, "column kinds are stored raw");
+
+  /**
+   * @brief Arrays stored in a snapshot, in file order.
+   */
+  enum Section : uint32_t {
+    ROW_START, ROW_INDEX, ROW_VALUE,
+    ROW_LOWER, ROW_UPPER, COL_LOWER, COL_UPPER, COL_KIND, OBJECTIVE,
+    VAR_ARENA, VAR_OFFSETS, VAR_SLOTS,
+    ROW_NAME_ARENA, ROW_NAME_OFFSETS, ROW_NAME_SLOTS,
+    SECTION_COUNT
+  };
+
+  struct SectionEntry {
+    uint64_t offset;   // From the start of the file, 8-byte aligned
+    uint64_t bytes;
+    uint64_t checksum; // ModelSnapshot::checksum of the section's bytes
+  };
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t fileSize;
+    uint64_t sourceFingerprint;
+    uint32_t optType;
+    uint32_t numRows;
+    uint32_t numCols;
+    uint32_t numSections;
+    double objectiveOffset;
+    uint64_t headerChecksum; // Of the header (this field zeroed) and the section table
+  };
+
+  struct Layout {
+    Header header;
+    SectionEntry sections[SECTION_COUNT];
+  };
+
+  constexpr uint64_t PRIME1 = 11400714785074694791ull;
+  constexpr uint64_t PRIME2 = 14029467366897019727ull;
+  constexpr uint64_t PRIME3 = 1609587929392839161ull;
+
+  uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  uint64_t load64(const unsigned char* p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+  }
+
+  uint64_t mix(uint64_t lane, uint64_t word) {
+    return rotl(lane + word * PRIME2, 31) * PRIME1;
+  }
+
+  /**
+   * @brief Pointer and byte count of one array to be written.
+   */
+  struct Blob {
+    const void* data = nullptr;
+    size_t bytes = 0;
+  };
+
+  template <typename T>
+  Blob blob(const vector<T>& v) {
+    return Blob{v.data(), v.size() * sizeof(T)};
+  }
+
+  Blob blob(const string& s) {
+    return Blob{s.data(), s.size()};
+  }
+
+  /**
+   * @brief Bounds-checked view of a mapped snapshot.
+   */
+  class SnapshotView {
+    string_view file;
+    const Layout& layout;
+    string path;
+
+  public:
+    SnapshotView(string_view file, const Layout& layout, const string& path)
+      : file(file), layout(layout), path(path) {}
+
+    [[noreturn]] void fail(const string& message) const {
+      throw runtime_error("Snapshot " + path + ": " + message);
+    }
+
+    /*
+     * Function: copy
+     * -------------------------
+     * Verifies section `s` holds exactly `count` elements of type T (if
+     * `count` is not SIZE_MAX) and copies it into `out` in one memcpy.
+     */
+    template <typename T>
+    void copy(Section s, vector<T>& out, size_t count = SIZE_MAX) const {
+      const SectionEntry& e = layout.sections[s];
+      if (e.bytes % sizeof(T) != 0) fail("section " + to_string(s) + " has a partial element");
+      size_t n = e.bytes / sizeof(T);
+      if (count != SIZE_MAX && n != count) fail("section " + to_string(s) + " has the wrong length");
+      out.resize(n);
+      if (n > 0) memcpy(out.data(), file.data() + e.offset, e.bytes);
+    }
+
+    void copy(Section s, string& out) const {
+      const SectionEntry& e = layout.sections[s];
+      out.assign(file.data() + e.offset, e.bytes);
+    }
+  };
+
+  /*
+   * Function: readSymbols
+   * -------------------------
+   * Restores a symbol table's arena, offsets and hash slots, and checks
+   * they agree with each other well enough for lookups to stay in bounds:
+   * offsets rise strictly from 0 to the arena size (every name ends in its
+   * '\0'), and every used slot holds an id below the name count, with at
+   * least one free slot left to end a probe. Free slots hold NOT_FOUND,
+   * which is what find() returns from them.
+   */
+  void readSymbols(const SnapshotView& view, Section first, SymbolTable& table,
+                   string& arena, vector<uint64_t>& offsets, vector<uint32_t>& slots) {
+    view.copy(first, arena);
+    view.copy(static_cast<Section>(first + 1), offsets);
+    view.copy(static_cast<Section>(first + 2), slots);
+
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != arena.size()) {
+      view.fail("symbol table offsets do not match its names");
+    }
+    for (size_t k = 1; k < offsets.size(); ++k) {
+      if (offsets[k] <= offsets[k - 1]) view.fail("symbol table offsets are not ascending");
+    }
+    size_t count = table.size();
+    bool powerOfTwo = (slots.size() & (slots.size() - 1)) == 0;
+    if (count > 0 ? !powerOfTwo || slots.size() < 2 * count : !slots.empty() && !powerOfTwo) {
+      view.fail("symbol table hash slots are malformed");
+    }
+    size_t used = 0;
+    for (uint32_t id : slots) {
+      if (id == SymbolTable::NOT_FOUND) continue;
+      if (id >= count) view.fail("symbol table hash slot holds an id out of range");
+      ++used;
+    }
+    if (used > count) view.fail("symbol table hash slots hold more ids than names");
+  }
+} // anonymous namespace
+
+/*
+ * Function: checksum
+ * -------------------------
+ * xxHash64-style mixing: four lanes each absorb every fourth 64-bit word,
+ * so the loop has no dependency between consecutive words and runs near
+ * memory bandwidth. The lanes, the length and any tail bytes are folded
+ * together at the end and avalanched.
+ */
+uint64_t ModelSnapshot::checksum(const void* data, size_t bytes) {
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  const unsigned char* end = p + bytes;
+
+  uint64_t h;
+  if (bytes >= 32) {
+    uint64_t v1 = PRIME1 + PRIME2, v2 = PRIME2, v3 = 0, v4 = 0 - PRIME1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = mix(v1, load64(p));
+      v2 = mix(v2, load64(p + 8));
+      v3 = mix(v3, load64(p + 16));
+      v4 = mix(v4, load64(p + 24));
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+  }
+  else {
+    h = PRIME3;
+  }
+  h += bytes;
+
+  for (; p + 8 <= end; p += 8) h = rotl(h ^ mix(0, load64(p)), 27) * PRIME1 + PRIME3;
+  for (; p < end; ++p) h = rotl(h ^ (*p * PRIME3), 11) * PRIME1;
+
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t ModelSnapshot::sourceFingerprint(const string& path, const string& format) {
+  struct stat st;
+  if (path == "-" || stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return 0;
+
+  uint64_t fields[] = {
+    static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino),
+    static_cast<uint64_t>(st.st_size),
+    static_cast<uint64_t>(st.st_mtim.tv_sec), static_cast<uint64_t>(st.st_mtim.tv_nsec),
+    SymbolTable::hash(format), VERSION
+  };
+  uint64_t fingerprint = checksum(fields, sizeof(fields));
+  return fingerprint != 0 ? fingerprint : 1;
+}
+
+/*
+ * Function: writeFile
+ * -------------------------
+ * Lays out the header, the section table and then each array, padded to
+ * 8 bytes. Checksums are computed from the in-memory arrays first, so the
+ * file is written front to back in one pass.
+ */
+void ModelSnapshot::writeFile(const CompactModel& model, const string& path, uint64_t sourceFingerprint) {
+  Blob blobs[SECTION_COUNT];
+  blobs[ROW_START] = blob(model.rows.start);
+  blobs[ROW_INDEX] = blob(model.rows.index);
+  blobs[ROW_VALUE] = blob(model.rows.value);
+  blobs[ROW_LOWER] = blob(model.rowLower);
+  blobs[ROW_UPPER] = blob(model.rowUpper);
+  blobs[COL_LOWER] = blob(model.colLower);
+  blobs[COL_UPPER] = blob(model.colUpper);
+  blobs[COL_KIND] = blob(model.colKind);
+  blobs[OBJECTIVE] = blob(model.objective);
+  blobs[VAR_ARENA] = blob(model.variables.arena);
+  blobs[VAR_OFFSETS] = blob(model.variables.offsets);
+  blobs[VAR_SLOTS] = blob(model.variables.slots);
+  blobs[ROW_NAME_ARENA] = blob(model.rowNames.arena);
+  blobs[ROW_NAME_OFFSETS] = blob(model.rowNames.offsets);
+  blobs[ROW_NAME_SLOTS] = blob(model.rowNames.slots);
+
+  Layout layout;
+  memset(&layout, 0, sizeof(layout));
+  Header& h = layout.header;
+  memcpy(h.magic, MAGIC, sizeof(MAGIC));
+  h.version = VERSION;
+  h.endianTag = ENDIAN_TAG;
+  h.sourceFingerprint = sourceFingerprint;
+  h.optType = static_cast<uint32_t>(model.type);
+  h.numRows = model.numRows;
+  h.numCols = model.numCols;
+  h.numSections = SECTION_COUNT;
+  h.objectiveOffset = model.objectiveOffset;
+
+  uint64_t offset = sizeof(Layout);
+  for (uint32_t s = 0; s < SECTION_COUNT; ++s) {
+    offset = (offset + 7) & ~uint64_t(7);
+    layout.sections[s].offset = offset;
+    layout.sections[s].bytes = blobs[s].bytes;
+    layout.sections[s].checksum = checksum(blobs[s].data, blobs[s].bytes);
+    offset += blobs[s].bytes;
+  }
+  h.fileSize = offset;
+  h.headerChecksum = checksum(&layout, sizeof(layout));
+
+  string tempPath = path + ".tmp";
+  FILE* file = fopen(tempPath.c_str(), "wb");
+  if (!file) throw runtime_error("Could not open output file: " + tempPath);
+
+  bool ok = fwrite(&layout, sizeof(layout), 1, file) == 1;
+  uint64_t written = sizeof(Layout);
+  static const char padding[8] = {};
+  for (uint32_t s = 0; ok && s < SECTION_COUNT; ++s) {
+    size_t pad = layout.sections[s].offset - written;
+    ok = fwrite(padding, 1, pad, file) == pad
+      && fwrite(blobs[s].data, 1, blobs[s].bytes, file) == blobs[s].bytes;
+    written = layout.sections[s].offset + blobs[s].bytes;
+  }
+  ok = (fclose(file) == 0) && ok;
+
+  if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+    remove(tempPath.c_str());
+    throw runtime_error("Failed to write snapshot: " + path);
+  }
+}
+
+/*
+ * Function: readFile
+ * -------------------------
+ * Maps the file, validates the header, the section table and every
+ * section checksum, then copies each array into the model in bulk. A
+ * valid checksum only shows the file is intact, so the contents are also
+ * checked in one pass each: row offsets ascend and every column index is
+ * below the column count.
+ */
+CompactModel ModelSnapshot::readFile(const string& path, uint64_t expectedFingerprint) {
+  InputFile input(path);
+  string_view file = input.contents();
+
+  Layout layout;
+  if (file.size() < sizeof(layout)) throw runtime_error("Snapshot " + path + ": file is truncated");
+  memcpy(&layout, file.data(), sizeof(layout));
+  SnapshotView view(file, layout, path);
+
+  const Header& h = layout.header;
+  if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) view.fail("not a model snapshot");
+  if (h.endianTag != ENDIAN_TAG) view.fail("written on a machine with different endianness");
+  if (h.version != VERSION) view.fail("unsupported version " + to_string(h.version));
+
+  Layout unsummed = layout;
+  unsummed.header.headerChecksum = 0;
+  if (checksum(&unsummed, sizeof(unsummed)) != h.headerChecksum) view.fail("header checksum mismatch");
+  if (h.fileSize != file.size()) view.fail("file size does not match its header");
+  if (h.numSections != SECTION_COUNT) view.fail("unexpected section count");
+  if (h.optType > static_cast<uint32_t>(OptType::MINIMIZE)) view.fail("invalid objective sense");
+  if (expectedFingerprint != 0 && h.sourceFingerprint != expectedFingerprint) {
+    view.fail("stale (the source model has changed)");
+  }
+
+  for (uint32_t s = 0; s < SECTION_COUNT; ++s) {
+    const SectionEntry& e = layout.sections[s];
+    if (e.offset > file.size() || e.bytes > file.size() - e.offset) {
+      view.fail("section " + to_string(s) + " lies outside the file");
+    }
+    if (checksum(file.data() + e.offset, e.bytes) != e.checksum) {
+      view.fail("checksum mismatch in section " + to_string(s));
+    }
+  }
+
+  CompactModel model;
+  model.type = static_cast<OptType>(h.optType);
+  model.numRows = h.numRows;
+  model.numCols = h.numCols;
+  model.objectiveOffset = h.objectiveOffset;
+
+  size_t rows = h.numRows, cols = h.numCols;
+  view.copy(ROW_START, model.rows.start, rows + 1);
+  view.copy(ROW_INDEX, model.rows.index);
+  view.copy(ROW_VALUE, model.rows.value, model.rows.index.size());
+  if (model.rows.start.front() != 0 || model.rows.start.back() != model.rows.index.size()) {
+    view.fail("row offsets do not match the nonzero count");
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    if (model.rows.start[i + 1] < model.rows.start[i]) view.fail("row offsets are not ascending");
+  }
+  for (uint32_t j : model.rows.index) {
+    if (j >= cols) view.fail("row entry refers to a column out of range");
+  }
+
+  view.copy(ROW_LOWER, model.rowLower, rows);
+  view.copy(ROW_UPPER, model.rowUpper, rows);
+  view.copy(COL_LOWER, model.colLower, cols);
+  view.copy(COL_UPPER, model.colUpper, cols);
+  view.copy(COL_KIND, model.colKind, cols);
+  for (VarType kind : model.colKind) {
+    if (static_cast<uint32_t>(kind) > static_cast<uint32_t>(VarType::BINARY)) view.fail("invalid column kind");
+  }
+  view.copy(OBJECTIVE, model.objective, cols);
+
+  SymbolTable& vars = model.variables;
+  readSymbols(view, VAR_ARENA, vars, vars.arena, vars.offsets, vars.slots);
+  if (vars.size() != cols) view.fail("variable name count does not match the column count");
+
+  SymbolTable& names = model.rowNames;
+  readSymbols(view, ROW_NAME_ARENA, names, names.arena, names.offsets, names.slots);
+  if (names.size() != 0 && names.size() != rows) view.fail("row name count does not match the row count");
+
+  return model;
+}
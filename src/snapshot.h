@@ -0,0 +1,57 @@
+#pragma once
+
+#include "compact_model.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @class ModelSnapshot
+ * @brief Versioned binary image of a CompactModel for fast reloads.
+ *
+ * A snapshot holds the model's flat arrays (CSR matrix, row and column
+ * bounds, column kinds, objective) and both symbol tables, including
+ * their hash slots, exactly as they sit in memory. Reading one maps the
+ * file and bulk-copies each array; nothing is parsed or re-interned.
+ *
+ * Every section carries a checksum, and the header records a fingerprint
+ * of the source file it was built from, so a corrupt or stale snapshot is
+ * rejected instead of silently solving the wrong model. Snapshots are
+ * only portable between machines with the same endianness.
+ */
+class ModelSnapshot {
+public:
+  /**
+   * @brief Writes `model` to `path`, tagged with `sourceFingerprint`.
+   *
+   * The file is written next to `path` and renamed into place, so a
+   * reader never sees a partially written snapshot.
+   *
+   * @throws std::runtime_error if the file cannot be written.
+   */
+  static void writeFile(const CompactModel& model, const std::string& path,
+                        uint64_t sourceFingerprint = 0);
+
+  /**
+   * @brief Loads the snapshot at `path`.
+   *
+   * @param expectedFingerprint If non-zero, the snapshot must have been
+   * written with this source fingerprint.
+   * @throws std::runtime_error if the file is not a snapshot, has a
+   * different version, fails a checksum, holds tables that disagree with
+   * each other, or is stale.
+   */
+  static CompactModel readFile(const std::string& path, uint64_t expectedFingerprint = 0);
+
+  /**
+   * @brief Identifies the current contents of a source model file from
+   * its device, inode, size and modification time, plus the input
+   * `format` it is read as. Returns 0 if `path` is not a regular file.
+   */
+  static uint64_t sourceFingerprint(const std::string& path, const std::string& format);
+
+  /**
+   * @brief 64-bit checksum of `bytes` bytes, processed 8 bytes at a time
+   * in four independent lanes.
+   */
+  static uint64_t checksum(const void* data, size_t bytes);
+};
@@ -0,0 +1,392 @@
+#include "solve_server.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+  constexpr size_t MAX_HEADER = 4096;     // Longest request header line
+  constexpr size_t MAX_PAYLOAD = 1 << 30; // Largest model text per request
+
+  double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  }
+
+  string statusLine(const string& id, const char* status) {
+    return "{\"id\":" + jsonString(id) + ",\"status\":\"" + status + "\"}\n";
+  }
+
+  string errorLine(const string* id, const string& message) {
+    return "{\"id\":" + (id ? jsonString(*id) : string("null")) + ",\"status\":\"ERROR\",\"error\":" +
+           jsonString(message) + "}\n";
+  }
+
+  runtime_error systemError(const string& what) {
+    return runtime_error(what + ": " + strerror(errno));
+  }
+} // anonymous namespace
+
+SolveServer::Connection::~Connection() {
+  if (fd >= 0) close(fd);
+}
+
+SolveServer::SolveServer(string socketPath, SolveOptions options)
+  : socketPath(move(socketPath)), options(move(options)) {
+  if (pipe(wakeFds) != 0) throw systemError("Could not create a pipe");
+}
+
+SolveServer::~SolveServer() {
+  close(wakeFds[0]);
+  close(wakeFds[1]);
+}
+
+void SolveServer::stop() {
+  char byte = 0;
+  ssize_t ignored = write(wakeFds[1], &byte, 1);
+  (void)ignored;
+}
+
+/*
+ * Function: run
+ * -------------------------
+ * The calling thread accepts connections; each connection gets a
+ * detached reader thread, and the workers are joined before returning.
+ */
+void SolveServer::run() {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(addr.sun_path)) throw runtime_error("Socket path too long: " + socketPath);
+  memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+  struct stat st;
+  if (lstat(socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(socketPath.c_str());
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listenFd < 0) throw systemError("Could not create a socket");
+  if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+    runtime_error error = systemError("Could not listen on " + socketPath);
+    close(listenFd);
+    throw error;
+  }
+
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+  }
+  vector<thread> workers;
+  unsigned count = ThreadPool::resolveThreads(numWorkers);
+  for (unsigned w = 0; w < count; ++w) workers.emplace_back(&SolveServer::workerLoop, this);
+
+  pollfd fds[2] = { { listenFd, POLLIN, 0 }, { wakeFds[0], POLLIN, 0 } };
+  while (true) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if (fds[1].revents) {
+      char byte;
+      ssize_t ignored = read(wakeFds[0], &byte, 1);
+      (void)ignored;
+      break;
+    }
+    if (!(fds[0].revents & POLLIN)) continue;
+    int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) continue;
+
+    auto connection = make_shared<Connection>();
+    connection->fd = fd;
+    {
+      lock_guard<std::mutex> lock(mutex);
+      connections.erase(remove_if(connections.begin(), connections.end(),
+                                  [](const weak_ptr<Connection>& c) { return c.expired(); }),
+                        connections.end());
+      connections.push_back(connection);
+      ++activeReaders;
+    }
+    thread(&SolveServer::readRequests, this, move(connection)).detach();
+  }
+
+  shutdownAll();
+  for (thread& worker : workers) worker.join();
+  {
+    unique_lock<std::mutex> lock(mutex);
+    readersDone.wait(lock, [this] { return activeReaders == 0; });
+  }
+  close(listenFd);
+  listenFd = -1;
+  unlink(socketPath.c_str());
+}
+
+/*
+ * Function: shutdownAll
+ * -------------------------
+ * Answers queued requests as CANCELLED, cancels running GLPK solves,
+ * wakes the workers, and shuts down the read side of every connection
+ * so that its reader sees end-of-file.
+ */
+void SolveServer::shutdownAll() {
+  vector<shared_ptr<Job>> dropped;
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+    for (const weak_ptr<Connection>& weak : connections) {
+      shared_ptr<Connection> connection = weak.lock();
+      if (!connection) continue;
+      cancelAllLocked(*connection, dropped);
+      shutdown(connection->fd, SHUT_RD);
+    }
+  }
+  workAvailable.notify_all();
+  for (const auto& job : dropped) answer(*job->connection, statusLine(job->id, "CANCELLED"));
+}
+
+/*
+ * Function: readRequests
+ * -------------------------
+ * Reader thread of one connection: splits the byte stream into headers
+ * and payloads and hands SOLVE and CANCEL requests to the server. Ends
+ * at end-of-file, or on a malformed request, which also cancels the
+ * connection's requests and closes it.
+ */
+void SolveServer::readRequests(shared_ptr<Connection> connection) {
+  string buffer;
+  size_t pos = 0;
+  auto fill = [&] {
+    buffer.erase(0, pos);
+    pos = 0;
+    char chunk[65536];
+    while (true) {
+      ssize_t n = read(connection->fd, chunk, sizeof chunk);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      buffer.append(chunk, static_cast<size_t>(n));
+      return true;
+    }
+  };
+
+  string error;
+  while (error.empty()) {
+    size_t eol;
+    while ((eol = buffer.find('\n', pos)) == string::npos) {
+      if (buffer.size() - pos > MAX_HEADER) {
+        error = "Request header too long";
+        break;
+      }
+      if (!fill()) {
+        if (buffer.size() > pos) error = "Connection closed inside a request header";
+        break;
+      }
+    }
+    if (eol == string::npos) break;
+
+    string header = buffer.substr(pos, eol - pos);
+    pos = eol + 1;
+    if (!header.empty() && header.back() == '\r') header.pop_back();
+    if (header.empty()) continue;
+
+    istringstream fields(header);
+    string verb, id;
+    fields >> verb >> id;
+    if (verb == "SOLVE" && !id.empty()) {
+      auto job = make_shared<Job>();
+      job->connection = connection;
+      job->id = id;
+      size_t bytes = 0;
+      if (!(fields >> job->format >> bytes) || bytes > MAX_PAYLOAD) {
+        error = "Expected 'SOLVE <id> <format> <bytes> [<time limit>]'";
+        break;
+      }
+      double limit;
+      if (fields >> limit) job->timeLimit = limit;
+
+      while (buffer.size() - pos < bytes) {
+        if (buffer.capacity() < bytes) buffer.reserve(bytes + MAX_HEADER);
+        if (!fill()) {
+          error = "Connection closed inside the model of request " + id;
+          break;
+        }
+      }
+      if (!error.empty()) break;
+      job->payload = buffer.substr(pos, bytes);
+      pos += bytes;
+      submit(connection, move(job));
+    }
+    else if (verb == "CANCEL" && !id.empty()) {
+      shared_ptr<Job> dropped;
+      {
+        lock_guard<std::mutex> lock(mutex);
+        dropped = cancelLocked(*connection, id);
+      }
+      if (dropped) answer(*connection, statusLine(id, "CANCELLED"));
+    }
+    else {
+      error = "Unknown request: " + header.substr(0, 80);
+    }
+  }
+
+  if (!error.empty()) {
+    vector<shared_ptr<Job>> dropped;
+    {
+      lock_guard<std::mutex> lock(mutex);
+      cancelAllLocked(*connection, dropped);
+    }
+    answer(*connection, errorLine(nullptr, error));
+    for (const auto& job : dropped) answer(*connection, statusLine(job->id, "CANCELLED"));
+    shutdown(connection->fd, SHUT_RDWR);
+  }
+
+  lock_guard<std::mutex> lock(mutex);
+  if (--activeReaders == 0) readersDone.notify_all();
+}
+
+void SolveServer::submit(const shared_ptr<Connection>& connection, shared_ptr<Job> job) {
+  string rejection;
+  {
+    lock_guard<std::mutex> lock(mutex);
+    if (stopping) rejection = statusLine(job->id, "CANCELLED");
+    else if (connection->jobs.count(job->id)) rejection = errorLine(&job->id, "Request id already in flight");
+    else if (queue.size() >= queueLimit) rejection = statusLine(job->id, "REJECTED");
+    else {
+      job->queued = chrono::steady_clock::now();
+      connection->jobs[job->id] = job;
+      queue.push_back(move(job));
+    }
+  }
+  if (rejection.empty()) workAvailable.notify_one();
+  else answer(*connection, rejection);
+}
+
+// Cancels request `id` of `connection`. Returns it if it was still queued
+// (and is now dropped); a running request keeps going until its solver
+// sees the cancel, and is answered by its worker.
+shared_ptr<SolveServer::Job> SolveServer::cancelLocked(Connection& connection, const string& id) {
+  auto it = connection.jobs.find(id);
+  if (it == connection.jobs.end()) return nullptr;
+  shared_ptr<Job> job = it->second;
+  if (job->solver) {
+    job->solver->cancel();
+    return nullptr;
+  }
+  connection.jobs.erase(it);
+  queue.erase(find(queue.begin(), queue.end(), job));
+  return job;
+}
+
+void SolveServer::cancelAllLocked(Connection& connection, vector<shared_ptr<Job>>& dropped) {
+  vector<string> ids;
+  for (const auto& entry : connection.jobs) ids.push_back(entry.first);
+  for (const string& id : ids) {
+    shared_ptr<Job> job = cancelLocked(connection, id);
+    if (job) dropped.push_back(move(job));
+  }
+}
+
+void SolveServer::workerLoop() {
+  glp_term_out(GLP_OFF); // GLPK's terminal output is per thread
+  {
+    GLPKSolver glpk;
+    while (true) {
+      shared_ptr<Job> job;
+      {
+        unique_lock<std::mutex> lock(mutex);
+        workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping) break;
+        job = move(queue.front());
+        queue.pop_front();
+        job->solver = &glpk;
+        glpk.clearCancel(); // A cancel left over from the previous request
+      }
+      process(*job, glpk);
+    }
+  }
+  glp_free_env(); // Releases this thread's GLPK environment
+}
+
+/*
+ * Function: process
+ * -------------------------
+ * Parses and solves one request and answers it. The request's time limit
+ * counts from when the worker picks it up: the solve gets what parsing
+ * left, and solveModel() passes each solver what presolve left of that.
+ * The answer carries the request's SolveStats, also when it failed part
+ * way.
+ */
+void SolveServer::process(Job& job, GLPKSolver& glpk) {
+  auto start = chrono::steady_clock::now();
+  ostringstream record;
+  record.precision(15);
+  record << "{\"id\":" << jsonString(job.id);
+  double queueSeconds = chrono::duration<double>(start - job.queued).count();
+  double readSeconds = 0.0;
+  double solveSeconds = 0.0;
+  bool parsed = false;
+  SolveStats stats;
+  try {
+    CompactModel model = readModelBuffer(job.payload, job.format, 1);
+    string().swap(job.payload);
+    readSeconds = secondsSince(start);
+    parsed = true;
+    stats.addTime("read", readSeconds);
+
+    SolveOptions requestOptions = options;
+    requestOptions.numThreads = 1;
+    requestOptions.verbose = false;
+    requestOptions.limits.timeLimit = min(options.limits.timeLimit, job.timeLimit) - readSeconds;
+    SolveResult result = solveModel(model, requestOptions, glpk, stats);
+    solveSeconds = secondsSince(start) - readSeconds;
+    record << ',' << resultJson(model, result);
+  }
+  catch (const exception& ex) {
+    if (parsed) solveSeconds = secondsSince(start) - readSeconds;
+    else readSeconds = secondsSince(start);
+    record << ",\"status\":\"ERROR\",\"error\":" << jsonString(ex.what());
+  }
+  stats.addTime("total", secondsSince(start));
+  record << ",\"stats\":" << stats.toJson();
+  record << ",\"queue_seconds\":" << queueSeconds << ",\"read_seconds\":" << readSeconds
+         << ",\"solve_seconds\":" << solveSeconds << "}\n";
+
+  {
+    lock_guard<std::mutex> lock(mutex);
+    job.solver = nullptr;
+    job.connection->jobs.erase(job.id);
+  }
+  answer(*job.connection, record.str());
+}
+
+/*
+ * Function: answer
+ * -------------------------
+ * Writes one answer line. If the client is gone, the connection is marked
+ * broken and its remaining requests are cancelled, since nobody would
+ * read their answers.
+ */
+void SolveServer::answer(Connection& connection, const string& line) {
+  {
+    lock_guard<std::mutex> lock(connection.writeMutex);
+    if (connection.broken) return;
+    size_t sent = 0;
+    while (sent < line.size()) {
+      ssize_t n = send(connection.fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        connection.broken = true;
+        break;
+      }
+      sent += static_cast<size_t>(n);
+    }
+    if (!connection.broken) return;
+  }
+  vector<shared_ptr<Job>> dropped;
+  lock_guard<std::mutex> lock(mutex);
+  cancelAllLocked(connection, dropped);
+}
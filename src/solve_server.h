@@ -0,0 +1,134 @@
+#pragma once
+
+#include "pipeline.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class SolveServer
+ * @brief Long-running solver service on a Unix domain socket.
+ *
+ * A client sends requests over a stream connection. Each request is a
+ * header line, followed by the model text for SOLVE:
+ *
+ *   SOLVE <id> <format> <bytes> [<time limit in seconds>]\n<bytes of model text>
+ *   CANCEL <id>\n
+ *
+ * <id> is any token the client picks, unique among its requests in flight
+ * on the connection, and <format> is txt, lp or mps. Every SOLVE is
+ * answered by one JSON line once it finishes, so answers may come out of
+ * order:
+ *
+ *   {"id":"...","status":"OPTIMAL","objective":...,"values":{...},
+ *    "stats":{"phases":{...},"counters":{...}},
+ *    "queue_seconds":...,"read_seconds":...,"solve_seconds":...}
+ *
+ * The status is the solver's, or CANCELLED, TIME_LIMIT, ERROR (with an
+ * "error" member) or REJECTED when the queue is full. Requests a worker
+ * ran carry "stats", the SolveStats of the request. A malformed header
+ * is answered with an ERROR line with a null id, and the connection is
+ * closed since its framing is lost.
+ *
+ * Requests from all connections share one FIFO queue, drained by a pool
+ * of workers that each keep one GLPKSolver across requests. CANCEL drops a
+ * queued request at once and stops a running GLPK solve at its next check;
+ * parsing and presolve run to the end. A connection is closed when the
+ * client has closed its side and every answer has been sent; if answers
+ * cannot be delivered, the connection's remaining requests are cancelled.
+ */
+class SolveServer {
+  struct Connection;
+
+  struct Job {
+    std::shared_ptr<Connection> connection;
+    std::string id;
+    std::string format;
+    std::string payload;
+    double timeLimit = INFINITY;
+    std::chrono::steady_clock::time_point queued;
+    GLPKSolver* solver = nullptr; // The worker's solver once it is running; guarded by SolveServer::mutex
+  };
+
+  struct Connection {
+    int fd = -1;
+    std::mutex writeMutex;
+    bool broken = false; // An answer could not be written; guarded by writeMutex
+    std::unordered_map<std::string, std::shared_ptr<Job>> jobs; // In flight; guarded by SolveServer::mutex
+    ~Connection();
+  };
+
+  std::string socketPath;
+  SolveOptions options;
+  unsigned numWorkers = 0;
+  size_t queueLimit = 1024;
+
+  int listenFd = -1;
+  int wakeFds[2] = {-1, -1}; // stop() writes to [1]; run() polls [0]
+
+  std::mutex mutex; // Guards everything below and Connection::jobs
+  std::condition_variable workAvailable;
+  std::condition_variable readersDone;
+  std::deque<std::shared_ptr<Job>> queue;
+  std::vector<std::weak_ptr<Connection>> connections;
+  size_t activeReaders = 0;
+  bool stopping = false;
+
+  void readRequests(std::shared_ptr<Connection> connection);
+  void submit(const std::shared_ptr<Connection>& connection, std::shared_ptr<Job> job);
+  std::shared_ptr<Job> cancelLocked(Connection& connection, const std::string& id);
+  void cancelAllLocked(Connection& connection, std::vector<std::shared_ptr<Job>>& dropped);
+  void workerLoop();
+  void process(Job& job, GLPKSolver& glpk);
+  void answer(Connection& connection, const std::string& line);
+  void shutdownAll();
+
+public:
+  /**
+   * @brief Prepares a server on `socketPath`; nothing is opened until run().
+   * `options` apply to every request; a request's time limit can only
+   * shorten options.limits.timeLimit.
+   */
+  SolveServer(std::string socketPath, SolveOptions options);
+
+  /**
+   * @brief Closes the wake-up pipe.
+   */
+  ~SolveServer();
+
+  SolveServer(const SolveServer&) = delete;
+  SolveServer& operator=(const SolveServer&) = delete;
+
+  /**
+   * @brief Worker threads solving requests (0 = one per hardware thread).
+   */
+  void setWorkers(unsigned workers) { numWorkers = workers; }
+
+  /**
+   * @brief Requests that may wait in the queue; beyond it SOLVE is REJECTED.
+   */
+  void setQueueLimit(size_t limit) { queueLimit = limit; }
+
+  /**
+   * @brief Listens on the socket and serves requests until stop(). A
+   * stale socket file at the path is replaced. On stop, queued and
+   * running requests are answered as CANCELLED, and the socket file is
+   * removed.
+   *
+   * @throws std::runtime_error if the socket cannot be set up.
+   */
+  void run();
+
+  /**
+   * @brief Makes run() return. Async-signal-safe, so a signal handler may
+   * call it.
+   */
+  void stop();
+};
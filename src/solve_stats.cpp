@@ -0,0 +1,69 @@
+#include "solve_stats.h"
+#include <sstream>
+
+using namespace std;
+
+SolveStats::Timer::Timer(SolveStats* stats, const char* phase)
+  : stats(stats), phase(phase), start(chrono::steady_clock::now()) {}
+
+SolveStats::Timer::~Timer() {
+  if (stats) stats->addTime(phase, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+}
+
+void SolveStats::addTime(const string& phase, double seconds) {
+  for (auto& entry : phases) {
+    if (entry.first == phase) {
+      entry.second += seconds;
+      return;
+    }
+  }
+  phases.emplace_back(phase, seconds);
+}
+
+void SolveStats::setCounter(const string& name, uint64_t value) {
+  for (auto& entry : counters) {
+    if (entry.first == name) {
+      entry.second = value;
+      return;
+    }
+  }
+  counters.emplace_back(name, value);
+}
+
+void SolveStats::addCounter(const string& name, uint64_t value) {
+  setCounter(name, counter(name) + value);
+}
+
+double SolveStats::time(const string& phase) const {
+  for (const auto& entry : phases) {
+    if (entry.first == phase) return entry.second;
+  }
+  return 0.0;
+}
+
+uint64_t SolveStats::counter(const string& name) const {
+  for (const auto& entry : counters) {
+    if (entry.first == name) return entry.second;
+  }
+  return 0;
+}
+
+/*
+ * Function: toJson
+ * -------------------------
+ * Names are fixed identifiers, so they are written without escaping.
+ */
+string SolveStats::toJson() const {
+  ostringstream out;
+  out.precision(6);
+  out << "{\"phases\":{";
+  for (size_t k = 0; k < phases.size(); ++k) {
+    out << (k ? "," : "") << '"' << phases[k].first << "\":" << phases[k].second;
+  }
+  out << "},\"counters\":{";
+  for (size_t k = 0; k < counters.size(); ++k) {
+    out << (k ? "," : "") << '"' << counters[k].first << "\":" << counters[k].second;
+  }
+  out << "}}";
+  return out.str();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SolveStats
+ * @brief Phase timings and counters of one solve, for reports and dashboards.
+ *
+ * Phases are wall-clock seconds on the monotonic clock, counters are plain
+ * totals; both keep the order in which they were first recorded. Phase
+ * names in use: read, presolve, load, lp, crossover, mip, postsolve, total,
+ * and race_primal, race_dual and race_barrier for a concurrent LP.
+ * Counters: rows, columns, nonzeros and integer_columns of the input model,
+ * the same with a presolved_ prefix for the reduced one, lp_iterations,
+ * crossover_iterations, mip_iterations, nodes, cuts, incumbent_updates, and
+ * primal_iterations, dual_iterations and barrier_iterations for a race.
+ *
+ * Not thread-safe: each solve records into its own SolveStats.
+ */
+class SolveStats {
+  std::vector<std::pair<std::string, double>> phases;
+  std::vector<std::pair<std::string, uint64_t>> counters;
+
+public:
+  /**
+   * @brief Adds the time from construction to destruction to a phase of
+   * `stats`; does nothing if `stats` is null.
+   */
+  class Timer {
+    SolveStats* stats;
+    const char* phase;
+    std::chrono::steady_clock::time_point start;
+
+  public:
+    Timer(SolveStats* stats, const char* phase);
+    ~Timer();
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+  };
+
+  /**
+   * @brief Adds `seconds` to `phase`, which starts at 0.
+   */
+  void addTime(const std::string& phase, double seconds);
+
+  /**
+   * @brief Sets `name` to `value`, or adds `value` to it.
+   */
+  void setCounter(const std::string& name, uint64_t value);
+  void addCounter(const std::string& name, uint64_t value);
+
+  /**
+   * @brief Seconds recorded for `phase` (0 if none).
+   */
+  double time(const std::string& phase) const;
+
+  /**
+   * @brief Value of `name` (0 if never recorded).
+   */
+  uint64_t counter(const std::string& name) const;
+
+  /**
+   * @brief JSON object {"phases":{"read":...,...},"counters":{"rows":...,...}}.
+   */
+  std::string toJson() const;
+};
@@ -1,43 +1,129 @@
 #include "solver.h"
+#include "interior_point.h"
+#include "pdlp.h"
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <climits>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 
 GLPKSolver::GLPKSolver() {
     lp = glp_create_prob();
+
+    // Name lookups go through GLPK's index, which it updates on every change
+    glp_create_index(lp);
 }
 
 GLPKSolver::~GLPKSolver() {
     glp_delete_prob(lp);
 }
 
+namespace {
+    // Maps a [lower, upper] interval onto GLPK's bound types.
+    int glpkBoundType(double lower, double upper) {
+        if (lower == -INFINITY && upper == INFINITY) return GLP_FR;
+        if (lower == -INFINITY) return GLP_UP;
+        if (upper == INFINITY) return GLP_LO;
+        if (lower == upper) return GLP_FX;
+        return GLP_DB;
+    }
+
+    // GLPK status for a variable of bound type `type` that should have `status`
+    int toGlpkStatus(BasisStatus status, int type) {
+        if (status == BasisStatus::BASIC) return GLP_BS;
+        switch (type) {
+            case GLP_FX: return GLP_NS;
+            case GLP_FR: return GLP_NF;
+            case GLP_LO: return GLP_NL;
+            case GLP_UP: return GLP_NU;
+            default: return status == BasisStatus::AT_UPPER ? GLP_NU : GLP_NL;
+        }
+    }
+
+    BasisStatus fromGlpkStatus(int stat) {
+        switch (stat) {
+            case GLP_BS: return BasisStatus::BASIC;
+            case GLP_NU: return BasisStatus::AT_UPPER;
+            case GLP_NF: return BasisStatus::AT_ZERO;
+            default: return BasisStatus::AT_LOWER; // GLP_NL, GLP_NS
+        }
+    }
+
+    // Longest glp_simplex call between checks for cancel()
+    constexpr double SIMPLEX_SLICE = 1.0;
+
+    // GLPK time limit in milliseconds for `seconds` (at least 1)
+    int glpkTimeLimit(double seconds) {
+        if (seconds >= INT_MAX / 1000.0) return INT_MAX;
+        return std::max(1, static_cast<int>(seconds * 1000.0));
+    }
+
+    // GLPK iteration limit for `iterations` more (at least 1)
+    int glpkIterationLimit(uint64_t iterations) {
+        return static_cast<int>(std::max<uint64_t>(1, std::min<uint64_t>(iterations, INT_MAX)));
+    }
+
+    // Fills GLPK's 1-based index and value arrays for a new row or column;
+    // `limit` is the number of columns (rows) the ids may refer to
+    void glpkEntries(const std::vector<uint32_t>& ids, const std::vector<double>& values, int limit,
+                     const char* kind, std::vector<int>& ind, std::vector<double>& val) {
+        if (ids.size() != values.size()) throw std::runtime_error("Entry ids and values differ in length");
+        ind.assign(ids.size() + 1, 0);
+        val.assign(values.size() + 1, 0.0);
+        for (size_t k = 0; k < ids.size(); ++k) {
+            if (ids[k] >= uint32_t(limit)) {
+                throw std::runtime_error(std::string(kind) + " id out of range: " + std::to_string(ids[k]));
+            }
+            ind[k + 1] = static_cast<int>(ids[k]) + 1;
+            val[k + 1] = values[k];
+        }
+    }
+}
+
+const char* stopReasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::NONE: return "NONE";
+        case StopReason::TIME_LIMIT: return "TIME_LIMIT";
+        case StopReason::GAP_LIMIT: return "GAP_LIMIT";
+        case StopReason::NODE_LIMIT: return "NODE_LIMIT";
+        case StopReason::ITERATION_LIMIT: return "ITERATION_LIMIT";
+        case StopReason::CANCELLED: return "CANCELLED";
+    }
+    return "UNKNOWN";
+}
+
 void GLPKSolver::loadModel(const LPModel& model) {
+    loadModel(CompactModel::fromLPModel(model));
+}
+
+void GLPKSolver::loadModel(const CompactModel& model) {
+    SolveStats::Timer timer(stats, "load");
+
+    // Start from an empty problem, so one solver can load model after model
+    glp_erase_prob(lp);
+    glp_create_index(lp);
+    warmStart = false;
+    lpBasis = SimplexBasis();
+    solveStatus = GLP_UNDEF;
+    source = SolutionSource::SIMPLEX;
+
     glp_set_prob_name(lp, "MILP_Model");
     glp_set_obj_dir(lp, model.type == OptType::MAXIMIZE ? GLP_MAX : GLP_MIN);
 
-    // 1. Add variables (columns)
-    int numVars = model.bounds.size();
-    glp_add_cols(lp, numVars);
+    // 1. Add variables (columns); column id j maps to GLPK column j + 1
+    numCols = model.numCols;
+    if (numCols > 0) glp_add_cols(lp, numCols);
 
-    int colIdx = 1;
-    for (const auto& [varName, bound] : model.bounds) {
-        varNameToCol[varName] = colIdx;
-        glp_set_col_name(lp, colIdx, varName.c_str());
-
-        // Set bounds
-        if (bound.isFree) {
-            glp_set_col_bnds(lp, colIdx, GLP_FR, 0.0, 0.0);
-        } else if (bound.lower != -INFINITY && bound.upper != INFINITY) {
-            glp_set_col_bnds(lp, colIdx, GLP_DB, bound.lower, bound.upper);
-        } else if (bound.lower != -INFINITY) {
-            glp_set_col_bnds(lp, colIdx, GLP_LO, bound.lower, 0.0);
-        } else if (bound.upper != INFINITY) {
-            glp_set_col_bnds(lp, colIdx, GLP_UP, 0.0, bound.upper);
-        } else {
-            glp_set_col_bnds(lp, colIdx, GLP_FR, 0.0, 0.0);
-        }
+    for (int j = 0; j < numCols; ++j) {
+        int colIdx = j + 1;
+        glp_set_col_name(lp, colIdx, model.variables.c_str(j));
+        glp_set_col_bnds(lp, colIdx, glpkBoundType(model.colLower[j], model.colUpper[j]),
+                         model.colLower[j], model.colUpper[j]);
 
         // Set variable type
-        switch (bound.type) {
+        switch (model.colKind[j]) {
             case VarType::CONTINUOUS:
                 glp_set_col_kind(lp, colIdx, GLP_CV);
                 break;
@@ -48,71 +134,591 @@ void GLPKSolver::loadModel(const LPModel& model) {
                 glp_set_col_kind(lp, colIdx, GLP_BV);
                 break;
         }
-        ++colIdx;
-    }
 
-    // 2. Set objective function
-    for (const auto& term : model.objective.terms) {
-        int idx = varNameToCol.at(term.variable);
-        glp_set_obj_coef(lp, idx, term.coefficient);
+        // 2. Set objective function
+        glp_set_obj_coef(lp, colIdx, model.objective[j]);
     }
+    glp_set_obj_coef(lp, 0, model.objectiveOffset);
 
     // 3. Add constraints (rows)
-    int numCons = model.constraints.size();
-    glp_add_rows(lp, numCons);
+    int numCons = model.numRows;
+    if (numCons > 0) glp_add_rows(lp, numCons);
 
     for (int i = 0; i < numCons; ++i) {
-        const auto& con = model.constraints[i];
-        glp_set_row_name(lp, i + 1, ("c" + std::to_string(i + 1)).c_str());
-
-        // Set constraint bounds
-        if (con.op == "<=") {
-            glp_set_row_bnds(lp, i + 1, GLP_UP, 0.0, con.rhs);
-        } else if (con.op == ">=") {
-            glp_set_row_bnds(lp, i + 1, GLP_LO, con.rhs, 0.0);
-        } else if (con.op == "=") {
-            glp_set_row_bnds(lp, i + 1, GLP_FX, con.rhs, con.rhs);
-        } else {
-            throw std::runtime_error("Unknown constraint operator: " + con.op);
-        }
+        glp_set_row_name(lp, i + 1, model.rowName(i).c_str());
+        glp_set_row_bnds(lp, i + 1, glpkBoundType(model.rowLower[i], model.rowUpper[i]),
+                         model.rowLower[i], model.rowUpper[i]);
     }
 
-    // 4. Set constraint matrix
+    // 4. Set constraint matrix straight from the CSR arrays
     // GLPK expects 1-based arrays for ia, ja, ar
-    std::vector<int> ia(1), ja(1);
-    std::vector<double> ar(1);
+    const SparseMatrix& a = model.rows;
+    size_t nnz = a.numNonzeros();
+    if (nnz > size_t(INT_MAX)) throw std::runtime_error("Too many nonzeros for GLPK");
+    std::vector<int> ia(nnz + 1), ja(nnz + 1);
+    std::vector<double> ar(nnz + 1);
     for (int i = 0; i < numCons; ++i) {
-        const auto& con = model.constraints[i];
-        for (const auto& term : con.terms) {
-            ia.push_back(i + 1);
-            ja.push_back(varNameToCol.at(term.variable));
-            ar.push_back(term.coefficient);
+        for (size_t p = a.start[i]; p < a.start[i + 1]; ++p) {
+            ia[p + 1] = i + 1;
+            ja[p + 1] = a.index[p] + 1;
         }
     }
-    glp_load_matrix(lp, ia.size() - 1, ia.data(), ja.data(), ar.data());
+    std::copy(a.value.begin(), a.value.end(), ar.begin() + 1);
+    glp_load_matrix(lp, static_cast<int>(nnz), ia.data(), ja.data(), ar.data());
+}
+
+uint32_t GLPKSolver::findColumn(const std::string& name) const {
+    int j = glp_find_col(lp, name.c_str());
+    return j > 0 ? static_cast<uint32_t>(j - 1) : SymbolTable::NOT_FOUND;
+}
+
+uint32_t GLPKSolver::findRow(const std::string& name) const {
+    int i = glp_find_row(lp, name.c_str());
+    return i > 0 ? static_cast<uint32_t>(i - 1) : SymbolTable::NOT_FOUND;
+}
+
+void GLPKSolver::checkColumn(uint32_t j) const {
+    if (j >= uint32_t(numCols)) throw std::runtime_error("Column id out of range: " + std::to_string(j));
+}
+
+void GLPKSolver::checkRow(uint32_t i) const {
+    if (i >= uint32_t(glp_get_num_rows(lp))) throw std::runtime_error("Row id out of range: " + std::to_string(i));
+}
+
+void GLPKSolver::setObjectiveCoefficient(uint32_t j, double value) {
+    checkColumn(j);
+    glp_set_obj_coef(lp, j + 1, value);
+}
+
+// glp_set_col_bnds and glp_set_row_bnds move a nonbasic variable to a
+// bound that exists under the new type, so the basis stays valid
+void GLPKSolver::setColumnBounds(uint32_t j, double lower, double upper) {
+    checkColumn(j);
+    glp_set_col_bnds(lp, j + 1, glpkBoundType(lower, upper), lower, upper);
+}
+
+void GLPKSolver::setRowBounds(uint32_t i, double lower, double upper) {
+    checkRow(i);
+    glp_set_row_bnds(lp, i + 1, glpkBoundType(lower, upper), lower, upper);
+}
+
+uint32_t GLPKSolver::addColumn(const std::string& name, VarType kind, double lower, double upper, double cost,
+                               const std::vector<uint32_t>& rows, const std::vector<double>& values) {
+    if (findColumn(name) != SymbolTable::NOT_FOUND) throw std::runtime_error("Duplicate column name: " + name);
+    std::vector<int> ind;
+    std::vector<double> val;
+    glpkEntries(rows, values, glp_get_num_rows(lp), "Row", ind, val);
+
+    int colIdx = glp_add_cols(lp, 1);
+    glp_set_col_name(lp, colIdx, name.c_str());
+    glp_set_col_bnds(lp, colIdx, glpkBoundType(lower, upper), lower, upper);
+    glp_set_col_kind(lp, colIdx, kind == VarType::CONTINUOUS ? GLP_CV : kind == VarType::INTEGER ? GLP_IV : GLP_BV);
+    glp_set_obj_coef(lp, colIdx, cost);
+    glp_set_mat_col(lp, colIdx, static_cast<int>(rows.size()), ind.data(), val.data());
+    numCols = colIdx;
+    lpBasis = SimplexBasis();
+    return static_cast<uint32_t>(colIdx - 1);
+}
+
+uint32_t GLPKSolver::addRow(const std::string& name, double lower, double upper,
+                            const std::vector<uint32_t>& columns, const std::vector<double>& values) {
+    if (!name.empty() && findRow(name) != SymbolTable::NOT_FOUND) throw std::runtime_error("Duplicate row name: " + name);
+    std::vector<int> ind;
+    std::vector<double> val;
+    glpkEntries(columns, values, numCols, "Column", ind, val);
+
+    int rowIdx = glp_add_rows(lp, 1);
+    if (!name.empty()) glp_set_row_name(lp, rowIdx, name.c_str());
+    glp_set_row_bnds(lp, rowIdx, glpkBoundType(lower, upper), lower, upper);
+    glp_set_mat_row(lp, rowIdx, static_cast<int>(columns.size()), ind.data(), val.data());
+    lpBasis = SimplexBasis();
+    return static_cast<uint32_t>(rowIdx - 1);
+}
+
+void GLPKSolver::removeColumns(std::vector<uint32_t> columns) {
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    if (columns.empty()) return;
+    checkColumn(columns.back());
+    std::vector<int> num(columns.size() + 1);
+    for (size_t k = 0; k < columns.size(); ++k) num[k + 1] = static_cast<int>(columns[k]) + 1;
+    glp_del_cols(lp, static_cast<int>(columns.size()), num.data());
+    numCols = glp_get_num_cols(lp);
+    lpBasis = SimplexBasis();
+    repairBasis();
+}
+
+void GLPKSolver::removeRows(std::vector<uint32_t> rows) {
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.empty()) return;
+    checkRow(rows.back());
+    std::vector<int> num(rows.size() + 1);
+    for (size_t k = 0; k < rows.size(); ++k) num[k + 1] = static_cast<int>(rows[k]) + 1;
+    glp_del_rows(lp, static_cast<int>(rows.size()), num.data());
+    lpBasis = SimplexBasis();
+    repairBasis();
+}
+
+/*
+ * Function: repairBasis
+ * -------------------------
+ * Removing a basic column or a row with a nonbasic logical leaves GLPK's
+ * basis with the wrong number of basic variables, which glp_simplex
+ * rejects. Excess basic columns are made nonbasic, last first, and
+ * missing basics are made up with row logicals, first first, as when a
+ * basis file is loaded. If the result is singular, solve() falls back to
+ * an advanced basis.
+ */
+void GLPKSolver::repairBasis() {
+    int numRows = glp_get_num_rows(lp);
+    int basic = 0;
+    for (int j = 1; j <= numCols; ++j) basic += glp_get_col_stat(lp, j) == GLP_BS;
+    for (int i = 1; i <= numRows; ++i) basic += glp_get_row_stat(lp, i) == GLP_BS;
+    for (int j = numCols; basic > numRows && j >= 1; --j) {
+        if (glp_get_col_stat(lp, j) != GLP_BS) continue;
+        glp_set_col_stat(lp, j, toGlpkStatus(BasisStatus::AT_LOWER, glp_get_col_type(lp, j)));
+        --basic;
+    }
+    for (int i = 1; basic < numRows && i <= numRows; ++i) {
+        if (glp_get_row_stat(lp, i) == GLP_BS) continue;
+        glp_set_row_stat(lp, i, GLP_BS);
+        ++basic;
+    }
+    warmStart = true;
+}
+
+SimplexBasis GLPKSolver::glpkBasis() const {
+    SimplexBasis basis;
+    basis.columns.resize(numCols);
+    basis.rows.resize(glp_get_num_rows(lp));
+    for (int j = 0; j < numCols; ++j) basis.columns[j] = fromGlpkStatus(glp_get_col_stat(lp, j + 1));
+    for (size_t i = 0; i < basis.rows.size(); ++i) basis.rows[i] = fromGlpkStatus(glp_get_row_stat(lp, int(i) + 1));
+    return basis;
+}
+
+/*
+ * Function: intoptCallback
+ * -------------------------
+ * Called by glp_intopt with `info` = the solver. Stops the search on
+ * cancel(), and on the limits GLPK does not check itself: nodes created,
+ * simplex iterations and the absolute gap. GLPK's relative gap is
+ * |incumbent - bound| / (|incumbent| + DBL_EPSILON), which gives back
+ * the absolute gap. Also counts nodes, new incumbents and the cut rows
+ * in the current node's LP for the stats.
+ */
+void GLPKSolver::intoptCallback(glp_tree* tree, void* info) {
+    GLPKSolver& self = *static_cast<GLPKSolver*>(info);
+    const SolveLimits& limits = self.limits;
+    glp_prob* prob = glp_ios_get_prob(tree);
+    int totalNodes = 0;
+    glp_ios_tree_size(tree, nullptr, nullptr, &totalNodes);
+    self.mipNodes = uint64_t(totalNodes);
+    if (glp_ios_reason(tree) == GLP_IBINGO) ++self.mipIncumbents;
+    int cutRows = glp_get_num_rows(prob) - self.mipBaseRows;
+    if (cutRows > 0) self.mipCutRows = std::max(self.mipCutRows, uint64_t(cutRows));
+
+    StopReason reason = StopReason::NONE;
+    if (self.cancelRequested) reason = StopReason::CANCELLED;
+    else if (uint64_t(totalNodes) >= limits.nodeLimit) reason = StopReason::NODE_LIMIT;
+    else if (uint64_t(glp_get_it_cnt(prob) - self.iterationStart) >= limits.iterationLimit) {
+        reason = StopReason::ITERATION_LIMIT;
+    }
+    else if (limits.absoluteGap > 0.0 && glp_mip_status(prob) == GLP_FEAS && glp_ios_best_node(tree) != 0 &&
+             glp_ios_mip_gap(tree) * (std::fabs(glp_mip_obj_val(prob)) + DBL_EPSILON) <= limits.absoluteGap) {
+        reason = StopReason::GAP_LIMIT;
+    }
+    if (reason == StopReason::NONE) return;
+    self.callbackStop = reason;
+    glp_ios_terminate(tree);
 }
 
 void GLPKSolver::solve(bool useDualSimplex, bool isMIP) {
-    if (isMIP) {
-        glp_intopt(lp, nullptr);
-    } else {
-        glp_smcp parm;
-        glp_init_smcp(&parm);
-        if (useDualSimplex) parm.meth = GLP_DUAL;
-        glp_simplex(lp, &parm);
+    auto start = std::chrono::steady_clock::now();
+    auto remaining = [&] {
+        return limits.timeLimit - std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    iterationStart = glp_get_it_cnt(lp);
+    auto iterationsLeft = [&] {
+        uint64_t done = uint64_t(glp_get_it_cnt(lp) - iterationStart);
+        return done >= limits.iterationLimit ? 0 : limits.iterationLimit - done;
+    };
+    stop = StopReason::NONE;
+    callbackStop = StopReason::NONE;
+
+    // Without integer columns there is nothing to branch on: take the LP path
+    isMIP = isMIP && glp_get_num_int(lp) > 0;
+    if (!isMIP && lpMethod == LpMethod::INTERIOR && glp_get_num_rows(lp) > 0) {
+        solveInterior();
+        cancelRequested = false;
+        return;
+    }
+    bool crossingOver = false; // The simplex below is the crossover of a native method
+    raceWinner = LpRacer::NONE;
+    raceSummary.clear();
+    bool native = lpMethod == LpMethod::BARRIER || lpMethod == LpMethod::PDLP || lpMethod == LpMethod::CONCURRENT;
+    if (!isMIP && native) {
+        solveNative(remaining());
+        if (!crossover || solveStatus != GLP_OPT) {
+            cancelRequested = false;
+            return;
+        }
+        crossingOver = true;
+    }
+
+    // glp_intopt starts from an optimal LP basis, so the relaxation is
+    // always solved first with the requested simplex method
+    glp_smcp parm;
+    glp_init_smcp(&parm);
+    if (useDualSimplex) parm.meth = GLP_DUAL;
+    if (warmStart && glp_warm_up(lp) != 0) {
+        std::cerr << "Warning: starting basis is invalid or singular; using an advanced basis\n";
+        glp_adv_basis(lp, 0);
+    }
+    warmStart = false;
+
+    // Each slice resumes from the basis where the previous one stopped;
+    // only the first prints GLPK's banner
+    auto lpStart = std::chrono::steady_clock::now();
+    while (true) {
+        if (cancelRequested) stop = StopReason::CANCELLED;
+        else if (remaining() <= 0.0) stop = StopReason::TIME_LIMIT;
+        else if (iterationsLeft() == 0) stop = StopReason::ITERATION_LIMIT;
+        if (stop != StopReason::NONE) break;
+        parm.tm_lim = glpkTimeLimit(std::min(remaining(), SIMPLEX_SLICE));
+        parm.it_lim = glpkIterationLimit(iterationsLeft());
+        int ret = glp_simplex(lp, &parm);
+        if (ret != GLP_ETMLIM && ret != GLP_EITLIM) break;
+        parm.msg_lev = std::min(parm.msg_lev, GLP_MSG_ON);
+    }
+    solveStatus = glp_get_status(lp);
+    source = SolutionSource::SIMPLEX;
+    int lpIterations = glp_get_it_cnt(lp) - iterationStart;
+    if (stats) {
+        stats->addTime(crossingOver ? "crossover" : "lp",
+                       std::chrono::duration<double>(std::chrono::steady_clock::now() - lpStart).count());
+        stats->addCounter(crossingOver ? "crossover_iterations" : "lp_iterations", uint64_t(lpIterations));
+    }
+
+    // Keep the LP basis before glp_intopt works on the problem object
+    int numRows = glp_get_num_rows(lp);
+    lpBasis = glpkBasis();
+    if (crossingOver && solveStatus != GLP_OPT) {
+        // The crossover stopped short of a vertex: the native optimum stands
+        source = SolutionSource::NATIVE;
+        solveStatus = GLP_OPT;
+    }
+
+    if (isMIP && stop == StopReason::NONE && glp_get_status(lp) == GLP_OPT) {
+        glp_iocp iocp;
+        glp_init_iocp(&iocp);
+        iocp.tm_lim = glpkTimeLimit(remaining());
+        iocp.mip_gap = limits.relativeGap;
+        iocp.cb_func = intoptCallback;
+        iocp.cb_info = this;
+        mipNodes = mipIncumbents = mipCutRows = 0;
+        mipBaseRows = numRows;
+        auto mipStart = std::chrono::steady_clock::now();
+        int ret = glp_intopt(lp, &iocp);
+        if (stats) {
+            stats->addTime("mip", std::chrono::duration<double>(std::chrono::steady_clock::now() - mipStart).count());
+            stats->addCounter("mip_iterations", uint64_t(glp_get_it_cnt(lp) - iterationStart - lpIterations));
+            stats->addCounter("nodes", mipNodes);
+            stats->addCounter("incumbent_updates", mipIncumbents);
+            stats->setCounter("cuts", std::max(stats->counter("cuts"), mipCutRows));
+        }
+        if (ret == GLP_ESTOP) stop = callbackStop;
+        else if (ret == GLP_ETMLIM) stop = StopReason::TIME_LIMIT;
+        else if (ret == GLP_EMIPGAP) stop = StopReason::GAP_LIMIT;
+        solveStatus = glp_mip_status(lp);
+        source = SolutionSource::MIP;
+
+        // Leave the relaxation's basis in place for the next solve()
+        for (int j = 0; j < numCols; ++j) {
+            glp_set_col_stat(lp, j + 1, toGlpkStatus(lpBasis.columns[j], glp_get_col_type(lp, j + 1)));
+        }
+        for (int i = 0; i < numRows; ++i) {
+            glp_set_row_stat(lp, i + 1, toGlpkStatus(lpBasis.rows[i], glp_get_row_type(lp, i + 1)));
+        }
+    }
+    else if (isMIP && solveStatus != GLP_NOFEAS && solveStatus != GLP_UNBND) {
+        solveStatus = GLP_UNDEF; // A relaxation point is no integer solution
+    }
+    cancelRequested = false;
+}
+
+/*
+ * Function: solveInterior
+ * -------------------------
+ * The LP path with glp_interior. It takes no time or iteration limit and
+ * cannot be interrupted, so the limits and cancel() are only checked
+ * before it starts. There is no basis afterwards; the one installed
+ * before stays in place for the next simplex run.
+ */
+void GLPKSolver::solveInterior() {
+    lpBasis = SimplexBasis();
+    source = SolutionSource::INTERIOR;
+    solveStatus = GLP_UNDEF;
+    if (cancelRequested) stop = StopReason::CANCELLED;
+    else if (limits.timeLimit <= 0.0) stop = StopReason::TIME_LIMIT;
+    else if (limits.iterationLimit == 0) stop = StopReason::ITERATION_LIMIT;
+    if (stop != StopReason::NONE) return;
+
+    glp_iptcp parm;
+    glp_init_iptcp(&parm);
+    auto start = std::chrono::steady_clock::now();
+    if (glp_interior(lp, &parm) == 0) solveStatus = glp_ipt_status(lp);
+    if (stats) {
+        stats->addTime("lp", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        stats->addCounter("lp_iterations", uint64_t(glp_get_it_cnt(lp) - iterationStart));
+    }
+}
+
+/*
+ * Function: currentModel
+ * -------------------------
+ * A CompactModel copy of the problem as GLPK holds it, so in-place
+ * changes are included; all columns are continuous.
+ */
+CompactModel GLPKSolver::currentModel() const {
+    auto hasLower = [](int type) { return type == GLP_LO || type == GLP_DB || type == GLP_FX; };
+    auto hasUpper = [](int type) { return type == GLP_UP || type == GLP_DB || type == GLP_FX; };
+    CompactModel model;
+    model.type = glp_get_obj_dir(lp) == GLP_MAX ? OptType::MAXIMIZE : OptType::MINIMIZE;
+    model.objectiveOffset = glp_get_obj_coef(lp, 0);
+    model.numCols = uint32_t(numCols);
+    for (int j = 1; j <= numCols; ++j) {
+        int type = glp_get_col_type(lp, j);
+        model.colLower.push_back(hasLower(type) ? glp_get_col_lb(lp, j) : -INFINITY);
+        model.colUpper.push_back(hasUpper(type) ? glp_get_col_ub(lp, j) : INFINITY);
+        model.colKind.push_back(VarType::CONTINUOUS);
+        model.objective.push_back(glp_get_obj_coef(lp, j));
+    }
+    model.numRows = uint32_t(glp_get_num_rows(lp));
+    std::vector<int> index(numCols + 1);
+    std::vector<double> value(numCols + 1);
+    for (int i = 1; i <= int(model.numRows); ++i) {
+        int type = glp_get_row_type(lp, i);
+        model.rowLower.push_back(hasLower(type) ? glp_get_row_lb(lp, i) : -INFINITY);
+        model.rowUpper.push_back(hasUpper(type) ? glp_get_row_ub(lp, i) : INFINITY);
+        int length = glp_get_mat_row(lp, i, index.data(), value.data());
+        for (int k = 1; k <= length; ++k) {
+            model.rows.index.push_back(uint32_t(index[k] - 1));
+            model.rows.value.push_back(value[k]);
+        }
+        model.rows.start.push_back(model.rows.index.size());
+    }
+    return model;
+}
+
+namespace {
+    // Runs one native method for runNativeLp(); they share their calls and the names of their statuses
+    template <class Solver, class StatusName>
+    void runNativeMethod(Solver& solver, StatusName statusName, const CompactModel& model,
+                         const NativeLpSettings& settings, SolveStats* stats, NativeLpResult& result) {
+        using Status = decltype(solver.solve());
+        using Outcome = NativeLpResult::Outcome;
+        {
+            SolveStats::Timer timer(stats, "load");
+            solver.loadModel(model);
+        }
+        solver.setThreads(settings.threads);
+        solver.setTimeLimit(settings.timeLimit);
+        if (settings.iterationLimit != UINT64_MAX) solver.setIterationLimit(settings.iterationLimit);
+        solver.setCancelFlag(settings.cancelFlag);
+        Status status;
+        {
+            SolveStats::Timer timer(stats, "lp");
+            status = solver.solve();
+        }
+        result.iterations = solver.iterations();
+        if (stats) stats->addCounter("lp_iterations", result.iterations);
+        result.status = statusName(status);
+        if (status == Status::OPTIMAL) result.outcome = Outcome::OPTIMAL;
+        else if (status == Status::INFEASIBLE) result.outcome = Outcome::INFEASIBLE;
+        else if (status == Status::UNBOUNDED) result.outcome = Outcome::UNBOUNDED;
+        else if (status == Status::TIME_LIMIT) result.stop = StopReason::TIME_LIMIT;
+        else if (status == Status::ITERATION_LIMIT) result.stop = StopReason::ITERATION_LIMIT;
+        else if (status == Status::CANCELLED) result.stop = StopReason::CANCELLED;
+        if (result.stop != StopReason::NONE) result.outcome = Outcome::STOPPED;
+        if (result.outcome != Outcome::OPTIMAL) return;
+        result.objective = solver.getObjectiveValue();
+        result.values = solver.getVariableValues();
+        if (settings.crossover) result.crossoverStartBasis = crossoverStart(model, solver, result.values);
+    }
+
+    // Solves `model` with the dual simplex from the slack basis after the barrier failed, in the
+    // `timeLimit` seconds it left. The optimal basis is also the crossover start: it is a vertex.
+    void dualSimplexFallback(const CompactModel& model, const NativeLpSettings& settings, double timeLimit,
+                             SolveStats* stats, NativeLpResult& result) {
+        using Outcome = NativeLpResult::Outcome;
+        SimplexSolver simplex;
+        {
+            SolveStats::Timer timer(stats, "load");
+            simplex.loadModel(model);
+        }
+        simplex.setTimeLimit(timeLimit);
+        simplex.setIterationLimit(settings.iterationLimit);
+        simplex.setCancelFlag(settings.cancelFlag);
+        SimplexStatus status;
+        {
+            SolveStats::Timer timer(stats, "lp");
+            status = simplex.solve(true);
+        }
+        result.fallbackFrom = result.status;
+        result.iterations += simplex.iterations();
+        if (stats) stats->addCounter("lp_iterations", simplex.iterations());
+        result.status = simplexStatusName(status);
+        result.outcome = Outcome::FAILED;
+        if (status == SimplexStatus::OPTIMAL) result.outcome = Outcome::OPTIMAL;
+        else if (status == SimplexStatus::INFEASIBLE) result.outcome = Outcome::INFEASIBLE;
+        else if (status == SimplexStatus::UNBOUNDED) result.outcome = Outcome::UNBOUNDED;
+        else if (status == SimplexStatus::TIME_LIMIT) result.stop = StopReason::TIME_LIMIT;
+        else if (status == SimplexStatus::ITERATION_LIMIT) result.stop = StopReason::ITERATION_LIMIT;
+        else if (status == SimplexStatus::CANCELLED) result.stop = StopReason::CANCELLED;
+        if (result.stop != StopReason::NONE) result.outcome = Outcome::STOPPED;
+        if (result.outcome != Outcome::OPTIMAL) return;
+        result.objective = simplex.getObjectiveValue();
+        result.values = simplex.getVariableValues();
+        result.basis = simplex.getBasis();
+        if (settings.crossover) result.crossoverStartBasis = result.basis;
+    }
+} // anonymous namespace
+
+NativeLpResult runNativeLp(const CompactModel& model, const NativeLpSettings& settings, SolveStats* stats) {
+    NativeLpResult result;
+    if (settings.method == LpMethod::PDLP) {
+        PdlpSolver pdlp;
+        runNativeMethod(pdlp, pdlpStatusName, model, settings, stats, result);
+    }
+    else if (settings.method == LpMethod::CONCURRENT) {
+        ConcurrentLpSolver race;
+        race.setBasis(settings.startBasis);
+        runNativeMethod(race, concurrentStatusName, model, settings, stats, result);
+        result.winner = race.winner();
+        result.raceSummary = race.summary();
+        if (race.hasBasis()) result.basis = race.getBasis();
+        if (stats) race.recordStats(*stats);
+    }
+    else if (settings.method == LpMethod::BARRIER) {
+        auto start = std::chrono::steady_clock::now();
+        InteriorPointSolver barrier;
+        runNativeMethod(barrier, ipmStatusName, model, settings, stats, result);
+        if (result.outcome == NativeLpResult::Outcome::FAILED) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            dualSimplexFallback(model, settings, settings.timeLimit - elapsed, stats, result);
+        }
+    }
+    else {
+        throw std::runtime_error("Not a native LP method");
+    }
+    return result;
+}
+
+/*
+ * Function: solveNative
+ * -------------------------
+ * The LP path with runNativeLp() on currentModel(). The solution is kept
+ * here, since GLPK has no slot for it. There is no basis afterwards
+ * unless a simplex won the race; with crossover, the guessed (or won)
+ * basis is installed for the simplex run solve() goes on to. A basis from
+ * setBasis() or a repair starts the race's simplex methods; one without a
+ * basic variable per row, which the race would reject, is dropped with a
+ * warning, as glp_warm_up() failures are in solve().
+ */
+void GLPKSolver::solveNative(double timeLimit) {
+    lpBasis = SimplexBasis();
+    source = SolutionSource::NATIVE;
+    solveStatus = GLP_UNDEF;
+    nativeValues.clear();
+
+    NativeLpSettings settings;
+    settings.method = lpMethod;
+    settings.threads = nativeThreads;
+    settings.timeLimit = timeLimit;
+    settings.iterationLimit = limits.iterationLimit;
+    settings.cancelFlag = &cancelRequested;
+    settings.crossover = crossover;
+    if (lpMethod == LpMethod::CONCURRENT && warmStart) {
+        SimplexBasis start = glpkBasis();
+        size_t basic = std::count(start.columns.begin(), start.columns.end(), BasisStatus::BASIC) +
+                       std::count(start.rows.begin(), start.rows.end(), BasisStatus::BASIC);
+        if (basic == start.rows.size()) settings.startBasis = std::move(start);
+        else std::cerr << "Warning: starting basis is invalid; the race starts from scratch\n";
+        warmStart = false;
+    }
+    NativeLpResult native = runNativeLp(currentModel(), settings, stats);
+
+    switch (native.outcome) {
+        case NativeLpResult::Outcome::OPTIMAL: solveStatus = GLP_OPT; break;
+        case NativeLpResult::Outcome::INFEASIBLE: solveStatus = GLP_NOFEAS; break;
+        case NativeLpResult::Outcome::UNBOUNDED: solveStatus = GLP_UNBND; break;
+        case NativeLpResult::Outcome::STOPPED: stop = native.stop; break;
+        case NativeLpResult::Outcome::FAILED: break;
+    }
+    raceWinner = native.winner;
+    raceSummary = native.raceSummary;
+    lpBasis = native.basis;
+    if (solveStatus == GLP_OPT) {
+        nativeObjective = native.objective;
+        nativeValues = native.values;
+        if (crossover) setBasis(native.crossoverStartBasis);
+    }
+}
+
+void GLPKSolver::setBasis(const SimplexBasis& basis) {
+    int numRows = glp_get_num_rows(lp);
+    if (basis.columns.size() != size_t(numCols) || basis.rows.size() != size_t(numRows)) {
+        throw std::runtime_error("Basis does not match the model");
+    }
+    for (int j = 0; j < numCols; ++j) {
+        glp_set_col_stat(lp, j + 1, toGlpkStatus(basis.columns[j], glp_get_col_type(lp, j + 1)));
+    }
+    for (int i = 0; i < numRows; ++i) {
+        glp_set_row_stat(lp, i + 1, toGlpkStatus(basis.rows[i], glp_get_row_type(lp, i + 1)));
+    }
+    warmStart = true;
+}
+
+SimplexBasis GLPKSolver::getBasis() const {
+    if (lpBasis.columns.size() != size_t(numCols) || lpBasis.rows.size() != size_t(glp_get_num_rows(lp))) {
+        throw std::runtime_error("No basis: the last solve() did not end in a simplex basis");
+    }
+    return lpBasis;
+}
+
+bool GLPKSolver::hasSolution() const {
+    return solveStatus == GLP_OPT || solveStatus == GLP_FEAS;
+}
+
+const char* GLPKSolver::statusName() const {
+    switch (solveStatus) {
+        case GLP_OPT: return "OPTIMAL";
+        case GLP_FEAS: return "FEASIBLE";
+        case GLP_NOFEAS: return "INFEASIBLE";
+        case GLP_UNBND: return "UNBOUNDED";
+        default: return "UNDEFINED";
     }
 }
 
 double GLPKSolver::getObjectiveValue() const {
-    return glp_mip_obj_val(lp); // For MIP
-    // For LP: return glp_get_obj_val(lp);
+    switch (source) {
+        case SolutionSource::MIP: return glp_mip_obj_val(lp);
+        case SolutionSource::INTERIOR: return glp_ipt_obj_val(lp);
+        case SolutionSource::NATIVE: return nativeObjective;
+        default: return glp_get_obj_val(lp);
+    }
 }
 
-std::unordered_map<std::string, double> GLPKSolver::getVariableValues() const {
-    std::unordered_map<std::string, double> result;
-    for (const auto& [name, idx] : varNameToCol) {
-        result[name] = glp_mip_col_val(lp, idx); // For MIP
-        // For LP: glp_get_col_prim(lp, idx);
+std::vector<double> GLPKSolver::getVariableValues() const {
+    if (source == SolutionSource::NATIVE) return nativeValues;
+    std::vector<double> result(numCols);
+    for (int j = 0; j < numCols; ++j) {
+        switch (source) {
+            case SolutionSource::MIP: result[j] = glp_mip_col_val(lp, j + 1); break;
+            case SolutionSource::INTERIOR: result[j] = glp_ipt_col_prim(lp, j + 1); break;
+            default: result[j] = glp_get_col_prim(lp, j + 1); break;
+        }
     }
     return result;
-}
\ No newline at end of file
+}
@@ -1,9 +1,107 @@
 #pragma once
 
 #include "parser.h"
+#include "compact_model.h"
+#include "concurrent_lp.h"
+#include "simplex.h"
+#include "solve_stats.h"
 #include <glpk.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Why a GLPKSolver::solve() stopped before finishing its search.
+ */
+enum class StopReason {
+  NONE,            // The solve ran to completion (whatever its status)
+  TIME_LIMIT,      // SolveLimits::timeLimit expired
+  GAP_LIMIT,       // The incumbent is within the relative or absolute gap of the bound
+  NODE_LIMIT,      // SolveLimits::nodeLimit branch-and-bound nodes were created
+  ITERATION_LIMIT, // SolveLimits::iterationLimit simplex iterations were done
+  CANCELLED        // cancel() was called
+};
+
+/**
+ * @brief Returns the name of `reason`, e.g. "TIME_LIMIT".
+ */
+const char* stopReasonName(StopReason reason);
+
+/**
+ * @brief How GLPKSolver::solve() solves a problem without integer columns.
+ */
+enum class LpMethod {
+  SIMPLEX,   // glp_simplex, primal or dual
+  INTERIOR,  // GLPK's interior-point method, glp_interior
+  BARRIER,   // The native InteriorPointSolver
+  PDLP,      // The native first-order PdlpSolver
+  CONCURRENT // ConcurrentLpSolver: native primal, dual and barrier race
+};
+
+/**
+ * @brief Limits on a GLPKSolver::solve(); the defaults impose none.
+ */
+struct SolveLimits {
+  double timeLimit = INFINITY;          // Wall seconds per solve()
+  double relativeGap = 0.0;             // MIP: |incumbent - bound| / |incumbent| (GLPK's mip_gap)
+  double absoluteGap = 0.0;             // MIP: |incumbent - bound|
+  uint64_t nodeLimit = UINT64_MAX;      // MIP: branch-and-bound nodes created
+  uint64_t iterationLimit = UINT64_MAX; // Simplex iterations, LP relaxation and nodes together
+};
+
+/**
+ * @brief Settings for runNativeLp(); the defaults impose no limits.
+ */
+struct NativeLpSettings {
+  LpMethod method = LpMethod::BARRIER;     // BARRIER, PDLP or CONCURRENT
+  unsigned threads = 0;                    // 0 = one per hardware thread
+  double timeLimit = INFINITY;             // Wall seconds
+  uint64_t iterationLimit = UINT64_MAX;    // Unset keeps the method's own default
+  const std::atomic<bool>* cancelFlag = nullptr;
+  SimplexBasis startBasis;                 // Race only: start of both simplex methods (empty = cold)
+  bool crossover = false;                  // Guess a crossover start for an optimum
+};
+
+/**
+ * @brief Outcome of runNativeLp().
+ */
+struct NativeLpResult {
+  enum class Outcome {
+    OPTIMAL,    // values holds an optimal solution
+    INFEASIBLE, // The method proved the LP infeasible
+    UNBOUNDED,  // The method proved the LP unbounded
+    STOPPED,    // A limit or the cancel flag stopped it; see stop
+    FAILED      // It gave up without a verdict, e.g. on numerical trouble
+  };
+  Outcome outcome = Outcome::FAILED;
+  const char* status = "UNSOLVED";   // The method's own status name, e.g. "NUMERICAL_ERROR"
+  StopReason stop = StopReason::NONE;
+  double objective = 0.0;            // In the model's sense, with the objective constant
+  std::vector<double> values;        // By column id; empty unless OPTIMAL
+  SimplexBasis basis;                // The optimal basis of a winning or fallback simplex; empty otherwise
+  SimplexBasis crossoverStartBasis;  // With NativeLpSettings::crossover and OPTIMAL: crossoverStart() or basis
+  uint64_t iterations = 0;
+  LpRacer winner = LpRacer::NONE;    // Race only: ConcurrentLpSolver::winner() and summary()
+  std::string raceSummary;
+  const char* fallbackFrom = nullptr; // Barrier only: its status if it failed and the dual simplex took over
+};
+
+/**
+ * @brief Solves `model` as an LP with a native method: InteriorPointSolver,
+ * PdlpSolver or the ConcurrentLpSolver race. Integrality is ignored. Both
+ * GLPKSolver and the native solve pipeline go through here, and each runs
+ * its own crossover from crossoverStartBasis. A barrier that fails without
+ * a verdict (NUMERICAL_ERROR) is followed by the dual simplex on the same
+ * model in the time left; status and outcome are then the simplex's.
+ *
+ * Records phases load and lp and counter lp_iterations in `stats` (if not
+ * null), and ConcurrentLpSolver::recordStats() for a race.
+ *
+ * @throws std::runtime_error if the method is not a native one, or from
+ * ConcurrentLpSolver::solve() if the start basis does not fit the model.
+ */
+NativeLpResult runNativeLp(const CompactModel& model, const NativeLpSettings& settings, SolveStats* stats);
 
 /**
  * @class GLPKSolver
@@ -12,11 +110,47 @@
  * This class provides functionality to:
  * - Map a parsed LPModel (from the parser) to a GLPK problem instance.
  * - Solve the problem using GLPK's simplex or integer optimization methods.
+ * - Change bounds, costs, rows and columns in place and re-solve from the
+ *   current basis.
  * - Retrieve the solution, including objective value and variable assignments.
  */
 class GLPKSolver {
   glp_prob* lp; // GLPK problem object
-  std::unordered_map<std::string, int> varNameToCol; // Map variable name to GLPK column index
+  int numCols = 0; // GLPK column j + 1 holds model column id j
+  bool warmStart = false; // The basis was set or repaired since the last solve()
+  SimplexBasis lpBasis;   // Basis at the end of the last simplex run
+  // Where the last solve()'s solution is: one of GLPK's (simplex, interior
+  // point or integer), or the copy below from a native method
+  enum class SolutionSource { SIMPLEX, INTERIOR, MIP, NATIVE };
+  SolutionSource source = SolutionSource::SIMPLEX;
+  int solveStatus = GLP_UNDEF; // GLPK status of that solution
+  LpMethod lpMethod = LpMethod::SIMPLEX;
+  unsigned nativeThreads = 0;
+  bool crossover = false;     // Barrier and PDLP optima go on to an optimal basis
+  double nativeObjective = 0.0;
+  std::vector<double> nativeValues;
+  LpRacer raceWinner = LpRacer::NONE; // Of the last solve() with LpMethod::CONCURRENT
+  std::string raceSummary;
+  SolveLimits limits;
+  std::atomic<bool> cancelRequested{false};
+  StopReason stop = StopReason::NONE;
+  StopReason callbackStop = StopReason::NONE; // Why intoptCallback terminated glp_intopt
+  int iterationStart = 0;                     // glp_get_it_cnt when solve() began
+  SolveStats* stats = nullptr;                // See setStats()
+  uint64_t mipNodes = 0;                      // Counted by intoptCallback during glp_intopt
+  uint64_t mipIncumbents = 0;
+  uint64_t mipCutRows = 0;
+  int mipBaseRows = 0;                        // Rows before glp_intopt; more are cuts
+
+  static void intoptCallback(glp_tree* tree, void* info);
+
+  void checkColumn(uint32_t j) const;
+  void checkRow(uint32_t i) const;
+  void repairBasis();
+  SimplexBasis glpkBasis() const;
+  void solveInterior();
+  CompactModel currentModel() const;
+  void solveNative(double timeLimit);
 
 public:
   /**
@@ -39,6 +173,70 @@ public:
    */
   void loadModel(const LPModel& model);
 
+  /**
+   * @brief Loads a CompactModel; the matrix is fed to glp_load_matrix
+   * directly from its CSR arrays. Whatever was loaded before is erased,
+   * so one solver can be reused for a sequence of models.
+   */
+  void loadModel(const CompactModel& model);
+
+  /**
+   * @brief Model id of the column named `name`, or SymbolTable::NOT_FOUND.
+   * Uses GLPK's name index, which follows every addition and removal.
+   */
+  uint32_t findColumn(const std::string& name) const;
+
+  /**
+   * @brief Model id of the row named `name`, or SymbolTable::NOT_FOUND.
+   */
+  uint32_t findRow(const std::string& name) const;
+
+  /**
+   * @brief Number of columns and rows of the current problem.
+   */
+  uint32_t columnCount() const { return static_cast<uint32_t>(numCols); }
+  uint32_t rowCount() const { return static_cast<uint32_t>(glp_get_num_rows(lp)); }
+
+  /**
+   * @brief Incremental changes to the loaded problem.
+   *
+   * None of these reloads the problem: GLPK keeps the current basis, and
+   * bound and objective changes keep its factorization too, so the next
+   * solve() starts from where the last one ended. Rows and columns keep
+   * consecutive ids; removing one shifts the ids after it down, as in
+   * GLPK. Added rows start basic and added columns nonbasic, so the basis
+   * stays valid; after a removal the basis is repaired to have one basic
+   * variable per row.
+   *
+   * @throws std::runtime_error for ids out of range, duplicate names, or
+   * entries that refer to missing rows or columns.
+   */
+  void setObjectiveCoefficient(uint32_t j, double value);
+  void setColumnBounds(uint32_t j, double lower, double upper);
+  void setRowBounds(uint32_t i, double lower, double upper);
+
+  /**
+   * @brief Appends a column with entries `values` in rows `rows`.
+   *
+   * @return The new column's id.
+   */
+  uint32_t addColumn(const std::string& name, VarType kind, double lower, double upper, double cost,
+                     const std::vector<uint32_t>& rows, const std::vector<double>& values);
+
+  /**
+   * @brief Appends a row lower <= sum values[k] * x[columns[k]] <= upper.
+   *
+   * @return The new row's id.
+   */
+  uint32_t addRow(const std::string& name, double lower, double upper,
+                  const std::vector<uint32_t>& columns, const std::vector<double>& values);
+
+  /**
+   * @brief Removes the given columns (rows); the remaining ones are renumbered.
+   */
+  void removeColumns(std::vector<uint32_t> columns);
+  void removeRows(std::vector<uint32_t> rows);
+
   /**
    * @brief Solves the loaded problem using GLPK.
    * 
@@ -46,10 +244,124 @@ public:
    * @param isMIP If true, solves the problem as a MILP using branch-and-bound.
    * 
    * This function solves the problem using either simplex (for LP) or
-   * branch-and-bound (for MILP), depending on the flags provided.
+   * branch-and-bound (for MILP), depending on the flags provided. For a
+   * MILP the LP relaxation is solved by simplex first, and branch-and-bound
+   * starts from its basis. A problem without integer columns is solved as
+   * an LP even if isMIP is set, so glp_intopt never runs for nothing and
+   * the results are read from the LP solution.
    */
   void solve(bool useDualSimplex = false, bool isMIP = false);
 
+  /**
+   * @brief Method for problems without integer columns (default simplex).
+   * Only simplex leaves a basis. GLPK's interior-point method takes no
+   * limits, so they and cancel() only take effect before it starts. The
+   * node and gap limits do not apply to the native methods. The barrier
+   * checks the others every iteration, and hands over to the native dual
+   * simplex if it fails numerically. PDLP checks the time limit and
+   * cancel() before every step it tries, rejected ones included, and
+   * counts only accepted steps against the iteration limit; a step search
+   * that keeps failing ends the solve without a result. The concurrent
+   * race runs the native methods, not GLPK's, starts both simplex methods
+   * from a basis installed by setBasis(), and leaves the basis of a
+   * winning simplex. MILPs keep using simplex for their relaxation, since
+   * branch-and-bound needs a basis.
+   */
+  void setLpMethod(LpMethod method) { lpMethod = method; }
+
+  /**
+   * @brief With LpMethod::BARRIER, PDLP or CONCURRENT, follow an optimal
+   * solution with a crossover: simplex (as chosen by solve()'s useDualSimplex) from the
+   * basis crossoverBasis() guesses, which leaves an optimal basis for
+   * getBasis(), or after a race won by a simplex, from that simplex's
+   * basis. It is timed as phase crossover with counter
+   * crossover_iterations. If a limit stops it, the native solution is kept.
+   */
+  void setCrossover(bool enable) { crossover = enable; }
+
+  /**
+   * @brief Threads for LpMethod::BARRIER, PDLP and CONCURRENT (0 = one
+   * per hardware thread).
+   */
+  void setThreads(unsigned threads) { nativeThreads = threads; }
+
+  /**
+   * @brief The method that won the last solve()'s concurrent race, and
+   * ConcurrentLpSolver::summary() of the race; LpRacer::NONE and empty
+   * unless it used LpMethod::CONCURRENT.
+   */
+  LpRacer lpWinner() const { return raceWinner; }
+  const std::string& lpRaceSummary() const { return raceSummary; }
+
+  /**
+   * @brief Limits for the following solve() calls. A MILP stopped by any
+   * limit keeps its best integer solution, if any.
+   *
+   * The time and iteration limits go to glp_simplex and glp_intopt, the
+   * relative gap to glp_iocp::mip_gap; the node limit, the absolute gap
+   * and the iteration count during branch-and-bound are checked in the
+   * glp_intopt callback, which GLPK calls at least once per node.
+   */
+  void setLimits(const SolveLimits& newLimits) { limits = newLimits; }
+  const SolveLimits& getLimits() const { return limits; }
+
+  /**
+   * @brief Records what the following loadModel() and solve() calls do in
+   * `target` (null stops recording): phases load, lp and mip, and counters
+   * lp_iterations, mip_iterations, nodes (created by branch-and-bound),
+   * incumbent_updates and cuts. GLPK does not report its cut count, so
+   * cuts is the most cut rows any node LP had.
+   */
+  void setStats(SolveStats* target) { stats = target; }
+
+  /**
+   * @brief Asks the running solve() to stop, or the next one if none is
+   * running. Safe to call from any thread. The request is used up when a
+   * solve() returns; clearCancel() withdraws it.
+   *
+   * GLPK's simplex has no callback, so it runs in slices of at most a
+   * second, and a cancel takes effect at the end of the current slice or
+   * at the next branch-and-bound callback.
+   */
+  void cancel() { cancelRequested = true; }
+  void clearCancel() { cancelRequested = false; }
+
+  /**
+   * @brief Why the last solve() stopped early, or StopReason::NONE.
+   */
+  StopReason stopReason() const { return stop; }
+
+  /**
+   * @brief Installs a starting basis for the next solve(), one status per
+   * model column and row. Nonbasic statuses are adapted to each bound
+   * type (fixed, free, one-sided). If GLPK finds the basis invalid or
+   * singular, solve() falls back to its advanced initial basis.
+   *
+   * @throws std::runtime_error if the sizes do not match the loaded model.
+   */
+  void setBasis(const SimplexBasis& basis);
+
+  /**
+   * @brief Returns the basis in which the last solve()'s simplex run
+   * ended: the optimal LP basis, or for a MILP that of the relaxation.
+   *
+   * @throws std::runtime_error if solve() has not run since the last
+   * row or column was added or removed, or it used an interior-point
+   * method without crossover.
+   */
+  SimplexBasis getBasis() const;
+
+  /**
+   * @brief True if the last solve() found a feasible (for a MILP, integer
+   * feasible) solution.
+   */
+  bool hasSolution() const;
+
+  /**
+   * @brief Status of the last solve(), e.g. "OPTIMAL" or "INFEASIBLE".
+   */
+  const char* statusName() const;
+
   /**
    * @brief Retrieves the objective value of the solved problem.
    * 
@@ -63,10 +375,10 @@ public:
   /**
    * @brief Retrieves the values of the decision variables in the solution.
    * 
-   * @return A map of variable names to their corresponding solution values.
+   * @return Solution values indexed by column id; names come from LPModel::variables.
    * 
    * For MILP, this retrieves the integer solution values.
    * For LP, it retrieves the optimal continuous values.
    */
-  std::unordered_map<std::string, double> getVariableValues() const;
+  std::vector<double> getVariableValues() const;
 };
\ No newline at end of file
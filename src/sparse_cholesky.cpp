@@ -0,0 +1,533 @@
+#include "sparse_cholesky.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+  constexpr uint32_t NONE = UINT32_MAX;
+  constexpr double PIVOT_TOLERANCE = 1e-13; // Relative to the largest diagonal entry of M
+  constexpr double REPLACED_PIVOT = 1e64;   // Square root of the value that stands in for a bad pivot
+  constexpr uint32_t BLOCK = 64;            // Pivot columns per block of a front
+  // Levels and fronts with less work (in multiply-adds) than this stay on one thread
+  constexpr double PARALLEL_WORK = 1 << 20;
+
+  /*
+   * Function: subtractColumns
+   * -------------------------
+   * column[i] -= sum over k in [k0, k1) of L(i, k) L(c, k), for rows i of
+   * [c, nr), where column k of L is front[k * nr ..]. Four columns go in
+   * one pass, so `column` is loaded and stored a quarter as often.
+   */
+  void subtractColumns(double* column, const double* front, size_t nr, uint32_t k0, uint32_t k1, size_t c) {
+    uint32_t k = k0;
+    for (; k + 4 <= k1; k += 4) {
+      const double* s0 = front + k * nr;
+      const double* s1 = s0 + nr;
+      const double* s2 = s1 + nr;
+      const double* s3 = s2 + nr;
+      double l0 = s0[c], l1 = s1[c], l2 = s2[c], l3 = s3[c];
+      if (l0 == 0.0 && l1 == 0.0 && l2 == 0.0 && l3 == 0.0) continue;
+      for (size_t i = c; i < nr; ++i) column[i] -= s0[i] * l0 + s1[i] * l1 + s2[i] * l2 + s3[i] * l3;
+    }
+    for (; k < k1; ++k) {
+      const double* source = front + k * nr;
+      double l = source[c];
+      if (l == 0.0) continue;
+      for (size_t i = c; i < nr; ++i) column[i] -= source[i] * l;
+    }
+  }
+
+  /*
+   * Function: minimumDegreeOrder
+   * -------------------------
+   * Approximate minimum degree ordering of the graph `adjacency` (a
+   * symmetric pattern without the diagonal). Eliminated nodes become
+   * elements of a quotient graph: a variable keeps its remaining variable
+   * neighbours and the elements it belongs to, and eliminating a pivot
+   * merges the pivot's elements into a new one. Degrees are AMD's upper
+   * bounds, using |Le \ Lp| for the other elements of each variable;
+   * elements that lie inside the new one are absorbed.
+   */
+  vector<uint32_t> minimumDegreeOrder(const SparseMatrix& adjacency) {
+    uint32_t n = adjacency.numMajor();
+    vector<vector<uint32_t>> vars(n), elems(n), members(n);
+    vector<size_t> degree(n);
+    for (uint32_t i = 0; i < n; ++i) {
+      vars[i].assign(adjacency.index.begin() + adjacency.start[i], adjacency.index.begin() + adjacency.start[i + 1]);
+      degree[i] = vars[i].size();
+    }
+    vector<char> eliminated(n, 0), absorbed(n, 0);
+    vector<uint32_t> mark(n, 0), wmark(n, 0);
+    vector<size_t> w(n, 0);
+
+    // Variables by degree, in doubly linked lists
+    vector<uint32_t> head(n + 1, NONE), next(n, NONE), prev(n, NONE);
+    auto insert = [&](uint32_t i) {
+      uint32_t& first = head[degree[i]];
+      next[i] = first;
+      prev[i] = NONE;
+      if (first != NONE) prev[first] = i;
+      first = i;
+    };
+    auto remove = [&](uint32_t i) {
+      if (prev[i] != NONE) next[prev[i]] = next[i];
+      else head[degree[i]] = next[i];
+      if (next[i] != NONE) prev[next[i]] = prev[i];
+    };
+    for (uint32_t i = 0; i < n; ++i) insert(i);
+
+    vector<uint32_t> order;
+    order.reserve(n);
+    size_t minDegree = 0;
+    uint32_t stamp = 0;
+    while (order.size() < n) {
+      while (head[minDegree] == NONE) ++minDegree;
+      uint32_t p = head[minDegree];
+      remove(p);
+      eliminated[p] = 1;
+      order.push_back(p);
+      ++stamp;
+
+      // The new element: p's variable neighbours and the members of its elements
+      vector<uint32_t>& lp = members[p];
+      mark[p] = stamp;
+      for (uint32_t i : vars[p]) {
+        if (!eliminated[i] && mark[i] != stamp) {
+          mark[i] = stamp;
+          lp.push_back(i);
+        }
+      }
+      for (uint32_t e : elems[p]) {
+        if (absorbed[e]) continue;
+        for (uint32_t i : members[e]) {
+          if (mark[i] != stamp) {
+            mark[i] = stamp;
+            lp.push_back(i);
+          }
+        }
+        absorbed[e] = 1;
+        vector<uint32_t>().swap(members[e]);
+      }
+      vector<uint32_t>().swap(vars[p]);
+      vector<uint32_t>().swap(elems[p]);
+
+      // w[e] = |Le \ Lp| for the elements next to Lp
+      for (uint32_t i : lp) {
+        for (uint32_t e : elems[i]) {
+          if (absorbed[e]) continue;
+          if (wmark[e] != stamp) {
+            wmark[e] = stamp;
+            w[e] = members[e].size();
+          }
+          --w[e];
+        }
+      }
+
+      size_t remaining = n - order.size();
+      for (uint32_t i : lp) {
+        remove(i);
+        size_t d = lp.size() - 1;
+        vector<uint32_t>& ei = elems[i];
+        size_t keep = 0;
+        for (uint32_t e : ei) {
+          if (absorbed[e]) continue;
+          if (wmark[e] == stamp && w[e] == 0) {
+            absorbed[e] = 1; // Le lies inside Lp
+            vector<uint32_t>().swap(members[e]);
+            continue;
+          }
+          d += wmark[e] == stamp ? w[e] : members[e].size();
+          ei[keep++] = e;
+        }
+        ei.resize(keep);
+        ei.push_back(p);
+
+        // Variable edges inside Lp are now implied by the element
+        vector<uint32_t>& vi = vars[i];
+        keep = 0;
+        for (uint32_t v : vi) {
+          if (!eliminated[v] && mark[v] != stamp) vi[keep++] = v;
+        }
+        vi.resize(keep);
+        d += keep;
+
+        degree[i] = min({ d, remaining - 1, degree[i] + lp.size() - 1 });
+        insert(i);
+        minDegree = min(minDegree, degree[i]);
+      }
+    }
+    return order;
+  }
+
+  /*
+   * Function: permutedLower
+   * -------------------------
+   * Lower triangle by columns of the matrix whose lower triangle by rows
+   * is `pattern`, with index i renumbered to position[i]. Rows ascend in
+   * each column, so the diagonal comes first. entryPosition[q] is where
+   * input entry q lands.
+   */
+  SparseMatrix permutedLower(const SparseMatrix& pattern, const vector<uint32_t>& position,
+                             vector<size_t>& entryPosition) {
+    uint32_t n = pattern.numMajor();
+    size_t nnz = pattern.numNonzeros();
+    SparseMatrix lower;
+    lower.start.assign(n + 1, 0);
+    vector<uint32_t> column(nnz), row(nnz);
+    for (uint32_t i = 0; i < n; ++i) {
+      for (size_t q = pattern.start[i]; q < pattern.start[i + 1]; ++q) {
+        uint32_t a = position[i], b = position[pattern.index[q]];
+        column[q] = min(a, b);
+        row[q] = max(a, b);
+        ++lower.start[column[q] + 1];
+      }
+    }
+    for (uint32_t j = 0; j < n; ++j) lower.start[j + 1] += lower.start[j];
+
+    vector<size_t> entries(nnz), fill(lower.start.begin(), lower.start.end() - 1);
+    for (size_t q = 0; q < nnz; ++q) entries[fill[column[q]]++] = q;
+    lower.index.resize(nnz);
+    lower.value.assign(nnz, 0.0);
+    entryPosition.resize(nnz);
+    for (uint32_t j = 0; j < n; ++j) {
+      auto first = entries.begin() + lower.start[j], last = entries.begin() + lower.start[j + 1];
+      sort(first, last, [&](size_t a, size_t b) { return row[a] < row[b]; });
+      for (size_t p = lower.start[j]; p < lower.start[j + 1]; ++p) {
+        lower.index[p] = row[entries[p]];
+        entryPosition[entries[p]] = p;
+      }
+    }
+    return lower;
+  }
+
+  // Elimination tree of the matrix with lower triangle `lower` (by columns)
+  vector<uint32_t> eliminationTree(const SparseMatrix& lower) {
+    uint32_t n = lower.numMajor();
+    SparseMatrix upper = lower.transpose(n); // Column k lists the rows i <= k
+    vector<uint32_t> parent(n, NONE), ancestor(n, NONE);
+    for (uint32_t k = 0; k < n; ++k) {
+      for (size_t p = upper.start[k]; p < upper.start[k + 1]; ++p) {
+        for (uint32_t i = upper.index[p]; i != NONE && i < k;) {
+          uint32_t up = ancestor[i];
+          ancestor[i] = k;
+          if (up == NONE) parent[i] = k;
+          i = up;
+        }
+      }
+    }
+    return parent;
+  }
+
+  // Depth-first postorder of the forest `parent`: post[k] is the k-th node
+  vector<uint32_t> postorder(const vector<uint32_t>& parent) {
+    uint32_t n = static_cast<uint32_t>(parent.size());
+    vector<uint32_t> firstChild(n, NONE), sibling(n, NONE);
+    for (uint32_t j = n; j-- > 0;) {
+      if (parent[j] == NONE) continue;
+      sibling[j] = firstChild[parent[j]];
+      firstChild[parent[j]] = j;
+    }
+    vector<uint32_t> post, stack;
+    post.reserve(n);
+    for (uint32_t root = 0; root < n; ++root) {
+      if (parent[root] != NONE) continue;
+      stack.push_back(root);
+      while (!stack.empty()) {
+        uint32_t top = stack.back();
+        uint32_t child = firstChild[top];
+        if (child == NONE) {
+          post.push_back(top);
+          stack.pop_back();
+        }
+        else {
+          firstChild[top] = sibling[child];
+          stack.push_back(child);
+        }
+      }
+    }
+    return post;
+  }
+} // anonymous namespace
+
+void SparseCholesky::analyze(const SparseMatrix& pattern) {
+  n = pattern.numMajor();
+
+  // Symmetric adjacency without the diagonal, for the ordering
+  SparseMatrix adjacency;
+  adjacency.start.assign(n + 1, 0);
+  for (uint32_t i = 0; i < n; ++i) {
+    for (size_t q = pattern.start[i]; q < pattern.start[i + 1]; ++q) {
+      uint32_t k = pattern.index[q];
+      if (k > i) throw runtime_error("Cholesky pattern has an entry above the diagonal");
+      if (k == i) continue;
+      ++adjacency.start[i + 1];
+      ++adjacency.start[k + 1];
+    }
+  }
+  for (uint32_t i = 0; i < n; ++i) adjacency.start[i + 1] += adjacency.start[i];
+  adjacency.index.resize(adjacency.start[n]);
+  vector<size_t> fill(adjacency.start.begin(), adjacency.start.end() - 1);
+  for (uint32_t i = 0; i < n; ++i) {
+    for (size_t q = pattern.start[i]; q < pattern.start[i + 1]; ++q) {
+      uint32_t k = pattern.index[q];
+      if (k == i) continue;
+      adjacency.index[fill[i]++] = k;
+      adjacency.index[fill[k]++] = i;
+    }
+  }
+  vector<uint32_t> order = minimumDegreeOrder(adjacency);
+  adjacency = SparseMatrix();
+
+  // Postorder the elimination tree so that supernodes and subtrees are
+  // contiguous; this renumbering does not change the fill
+  vector<uint32_t> position(n);
+  for (uint32_t k = 0; k < n; ++k) position[order[k]] = k;
+  vector<uint32_t> parent = eliminationTree(permutedLower(pattern, position, entryPosition));
+  vector<uint32_t> post = postorder(parent);
+  vector<uint32_t> renumber(n);
+  for (uint32_t k = 0; k < n; ++k) renumber[post[k]] = k;
+  perm.resize(n);
+  vector<uint32_t> newParent(n);
+  for (uint32_t k = 0; k < n; ++k) {
+    perm[k] = order[post[k]];
+    newParent[k] = parent[post[k]] == NONE ? NONE : renumber[parent[post[k]]];
+  }
+  parent.swap(newParent);
+  for (uint32_t k = 0; k < n; ++k) position[perm[k]] = k;
+  lower = permutedLower(pattern, position, entryPosition);
+
+  // Row structure of each column of L: its rows of M and its children's
+  // structures, below the diagonal
+  vector<uint32_t> firstChild(n, NONE), sibling(n, NONE), numChildren(n, 0);
+  for (uint32_t j = n; j-- > 0;) {
+    if (parent[j] == NONE) continue;
+    sibling[j] = firstChild[parent[j]];
+    firstChild[parent[j]] = j;
+    ++numChildren[parent[j]];
+  }
+  vector<vector<uint32_t>> structure(n);
+  vector<uint32_t> mark(n, NONE);
+  for (uint32_t j = 0; j < n; ++j) {
+    vector<uint32_t>& s = structure[j];
+    mark[j] = j;
+    for (size_t p = lower.start[j]; p < lower.start[j + 1]; ++p) {
+      uint32_t r = lower.index[p];
+      if (mark[r] != j) {
+        mark[r] = j;
+        s.push_back(r);
+      }
+    }
+    for (uint32_t c = firstChild[j]; c != NONE; c = sibling[c]) {
+      for (uint32_t r : structure[c]) {
+        if (mark[r] != j) {
+          mark[r] = j;
+          s.push_back(r);
+        }
+      }
+    }
+    sort(s.begin(), s.end());
+  }
+
+  // Fundamental supernodes: j joins j - 1 if it is j - 1's parent, has no
+  // other child, and its structure is that of j - 1 without j
+  superStart.assign(1, 0);
+  for (uint32_t j = 1; j < n; ++j) {
+    bool nested = parent[j - 1] == j && numChildren[j] == 1 && structure[j - 1].size() == structure[j].size() + 1;
+    if (!nested) superStart.push_back(j);
+  }
+  if (n > 0) superStart.push_back(n);
+  uint32_t numSuper = supernodes();
+
+  vector<uint32_t> superOf(n);
+  rowStart.assign(1, 0);
+  superRows.clear();
+  valueStart.assign(1, 0);
+  for (uint32_t s = 0; s < numSuper; ++s) {
+    uint32_t first = superStart[s], last = superStart[s + 1];
+    for (uint32_t j = first; j < last; ++j) {
+      superOf[j] = s;
+      superRows.push_back(j);
+    }
+    superRows.insert(superRows.end(), structure[last - 1].begin(), structure[last - 1].end());
+    rowStart.push_back(superRows.size());
+    valueStart.push_back(valueStart.back() + (rowStart[s + 1] - rowStart[s]) * (last - first));
+  }
+  structure.clear();
+
+  // Supernodal tree, its children lists and levels
+  superParent.assign(numSuper, NONE);
+  childStart.assign(numSuper + 1, 0);
+  for (uint32_t s = 0; s < numSuper; ++s) {
+    uint32_t up = parent[superStart[s + 1] - 1];
+    if (up == NONE) continue;
+    superParent[s] = superOf[up];
+    ++childStart[superParent[s] + 1];
+  }
+  for (uint32_t s = 0; s < numSuper; ++s) childStart[s + 1] += childStart[s];
+  superChildren.resize(childStart[numSuper]);
+  vector<size_t> slot(childStart.begin(), childStart.end() - 1);
+  vector<uint32_t> height(numSuper, 0);
+  levels.clear();
+  for (uint32_t s = 0; s < numSuper; ++s) {
+    if (height[s] >= levels.size()) levels.resize(height[s] + 1);
+    levels[height[s]].push_back(s);
+    if (superParent[s] == NONE) continue;
+    superChildren[slot[superParent[s]]++] = s;
+    height[superParent[s]] = max(height[superParent[s]], height[s] + 1);
+  }
+  factorValues.assign(valueStart.back(), 0.0);
+}
+
+/*
+ * Function: factorSupernode
+ * -------------------------
+ * Assembles the front of supernode `s` (its columns of M plus the update
+ * matrices of its children), factors its pivot columns in blocks,
+ * right-looking between blocks, and leaves the Schur complement of the
+ * other rows in updates[s]. With a pool, the update of the columns right
+ * of each block is split across it.
+ */
+void SparseCholesky::factorSupernode(uint32_t s, Scratch& scratch, vector<vector<double>>& updates,
+                                     double pivotTolerance, ThreadPool* pool, uint32_t& replaced) {
+  uint32_t first = superStart[s];
+  uint32_t ns = superStart[s + 1] - first;
+  const uint32_t* rows = superRows.data() + rowStart[s];
+  size_t nr = rowStart[s + 1] - rowStart[s];
+
+  vector<uint32_t>& position = scratch.position;
+  if (position.size() < n) position.resize(n);
+  for (size_t r = 0; r < nr; ++r) position[rows[r]] = static_cast<uint32_t>(r);
+  vector<double>& front = scratch.front;
+  front.assign(nr * nr, 0.0);
+
+  for (uint32_t c = 0; c < ns; ++c) {
+    double* column = front.data() + c * nr;
+    for (size_t p = lower.start[first + c]; p < lower.start[first + c + 1]; ++p) {
+      column[position[lower.index[p]]] += lower.value[p];
+    }
+  }
+  for (size_t k = childStart[s]; k < childStart[s + 1]; ++k) {
+    uint32_t child = superChildren[k];
+    size_t childPivots = superStart[child + 1] - superStart[child];
+    const uint32_t* childRows = superRows.data() + rowStart[child] + childPivots;
+    size_t nu = rowStart[child + 1] - rowStart[child] - childPivots;
+    const vector<double>& update = updates[child];
+    for (size_t b = 0; b < nu; ++b) {
+      double* column = front.data() + position[childRows[b]] * nr;
+      const double* source = update.data() + b * nu;
+      for (size_t a = b; a < nu; ++a) column[position[childRows[a]]] += source[a];
+    }
+    vector<double>().swap(updates[child]);
+  }
+
+  for (uint32_t j0 = 0; j0 < ns; j0 += BLOCK) {
+    uint32_t j1 = min(ns, j0 + BLOCK);
+    for (uint32_t j = j0; j < j1; ++j) {
+      double* column = front.data() + j * nr;
+      subtractColumns(column, front.data(), nr, j0, j, j);
+      double d = column[j];
+      if (!(d > pivotTolerance)) {
+        d = REPLACED_PIVOT;
+        ++replaced;
+      }
+      else {
+        d = sqrt(d);
+      }
+      column[j] = d;
+      for (size_t i = j + 1; i < nr; ++i) column[i] /= d;
+    }
+
+    auto updateColumn = [&](size_t c) { subtractColumns(front.data() + c * nr, front.data(), nr, j0, j1, c); };
+    size_t trailing = nr - j1;
+    if (pool && pool->size() > 1 && 0.5 * double(trailing) * trailing * (j1 - j0) >= PARALLEL_WORK) {
+      size_t stride = pool->size();
+      pool->parallelFor(stride, [&](size_t t) {
+        for (size_t c = j1 + t; c < nr; c += stride) updateColumn(c);
+      });
+    }
+    else {
+      for (size_t c = j1; c < nr; ++c) updateColumn(c);
+    }
+  }
+
+  size_t nu = nr - ns;
+  if (nu > 0) {
+    vector<double>& update = updates[s];
+    update.resize(nu * nu);
+    for (size_t b = 0; b < nu; ++b) {
+      const double* column = front.data() + (ns + b) * nr + ns;
+      copy(column + b, column + nu, update.begin() + b * nu + b);
+    }
+  }
+  copy(front.begin(), front.begin() + nr * ns, factorValues.begin() + valueStart[s]);
+}
+
+uint32_t SparseCholesky::factor(const vector<double>& values, ThreadPool* pool) {
+  if (values.size() != entryPosition.size()) throw runtime_error("Cholesky values do not match the pattern");
+  double maxDiagonal = 0.0;
+  for (size_t q = 0; q < values.size(); ++q) lower.value[entryPosition[q]] = values[q];
+  for (uint32_t j = 0; j < n; ++j) maxDiagonal = max(maxDiagonal, lower.value[lower.start[j]]);
+  double pivotTolerance = PIVOT_TOLERANCE * maxDiagonal;
+
+  unsigned workers = pool ? pool->size() : 1;
+  vector<Scratch> scratch(workers);
+  vector<uint32_t> replaced(workers, 0);
+  vector<vector<double>> updates(supernodes());
+  for (const vector<uint32_t>& level : levels) {
+    double work = 0.0;
+    for (uint32_t s : level) {
+      double nr = double(rowStart[s + 1] - rowStart[s]);
+      work += 0.5 * nr * nr * (superStart[s + 1] - superStart[s]);
+    }
+    if (workers == 1 || level.size() == 1 || work < PARALLEL_WORK) {
+      ThreadPool* frontPool = level.size() == 1 ? pool : nullptr;
+      for (uint32_t s : level) factorSupernode(s, scratch[0], updates, pivotTolerance, frontPool, replaced[0]);
+      continue;
+    }
+    atomic<size_t> next{0};
+    pool->parallelFor(workers, [&](size_t w) {
+      for (size_t k; (k = next++) < level.size();) {
+        factorSupernode(level[k], scratch[w], updates, pivotTolerance, nullptr, replaced[w]);
+      }
+    });
+  }
+  numReplaced = 0;
+  for (uint32_t r : replaced) numReplaced += r;
+  return numReplaced;
+}
+
+void SparseCholesky::solve(vector<double>& x) const {
+  vector<double> y(n);
+  for (uint32_t k = 0; k < n; ++k) y[k] = x[perm[k]];
+
+  uint32_t numSuper = supernodes();
+  for (uint32_t s = 0; s < numSuper; ++s) {
+    uint32_t first = superStart[s], ns = superStart[s + 1] - first;
+    const uint32_t* rows = superRows.data() + rowStart[s];
+    size_t nr = rowStart[s + 1] - rowStart[s];
+    const double* block = factorValues.data() + valueStart[s];
+    for (uint32_t c = 0; c < ns; ++c) {
+      const double* column = block + c * nr;
+      double v = y[first + c] /= column[c];
+      if (v == 0.0) continue;
+      for (size_t r = c + 1; r < nr; ++r) y[rows[r]] -= column[r] * v;
+    }
+  }
+  for (uint32_t s = numSuper; s-- > 0;) {
+    uint32_t first = superStart[s], ns = superStart[s + 1] - first;
+    const uint32_t* rows = superRows.data() + rowStart[s];
+    size_t nr = rowStart[s + 1] - rowStart[s];
+    const double* block = factorValues.data() + valueStart[s];
+    for (uint32_t c = ns; c-- > 0;) {
+      const double* column = block + c * nr;
+      double v = y[first + c];
+      for (size_t r = c + 1; r < nr; ++r) v -= column[r] * y[rows[r]];
+      y[first + c] = v / column[c];
+    }
+  }
+  for (uint32_t k = 0; k < n; ++k) x[perm[k]] = y[k];
+}
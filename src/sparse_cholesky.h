@@ -0,0 +1,93 @@
+#pragma once
+
+#include "compact_model.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @class SparseCholesky
+ * @brief Supernodal multifrontal Cholesky factorization P M P^T = L L^T
+ * of a sparse symmetric positive definite matrix M.
+ *
+ * analyze() works on the nonzero pattern alone and is done once per
+ * pattern: a fill-reducing approximate minimum degree ordering (quotient
+ * graph with element absorption and AMD's approximate external degrees,
+ * without supervariables), a postorder of the elimination tree so that
+ * every subtree is a contiguous range of columns, and the fundamental
+ * supernodes (runs of columns with nested structure) of L.
+ *
+ * factor() may then be called for any values on that pattern. Each
+ * supernode assembles a dense frontal matrix from its columns of M and
+ * its children's update matrices, factors its pivot columns and passes
+ * the Schur complement to its parent. Supernodes of the same level of the
+ * supernodal tree are independent and are factored in parallel; a level
+ * holding a single large front splits that front's Schur update across
+ * the pool instead.
+ *
+ * A pivot that is not clearly positive (at most 1e-13 of the largest
+ * diagonal entry) is replaced by a huge value, so the matching component
+ * of a solve comes out as zero. Interior-point normal equations need this
+ * when rows are dependent or nearly so.
+ */
+class SparseCholesky {
+  uint32_t n = 0;
+  std::vector<uint32_t> perm;         // perm[k]: index in M of pivot k
+  SparseMatrix lower;                 // Lower triangle of P M P^T by columns, diagonal first
+  std::vector<size_t> entryPosition;  // Input entry -> position in lower.value
+
+  // Supernode s holds columns [superStart[s], superStart[s + 1]) of L; its
+  // rows are superRows[rowStart[s] .. rowStart[s + 1]), its own columns
+  // first, and its block of L is stored dense and column-major from
+  // factorValues[valueStart[s]].
+  std::vector<uint32_t> superStart{0};
+  std::vector<uint32_t> superParent;  // UINT32_MAX for roots
+  std::vector<size_t> childStart;     // Children of s: superChildren[childStart[s] .. childStart[s + 1])
+  std::vector<uint32_t> superChildren;
+  std::vector<size_t> rowStart;
+  std::vector<uint32_t> superRows;
+  std::vector<size_t> valueStart;
+  std::vector<double> factorValues;
+  std::vector<std::vector<uint32_t>> levels; // Supernodes by height in the tree, leaves first
+  uint32_t numReplaced = 0;
+
+  struct Scratch {
+    std::vector<uint32_t> position; // Row of M -> row of the current front
+    std::vector<double> front;
+  };
+
+  void factorSupernode(uint32_t s, Scratch& scratch, std::vector<std::vector<double>>& updates,
+                       double pivotTolerance, ThreadPool* pool, uint32_t& replaced);
+
+public:
+  /**
+   * @brief Analyzes the pattern of M given as its lower triangle by rows:
+   * row i of `pattern` lists the columns k <= i with M(i, k) != 0, and
+   * must include the diagonal. Values are ignored.
+   */
+  void analyze(const SparseMatrix& pattern);
+
+  /**
+   * @brief Factors M with `values` in the order of the analyzed pattern's
+   * entries. Runs on `pool` if it is not null.
+   *
+   * @return The number of pivots that had to be replaced (see class notes).
+   */
+  uint32_t factor(const std::vector<double>& values, ThreadPool* pool = nullptr);
+
+  /**
+   * @brief Overwrites `x` with M^-1 x using the last factorization.
+   */
+  void solve(std::vector<double>& x) const;
+
+  /**
+   * @brief Nonzeros of L, counting the dense supernode blocks in full.
+   */
+  size_t factorNonzeros() const { return factorValues.size(); }
+
+  /**
+   * @brief Number of supernodes found by analyze().
+   */
+  uint32_t supernodes() const { return static_cast<uint32_t>(superStart.size() - 1); }
+};
@@ -0,0 +1,119 @@
+#include "sparse_multiply.h"
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MILP_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+  void multiplyScalar(const SparseMatrix& a, const double* x, double* y, uint32_t first, uint32_t end) {
+    const size_t* start = a.start.data();
+    const uint32_t* index = a.index.data();
+    const double* value = a.value.data();
+    for (uint32_t i = first; i < end; ++i) {
+      double sum = 0.0;
+      for (size_t p = start[i]; p < start[i + 1]; ++p) sum += value[p] * x[index[p]];
+      y[i] = sum;
+    }
+  }
+
+#ifdef MILP_X86_SIMD
+  __attribute__((target("avx2,fma")))
+  void multiplyAvx2(const SparseMatrix& a, const double* x, double* y, uint32_t first, uint32_t end) {
+    const size_t* start = a.start.data();
+    const uint32_t* index = a.index.data();
+    const double* value = a.value.data();
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (uint32_t i = first; i < end; ++i) {
+      size_t p = start[i], stop = start[i + 1];
+      __m256d sum = zero;
+      for (; p + 4 <= stop; p += 4) {
+        __m128i columns = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + p));
+        __m256d gathered = _mm256_mask_i32gather_pd(zero, x, columns, all, 8);
+        sum = _mm256_fmadd_pd(_mm256_loadu_pd(value + p), gathered, sum);
+      }
+      double lanes[4];
+      _mm256_storeu_pd(lanes, sum);
+      double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+      for (; p < stop; ++p) total += value[p] * x[index[p]];
+      y[i] = total;
+    }
+  }
+
+  __attribute__((target("avx512f")))
+  void multiplyAvx512(const SparseMatrix& a, const double* x, double* y, uint32_t first, uint32_t end) {
+    const size_t* start = a.start.data();
+    const uint32_t* index = a.index.data();
+    const double* value = a.value.data();
+    const __m512d zero = _mm512_setzero_pd();
+    for (uint32_t i = first; i < end; ++i) {
+      size_t p = start[i], stop = start[i + 1];
+      __m512d sum = zero;
+      for (; p + 8 <= stop; p += 8) {
+        __m256i columns = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + p));
+        __m512d gathered = _mm512_mask_i32gather_pd(zero, 0xFF, columns, x, 8);
+        sum = _mm512_fmadd_pd(_mm512_loadu_pd(value + p), gathered, sum);
+      }
+      double lanes[8];
+      _mm512_storeu_pd(lanes, sum);
+      double total = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+      // A masked gather for the last 1-7 entries is several times slower than
+      // these scalar loads on CPUs that microcode gathers
+      for (; p < stop; ++p) total += value[p] * x[index[p]];
+      y[i] = total;
+    }
+  }
+#endif
+} // anonymous namespace
+
+const char* simdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::SCALAR: return "SCALAR";
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::AVX512: return "AVX512";
+  }
+  return "UNKNOWN";
+}
+
+SimdLevel detectSimdLevel() {
+#ifdef MILP_X86_SIMD
+  static const SimdLevel detected = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+    return SimdLevel::SCALAR;
+  }();
+  return detected;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+void sparseMultiply(const SparseMatrix& a, const double* x, double* y, uint32_t first, uint32_t end,
+                    SimdLevel level) {
+  level = min(level, detectSimdLevel());
+#ifdef MILP_X86_SIMD
+  if (level == SimdLevel::AVX512) return multiplyAvx512(a, x, y, first, end);
+  if (level == SimdLevel::AVX2) return multiplyAvx2(a, x, y, first, end);
+#endif
+  multiplyScalar(a, x, y, first, end);
+}
+
+vector<uint32_t> balancedLineRanges(const SparseMatrix& a, unsigned parts) {
+  uint32_t lines = a.numMajor();
+  parts = max(1u, parts);
+  vector<uint32_t> ranges(parts + 1, lines);
+  ranges[0] = 0;
+  double total = double(a.numNonzeros()) + lines;
+  uint32_t i = 0;
+  for (unsigned t = 1; t < parts; ++t) {
+    double target = total * t / parts;
+    while (i < lines && double(a.start[i]) + i < target) ++i;
+    ranges[t] = i;
+  }
+  return ranges;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "compact_model.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Instruction set of the sparse matrix-vector kernels.
+ */
+enum class SimdLevel {
+  SCALAR, // Plain C++
+  AVX2,   // 4 doubles per step: AVX2 gathers and FMA
+  AVX512  // 8 doubles per step: AVX-512F gathers and FMA
+};
+
+/**
+ * @brief Returns the name of `level`, e.g. "AVX2".
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief The best level this CPU and build support, detected once.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @brief y[i] = sum_p value[p] * x[index[p]] over the entries of major
+ * lines [first, end) of `a`: a CSR matrix times x, or a CSC matrix's
+ * transpose times x.
+ *
+ * Each line is a dot product of its values with x gathered at its minor
+ * indices, with fused multiply-adds at `level` (lowered to what
+ * detectSimdLevel() allows) and a scalar tail. Only y[first, end) is
+ * written, so disjoint line ranges may run on separate threads. Minor
+ * indices must be below 2^31.
+ */
+void sparseMultiply(const SparseMatrix& a, const double* x, double* y, uint32_t first, uint32_t end,
+                    SimdLevel level);
+
+/**
+ * @brief Splits the major lines of `a` into `parts` contiguous ranges with
+ * about equal nonzeros (plus one per line, for the cost of the line
+ * itself). Range t is [result[t], result[t + 1]).
+ */
+std::vector<uint32_t> balancedLineRanges(const SparseMatrix& a, unsigned parts);
@@ -0,0 +1,64 @@
+#include "symbol_table.h"
+#include <stdexcept>
+
+using namespace std;
+
+uint64_t SymbolTable::hash(string_view name) {
+  uint64_t h = 14695981039346656037ull;
+  for (char c : name) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+/*
+ * Function: findSlot
+ * -------------------------
+ * Linear probing: returns the slot holding `name`, or the first empty
+ * slot where it would be inserted. The table is never more than half full.
+ */
+size_t SymbolTable::findSlot(string_view name, uint64_t h) const {
+  size_t mask = slots.size() - 1;
+  for (size_t i = h & mask;; i = (i + 1) & mask) {
+    uint32_t id = slots[i];
+    if (id == EMPTY || this->name(id) == name) return i;
+  }
+}
+
+void SymbolTable::rehash(size_t capacity) {
+  slots.assign(capacity, EMPTY);
+  for (uint32_t id = 0; id < size(); ++id) {
+    slots[findSlot(name(id), hash(name(id)))] = id;
+  }
+}
+
+uint32_t SymbolTable::intern(string_view name) {
+  if (2 * (size_t(size()) + 1) > slots.size()) {
+    rehash(slots.empty() ? 64 : slots.size() * 2);
+  }
+
+  size_t slot = findSlot(name, hash(name));
+  if (slots[slot] != EMPTY) return slots[slot];
+
+  if (size() == NOT_FOUND - 1) throw runtime_error("Too many symbols");
+  uint32_t id = size();
+  arena.append(name);
+  arena.push_back('\0');
+  offsets.push_back(arena.size());
+  slots[slot] = id;
+  return id;
+}
+
+uint32_t SymbolTable::find(string_view name) const {
+  if (slots.empty()) return NOT_FOUND;
+  return slots[findSlot(name, hash(name))];
+}
+
+void SymbolTable::reserve(size_t count, size_t bytes) {
+  offsets.reserve(count + 1);
+  arena.reserve(bytes);
+  size_t capacity = slots.empty() ? 64 : slots.size();
+  while (capacity < 2 * count) capacity *= 2;
+  if (capacity > slots.size()) rehash(capacity);
+}
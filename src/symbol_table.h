@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class SymbolTable
+ * @brief Interns names into dense 32-bit ids.
+ *
+ * Names are stored back to back (each followed by '\0') in one contiguous
+ * arena, and looked up through an open-addressing hash table of ids, so a
+ * model with millions of variables costs a few bytes per name beyond the
+ * characters themselves. Ids are assigned in order of first appearance.
+ */
+class SymbolTable {
+  std::string arena;                // All names, '\0'-terminated, back to back
+  std::vector<uint64_t> offsets{0}; // Name i occupies [offsets[i], offsets[i + 1] - 1)
+  std::vector<uint32_t> slots;      // Hash table of ids; EMPTY marks a free slot
+
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+
+  size_t findSlot(std::string_view name, uint64_t hash) const;
+  void rehash(size_t capacity);
+
+  friend class ModelSnapshot; // Saves and restores the three arrays directly
+
+public:
+  static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+  /**
+   * @brief 64-bit FNV-1a hash. Stable across runs and platforms.
+   */
+  static uint64_t hash(std::string_view name);
+
+  /**
+   * @brief Returns the id of `name`, adding it if it is not yet present.
+   */
+  uint32_t intern(std::string_view name);
+
+  /**
+   * @brief Returns the id of `name`, or NOT_FOUND.
+   */
+  uint32_t find(std::string_view name) const;
+
+  /**
+   * @brief Returns the name of symbol `id`.
+   */
+  std::string_view name(uint32_t id) const {
+    return std::string_view(arena.data() + offsets[id], offsets[id + 1] - offsets[id] - 1);
+  }
+
+  /**
+   * @brief Returns the name of symbol `id` as a null-terminated C string.
+   */
+  const char* c_str(uint32_t id) const { return arena.data() + offsets[id]; }
+
+  /**
+   * @brief Number of interned names.
+   */
+  uint32_t size() const { return static_cast<uint32_t>(offsets.size() - 1); }
+
+  /**
+   * @brief Pre-sizes the table for `count` names of `bytes` total length.
+   */
+  void reserve(size_t count, size_t bytes = 0);
+};
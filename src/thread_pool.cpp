@@ -0,0 +1,46 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned numThreads) {
+  numThreads = resolveThreads(numThreads);
+  workers.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    workers.emplace_back([this] { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  available.notify_all();
+  for (auto& worker : workers) worker.join();
+}
+
+unsigned ThreadPool::resolveThreads(unsigned requested) {
+  if (requested > 0) return requested;
+  unsigned hw = std::thread::hardware_concurrency();
+  return hw > 0 ? hw : 1;
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(task));
+  }
+  available.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) return;
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
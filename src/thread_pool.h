@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of worker threads draining a FIFO task queue.
+ */
+class ThreadPool {
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable available;
+  bool stopping = false;
+
+  void workerLoop();
+  void enqueue(std::function<void()> task);
+
+public:
+  /**
+   * @brief Starts `numThreads` workers (0 = one per hardware thread).
+   */
+  explicit ThreadPool(unsigned numThreads = 0);
+
+  /**
+   * @brief Finishes queued tasks, then joins all workers.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Number of worker threads.
+   */
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  /**
+   * @brief Resolves a requested thread count: 0 means all hardware threads.
+   */
+  static unsigned resolveThreads(unsigned requested);
+
+  /**
+   * @brief Queues `f` and returns a future for its result (or exception).
+   */
+  template <typename F>
+  auto submit(F&& f) -> std::future<decltype(f())> {
+    using R = decltype(f());
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> result = task->get_future();
+    enqueue([task] { (*task)(); });
+    return result;
+  }
+
+  /**
+   * @brief Runs body(i) for i in [0, count) across the pool and waits.
+   * Rethrows the exception of the lowest failing index, if any.
+   */
+  template <typename F>
+  void parallelFor(size_t count, F&& body) {
+    std::vector<std::future<void>> pending;
+    pending.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      pending.push_back(submit([&body, i] { body(i); }));
+    }
+    std::exception_ptr first;
+    for (auto& f : pending) {
+      try {
+        f.get();
+      }
+      catch (...) {
+        if (!first) first = std::current_exception();
+      }
+    }
+    if (first) std::rethrow_exception(first);
+  }
+};